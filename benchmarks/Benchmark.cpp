@@ -0,0 +1,124 @@
+//
+// Class Benchmark
+//   Times kernels of OPAL-X and writes the results in JSON.
+//
+// This file is part of OPAL.
+//
+// OPAL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// You should have received a copy of the GNU General Public License
+// along with OPAL. If not, see <https://www.gnu.org/licenses/>.
+//
+#include "Benchmark.h"
+
+#include "Ippl.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <numeric>
+#include <sstream>
+
+extern Inform* gmsg;
+
+double Benchmark::Result::getMinTime() const {
+    return *std::min_element(times.begin(), times.end());
+}
+
+double Benchmark::Result::getMedianTime() const {
+    std::vector<double> sorted(times);
+    std::sort(sorted.begin(), sorted.end());
+
+    const size_t n = sorted.size();
+    return n % 2 == 1 ? sorted[n / 2] : 0.5 * (sorted[n / 2 - 1] + sorted[n / 2]);
+}
+
+double Benchmark::Result::getMeanTime() const {
+    return std::accumulate(times.begin(), times.end(), 0.0) / times.size();
+}
+
+Benchmark::Benchmark(unsigned int numRepetitions)
+    : numRepetitions_m(std::max(numRepetitions, 1u)) {
+}
+
+double Benchmark::timeKernel(const std::function<void()>& kernel) const {
+    Kokkos::fence();
+    ippl::Comm->barrier();
+
+    const auto start = std::chrono::steady_clock::now();
+    kernel();
+    Kokkos::fence();
+    const auto end = std::chrono::steady_clock::now();
+
+    double time = std::chrono::duration<double>(end - start).count();
+    ippl::Comm->allreduce(time, 1, std::greater<double>());
+
+    return time;
+}
+
+void Benchmark::run(
+    const std::string& group, const std::string& name, size_t numParticles, double numBytes,
+    const std::function<void()>& kernel, const std::function<void()>& setup) {
+    if (setup) {
+        setup();
+    }
+    kernel();
+
+    Result result{group, name, numParticles, numBytes, {}};
+    for (unsigned int i = 0; i < numRepetitions_m; ++i) {
+        if (setup) {
+            setup();
+        }
+        result.times.push_back(timeKernel(kernel));
+    }
+
+    *gmsg << "* " << std::left << std::setw(16) << group << std::setw(40) << name << std::right
+          << std::scientific << std::setprecision(4) << result.getMedianTime() << " s" << endl;
+
+    results_m.push_back(result);
+}
+
+void Benchmark::addProperty(const std::string& key, const std::string& value) {
+    properties_m[key] = "\"" + value + "\"";
+}
+
+void Benchmark::addProperty(const std::string& key, double value) {
+    std::ostringstream json;
+    json << std::setprecision(15) << value;
+    properties_m[key] = json.str();
+}
+
+void Benchmark::writeJson(const std::string& fileName) const {
+    if (ippl::Comm->rank() != 0) {
+        return;
+    }
+
+    std::ofstream out(fileName);
+    out << std::setprecision(6) << std::scientific;
+    out << "{\n";
+    for (const auto& property : properties_m) {
+        out << "    \"" << property.first << "\": " << property.second << ",\n";
+    }
+
+    out << "    \"benchmarks\": [";
+    for (size_t i = 0; i < results_m.size(); ++i) {
+        const Result& result = results_m[i];
+        const double median  = result.getMedianTime();
+
+        out << (i == 0 ? "\n" : ",\n");
+        out << "        {\"group\": \"" << result.group << "\", \"name\": \"" << result.name
+            << "\", \"particles\": " << result.numParticles
+            << ", \"bytes\": " << result.numBytes
+            << ", \"repetitions\": " << result.times.size()
+            << ", \"min_s\": " << result.getMinTime() << ", \"median_s\": " << median
+            << ", \"mean_s\": " << result.getMeanTime()
+            << ", \"particles_per_s\": " << (median > 0.0 ? result.numParticles / median : 0.0)
+            << ", \"gb_per_s\": " << (median > 0.0 ? result.numBytes / median * 1e-9 : 0.0)
+            << "}";
+    }
+    out << "\n    ]\n}\n";
+}
@@ -0,0 +1,67 @@
+//
+// Class Benchmark
+//   Times kernels of OPAL-X and writes the results in JSON.
+//
+//   Every kernel is run once to warm up and then a fixed number of
+//   repetitions. Before and after every repetition the devices are fenced
+//   and the ranks synchronized, the time of a repetition is the maximum over
+//   the ranks. The throughput is computed from the median time with the
+//   global number of particles and the number of bytes the kernel has to move
+//   at least, i.e. the GB/s are a lower bound of the achieved bandwidth.
+//
+// This file is part of OPAL.
+//
+// OPAL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// You should have received a copy of the GNU General Public License
+// along with OPAL. If not, see <https://www.gnu.org/licenses/>.
+//
+#ifndef OPALX_BENCHMARK_H
+#define OPALX_BENCHMARK_H
+
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+class Benchmark {
+public:
+    struct Result {
+        std::string group;
+        std::string name;
+        size_t numParticles;  // global
+        double numBytes;      // global
+        std::vector<double> times;  // [s] per repetition
+
+        double getMinTime() const;
+        double getMedianTime() const;
+        double getMeanTime() const;
+    };
+
+    explicit Benchmark(unsigned int numRepetitions);
+
+    /// runs kernel numRepetitions times after one warm up, setup is run untimed before every call
+    void run(
+        const std::string& group, const std::string& name, size_t numParticles, double numBytes,
+        const std::function<void()>& kernel,
+        const std::function<void()>& setup = std::function<void()>());
+
+    /// adds a key to the header of the JSON file
+    void addProperty(const std::string& key, const std::string& value);
+    void addProperty(const std::string& key, double value);
+
+    /// writes the results on rank 0
+    void writeJson(const std::string& fileName) const;
+
+private:
+    double timeKernel(const std::function<void()>& kernel) const;
+
+    unsigned int numRepetitions_m;
+    std::map<std::string, std::string> properties_m;  // values in JSON
+    std::vector<Result> results_m;
+};
+
+#endif
@@ -0,0 +1,459 @@
+//
+// opalx_bench
+//   Micro benchmarks of the kernels of a tracking step on synthetic,
+//   deterministic input: the Boris push, the external fields of the element
+//   types, the moments of the bunch, the binning, the space charge (scatter,
+//   solve and gather for several meshes), the phase space dump and the
+//   loading of field maps.
+//
+//   Runs on a single node without an input file, e.g.
+//     mpirun -np 2 opalx_bench --particles 1000000 --mesh 32,64 --output bench.json
+//   The results are written in JSON with the throughput in particles/s and GB/s.
+//
+// This file is part of OPAL.
+//
+// OPAL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// You should have received a copy of the GNU General Public License
+// along with OPAL. If not, see <https://www.gnu.org/licenses/>.
+//
+#include "H5hut.h"
+
+#include "Benchmark.h"
+#include "SyntheticInput.h"
+
+#include "AbsBeamline/Multipole.h"
+#include "AbsBeamline/RFCavity.h"
+#include "AbsBeamline/Solenoid.h"
+#include "AbsBeamline/TravelingWave.h"
+#include "Algorithms/DistributionMoments.h"
+#include "Algorithms/ExternalFieldFunction.h"
+#include "Fields/Fieldmap.h"
+#include "OpalConfigure/Configure.h"
+#include "Physics/Physics.h"
+#include "Physics/Units.h"
+#include "Steppers/BorisPusher.h"
+#include "Structure/H5PartWrapperForPT.h"
+#include "Utilities/ClassicException.h"
+#include "Utilities/OpalException.h"
+#include "Utilities/Options.h"
+#include "Utilities/Util.h"
+
+#include "OPALconfig.h"
+
+// IPPL
+#include "GSLErrorHandling.h"
+#include "Utility/IpplException.h"
+
+#include <gsl/gsl_errno.h>
+
+#include <boost/filesystem.hpp>
+
+#include <cmath>
+#include <cstdlib>
+#include <map>
+#include <sstream>
+
+Inform* gmsg;
+
+// the kernels can't be defined in the lambdas passed to Benchmark::run
+namespace BenchmarkKernels {
+    using vector_view_type = Kokkos::View<Vector_t<double, 3>*>;
+    using field_view_type  = ExternalFieldFunction::field_view_type;
+
+    void kickAndPush(
+        const BorisPusher& pusher, const vector_view_type& Rview, const vector_view_type& Pview,
+        const vector_view_type& Eview, const vector_view_type& Bview,
+        const Kokkos::View<double*>& dtview, double mass, double charge, double newdT) {
+        Kokkos::parallel_for(
+            "benchKickAndPush", Rview.extent(0), KOKKOS_LAMBDA(const size_t i) {
+                const double dt    = dtview(i);
+                const double scale = Physics::c * dt;
+
+                Vector_t<double, 3> x = Rview(i) / scale;
+                Vector_t<double, 3> p = Pview(i);
+
+                pusher.kick(x, p, Eview(i), Bview(i), dt, mass, charge);
+                pusher.push(x, p, dt);
+
+                Rview(i)  = x * scale;
+                Pview(i)  = p;
+                dtview(i) = newdT;
+            });
+    }
+
+    void evaluateFields(
+        const ExternalFieldFunction& function, double t, const field_view_type& Rview,
+        const field_view_type& Pview, const field_view_type& Eview,
+        const field_view_type& Bview) {
+        Kokkos::parallel_for(
+            "benchElementFields", Eview.extent(0), KOKKOS_LAMBDA(const size_t i) {
+                Vector_t<double, 3> E, B;
+                function(t, i, Rview(i), Pview(i), E, B);
+                Eview(i) = E;
+                Bview(i) = B;
+            });
+    }
+}  // namespace BenchmarkKernels
+
+namespace {
+    struct Arguments {
+        size_t numParticles = 1 << 20;
+        unsigned int numRepetitions = 10;
+        unsigned int numFieldMapPoints = 100001;
+        std::vector<unsigned int> meshSizes = {16, 32, 64};
+        std::string output    = "opalx_bench.json";
+        std::string directory = "opalx_bench.d";
+    };
+
+    void printHelp() {
+        *ippl::Info << "Usage: opalx_bench [<option> <option> ...]\n"
+                    << "   --particles <n>       : Number of particles (1048576).\n"
+                    << "   --repetitions <n>     : Timed repetitions per benchmark (10).\n"
+                    << "   --mesh <n>,<n>,...    : Space charge meshes with n^3 cells (16,32,64).\n"
+                    << "   --fieldmap-points <n> : Grid points of the field maps (100001).\n"
+                    << "   --output <fname>      : JSON file of the results (opalx_bench.json).\n"
+                    << "   --directory <dir>     : Directory of written files (opalx_bench.d).\n"
+                    << "   --help                : Display this command-line summary.\n"
+                    << endl;
+    }
+
+    Arguments parseArguments(int argc, char* argv[]) {
+        Arguments arguments;
+        for (int i = 1; i < argc; ++i) {
+            const std::string arg(argv[i]);
+            if (arg == "-h" || arg == "--help") {
+                printHelp();
+                ippl::finalize();
+                exit(0);
+            }
+
+            if (i + 1 == argc) {
+                throw OpalException("parseArguments", "Missing value of argument \"" + arg + "\"");
+            }
+            const std::string value(argv[++i]);
+
+            if (arg == "--particles") {
+                arguments.numParticles = std::stoull(value);
+            } else if (arg == "--repetitions") {
+                arguments.numRepetitions = std::stoul(value);
+            } else if (arg == "--fieldmap-points") {
+                arguments.numFieldMapPoints = std::max(std::stoul(value), 2ul);
+            } else if (arg == "--mesh") {
+                arguments.meshSizes.clear();
+                std::istringstream list(value);
+                for (std::string size; std::getline(list, size, ',');) {
+                    arguments.meshSizes.push_back(std::stoul(size));
+                }
+            } else if (arg == "--output") {
+                arguments.output = value;
+            } else if (arg == "--directory") {
+                arguments.directory = value;
+            } else {
+                throw OpalException("parseArguments", "Unknown argument \"" + arg + "\"");
+            }
+        }
+
+        if (arguments.numParticles == 0 || arguments.meshSizes.empty()) {
+            throw OpalException("parseArguments", "No particles or no mesh to benchmark");
+        }
+
+        return arguments;
+    }
+
+    /// like ParallelTracker::kickAndPushParticles, on a copy of the particles in constant fields
+    void benchmarkPusher(Benchmark& benchmark, PartBunch_t& bunch) {
+        using vector_view_type = BenchmarkKernels::vector_view_type;
+
+        auto pc               = bunch.getParticleContainer();
+        const size_t numLocal = pc->getLocalNum();
+        const auto range      = std::make_pair(size_t(0), numLocal);
+
+        vector_view_type Rview("benchR", numLocal), Pview("benchP", numLocal);
+        vector_view_type Eview("benchE", numLocal), Bview("benchB", numLocal);
+        Kokkos::View<double*> dtview("benchDt", numLocal);
+        Kokkos::deep_copy(Rview, Kokkos::subview(pc->R.getView(), range));
+        Kokkos::deep_copy(Pview, Kokkos::subview(pc->P.getView(), range));
+        Kokkos::deep_copy(Eview, Vector_t<double, 3>({1e5, 0.0, 1e6}));
+        Kokkos::deep_copy(Bview, Vector_t<double, 3>({0.0, 0.1, 0.5}));
+        Kokkos::deep_copy(dtview, bunch.getdT());
+
+        const BorisPusher pusher;
+        const double mass   = Physics::m_e * Units::GeV2eV;
+        const double charge = -1.0;
+        const double newdT  = bunch.getdT();
+
+        // read R, P, E, B and dt, write R, P and dt
+        const double bytesPerParticle = 6 * sizeof(Vector_t<double, 3>) + 2 * sizeof(double);
+        benchmark.run(
+            "pusher", "BorisPusher::kick+push", bunch.getTotalNum(),
+            bytesPerParticle * bunch.getTotalNum(), [&]() {
+                BenchmarkKernels::kickAndPush(
+                    pusher, Rview, Pview, Eview, Bview, dtview, mass, charge, newdT);
+            });
+    }
+
+    /// evaluates one element at a time through ExternalFieldFunction as ParallelTracker does
+    void benchmarkElements(
+        Benchmark& benchmark, PartBunch_t& bunch, const std::string& rfFieldMap,
+        const std::string& solenoidFieldMap) {
+        const double rfFrequency = SyntheticInput::rfFrequency * Units::MHz2Hz * Physics::two_pi;
+
+        auto quadrupole = std::make_shared<Multipole>("BENCH_QUADRUPOLE");
+        quadrupole->setElementLength(0.2);
+        quadrupole->setNormalComponent(2, 1.0);
+
+        auto solenoid = std::make_shared<Solenoid>("BENCH_SOLENOID");
+        solenoid->setFieldMapFN(solenoidFieldMap);
+        solenoid->setKS(0.1);
+
+        auto cavity = std::make_shared<RFCavity>("BENCH_RFCAVITY");
+        cavity->setFieldMapFN(rfFieldMap);
+        cavity->setFrequencym(rfFrequency);
+        cavity->setAmplitudem(10.0);
+        cavity->setPhasem(0.0);
+
+        auto travelingWave = std::make_shared<TravelingWave>("BENCH_TRAVELINGWAVE");
+        travelingWave->setFieldMapFN(rfFieldMap);
+        travelingWave->setFrequencym(rfFrequency);
+        travelingWave->setAmplitudem(10.0);
+        travelingWave->setPhasem(0.0);
+        travelingWave->setNumCells(10);
+        travelingWave->setMode(1.0 / 3.0);
+
+        const std::vector<std::pair<std::string, std::shared_ptr<Component>>> components = {
+            {"Multipole", quadrupole},
+            {"Solenoid", solenoid},
+            {"RFCavity", cavity},
+            {"TravelingWave", travelingWave}};
+
+        auto pc               = bunch.getParticleContainer();
+        const size_t numLocal = pc->getLocalNum();
+        auto Rview            = pc->R.getView();
+        auto Pview            = pc->P.getView();
+        auto selfE            = pc->E.getView();
+        auto selfB            = pc->B.getView();
+
+        ExternalFieldFunction::field_view_type Eview("benchElementE", numLocal);
+        ExternalFieldFunction::field_view_type Bview("benchElementB", numLocal);
+
+        // read R, P and the self fields, write E and B
+        const double bytesPerParticle = 6 * sizeof(Vector_t<double, 3>);
+        const double t                = bunch.getT() + 0.5 * bunch.getdT();
+        for (const auto& component : components) {
+            double startField = 0.0, endField = 0.0;
+            component.second->initialise(&bunch, startField, endField);
+            component.second->goOnline(0.0);
+
+            // the center of the bunch is placed in the center of the element
+            const double center = 0.5 * (startField + endField);
+            const CoordinateSystemTrafo refToLocal(
+                Vector_t<double, 3>({0.0, 0.0, -center}), Quaternion(1.0, 0.0, 0.0, 0.0));
+
+            const std::vector<ExternalFieldFunction::Element> elements = {
+                ExternalFieldFunction::Element(component.second.get(), refToLocal)};
+            const ExternalFieldFunction function(elements, selfE, selfB);
+
+            benchmark.run(
+                "elements", component.first + "::apply", bunch.getTotalNum(),
+                bytesPerParticle * bunch.getTotalNum(), [&]() {
+                    component.second->updateTimeDependence(t);
+                    BenchmarkKernels::evaluateFields(function, t, Rview, Pview, Eview, Bview);
+                });
+
+            component.second->goOffline();
+        }
+    }
+
+    void benchmarkMoments(Benchmark& benchmark, PartBunch_t& bunch) {
+        auto pc = bunch.getParticleContainer();
+
+        auto Rview = pc->R.getView();
+        auto Pview = pc->P.getView();
+        auto Mview = pc->getMassView();
+
+        const size_t numTotal = bunch.getTotalNum();
+        const size_t numLocal = pc->getLocalNum();
+
+        // read R, P and M
+        const double bytesPerParticle = 2 * sizeof(Vector_t<double, 3>) + sizeof(double);
+
+        DistributionMoments moments;
+        benchmark.run(
+            "moments", "DistributionMoments::computeMoments", numTotal,
+            bytesPerParticle * numTotal,
+            [&]() { moments.computeMoments(Rview, Pview, Mview, numTotal, numLocal); });
+
+        benchmark.run(
+            "moments", "PartBunch::calcBeamParameters", numTotal, bytesPerParticle * numTotal,
+            [&]() { bunch.calcBeamParameters(); });
+    }
+
+    void benchmarkBinning(Benchmark& benchmark, PartBunch_t& bunch) {
+        using bin_index_type = PartBunch_t::ParticleContainer_t::bin_index_type;
+
+        auto bins             = bunch.getBins();
+        const size_t numTotal = bunch.getTotalNum();
+
+        // read R, write the bin
+        benchmark.run(
+            "binning", "AdaptBins::doFullRebin", numTotal,
+            (sizeof(Vector_t<double, 3>) + sizeof(bin_index_type)) * numTotal,
+            [&]() { bins->doFullRebin(bins->getMaxBinCount()); });
+
+        // read the bin, write the index
+        benchmark.run(
+            "binning", "AdaptBins::sortContainerByBin", numTotal,
+            (sizeof(bin_index_type) + sizeof(size_type)) * numTotal,
+            [&]() { bins->sortContainerByBin(); });
+    }
+
+    void benchmarkSpaceCharge(Benchmark& benchmark, PartBunch_t& bunch, unsigned int meshSize) {
+        const std::string mesh = std::to_string(meshSize) + "^3";
+        const double numCells  = std::pow(double(meshSize), 3);
+        const size_t numTotal  = bunch.getTotalNum();
+
+        // read R and Q, write rho
+        benchmark.run(
+            "spacecharge", "PartBunch::scatterCIC/" + mesh, numTotal,
+            (sizeof(Vector_t<double, 3>) + sizeof(double)) * numTotal
+                + sizeof(double) * numCells,
+            [&]() { bunch.scatterCIC(); });
+
+        // read rho, write E
+        benchmark.run(
+            "spacecharge", "FieldSolver::runSolver/" + mesh, numTotal,
+            (sizeof(double) + sizeof(Vector_t<double, 3>)) * numCells,
+            [&]() { bunch.getFieldSolver()->runSolver(); });
+
+        // read R and the field E, write E
+        benchmark.run(
+            "spacecharge", "PartBunch::gatherCIC/" + mesh, numTotal,
+            2 * sizeof(Vector_t<double, 3>) * numTotal + sizeof(Vector_t<double, 3>) * numCells,
+            [&]() { bunch.gatherCIC(); });
+    }
+
+    /// times writeStep since writeStepData needs the step opened by it
+    void benchmarkPhaseSpaceDump(
+        Benchmark& benchmark, PartBunch_t& bunch, const std::string& directory) {
+        const std::string fileName = Util::combineFilePath({directory, "bench.h5"});
+        if (ippl::Comm->rank() == 0) {
+            boost::filesystem::remove(fileName);
+        }
+        ippl::Comm->barrier();
+
+        H5PartWrapperForPT h5(fileName, H5_O_WRONLY);
+        h5.writeHeader();
+
+        // x, y, z, px, py, pz, q, (E, B), id, bin and sp
+        const double bytesPerParticle =
+            (Options::ebDump ? 13 : 7) * sizeof(h5_float64_t) + sizeof(h5_int64_t)
+            + 2 * sizeof(h5_int32_t);
+        const std::map<std::string, double> attributes;
+        benchmark.run(
+            "io", "H5PartWrapperForPT::writeStep", bunch.getTotalNum(),
+            bytesPerParticle * bunch.getTotalNum(), [&]() { h5.writeStep(&bunch, attributes); });
+    }
+
+    void benchmarkFieldMaps(Benchmark& benchmark, const std::vector<std::string>& fileNames) {
+        for (const std::string& fileName : fileNames) {
+            const std::string name = boost::filesystem::path(fileName).filename().string();
+            const double fileSize  = boost::filesystem::file_size(fileName);
+            benchmark.run("fieldmaps", "Fieldmap::readMap/" + name, 0, fileSize, [&]() {
+                Fieldmap::getFieldmap(fileName);
+                Fieldmap::readMap(fileName);
+                Fieldmap::deleteFieldmap(fileName);
+            });
+        }
+    }
+
+    void printError(const std::string& where, std::string what) {
+        Inform errorMsg("Error", std::cerr, INFORM_ALL_NODES);
+        errorMsg << "\n*** Error detected by function \"" << where << "\"\n";
+        size_t pos = what.find_first_of('\n');
+        while (pos != std::string::npos) {
+            errorMsg << "    " << what.substr(0, pos) << endl;
+            what = what.substr(pos + 1, std::string::npos);
+            pos  = what.find_first_of('\n');
+        }
+        errorMsg << "    " << what << endl;
+    }
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    ippl::initialize(argc, argv);
+    {
+        gmsg = new Inform("opalx_bench");
+
+        H5SetVerbosityLevel(1);
+        gsl_set_error_handler(&handleGSLErrors);
+
+        try {
+            const Arguments arguments = parseArguments(argc, argv);
+
+            Configure::configure();
+
+            namespace fs = boost::filesystem;
+            if (ippl::Comm->rank() == 0 && !fs::exists(arguments.directory)) {
+                fs::create_directories(arguments.directory);
+            }
+            ippl::Comm->barrier();
+
+            Benchmark benchmark(arguments.numRepetitions);
+            benchmark.addProperty("opalx_version", OPAL_PROJECT_VERSION);
+            benchmark.addProperty("git_revision", Util::getGitRevision());
+            benchmark.addProperty("execution_space", Kokkos::DefaultExecutionSpace::name());
+            benchmark.addProperty("ranks", ippl::Comm->size());
+            benchmark.addProperty(
+                "host_threads", Kokkos::DefaultHostExecutionSpace().concurrency());
+            benchmark.addProperty("particles", arguments.numParticles);
+            benchmark.addProperty("repetitions", arguments.numRepetitions);
+
+            const std::string rfFieldMap = SyntheticInput::writeRFFieldMap(
+                arguments.directory, arguments.numFieldMapPoints);
+            const std::string solenoidFieldMap = SyntheticInput::writeSolenoidFieldMap(
+                arguments.directory, arguments.numFieldMapPoints);
+            benchmarkFieldMaps(benchmark, {rfFieldMap, solenoidFieldMap});
+
+            SyntheticInput::defineFieldSolvers(arguments.meshSizes);
+            for (size_t k = 0; k < arguments.meshSizes.size(); ++k) {
+                std::shared_ptr<PartBunch_t> bunch =
+                    SyntheticInput::makeBunch(arguments.meshSizes[k], arguments.numParticles);
+
+                // the particle kernels don't depend on the mesh
+                if (k == 0) {
+                    benchmarkPusher(benchmark, *bunch);
+                    benchmarkElements(benchmark, *bunch, rfFieldMap, solenoidFieldMap);
+                    benchmarkMoments(benchmark, *bunch);
+                    benchmarkBinning(benchmark, *bunch);
+                    benchmarkPhaseSpaceDump(benchmark, *bunch, arguments.directory);
+                }
+
+                benchmarkSpaceCharge(benchmark, *bunch, arguments.meshSizes[k]);
+            }
+
+            benchmark.writeJson(arguments.output);
+            *gmsg << "* Results written to '" << arguments.output << "'" << endl;
+        } catch (OpalException& ex) {
+            printError(ex.where(), ex.what());
+            MPI_Abort(MPI_COMM_WORLD, -100);
+        } catch (ClassicException& ex) {
+            printError(ex.where(), ex.what());
+            MPI_Abort(MPI_COMM_WORLD, -100);
+        } catch (IpplException& ex) {
+            printError(ex.where(), ex.what());
+            MPI_Abort(MPI_COMM_WORLD, -100);
+        } catch (std::exception& ex) {
+            printError("opalx_bench", ex.what());
+            MPI_Abort(MPI_COMM_WORLD, -100);
+        }
+
+        delete gmsg;
+    }
+    ippl::finalize();
+
+    return 0;
+}
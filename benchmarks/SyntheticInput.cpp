@@ -0,0 +1,175 @@
+//
+// Namespace SyntheticInput
+//   Deterministic inputs of the benchmarks: field solvers, bunches and
+//   field maps.
+//
+// This file is part of OPAL.
+//
+// OPAL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// You should have received a copy of the GNU General Public License
+// along with OPAL. If not, see <https://www.gnu.org/licenses/>.
+//
+#include "SyntheticInput.h"
+
+#include "Distribution/CounterBasedSampling.hpp"
+#include "OpalParser/OpalParser.h"
+#include "OpalParser/StringStream.h"
+#include "Physics/Physics.h"
+#include "Physics/Units.h"
+#include "Structure/FieldSolverCmd.h"
+#include "Utilities/OpalException.h"
+#include "Utilities/Util.h"
+
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace {
+    constexpr uint64_t seed = 20240611;
+
+    std::string getFieldSolverName(unsigned int meshSize) {
+        return "BENCH_FS_" + std::to_string(meshSize);
+    }
+}  // namespace
+
+namespace SyntheticInput {
+    void defineFieldSolvers(const std::vector<unsigned int>& meshSizes) {
+        std::ostringstream input;
+        for (unsigned int n : meshSizes) {
+            input << getFieldSolverName(n) << ": FIELDSOLVER, TYPE = FFT, NX = " << n
+                  << ", NY = " << n << ", NZ = " << n << ", BBOXINCR = 1.0;\n";
+        }
+
+        const OpalParser parser;
+        parser.run(new StringStream(input.str()));
+    }
+
+    std::shared_ptr<PartBunch_t> makeBunch(unsigned int meshSize, size_t numParticles) {
+        FieldSolverCmd* fs = FieldSolverCmd::find(getFieldSolverName(meshSize));
+        if (fs == nullptr) {
+            throw OpalException(
+                "SyntheticInput::makeBunch",
+                "No field solver defined for a mesh with " + std::to_string(meshSize) + "^3 cells");
+        }
+
+        // the field solver is owned by OpalData
+        std::shared_ptr<FieldSolverCmd> solver(fs, [](FieldSolverCmd*) {});
+        std::shared_ptr<Distribution> distribution;
+
+        // 1 nC of electrons, the units of the mass as in TrackRun
+        const double charge = -1e-9 / numParticles;
+        const double mass   = Physics::m_e * 1e9 * Units::eV2MeV;
+        auto bunch          = std::make_shared<PartBunch_t>(
+            charge, mass, numParticles, 10, 1.0, "LF2", distribution, solver);
+
+        const size_t numRanks = ippl::Comm->size();
+        const size_t rank     = ippl::Comm->rank();
+        const size_t numLocal = numParticles / numRanks + (rank < numParticles % numRanks);
+        const uint64_t firstId =
+            rank * (numParticles / numRanks) + std::min(rank, numParticles % numRanks);
+
+        const double dt = 1e-12;
+        bunch->setT(0.0);
+        bunch->setdT(dt);
+
+        std::shared_ptr<PartBunch_t::ParticleContainer_t> pc = bunch->getParticleContainer();
+        pc->create(numLocal);
+
+        auto Rview   = pc->R.getView();
+        auto Pview   = pc->P.getView();
+        auto Eview   = pc->E.getView();
+        auto Bview   = pc->B.getView();
+        auto Qview   = pc->Q.getView();
+        auto Mview   = pc->M.getView();
+        auto dtview  = pc->dt.getView();
+        auto Binview = pc->Bin.getView();
+        auto Spview  = pc->Sp.getView();
+
+        // Gaussian bunch with sigma 1 mm around a mean momentum of beta gamma = 1
+        const double sigmaR = 1e-3;
+        const double sigmaP = 1e-3;
+        const double meanPz = 1.0;
+        const double cutoff = 5.0;
+        const double q      = bunch->getChargePerParticle();
+        const double m      = bunch->getMassPerParticle();
+        const bool compact  = pc->hasCompactLayout();
+        Kokkos::parallel_for(
+            "fillSyntheticBunch", numLocal, KOKKOS_LAMBDA(const size_t i) {
+                const uint64_t id = firstId + i;
+
+                Vector_t<double, 3> R, P;
+                for (unsigned int d = 0; d < 3; ++d) {
+                    R[d] = sigmaR
+                           * CounterBasedSampling::truncatedNormal(seed, id, d, -cutoff, cutoff);
+                    P[d] = sigmaP
+                           * CounterBasedSampling::truncatedNormal(
+                               seed, id, 3 + d, -cutoff, cutoff);
+                }
+                P[2] += meanPz;
+
+                Rview(i)   = R;
+                Pview(i)   = P;
+                Eview(i)   = 0.0;
+                Bview(i)   = 0.0;
+                if (!compact) {
+                    Qview(i)  = q;
+                    Mview(i)  = m;
+                    dtview(i) = dt;
+                }
+                Binview(i) = 0;
+                Spview(i)  = 0;
+            });
+        Kokkos::fence();
+
+        bunch->setTotalNum(numParticles);
+        bunch->bunchUpdate();
+
+        return bunch;
+    }
+
+    std::string writeRFFieldMap(const std::string& directory, unsigned int numGridPoints) {
+        const std::string fileName = Util::combineFilePath({directory, "bench_rf.T7"});
+        if (ippl::Comm->rank() == 0) {
+            // a standing wave sin(pi z / L) over L = 30 cm
+            const double length = 30.0;  // [cm]
+            std::ofstream out(fileName);
+            out << "1DDynamic 40\n"
+                << "0.0 " << length << " " << numGridPoints - 1 << "\n"
+                << rfFrequency << "\n"
+                << "0.0 2.0 2\n";
+            out << std::setprecision(12);
+            for (unsigned int i = 0; i < numGridPoints; ++i) {
+                out << std::sin(Physics::pi * i / (numGridPoints - 1)) << "\n";
+            }
+        }
+        ippl::Comm->barrier();
+
+        return fileName;
+    }
+
+    std::string writeSolenoidFieldMap(const std::string& directory, unsigned int numGridPoints) {
+        const std::string fileName = Util::combineFilePath({directory, "bench_solenoid.T7"});
+        if (ippl::Comm->rank() == 0) {
+            // Gaussian profile with a width of 5 cm centered in 40 cm
+            const double length = 40.0;  // [cm]
+            const double width  = 5.0;   // [cm]
+            std::ofstream out(fileName);
+            out << "1DMagnetoStatic 40\n"
+                << "0.0 " << length << " " << numGridPoints - 1 << "\n"
+                << "0.0 2.0 2\n";
+            out << std::setprecision(12);
+            for (unsigned int i = 0; i < numGridPoints; ++i) {
+                const double z = length * i / (numGridPoints - 1) - 0.5 * length;
+                out << std::exp(-z * z / (width * width)) << "\n";
+            }
+        }
+        ippl::Comm->barrier();
+
+        return fileName;
+    }
+}  // namespace SyntheticInput
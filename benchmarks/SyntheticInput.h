@@ -0,0 +1,47 @@
+//
+// Namespace SyntheticInput
+//   Deterministic inputs of the benchmarks: field solvers, bunches and
+//   field maps.
+//
+//   The particles are sampled with counter-based random numbers from the
+//   global particle index, hence the bunch does not depend on the number of
+//   ranks or threads. The field maps are written to a directory and have a
+//   fixed analytic profile.
+//
+// This file is part of OPAL.
+//
+// OPAL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// You should have received a copy of the GNU General Public License
+// along with OPAL. If not, see <https://www.gnu.org/licenses/>.
+//
+#ifndef OPALX_BENCHMARK_SYNTHETIC_INPUT_H
+#define OPALX_BENCHMARK_SYNTHETIC_INPUT_H
+
+#include "OPALTypes.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace SyntheticInput {
+    /// frequency of the RF field map [MHz]
+    constexpr double rfFrequency = 1300.0;
+
+    /// defines a field solver with n^3 cells for every mesh size n
+    void defineFieldSolvers(const std::vector<unsigned int>& meshSizes);
+
+    /// creates a bunch on the mesh of the field solver with meshSize^3 cells
+    std::shared_ptr<PartBunch_t> makeBunch(unsigned int meshSize, size_t numParticles);
+
+    /// writes a 1DDynamic field map of a standing wave cavity, returns the file name
+    std::string writeRFFieldMap(const std::string& directory, unsigned int numGridPoints);
+
+    /// writes a 1DMagnetoStatic field map of a solenoid, returns the file name
+    std::string writeSolenoidFieldMap(const std::string& directory, unsigned int numGridPoints);
+}  // namespace SyntheticInput
+
+#endif
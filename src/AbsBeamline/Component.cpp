@@ -97,6 +97,9 @@ bool Component::apply(
     return false;
 }
 
+void Component::updateTimeDependence(const double& /*t*/) {
+}
+
 bool Component::applyToReferenceParticle(
     const Vector_t<double, 3>& R, const Vector_t<double, 3>& /*P*/, const double& /*t*/,
     Vector_t<double, 3>& /*E*/, Vector_t<double, 3>& /*B*/) {
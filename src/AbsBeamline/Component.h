@@ -107,6 +107,14 @@ public:
         const Vector_t<double, 3>& R, const Vector_t<double, 3>& P, const double& t,
         Vector_t<double, 3>& E, Vector_t<double, 3>& B);
 
+    /** Evaluate the time dependent parameters of the component once for a step
+     *
+     *  Called by the tracker before apply is called for the particles of a step, such
+     *  that the per particle calls only read the parameters evaluated at t.
+     *  \param t time at which the particles are evaluated
+     */
+    virtual void updateTimeDependence(const double& t);
+
     /** Calculate the four-potential at some position relative to the component
      *
      *  \param R position in the local coordinate system of the component
@@ -63,18 +63,21 @@ void Monitor::accept(BeamlineVisitor& visitor) const {
 
 bool Monitor::apply(
     const size_t& i, const double& t, Vector_t<double, 3>& /*E*/, Vector_t<double, 3>& /*B*/) {
-    const Vector_t<double, 3>& R         = RefPartBunch_m->R[i];
-    const Vector_t<double, 3>& P         = RefPartBunch_m->P[i];
-    const double& dt                     = RefPartBunch_m->dt[i];
+    std::shared_ptr<ParticleContainer_t> pc = RefPartBunch_m->getParticleContainer();
+
+    const Vector_t<double, 3> R          = pc->R.getView()(i);
+    const Vector_t<double, 3> P          = pc->P.getView()(i);
+    const double dt                      = RefPartBunch_m->getdT();
     const Vector_t<double, 3> singleStep = Physics::c * dt * Util::getBeta(P);
     if (online_m && type_m == CollectionType::SPATIAL) {
         if (dt * R(2) < 0.0 && dt * (R(2) + singleStep(2)) > 0.0) {
             // if R(2) is negative then frac should be positive and vice versa
             double frac = -R(2) / singleStep(2);
 
+            // the charge and the mass come from the species table in the compact layout
             lossDs_m->addParticle(OpalParticle(
-                RefPartBunch_m->ID[i], R + frac * singleStep, P, t + frac * dt,
-                RefPartBunch_m->Q[i], RefPartBunch_m->M[i]));
+                pc->ID.getView()(i), R + frac * singleStep, P, t + frac * dt,
+                pc->getCharges()(i), pc->getMasses()(i)));
         }
     }
 
@@ -172,6 +175,9 @@ void Monitor::initialise(PartBunch_t* bunch, double& startField, double& endFiel
 }
 
 void Monitor::finalise() {
+    if (lossDs_m) {
+        lossDs_m->close();
+    }
 }
 
 void Monitor::goOnline(const double&) {
@@ -210,7 +216,7 @@ void Monitor::writeStatistics() {
         OpalData::getInstance()->getInputBasename() + std::string("_Monitors.stat");
     auto instance      = OpalData::getInstance();
     bool hasPriorTrack = instance->hasPriorTrack();
-    bool inRestartRun  = instance->inRestartRun();
+    bool inRestartRun  = instance->inRestartRun() || instance->inCheckpointRestart();
 
     auto it     = statFileEntries_sm.begin();
     double spos = it->first;
@@ -61,8 +61,11 @@ void PluginElement::finalise() {
 }
 
 void PluginElement::goOffline() {
-    if (online_m && lossDs_m)
-        lossDs_m->save();
+    if (lossDs_m) {
+        if (online_m)
+            lossDs_m->save();
+        lossDs_m->close();
+    }
     lossDs_m.reset(nullptr);
     doGoOffline();
     online_m = false;
@@ -122,66 +125,18 @@ void PluginElement::setDimensions(double xstart, double xend, double ystart, dou
 }
 
 void PluginElement::setGeom(const double dist) {
-    double slope;
-    if (xend_m == xstart_m)
-        slope = 1.0e12;
-    else
-        slope = (yend_m - ystart_m) / (xend_m - xstart_m);
-
-    double coeff2   = std::sqrt(1 + slope * slope);
-    double coeff1   = slope / coeff2;
-    double halfdist = dist / 2.0;
-    geom_m[0].x     = xstart_m - halfdist * coeff1;
-    geom_m[0].y     = ystart_m + halfdist / coeff2;
-
-    geom_m[1].x = xstart_m + halfdist * coeff1;
-    geom_m[1].y = ystart_m - halfdist / coeff2;
-
-    geom_m[2].x = xend_m + halfdist * coeff1;
-    geom_m[2].y = yend_m - halfdist / coeff2;
-
-    geom_m[3].x = xend_m - halfdist * coeff1;
-    geom_m[3].y = yend_m + halfdist / coeff2;
-
-    geom_m[4].x = geom_m[0].x;
-    geom_m[4].y = geom_m[0].y;
+    getDeviceGeometry().computeGeom(dist, geom_m);
 
     doSetGeom();
 }
 
 void PluginElement::changeWidth(
     PartBunch_t* bunch, int i, const double tstep, const double tangle) {
-    constexpr double c_mtns = Physics::c / Units::s2ns;  // m/s --> m/ns
-
-    const double tmp = std::sqrt(dot(bunch->P(i), bunch->P(i)));
-    double lstep     = tmp / Util::getGamma(bunch->P(i)) * c_mtns * tstep;  // [m]
-    double sWidth    = lstep / std::sqrt(1 + 1 / tangle / tangle);
-    setGeom(sWidth);
+    setGeom(getDeviceGeometry().width(bunch->P(i), tstep, tangle));
 }
 
 double PluginElement::calculateIncidentAngle(double xp, double yp) const {
-    double k1, k2, tangle = 0.0;
-    if (B_m == 0.0 && xp == 0.0) {
-        // width is 0.0, keep non-zero
-        tangle = 0.1;
-    } else if (B_m == 0.0) {
-        k1 = yp / xp;
-        if (k1 == 0.0)
-            tangle = 1.0e12;
-        else
-            tangle = std::abs(1 / k1);
-    } else if (xp == 0.0) {
-        k2 = -A_m / B_m;
-        if (k2 == 0.0)
-            tangle = 1.0e12;
-        else
-            tangle = std::abs(1 / k2);
-    } else {
-        k1     = yp / xp;
-        k2     = -A_m / B_m;
-        tangle = std::abs((k1 - k2) / (1 + k1 * k2));
-    }
-    return tangle;
+    return getDeviceGeometry().incidentAngle(xp, yp);
 }
 
 double PluginElement::getXStart() const {
@@ -200,6 +155,10 @@ double PluginElement::getYEnd() const {
     return yend_m;
 }
 
+PluginElement::DeviceGeometry PluginElement::getDeviceGeometry() const {
+    return DeviceGeometry{xstart_m, xend_m, ystart_m, yend_m, A_m, B_m, R_m, C_m};
+}
+
 bool PluginElement::check(
     PartBunch_t* bunch, const int turnnumber, const double t, const double tstep) {
     bool flag = false;
@@ -221,16 +180,7 @@ void PluginElement::getDimensions(double& zBegin, double& zEnd) const {
 }
 
 int PluginElement::checkPoint(const double& x, const double& y) const {
-    int cn = 0;
-    for (int i = 0; i < 4; i++) {
-        if (((geom_m[i].y <= y) && (geom_m[i + 1].y > y))
-            || ((geom_m[i].y > y) && (geom_m[i + 1].y <= y))) {
-            float vt = (float)(y - geom_m[i].y) / (geom_m[i + 1].y - geom_m[i].y);
-            if (x < geom_m[i].x + vt * (geom_m[i + 1].x - geom_m[i].x))
-                ++cn;
-        }
-    }
-    return (cn & 1);  // 0 if even (out), and 1 if odd (in)
+    return DeviceGeometry::checkPoint(geom_m, x, y);
 }
 
 void PluginElement::save() {
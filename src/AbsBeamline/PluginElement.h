@@ -22,10 +22,39 @@
 #include <memory>
 #include <string>
 #include "AbsBeamline/Component.h"
+#include "Physics/Physics.h"
+#include "Physics/Units.h"
 
 class LossDataSink;
 class PluginElement : public Component {
 public:
+    /// Copy of the geometry that can be captured by value in Kokkos kernels
+    struct DeviceGeometry {
+        double xstart, xend, ystart, yend;
+        double A, B, R, C;
+
+        /// see calculateIncidentAngle
+        KOKKOS_INLINE_FUNCTION double incidentAngle(double xp, double yp) const;
+
+        /// see changeWidth, the width for a particle with momentum P and a step tstep [ns]
+        KOKKOS_INLINE_FUNCTION double width(
+            const Vector_t<double, 3>& P, double tstep, double tangle) const;
+
+        /// the corners of the element with width dist, see setGeom
+        KOKKOS_INLINE_FUNCTION void computeGeom(double dist, Point* geom) const;
+
+        /// see checkPoint, 1 if (x, y) is inside the polygon geom, else 0
+        KOKKOS_INLINE_FUNCTION static int checkPoint(const Point* geom, double x, double y);
+
+        /// whether (x, y) is inside the element with width dist
+        KOKKOS_INLINE_FUNCTION bool isInside(double x, double y, double dist) const {
+            Point geom[5];
+            computeGeom(dist, geom);
+            return checkPoint(geom, x, y) == 1;
+        }
+    };
+
+
     /// Constructor with given name.
     explicit PluginElement(const std::string& name);
 
@@ -65,6 +94,7 @@ public:
     double getXEnd() const;
     double getYStart() const;
     double getYEnd() const;
+    DeviceGeometry getDeviceGeometry() const;
     ///@}
     /// Check if bunch particles are lost
     bool check(PartBunch_t* bunch, const int turnnumber, const double t, const double tstep);
@@ -130,4 +160,80 @@ protected:
     int numPassages_m = 0;  ///< Number of turns (number of times save() method is called)
 };
 
+KOKKOS_INLINE_FUNCTION double PluginElement::DeviceGeometry::incidentAngle(
+    double xp, double yp) const {
+    double k1, k2, tangle = 0.0;
+    if (B == 0.0 && xp == 0.0) {
+        // width is 0.0, keep non-zero
+        tangle = 0.1;
+    } else if (B == 0.0) {
+        k1 = yp / xp;
+        if (k1 == 0.0)
+            tangle = 1.0e12;
+        else
+            tangle = Kokkos::abs(1 / k1);
+    } else if (xp == 0.0) {
+        k2 = -A / B;
+        if (k2 == 0.0)
+            tangle = 1.0e12;
+        else
+            tangle = Kokkos::abs(1 / k2);
+    } else {
+        k1     = yp / xp;
+        k2     = -A / B;
+        tangle = Kokkos::abs((k1 - k2) / (1 + k1 * k2));
+    }
+    return tangle;
+}
+
+KOKKOS_INLINE_FUNCTION double PluginElement::DeviceGeometry::width(
+    const Vector_t<double, 3>& P, double tstep, double tangle) const {
+    constexpr double c_mtns = Physics::c / Units::s2ns;  // m/s --> m/ns
+
+    const double tmp   = Kokkos::sqrt(dot(P, P));
+    const double lstep = tmp / Kokkos::sqrt(1.0 + dot(P, P)) * c_mtns * tstep;  // [m]
+    return lstep / Kokkos::sqrt(1 + 1 / tangle / tangle);
+}
+
+KOKKOS_INLINE_FUNCTION void PluginElement::DeviceGeometry::computeGeom(
+    double dist, Point* geom) const {
+    double slope;
+    if (xend == xstart)
+        slope = 1.0e12;
+    else
+        slope = (yend - ystart) / (xend - xstart);
+
+    double coeff2   = Kokkos::sqrt(1 + slope * slope);
+    double coeff1   = slope / coeff2;
+    double halfdist = dist / 2.0;
+    geom[0].x       = xstart - halfdist * coeff1;
+    geom[0].y       = ystart + halfdist / coeff2;
+
+    geom[1].x = xstart + halfdist * coeff1;
+    geom[1].y = ystart - halfdist / coeff2;
+
+    geom[2].x = xend + halfdist * coeff1;
+    geom[2].y = yend - halfdist / coeff2;
+
+    geom[3].x = xend - halfdist * coeff1;
+    geom[3].y = yend + halfdist / coeff2;
+
+    geom[4].x = geom[0].x;
+    geom[4].y = geom[0].y;
+}
+
+KOKKOS_INLINE_FUNCTION int PluginElement::DeviceGeometry::checkPoint(
+    const Point* geom, double x, double y) {
+    int cn = 0;
+    for (int i = 0; i < 4; i++) {
+        if (((geom[i].y <= y) && (geom[i + 1].y > y))
+            || ((geom[i].y > y) && (geom[i + 1].y <= y))) {
+            float vt = (float)(y - geom[i].y) / (geom[i + 1].y - geom[i].y);
+            if (x < geom[i].x + vt * (geom[i + 1].x - geom[i].x))
+                ++cn;
+        }
+    }
+    return (cn & 1);  // 0 if even (out), and 1 if odd (in)
+}
+
 #endif  // CLASSIC_PluginElement_HH
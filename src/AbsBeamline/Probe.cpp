@@ -23,6 +23,12 @@
 #include "Structure/LossDataSink.h"
 #include "Structure/PeakFinder.h"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+
 extern Inform* gmsg;
 
 Probe::Probe() : Probe("") {
@@ -65,11 +71,27 @@ double Probe::getStep() const {
 bool Probe::doPreCheck(PartBunch_t* bunch) {
     Vector_t<double, 3> rmin, rmax;
     bunch->get_bounds(rmin, rmax);
+
+    // the probe is given in the lab frame, take the bounds of the corners of the bunch in it
+    Vector_t<double, 3> labMin(std::numeric_limits<double>::max());
+    Vector_t<double, 3> labMax(std::numeric_limits<double>::lowest());
+    for (unsigned int corner = 0; corner < 8; ++corner) {
+        Vector_t<double, 3> r;
+        for (unsigned int d = 0; d < 3; ++d) {
+            r(d) = (corner & (1u << d)) ? rmax(d) : rmin(d);
+        }
+        r = bunch->toLabTrafo_m.transformFrom(r);
+        for (unsigned int d = 0; d < 3; ++d) {
+            labMin(d) = std::min(labMin(d), r(d));
+            labMax(d) = std::max(labMax(d), r(d));
+        }
+    }
+
     // interested in absolute minimum and maximum
-    double xmin       = std::min(std::abs(rmin(0)), std::abs(rmax(0)));
-    double xmax       = std::max(std::abs(rmin(0)), std::abs(rmax(0)));
-    double ymin       = std::min(std::abs(rmin(1)), std::abs(rmax(1)));
-    double ymax       = std::max(std::abs(rmin(1)), std::abs(rmax(1)));
+    double xmin       = std::min(std::abs(labMin(0)), std::abs(labMax(0)));
+    double xmax       = std::max(std::abs(labMin(0)), std::abs(labMax(0)));
+    double ymin       = std::min(std::abs(labMin(1)), std::abs(labMax(1)));
+    double ymax       = std::max(std::abs(labMin(1)), std::abs(labMax(1)));
     double rbunch_min = std::hypot(xmin, ymin);
     double rbunch_max = std::hypot(xmax, ymax);
 
@@ -80,39 +102,82 @@ bool Probe::doPreCheck(PartBunch_t* bunch) {
 }
 
 bool Probe::doCheck(PartBunch_t* bunch, const int turnnumber, const double t, const double tstep) {
-    Vector_t<double, 3> probepoint;
-    size_t tempnum = bunch->getLocalNum();
-
-    for (unsigned int i = 0; i < tempnum; ++i) {
-        double tangle = calculateIncidentAngle(bunch->P(i)(0), bunch->P(i)(1));
-        changeWidth(bunch, i, tstep, tangle);
-        int pflag = checkPoint(bunch->R(i)(0), bunch->R(i)(1));
-        if (pflag == 0)
-            continue;
-        // calculate closest point at probe -> better to use momentum direction
-        // probe: y = -A/B * x - C/B or A*X + B*Y + C = 0
-        // perpendicular line through R: y = B/A * x + R(1) - B/A * R(0)
-        // probepoint(0) = (B_m*B_m*bunch->R(i)(0) - A_m*B_m*bunch->R(i)(1) - A_m*C_m) / (R_m*R_m);
-        // probepoint(1) = (A_m*A_m*bunch->R(i)(1) - A_m*B_m*bunch->R(i)(0) - B_m*C_m) / (R_m*R_m);
-        // probepoint(2) = bunch->R(i)(2);
-        // calculate time correction for probepoint
-        // dist1 > 0, right hand, dt > 0; dist1 < 0, left hand, dt < 0
-        double dist1 = (A_m * bunch->R(i)(0) + B_m * bunch->R(i)(1) + C_m) / R_m;  // [m]
-        double dist2 = dist1 * std::sqrt(1.0 + 1.0 / tangle / tangle);
-        //double dt =
-        //  dist2 / (std::sqrt(1.0 - 1.0 / (1.0 + dot(bunch->P(i), bunch->P(i)))) * Physics::c);
-
-        // ADA probepoint = bunch->R(i) + dist2 * bunch->P(i) / euclidean_norm(bunch->P(i));
-        probepoint = bunch->R(i) + dist2 * bunch->P(i) / std::sqrt(dot(bunch->P(i), bunch->P(i)));
-
-        // peak finder uses millimetre not metre
-        peakfinder_m->addParticle(probepoint * Units::m2mm);
-
-        // ADA lossDs_m->addParticle(
-        //    OpalParticle(bunch->ID(i), probepoint, bunch->P(i), t + dt, bunch->Q(i), bunch->M(i)),
-        //    std::make_pair(turnnumber, (int)
-        //
-        // 3bunch->bunchNum(i)));
+    auto pc          = bunch->getParticleContainer();
+    const size_t n   = pc->getLocalNum();
+    auto Rview       = pc->R.getView();
+    auto Pview       = pc->P.getView();
+    auto IDview      = pc->ID.getView();
+    auto Qview       = pc->getCharges();
+    auto Mview       = pc->getMasses();
+    const auto geom  = getDeviceGeometry();
+    const auto toLab = DeviceCoordinateSystemTrafo(bunch->toLabTrafo_m);
+
+    // the buffers only grow if there are more local particles than ever before
+    if (hitData_m.extent(0) < n) {
+        Kokkos::realloc(Kokkos::WithoutInitializing, hitData_m, n + n / 4);
+        Kokkos::realloc(Kokkos::WithoutInitializing, hitID_m, n + n / 4);
+    }
+    auto hitData = hitData_m;
+    auto hitID   = hitID_m;
+
+    // the width of the probe depends on the step and the angle of each particle s.t. every
+    // particle hits it once per passage, the hits are compacted into the buffers
+    size_t numHits = 0;
+    Kokkos::parallel_scan(
+        "Probe::doCheck", n,
+        KOKKOS_LAMBDA(const size_t i, size_t& hit, const bool final) {
+            const Vector_t<double, 3> R = toLab.transformFrom(Rview(i));
+            const Vector_t<double, 3> P = toLab.rotateFrom(Pview(i));
+
+            const double tangle = geom.incidentAngle(P(0), P(1));
+            if (!geom.isInside(R(0), R(1), geom.width(P, tstep, tangle))) {
+                return;
+            }
+
+            if (final) {
+                // calculate closest point at probe -> better to use momentum direction
+                // dist1 > 0, right hand, dt > 0; dist1 < 0, left hand, dt < 0
+                const double dist1 = (geom.A * R(0) + geom.B * R(1) + geom.C) / geom.R;  // [m]
+                const double dist2 = dist1 * Kokkos::sqrt(1.0 + 1.0 / tangle / tangle);
+                const double pnorm = Kokkos::sqrt(dot(P, P));
+                const double dt =
+                    dist2 / (pnorm / Kokkos::sqrt(1.0 + pnorm * pnorm) * Physics::c);  // [s]
+
+                const Vector_t<double, 3> probepoint = R + dist2 * P / pnorm;
+                for (unsigned int d = 0; d < 3; ++d) {
+                    hitData(hit, d)     = probepoint(d);
+                    hitData(hit, d + 3) = P(d);
+                }
+                hitData(hit, 6) = t + dt;
+                hitData(hit, 7) = Qview(i);
+                hitData(hit, 8) = Mview(i);
+                hitID(hit)      = IDview(i);
+            }
+            ++hit;
+        },
+        numHits);
+
+    if (numHits > 0) {
+        const auto range = std::make_pair(size_t(0), numHits);
+        auto hostData    = Kokkos::create_mirror_view_and_copy(
+            Kokkos::HostSpace(), Kokkos::subview(hitData, range, Kokkos::ALL));
+        auto hostID = Kokkos::create_mirror_view_and_copy(
+            Kokkos::HostSpace(), Kokkos::subview(hitID, range));
+
+        std::vector<OpalParticle> particles;
+        particles.reserve(numHits);
+        for (size_t h = 0; h < numHits; ++h) {
+            const Vector_t<double, 3> probepoint(hostData(h, 0), hostData(h, 1), hostData(h, 2));
+
+            // peak finder uses millimetre not metre
+            peakfinder_m->addParticle(probepoint * Units::m2mm);
+
+            particles.emplace_back(
+                hostID(h), probepoint,
+                Vector_t<double, 3>(hostData(h, 3), hostData(h, 4), hostData(h, 5)),
+                hostData(h, 6), hostData(h, 7), hostData(h, 8));
+        }
+        lossDs_m->addParticles(std::move(particles));
     }
 
     peakfinder_m->evaluate(turnnumber);
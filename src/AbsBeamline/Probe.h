@@ -58,6 +58,10 @@ private:
 
     double step_m; ///< Step size of the probe (bin width in histogram file)
     std::unique_ptr<PeakFinder> peakfinder_m; ///< Pointer to Peakfinder instance
+
+    /// the hits of a check, probe point, momentum, time, charge and mass, kept between checks
+    Kokkos::View<double* [9]> hitData_m;
+    Kokkos::View<int64_t*> hitID_m;
 };
 
 #endif // CLASSIC_Probe_HH
@@ -62,6 +62,8 @@ RFCavity::RFCavity(const RFCavity& right)
       designEnergy_m(right.designEnergy_m),
       fieldmap_m(right.fieldmap_m),
       startField_m(right.startField_m),
+      timeDependenceStep_m(right.timeDependenceStep_m),
+      timeDependence_m(right.timeDependence_m),
       endField_m(right.endField_m),
       type_m(right.type_m),
       rmin_m(right.rmin_m),
@@ -94,6 +96,8 @@ RFCavity::RFCavity(const std::string& name)
       designEnergy_m(-1.0),
       fieldmap_m(nullptr),
       startField_m(0.0),
+      timeDependenceStep_m(-1),
+      timeDependence_m({1.0, 1.0, 0.0}),
       endField_m(0.0),
       type_m(CavityType::SW),
       rmin_m(0.0),
@@ -139,12 +143,47 @@ bool RFCavity::apply(
         if (outOfBounds)
             return getFlagDeleteOnTransverseExit();
 
-        E += (scale_m + scaleError_m) * std::cos(frequency_m * t + phase_m + phaseError_m) * tmpE;
-        B -= (scale_m + scaleError_m) * std::sin(frequency_m * t + phase_m + phaseError_m) * tmpB;
+        const RFFactors factors = computeRFFactors(
+            getTimeDependence(), scale_m + scaleError_m, phase_m + phaseError_m, t);
+        E += factors.cosine * tmpE;
+        B -= factors.sine * tmpB;
     }
     return false;
 }
 
+/**
+   The models of the frequency and the amplitude scale the frequency and the
+   amplitude, the model of the phase is added to the phase. The models are
+   evaluated once per track step, at the time t of the tracker, and are kept
+   for all particles and all stages of the step. The models are not evaluated
+   per particle, applying the field in a step without update is an error.
+ */
+void RFCavity::updateTimeDependence(const double& t) {
+    timeDependence_m     = evaluateTimeDependence(t);
+    timeDependenceStep_m = RefPartBunch_m != nullptr ? RefPartBunch_m->getGlobalTrackStep() : -1;
+}
+
+RFCavity::TimeDependence RFCavity::evaluateTimeDependence(const double& t) const {
+    return {frequencyTD_m ? frequencyTD_m->getValue(t) : 1.0,
+            amplitudeTD_m ? amplitudeTD_m->getValue(t) : 1.0,
+            phaseTD_m ? phaseTD_m->getValue(t) : 0.0};
+}
+
+RFCavity::TimeDependence RFCavity::getTimeDependence() const {
+    if (!frequencyTD_m && !amplitudeTD_m && !phaseTD_m) {
+        return {1.0, 1.0, 0.0};
+    }
+
+    if (RefPartBunch_m == nullptr || timeDependenceStep_m < 0
+        || RefPartBunch_m->getGlobalTrackStep() != timeDependenceStep_m) {
+        throw GeneralClassicException(
+            "RFCavity::getTimeDependence",
+            "The time dependence models of '" + getName()
+                + "' weren't updated in the current track step");
+    }
+    return timeDependence_m;
+}
+
 bool RFCavity::applyToReferenceParticle(
     const Vector_t<double, 3>& R, const Vector_t<double, 3>& /*P*/, const double& t,
     Vector_t<double, 3>& E, Vector_t<double, 3>& B) {
@@ -155,8 +194,10 @@ bool RFCavity::applyToReferenceParticle(
         if (outOfBounds)
             return true;
 
-        E += scale_m * std::cos(frequency_m * t + phase_m) * tmpE;
-        B -= scale_m * std::sin(frequency_m * t + phase_m) * tmpB;
+        // the reference particle runs ahead of the bunch, hence the models are evaluated at t
+        const RFFactors factors = computeRFFactors(evaluateTimeDependence(t), scale_m, phase_m, t);
+        E += factors.cosine * tmpE;
+        B -= factors.sine * tmpB;
     }
     return false;
 }
@@ -104,6 +104,8 @@ public:
         const Vector_t<double, 3>& R, const Vector_t<double, 3>& P, const double& t,
         Vector_t<double, 3>& E, Vector_t<double, 3>& B) override;
 
+    virtual void updateTimeDependence(const double& t) override;
+
     virtual void initialise(PartBunch_t* bunch, double& startField, double& endField) override;
 
     virtual void initialise(
@@ -177,6 +179,27 @@ public:
     virtual CoordinateSystemTrafo getEdgeToEnd() const override;
 
 protected:
+    struct RFFactors {
+        double cosine; /**< scale * cos(frequency * t + phase)*/
+        double sine;   /**< scale * sin(frequency * t + phase)*/
+    };
+
+    /// the values of the frequency, amplitude and phase models at some time
+    struct TimeDependence {
+        double frequencyFactor;
+        double amplitudeFactor;
+        double phaseOffset;
+    };
+
+    /// the models evaluated at t
+    TimeDependence evaluateTimeDependence(const double& t) const;
+
+    /// the models of updateTimeDependence, throws if it wasn't called in the current track step
+    TimeDependence getTimeDependence() const;
+
+    RFFactors computeRFFactors(
+        const TimeDependence& timeDependence, double scale, double phase, const double& t) const;
+
     std::shared_ptr<AbstractTimeDependence> phaseTD_m;
     std::string phaseName_m;
     std::shared_ptr<AbstractTimeDependence> amplitudeTD_m;
@@ -200,6 +223,10 @@ protected:
     Fieldmap* fieldmap_m;
     double startField_m; /**< starting point of field(m)*/
 
+    /// the models evaluated by updateTimeDependence in the global track step timeDependenceStep_m
+    long long timeDependenceStep_m;
+    TimeDependence timeDependence_m;
+
 private:
     double endField_m;
 
@@ -381,6 +408,14 @@ inline bool RFCavity::getAutophaseVeto() const {
     return autophaseVeto_m;
 }
 
+inline RFCavity::RFFactors RFCavity::computeRFFactors(
+    const TimeDependence& timeDependence, double scale, double phase, const double& t) const {
+    const double arg =
+        frequency_m * timeDependence.frequencyFactor * t + phase + timeDependence.phaseOffset;
+    const double amplitude = scale * timeDependence.amplitudeFactor;
+    return {amplitude * std::cos(arg), amplitude * std::sin(arg)};
+}
+
 inline void RFCavity::setAmplitudeModel(std::shared_ptr<AbstractTimeDependence> amplitudeTD) {
     amplitudeTD_m = amplitudeTD;
 }
@@ -119,8 +119,8 @@ bool Ring::apply(
     if (flagNeedUpdate) {
         Inform gmsgALL("OPAL ", INFORM_ALL_NODES);
 
-        auto Qview   = pc->Q.getView();
-        auto Mview   = pc->M.getView();
+        auto Qview   = pc->getCharges();
+        auto Mview   = pc->getMasses();
         auto Binview = pc->Bin.getView();
 
         const double Q      = Qview(id);
@@ -189,6 +189,7 @@ void Ring::initialise(PartBunch_t* bunch, double& /*startField*/, double& /*endF
 
 void Ring::finalise() {
     lossDS_m->save();
+    lossDS_m->close();
     online_m = false;
     setLossDataSink(nullptr);
 }
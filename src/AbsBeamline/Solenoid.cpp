@@ -67,6 +67,10 @@ void Solenoid::setFieldMapFN(std::string fn) {
     filename_m = fn;
 }
 
+std::string Solenoid::getFieldMapFN() const {
+    return filename_m;
+}
+
 void Solenoid::setFast(bool fast) {
     fast_m = fast;
 }
@@ -73,6 +73,8 @@ public:
     //  Assign the field filename.
     void setFieldMapFN(std::string fn);
 
+    std::string getFieldMapFN() const;
+
     void setFast(bool fast);
 
     bool getFast() const;
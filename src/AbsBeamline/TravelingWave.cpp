@@ -84,15 +84,16 @@ bool TravelingWave::apply(
         return false;
 
     Vector_t<double, 3> tmpR = Vector_t<double, 3>({R(0), R(1), R(2) + 0.5 * periodLength_m});
-    double tmpcos, tmpsin;
+    const TimeDependence timeDependence = getTimeDependence();
+    RFFactors factors;
     Vector_t<double, 3> tmpE({0.0, 0.0, 0.0}), tmpB({0.0, 0.0, 0.0});
 
     if (tmpR(2) < startCoreField_m) {
         if (!fieldmap_m->isInside(tmpR))
             return getFlagDeleteOnTransverseExit();
 
-        tmpcos = (scale_m + scaleError_m) * std::cos(frequency_m * t + phase_m + phaseError_m);
-        tmpsin = -(scale_m + scaleError_m) * std::sin(frequency_m * t + phase_m + phaseError_m);
+        factors = computeRFFactors(
+            timeDependence, scale_m + scaleError_m, phase_m + phaseError_m, t);
 
     } else if (tmpR(2) < startExitField_m) {
         Vector_t<double, 3> tmpE2({0.0, 0.0, 0.0}), tmpB2({0.0, 0.0, 0.0});
@@ -103,13 +104,11 @@ bool TravelingWave::apply(
         if (!fieldmap_m->isInside(tmpR))
             return getFlagDeleteOnTransverseExit();
 
-        tmpcos = (scaleCore_m + scaleCoreError_m)
-                 * std::cos(frequency_m * t + phaseCore1_m + phaseError_m);
-        tmpsin = -(scaleCore_m + scaleCoreError_m)
-                 * std::sin(frequency_m * t + phaseCore1_m + phaseError_m);
+        factors = computeRFFactors(
+            timeDependence, scaleCore_m + scaleCoreError_m, phaseCore1_m + phaseError_m, t);
         fieldmap_m->getFieldstrength(tmpR, tmpE, tmpB);
-        E += tmpcos * tmpE;
-        B += tmpsin * tmpB;
+        E += factors.cosine * tmpE;
+        B -= factors.sine * tmpB;
 
         tmpE = 0.0;
         tmpB = 0.0;
@@ -118,23 +117,21 @@ bool TravelingWave::apply(
         tmpR(2) = tmpR(2) - periodLength_m * std::floor(tmpR(2) / periodLength_m);
         tmpR(2) += startCoreField_m;
 
-        tmpcos = (scaleCore_m + scaleCoreError_m)
-                 * std::cos(frequency_m * t + phaseCore2_m + phaseError_m);
-        tmpsin = -(scaleCore_m + scaleCoreError_m)
-                 * std::sin(frequency_m * t + phaseCore2_m + phaseError_m);
+        factors = computeRFFactors(
+            timeDependence, scaleCore_m + scaleCoreError_m, phaseCore2_m + phaseError_m, t);
 
     } else {
         tmpR(2) -= mappedStartExitField_m;
         if (!fieldmap_m->isInside(tmpR))
             return getFlagDeleteOnTransverseExit();
-        tmpcos = (scale_m + scaleError_m) * std::cos(frequency_m * t + phaseExit_m + phaseError_m);
-        tmpsin = -(scale_m + scaleError_m) * std::sin(frequency_m * t + phaseExit_m + phaseError_m);
+        factors = computeRFFactors(
+            timeDependence, scale_m + scaleError_m, phaseExit_m + phaseError_m, t);
     }
 
     fieldmap_m->getFieldstrength(tmpR, tmpE, tmpB);
 
-    E += tmpcos * tmpE;
-    B += tmpsin * tmpB;
+    E += factors.cosine * tmpE;
+    B -= factors.sine * tmpB;
 
     return false;
 }
@@ -146,14 +143,15 @@ bool TravelingWave::applyToReferenceParticle(
         return false;
 
     Vector_t<double, 3> tmpR = Vector_t<double, 3>({R(0), R(1), R(2) + 0.5 * periodLength_m});
-    double tmpcos, tmpsin;
+    // the reference particle runs ahead of the bunch, hence the models are evaluated at t
+    const TimeDependence timeDependence = evaluateTimeDependence(t);
+    RFFactors factors;
     Vector_t<double, 3> tmpE({0.0, 0.0, 0.0}), tmpB({0.0, 0.0, 0.0});
 
     if (tmpR(2) < startCoreField_m) {
         if (!fieldmap_m->isInside(tmpR))
             return true;
-        tmpcos = scale_m * std::cos(frequency_m * t + phase_m);
-        tmpsin = -scale_m * std::sin(frequency_m * t + phase_m);
+        factors = computeRFFactors(timeDependence, scale_m, phase_m, t);
 
     } else if (tmpR(2) < startExitField_m) {
         Vector_t<double, 3> tmpE2({0.0, 0.0, 0.0}), tmpB2({0.0, 0.0, 0.0});
@@ -164,11 +162,10 @@ bool TravelingWave::applyToReferenceParticle(
         if (!fieldmap_m->isInside(tmpR))
             return true;
 
-        tmpcos = scaleCore_m * std::cos(frequency_m * t + phaseCore1_m);
-        tmpsin = -scaleCore_m * std::sin(frequency_m * t + phaseCore1_m);
+        factors = computeRFFactors(timeDependence, scaleCore_m, phaseCore1_m, t);
         fieldmap_m->getFieldstrength(tmpR, tmpE, tmpB);
-        E += tmpcos * tmpE;
-        B += tmpsin * tmpB;
+        E += factors.cosine * tmpE;
+        B -= factors.sine * tmpB;
 
         tmpE = 0.0;
         tmpB = 0.0;
@@ -177,21 +174,19 @@ bool TravelingWave::applyToReferenceParticle(
         tmpR(2) = tmpR(2) - periodLength_m * std::floor(tmpR(2) / periodLength_m);
         tmpR(2) += startCoreField_m;
 
-        tmpcos = scaleCore_m * std::cos(frequency_m * t + phaseCore2_m);
-        tmpsin = -scaleCore_m * std::sin(frequency_m * t + phaseCore2_m);
+        factors = computeRFFactors(timeDependence, scaleCore_m, phaseCore2_m, t);
 
     } else {
         tmpR(2) -= mappedStartExitField_m;
         if (!fieldmap_m->isInside(tmpR))
             return true;
 
-        tmpcos = scale_m * std::cos(frequency_m * t + phaseExit_m);
-        tmpsin = -scale_m * std::sin(frequency_m * t + phaseExit_m);
+        factors = computeRFFactors(timeDependence, scale_m, phaseExit_m, t);
     }
 
     fieldmap_m->getFieldstrength(tmpR, tmpE, tmpB);
-    E += tmpcos * tmpE;
-    B += tmpsin * tmpB;
+    E += factors.cosine * tmpE;
+    B -= factors.sine * tmpB;
 
     return false;
 }
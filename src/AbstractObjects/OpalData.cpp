@@ -96,6 +96,9 @@ struct OpalDataImpl {
     // dump frequency as found in restart file
     int restart_dump_freq_m;
 
+    // directory of the checkpoint to restart from, empty if none
+    std::string checkpointRestartDir_m;
+
     // Input file name
     std::string inputFn_m;
 
@@ -155,6 +158,7 @@ OpalDataImpl::OpalDataImpl()
       restartStep_m(0),
       hasRestartFile_m(false),
       restart_dump_freq_m(1),
+      checkpointRestartDir_m(),
       last_step_m(0),
       hasBunchAllocated_m(false),
       hasDataSinkAllocated_m(false),
@@ -345,6 +349,18 @@ int OpalData::getRestartDumpFreq() const {
     return p->restart_dump_freq_m;
 }
 
+bool OpalData::inCheckpointRestart() const {
+    return !p->checkpointRestartDir_m.empty();
+}
+
+void OpalData::setCheckpointRestartDir(const std::string& dir) {
+    p->checkpointRestartDir_m = dir;
+}
+
+std::string OpalData::getCheckpointRestartDir() const {
+    return p->checkpointRestartDir_m;
+}
+
 void OpalData::setOpenMode(OpenMode openMode) {
     p->openMode_m = openMode;
 }
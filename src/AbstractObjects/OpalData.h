@@ -199,6 +199,15 @@ public:
     /// get the dump frequency as found in restart file
     int getRestartDumpFreq() const;
 
+    /// true if we restart from a checkpoint (see CHECKPOINTFREQ)
+    bool inCheckpointRestart() const;
+
+    /// store the checkpoint directory to restart from
+    void setCheckpointRestartDir(const std::string& dir);
+
+    /// get the checkpoint directory to restart from
+    std::string getCheckpointRestartDir() const;
+
     void setOpenMode(OpenMode openMode);
     OpenMode getOpenMode() const;
 
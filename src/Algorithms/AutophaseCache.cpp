@@ -0,0 +1,99 @@
+//
+// Class AutophaseCache
+//   Stores the phases found by the CavityAutophaser in a file, such that runs
+//   with identical cavities and identical entry conditions of the reference
+//   particle can skip the phase search.
+//
+// This file is part of OPAL.
+//
+// OPAL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// You should have received a copy of the GNU General Public License
+// along with OPAL. If not, see <https://www.gnu.org/licenses/>.
+//
+#include "Algorithms/AutophaseCache.h"
+
+#include "Ippl.h"
+
+#include "AbsBeamline/RFCavity.h"
+#include "Algorithms/PartData.h"
+#include "Physics/Physics.h"
+#include "Utilities/Options.h"
+#include "Utilities/Util.h"
+
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+AutophaseCache::AutophaseCache(const std::string& fileName) : fileName_m(fileName) {
+}
+
+std::string AutophaseCache::makeKey(
+    const RFCavity& cavity, const PartData& reference, double entryEnergy, double entryTime,
+    double dt) const {
+    // the key is only compared and written on rank 0
+    const std::uint64_t fieldMapHash =
+        ippl::Comm->rank() == 0 ? Util::hashFile(cavity.getFieldMapFN()) : 0;
+
+    std::ostringstream key;
+    key << std::setprecision(17);
+    key << cavity.getName() << " " << std::hex << fieldMapHash << std::dec
+        << " " << cavity.getAmplitudem() << " " << cavity.getDesignEnergy() << " "
+        << cavity.getFrequencym() << " " << entryEnergy << " "
+        << std::fmod(cavity.getFrequencym() * entryTime, Physics::two_pi) << " " << dt << " "
+        << reference.getQ() << " " << reference.getM() << " " << Options::autoPhase;
+
+    return key.str();
+}
+
+bool AutophaseCache::lookup(const std::string& key, Entry& entry) const {
+    double data[] = {0.0, 0.0, 0.0, 0.0};  // found, phase, energy, amplitude
+
+    if (ippl::Comm->rank() == 0) {
+        std::ifstream in(fileName_m);
+        std::string line;
+        while (std::getline(in, line)) {
+            if (line.compare(0, key.size(), key) != 0 || line.size() <= key.size()
+                || line[key.size()] != ' ') {
+                continue;
+            }
+            std::istringstream values(line.substr(key.size()));
+            Entry candidate;
+            if (values >> candidate.phase >> candidate.energy >> candidate.amplitude) {
+                data[0] = 1.0;
+                data[1] = candidate.phase;
+                data[2] = candidate.energy;
+                data[3] = candidate.amplitude;
+            }
+        }
+    }
+
+    MPI_Bcast(data, 4, MPI_DOUBLE, 0, ippl::Comm->getCommunicator());
+
+    if (data[0] == 0.0) {
+        return false;
+    }
+
+    entry.phase     = data[1];
+    entry.energy    = data[2];
+    entry.amplitude = data[3];
+    return true;
+}
+
+void AutophaseCache::store(const std::string& key, const Entry& entry) const {
+    if (ippl::Comm->rank() != 0) {
+        return;
+    }
+
+    // one write per line such that concurrent runs don't interleave their entries
+    std::ostringstream line;
+    line << std::setprecision(17) << key << " " << entry.phase << " " << entry.energy << " "
+         << entry.amplitude << "\n";
+
+    std::ofstream out(fileName_m, std::ios::app);
+    out << line.str() << std::flush;
+}
@@ -0,0 +1,63 @@
+//
+// Class AutophaseCache
+//   Stores the phases found by the CavityAutophaser in a file, such that runs
+//   with identical cavities and identical entry conditions of the reference
+//   particle can skip the phase search.
+//
+//   Every line of the file holds one entry: the key (cavity name, hash of the
+//   field map, amplitude, design energy, frequency, kinetic energy and RF phase
+//   at the entry, time step, charge, mass and the number of refinements of the
+//   search) followed by the phase, the final energy and the amplitude. All
+//   numbers are written with 17 significant digits, i.e. an entry is only used
+//   if the key matches exactly. Later entries override earlier ones.
+//
+// This file is part of OPAL.
+//
+// OPAL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// You should have received a copy of the GNU General Public License
+// along with OPAL. If not, see <https://www.gnu.org/licenses/>.
+//
+#ifndef OPAL_AUTOPHASE_CACHE_H
+#define OPAL_AUTOPHASE_CACHE_H
+
+#include <string>
+
+class PartData;
+class RFCavity;
+
+class AutophaseCache {
+public:
+    struct Entry {
+        double phase;
+        double energy;
+        double amplitude;
+    };
+
+    explicit AutophaseCache(const std::string& fileName);
+
+    bool isEnabled() const;
+
+    /// the key is only complete on rank 0, it is not needed on the other ranks
+    std::string makeKey(
+        const RFCavity& cavity, const PartData& reference, double entryEnergy, double entryTime,
+        double dt) const;
+
+    /// looks up the key on rank 0 and broadcasts the result, has to be called by all ranks
+    bool lookup(const std::string& key, Entry& entry) const;
+
+    /// appends an entry to the file, only rank 0 writes
+    void store(const std::string& key, const Entry& entry) const;
+
+private:
+    std::string fileName_m;
+};
+
+inline bool AutophaseCache::isEnabled() const {
+    return !fileName_m.empty();
+}
+
+#endif  // OPAL_AUTOPHASE_CACHE_H
@@ -25,6 +25,7 @@
 #include "AbsBeamline/RFCavity.h"
 #include "AbsBeamline/TravelingWave.h"
 #include "AbstractObjects/OpalData.h"
+#include "Algorithms/AutophaseCache.h"
 #include "Algorithms/CavityAutophaser.h"
 //
 #include "Physics/Units.h"
@@ -98,50 +99,70 @@ double CavityAutophaser::getPhaseAtMaxEnergy(
             element->setAmplitudem(amplitude);
         }
 
-        double initialPhase = guessCavityPhase(t + tErr);
+        AutophaseCache cache(Options::autoPhaseCache);
+        const std::string cacheKey =
+            cache.isEnabled() ? cache.makeKey(*element, itsReference_m, initialEnergy, t + tErr, dt)
+                              : std::string();
+        AutophaseCache::Entry cached;
 
-        if (amplitude == 0.0 && designEnergy <= 0.0) {
-            throw OpalException(
-                "CavityAutophaser::getPhaseAtMaxEnergy()",
-                "neither amplitude or design energy given to cavity " + element->getName());
-        }
+        if (cache.isEnabled() && cache.lookup(cacheKey, cached)) {
+            optimizedPhase = cached.phase;
+            finalEnergy    = cached.energy;
+            amplitude      = cached.amplitude;
+            element->setAmplitudem(amplitude);
 
-        if (designEnergy > 0.0) {
-            const double length = itsCavity_m->getElementLength();
-            if (length <= 0.0) {
+            *ippl::Info << level2 << "phase of " << itsCavity_m->getName() << " taken from "
+                        << Options::autoPhaseCache << endl;
+        } else {
+            double initialPhase = guessCavityPhase(t + tErr);
+
+            if (amplitude == 0.0 && designEnergy <= 0.0) {
                 throw OpalException(
                     "CavityAutophaser::getPhaseAtMaxEnergy()",
-                    "length of cavity " + element->getName() + " is zero");
+                    "neither amplitude or design energy given to cavity " + element->getName());
             }
 
-            amplitude =
-                2 * (designEnergy - initialEnergy) / (std::abs(itsReference_m.getQ()) * length);
+            if (designEnergy > 0.0) {
+                const double length = itsCavity_m->getElementLength();
+                if (length <= 0.0) {
+                    throw OpalException(
+                        "CavityAutophaser::getPhaseAtMaxEnergy()",
+                        "length of cavity " + element->getName() + " is zero");
+                }
 
-            element->setAmplitudem(amplitude);
+                amplitude =
+                    2 * (designEnergy - initialEnergy) / (std::abs(itsReference_m.getQ()) * length);
 
-            int count = 0;
-            while (count < 1000) {
-                initialPhase = guessCavityPhase(t + tErr);
-                auto status  = optimizeCavityPhase(initialPhase, t + tErr, dt);
+                element->setAmplitudem(amplitude);
 
-                optimizedPhase = status.first;
-                finalEnergy    = status.second;
+                int count = 0;
+                while (count < 1000) {
+                    initialPhase = guessCavityPhase(t + tErr);
+                    auto status  = optimizeCavityPhase(initialPhase, t + tErr, dt);
 
-                if (std::abs(designEnergy - finalEnergy) < 1e-7)
-                    break;
+                    optimizedPhase = status.first;
+                    finalEnergy    = status.second;
 
-                amplitude *= std::abs(designEnergy / finalEnergy);
-                element->setAmplitudem(amplitude);
-                initialPhase = optimizedPhase;
+                    if (std::abs(designEnergy - finalEnergy) < 1e-7)
+                        break;
 
-                ++count;
+                    amplitude *= std::abs(designEnergy / finalEnergy);
+                    element->setAmplitudem(amplitude);
+                    initialPhase = optimizedPhase;
+
+                    ++count;
+                }
             }
-        }
 
-        auto status = optimizeCavityPhase(initialPhase, t + tErr, dt);
+            auto status = optimizeCavityPhase(initialPhase, t + tErr, dt);
 
-        optimizedPhase = status.first;
-        finalEnergy    = status.second;
+            optimizedPhase = status.first;
+            finalEnergy    = status.second;
+
+            if (cache.isEnabled()) {
+                cache.store(cacheKey, {optimizedPhase, finalEnergy, amplitude});
+            }
+        }
 
         AstraPhase = std::fmod(optimizedPhase + Physics::pi / 2 + Physics::two_pi, Physics::two_pi);
         newPhase   = std::fmod(originalPhase + optimizedPhase + Physics::two_pi, Physics::two_pi);
@@ -242,42 +263,33 @@ std::pair<double, double> CavityAutophaser::optimizeCavityPhase(
     double phi               = initialPhase;
     double dphi              = Physics::pi / 360.0;
     const int numRefinements = Options::autoPhase;
-    int j                    = -1;
-
-    double E    = track(t, dt, phi);
-    double Emax = E;
-
-    do {
-        j++;
-        Emax         = E;
-        initialPhase = phi;
-        phi -= dphi;
-        E = track(t, dt, phi);
-    } while (E > Emax);
-
-    if (j == 0) {
-        phi = initialPhase;
-        E   = Emax;
-        // j = -1;
-        do {
-            // j ++;
-            Emax         = E;
-            initialPhase = phi;
-            phi += dphi;
-            E = track(t, dt, phi);
-        } while (E > Emax);
+    double E                 = 0.0;
+
+    double Emax = track(t, dt, phi);
+
+    int numSteps = 0;
+    initialPhase = climb(phi, -dphi, t, dt, Emax, numSteps);
+
+    if (numSteps == 0) {
+        initialPhase = climb(phi, dphi, t, dt, Emax, numSteps);
     }
 
     for (int rl = 0; rl < numRefinements; ++rl) {
         dphi /= 2.;
-        phi = initialPhase - dphi;
-        E   = track(t, dt, phi);
-        if (E > Emax) {
-            initialPhase = phi;
-            Emax         = E;
+
+        // with more than one rank both neighbours are tracked at once
+        std::vector<double> phases = {initialPhase - dphi};
+        if (ippl::Comm->size() > 1) {
+            phases.push_back(initialPhase + dphi);
+        }
+        std::vector<double> energies = trackBatch(t, dt, phases);
+
+        if (energies[0] > Emax) {
+            initialPhase = phases[0];
+            Emax         = energies[0];
         } else {
             phi = initialPhase + dphi;
-            E   = track(t, dt, phi);
+            E   = energies.size() > 1 ? energies[1] : track(t, dt, phi);
             if (E > Emax) {
                 initialPhase = phi;
                 Emax         = E;
@@ -307,3 +319,50 @@ double CavityAutophaser::track(
         Vector_t<double, 3>(0.0, 0.0, pe.first), itsReference_m.getM() * Units::eV2MeV);
     return finalKineticEnergy;
 }
+
+std::vector<double> CavityAutophaser::trackBatch(
+    double t, const double dt, const std::vector<double>& phases) const {
+    const int numRanks = ippl::Comm->size();
+    std::vector<double> energies(phases.size(), 0.0);
+
+    if (numRanks == 1 || phases.size() == 1) {
+        for (size_t i = 0; i < phases.size(); ++i) {
+            energies[i] = track(t, dt, phases[i]);
+        }
+        return energies;
+    }
+
+    for (size_t i = ippl::Comm->rank(); i < phases.size(); i += numRanks) {
+        energies[i] = track(t, dt, phases[i]);
+    }
+    ippl::Comm->allreduce(energies.data(), energies.size(), std::plus<double>());
+
+    return energies;
+}
+
+double CavityAutophaser::climb(
+    double phase, double dphi, double t, const double dt, double& Emax, int& numSteps) const {
+    // every rank tracks one phase of the batch; the phases are accumulated step by step
+    // such that the result doesn't depend on the number of ranks
+    const size_t batchSize = ippl::Comm->size();
+    std::vector<double> phases(batchSize);
+
+    numSteps = 0;
+    while (true) {
+        double phi = phase;
+        for (size_t i = 0; i < batchSize; ++i) {
+            phi += dphi;
+            phases[i] = phi;
+        }
+
+        std::vector<double> energies = trackBatch(t, dt, phases);
+        for (size_t i = 0; i < batchSize; ++i) {
+            if (!(energies[i] > Emax)) {
+                return phase;
+            }
+            Emax  = energies[i];
+            phase = phases[i];
+            ++numSteps;
+        }
+    }
+}
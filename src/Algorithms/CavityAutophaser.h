@@ -25,6 +25,8 @@
 #include "AbsBeamline/Component.h"
 #include "Algorithms/PartData.h"
 
+#include <vector>
+
 class CavityAutophaser {
 public:
     CavityAutophaser(const PartData &ref,
@@ -48,6 +50,19 @@ private:
                  const double phase,
                  std::ofstream *out = nullptr) const;
 
+    /// tracks the reference particle for several phases, the phases are split among the ranks
+    std::vector<double> trackBatch(double t,
+                                   const double dt,
+                                   const std::vector<double> &phases) const;
+
+    /// steps the phase by dphi as long as the energy increases, returns the best phase
+    double climb(double phase,
+                 double dphi,
+                 double t,
+                 const double dt,
+                 double &Emax,
+                 int &numSteps) const;
+
     const PartData &itsReference_m;
     std::shared_ptr<Component> itsCavity_m;
 
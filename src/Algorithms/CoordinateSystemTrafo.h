@@ -37,6 +37,53 @@ private:
     matrix_t rotationMatrix_m;
 };
 
+/// Copy of a CoordinateSystemTrafo that can be captured by value in Kokkos kernels.
+/// The boost matrix of CoordinateSystemTrafo is not usable on the device.
+struct DeviceCoordinateSystemTrafo {
+    explicit DeviceCoordinateSystemTrafo(const CoordinateSystemTrafo& trafo);
+
+    KOKKOS_INLINE_FUNCTION ippl::Vector<double, 3> transformTo(
+        const ippl::Vector<double, 3>& r) const {
+        return rotateTo(r - origin_m);
+    }
+
+    KOKKOS_INLINE_FUNCTION ippl::Vector<double, 3> rotateTo(const ippl::Vector<double, 3>& r) const {
+        ippl::Vector<double, 3> result;
+        for (unsigned int i = 0; i < 3; ++i) {
+            result[i] = rotation_m[3 * i] * r[0] + rotation_m[3 * i + 1] * r[1]
+                        + rotation_m[3 * i + 2] * r[2];
+        }
+        return result;
+    }
+
+    KOKKOS_INLINE_FUNCTION ippl::Vector<double, 3> transformFrom(
+        const ippl::Vector<double, 3>& r) const {
+        return rotateFrom(r) + origin_m;
+    }
+
+    KOKKOS_INLINE_FUNCTION ippl::Vector<double, 3> rotateFrom(
+        const ippl::Vector<double, 3>& r) const {
+        ippl::Vector<double, 3> result;
+        for (unsigned int i = 0; i < 3; ++i) {
+            result[i] = rotation_m[i] * r[0] + rotation_m[3 + i] * r[1] + rotation_m[6 + i] * r[2];
+        }
+        return result;
+    }
+
+    Kokkos::Array<double, 9> rotation_m;
+    ippl::Vector<double, 3> origin_m;
+};
+
+inline DeviceCoordinateSystemTrafo::DeviceCoordinateSystemTrafo(const CoordinateSystemTrafo& trafo)
+    : origin_m(trafo.getOrigin()) {
+    const matrix_t rot = trafo.getRotationMatrix();
+    for (unsigned int i = 0; i < 3; ++i) {
+        for (unsigned int j = 0; j < 3; ++j) {
+            rotation_m[3 * i + j] = rot(i, j);
+        }
+    }
+}
+
 inline std::ostream& operator<<(std::ostream& os, const CoordinateSystemTrafo& trafo) {
     trafo.print(os);
     return os;
@@ -25,10 +25,13 @@
 
 #include "AbstractObjects/OpalParticle.h"
 
-#include <gsl/gsl_histogram.h>
+#include <Kokkos_ScatterView.hpp>
 
 #include <boost/numeric/conversion/cast.hpp>
 
+#include <algorithm>
+#include <cmath>
+
 extern Inform* gmsg;
 
 const double DistributionMoments::percentileOneSigmaNormalDist_m    = std::erf(1 / sqrt(2));
@@ -263,19 +266,34 @@ void DistributionMoments::computeMoments(ippl::ParticleAttrib<Vector_t<double,3>
             }
      }
 
+    // fourth central moments for the halo parameter
+    double loc_moment4[Dim] = {};
+    double moment4[Dim]     = {};
+    Kokkos::parallel_reduce(
+                "calc halo of particle distr.", Nlocal,
+                KOKKOS_LAMBDA(
+                    const int k, double& mom0, double& mom1, double& mom2) {
+                    const double dx = Rview(k)[0] - meanR_loc[0];
+                    const double dy = Rview(k)[1] - meanR_loc[1];
+                    const double dz = Rview(k)[2] - meanR_loc[2];
+                    mom0 += dx * dx * dx * dx;
+                    mom1 += dy * dy * dy * dy;
+                    mom2 += dz * dz * dz * dz;
+                },
+                Kokkos::Sum<double>(loc_moment4[0]), Kokkos::Sum<double>(loc_moment4[1]),
+                Kokkos::Sum<double>(loc_moment4[2]));
+    Kokkos::fence();
+
+    MPI_Allreduce(
+            loc_moment4, moment4, Dim, MPI_DOUBLE, MPI_SUM, ippl::Comm->getCommunicator());
+
     // compute emmitance, halo, ...
     double perParticle = 1./(1.*Np);
     Vector_t<double, 3> squaredEps, fac, sumRP;
-    unsigned int l = 0;
-    for (unsigned int i = 0; i < 3; ++ i, l += 2) {
-        double w1 = centroid_m[2 * i] * perParticle;
-        double w2 = moments_m(2 * i , 2 * i);
-        //not clear which components of non-central moments are computed, needs to be checked
-        double w3 = notCentMoments_m(l, l) * perParticle;
-        double w4 = notCentMoments_m(l + 1, l + 1) * perParticle;
-        double tmp = w2 - std::pow(w1, 2);
+    for (unsigned int i = 0; i < 3; ++ i) {
+        double variance = moments_m(2 * i, 2 * i);
 
-        halo_m(i) = (w4 + w1 * (-4 * w3 + 3 * w1 * (tmp + w2))) / tmp;
+        halo_m(i) = (variance > 0.0) ? moment4[i] * perParticle / (variance * variance) : 0.0;
         halo_m(i) -= Options::haloShift;
     }
 
@@ -293,6 +311,7 @@ void DistributionMoments::computeMoments(ippl::ParticleAttrib<Vector_t<double,3>
     double betaGamma = std::sqrt(std::pow(meanGamma_m, 2) - 1.0);
     geometricEps_m = normalizedEps_m / Vector_t<double,3>(betaGamma);
 
+    computePercentiles(Rview, Pview, Np, Nlocal);
 }
 
 void DistributionMoments::computeMinMaxPosition(ippl::ParticleAttrib<Vector_t<double,3>>::view_type& Rview, size_t Nlocal)
@@ -343,7 +362,55 @@ void DistributionMoments::computeMinMaxPosition(ippl::ParticleAttrib<Vector_t<do
 void DistributionMoments::compute(
     const std::vector<OpalParticle>::const_iterator& first,
     const std::vector<OpalParticle>::const_iterator& last) {
-    // computeStatistics(first, last);
+    using position_view_type = ippl::ParticleAttrib<Vector_t<double, 3>>::view_type;
+    using mass_view_type     = ippl::ParticleAttrib<double>::view_type;
+
+    const size_t localNum = last - first;
+    size_t totalNum       = localNum;
+    ippl::Comm->allreduce(totalNum, 1, std::plus<size_t>());
+
+    position_view_type Rview("lossR", localNum);
+    position_view_type Pview("lossP", localNum);
+    mass_view_type Mview("lossM", localNum);
+    auto hostR = Kokkos::create_mirror_view(Rview);
+    auto hostP = Kokkos::create_mirror_view(Pview);
+    auto hostM = Kokkos::create_mirror_view(Mview);
+
+    // time, charge and mass are only needed here, sum them on the host
+    double localSums[3] = {0.0, 0.0, 0.0};
+    size_t i = 0;
+    for (auto it = first; it != last; ++it, ++i) {
+        const OpalParticle& particle = *it;
+        for (unsigned int d = 0; d < 3; ++d) {
+            hostR(i)[d] = particle[2 * d];
+            hostP(i)[d] = particle[2 * d + 1];
+        }
+        hostM(i) = particle.getMass();
+
+        localSums[0] += particle.getTime();
+        localSums[1] += particle.getCharge();
+        localSums[2] += particle.getMass();
+    }
+    Kokkos::deep_copy(Rview, hostR);
+    Kokkos::deep_copy(Pview, hostP);
+    Kokkos::deep_copy(Mview, hostM);
+
+    computeMoments(Rview, Pview, Mview, totalNum, localNum);
+    computeMinMaxPosition(Rview, localNum);
+
+    ippl::Comm->allreduce(localSums, 3, std::plus<double>());
+    const double perParticle = 1.0 / std::max<size_t>(totalNum, 1);
+    meanTime_m          = localSums[0] * perParticle;
+    totalCharge_m       = localSums[1];
+    totalMass_m         = localSums[2];
+    totalNumParticles_m = totalNum;
+
+    double localTimeVariance = 0.0;
+    for (auto it = first; it != last; ++it) {
+        localTimeVariance += std::pow(it->getTime() - meanTime_m, 2);
+    }
+    ippl::Comm->allreduce(localTimeVariance, 1, std::plus<double>());
+    stdTime_m = std::sqrt(localTimeVariance * perParticle);
 }
 
 /*
@@ -457,227 +524,277 @@ void DistributionMoments::computeStatistics(const InputIt& first, const InputIt&
 }
 */
 
-template <class InputIt>
-void DistributionMoments::computePercentiles(const InputIt& first, const InputIt& last) {
-    if (!Options::computePercentiles || totalNumParticles_m < 100) {
-        return;
-    }
+namespace {
+    using PositionView_t = ippl::ParticleAttrib<Vector_t<double, 3>>::view_type;
+
+    constexpr unsigned int numPercentiles       = 4;
+    constexpr unsigned int numPercentileWindows = 3 * numPercentiles;
+    constexpr unsigned int numEmittanceSums     = 6;
+
+    /// Sums (N, x, p, x^2, p^2, xp) of the particles inside every percentile,
+    /// positions and momenta relative to the mean
+    struct PercentileEmittanceSums {
+        typedef double value_type[];
+        unsigned int value_count = numPercentileWindows * numEmittanceSums;
+
+        PositionView_t Rview;
+        PositionView_t Pview;
+        Kokkos::Array<double, 3> meanR;
+        Kokkos::Array<double, 3> meanP;
+        Kokkos::Array<double, numPercentileWindows> percentiles;
+
+        KOKKOS_INLINE_FUNCTION void operator()(const size_t i, value_type sums) const {
+            for (unsigned int d = 0; d < 3; ++d) {
+                const double dx = Rview(i)[d] - meanR[d];
+                const double dp = Pview(i)[d] - meanP[d];
+                const double a  = Kokkos::abs(dx);
+                for (unsigned int t = 0; t < numPercentiles; ++t) {
+                    const unsigned int w = d * numPercentiles + t;
+                    if (a < percentiles[w]) {
+                        double* s = sums + w * numEmittanceSums;
+                        s[0] += 1.0;
+                        s[1] += dx;
+                        s[2] += dp;
+                        s[3] += dx * dx;
+                        s[4] += dp * dp;
+                        s[5] += dx * dp;
+                    }
+                }
+            }
+        }
 
-    std::vector<gsl_histogram*> histograms(3);
-    // For a normal distribution the number of exchanged data between the cores is minimized
-    // if the number of histogram bins follows the following formula. Since we can't know
-    // how many particles are in each bin for the real distribution we use this formula.
-    unsigned int numBins = 3.5 * std::pow(3, std::log10(totalNumParticles_m));
+        KOKKOS_INLINE_FUNCTION void init(value_type sums) const {
+            for (unsigned int j = 0; j < value_count; ++j) {
+                sums[j] = 0.0;
+            }
+        }
 
-    Vector_t<double, 3> maxR;
-    for (unsigned int d = 0; d < 3; ++d) {
-        maxR(d)       = 1.0000001 * std::max(maxR_m[d] - meanR_m[d], meanR_m[d] - minR_m[d]);
-        histograms[d] = gsl_histogram_alloc(numBins);
-        gsl_histogram_set_ranges_uniform(histograms[d], 0.0, maxR(d));
-    }
-    for (InputIt it = first; it != last; ++it) {
-        OpalParticle const& particle = *it;
-        for (unsigned int d = 0; d < 3; ++d) {
-            gsl_histogram_increment(histograms[d], std::abs(particle[2 * d] - meanR_m[d]));
+        KOKKOS_INLINE_FUNCTION void join(value_type dst, const value_type src) const {
+            for (unsigned int j = 0; j < value_count; ++j) {
+                dst[j] += src[j];
+            }
+        }
+    };
+
+    /// Largest |x - <x>| below and smallest at or above the upper bound of every search window
+    struct PercentileNeighbours {
+        typedef double value_type[];
+        unsigned int value_count = 2 * numPercentileWindows;
+
+        PositionView_t Rview;
+        Kokkos::Array<double, 3> meanR;
+        Kokkos::Array<double, numPercentileWindows> upper;
+
+        KOKKOS_INLINE_FUNCTION void operator()(const size_t i, value_type values) const {
+            for (unsigned int d = 0; d < 3; ++d) {
+                const double a = Kokkos::abs(Rview(i)[d] - meanR[d]);
+                for (unsigned int t = 0; t < numPercentiles; ++t) {
+                    const unsigned int w = d * numPercentiles + t;
+                    if (a < upper[w]) {
+                        values[w] = Kokkos::max(values[w], a);
+                    } else {
+                        values[numPercentileWindows + w] =
+                            Kokkos::min(values[numPercentileWindows + w], a);
+                    }
+                }
+            }
         }
-    }
 
-    std::vector<int> localHistogramValues(3 * (numBins + 1)),
-        globalHistogramValues(3 * (numBins + 1));
-    for (unsigned int d = 0; d < 3; ++d) {
-        int j              = 0;
-        size_t accumulated = 0;
-        std::generate(
-            localHistogramValues.begin() + d * (numBins + 1) + 1,
-            localHistogramValues.begin() + (d + 1) * (numBins + 1),
-            [&histograms, &d, &j, &accumulated]() {
-                accumulated += gsl_histogram_get(histograms[d], j++);
-                return accumulated;
-            });
+        KOKKOS_INLINE_FUNCTION void init(value_type values) const {
+            for (unsigned int w = 0; w < numPercentileWindows; ++w) {
+                values[w]                        = 0.0;
+                values[numPercentileWindows + w] = Kokkos::reduction_identity<double>::min();
+            }
+        }
+
+        KOKKOS_INLINE_FUNCTION void join(value_type dst, const value_type src) const {
+            for (unsigned int w = 0; w < numPercentileWindows; ++w) {
+                dst[w] = Kokkos::max(dst[w], src[w]);
+                dst[numPercentileWindows + w] =
+                    Kokkos::min(dst[numPercentileWindows + w], src[numPercentileWindows + w]);
+            }
+        }
+    };
+}  // namespace
 
-        gsl_histogram_free(histograms[d]);
+/** Computes the 68.27, 95.45, 99.73 and 99.994 percentiles of |x - <x>| per dimension and the
+ *  normalized emittances of the particles inside of them, without sorting and without copying
+ *  particles to the host.
+ *
+ *  The percentiles are found by a distributed selection: every (dimension, percentile) pair owns
+ *  a search window that initially spans [0, max |x - <x>|]. The particles inside of a window are
+ *  histogrammed on the device, the histograms are summed over all ranks and the window shrinks to
+ *  the bin that contains the required particle. After numPercentileLevels refinements the window
+ *  is smaller than 1e-9 of the initial width. Only the histograms (numPercentileWindows x
+ *  numPercentileBins counts) are communicated.
+ *
+ *  As in the former sorting implementation the percentile is the midpoint (R(N) + R(N + 1)) / 2
+ *  of the N-th and the (N + 1)-th smallest |x - <x>|. If the N-th particle is the last one in its
+ *  window both are found by one more reduction, otherwise they lie in the window and its center
+ *  is taken. The emittance is the one of the particles with |x - <x>| < percentile.
+ */
+void DistributionMoments::computePercentiles(ippl::ParticleAttrib<Vector_t<double,3>>::view_type& Rview,
+                                             ippl::ParticleAttrib<Vector_t<double,3>>::view_type& Pview,
+                                             size_t Np,
+                                             size_t Nlocal) {
+    if (!Options::computePercentiles || Np < 100) {
+        return;
     }
 
-    ippl::Comm->allreduce(
-        localHistogramValues.data(), globalHistogramValues.data(), 3 * (numBins + 1),
-        std::plus<int>());
-
-    int numParticles68 = boost::numeric_cast<int>(
-        std::floor(totalNumParticles_m * percentileOneSigmaNormalDist_m + 0.5));
-    int numParticles95 = boost::numeric_cast<int>(
-        std::floor(totalNumParticles_m * percentileTwoSigmasNormalDist_m + 0.5));
-    int numParticles99 = boost::numeric_cast<int>(
-        std::floor(totalNumParticles_m * percentileThreeSigmasNormalDist_m + 0.5));
-    int numParticles99_99 = boost::numeric_cast<int>(
-        std::floor(totalNumParticles_m * percentileFourSigmasNormalDist_m + 0.5));
-
-    for (int d = 0; d < 3; ++d) {
-        unsigned int localNum = last - first, current = 0;
-        std::vector<Vector_t<double, 2>> oneDPhaseSpace(localNum);
-        for (InputIt it = first; it != last; ++it, ++current) {
-            OpalParticle const& particle = *it;
-            oneDPhaseSpace[current](0)   = particle[2 * d];
-            oneDPhaseSpace[current](1)   = particle[2 * d + 1];
-        }
-        std::sort(
-            oneDPhaseSpace.begin(), oneDPhaseSpace.end(),
-            [d, this](Vector_t<double, 2>& left, Vector_t<double, 2>& right) {
-                return std::abs(left[0] - meanR_m[d]) < std::abs(right[0] - meanR_m[d]);
-            });
+    static IpplTimings::TimerRef percentileTimer = IpplTimings::getTimer("computePercentiles");
+    IpplTimings::startTimer(percentileTimer);
+
+    constexpr unsigned int numPercentileBins   = 1024;
+    constexpr unsigned int numPercentileLevels = 3;
+
+    using histogram_type = Kokkos::View<size_t**>;
+
+    const double fractions[numPercentiles] = {
+        percentileOneSigmaNormalDist_m, percentileTwoSigmasNormalDist_m,
+        percentileThreeSigmasNormalDist_m, percentileFourSigmasNormalDist_m};
 
-        iterator_t endSixtyEight, endNinetyFive, endNinetyNine, endNinetyNine_NinetyNine;
-        endSixtyEight = endNinetyFive = endNinetyNine = endNinetyNine_NinetyNine =
-            oneDPhaseSpace.end();
-
-        std::tie(sixtyEightPercentile_m[d], endSixtyEight) = determinePercentilesDetail(
-            oneDPhaseSpace.begin(), oneDPhaseSpace.end(), globalHistogramValues,
-            localHistogramValues, d, numParticles68);
-
-        std::tie(ninetyFivePercentile_m[d], endNinetyFive) = determinePercentilesDetail(
-            oneDPhaseSpace.begin(), oneDPhaseSpace.end(), globalHistogramValues,
-            localHistogramValues, d, numParticles95);
-
-        std::tie(ninetyNinePercentile_m[d], endNinetyNine) = determinePercentilesDetail(
-            oneDPhaseSpace.begin(), oneDPhaseSpace.end(), globalHistogramValues,
-            localHistogramValues, d, numParticles99);
-
-        std::tie(ninetyNine_NinetyNinePercentile_m[d], endNinetyNine_NinetyNine) =
-            determinePercentilesDetail(
-                oneDPhaseSpace.begin(), oneDPhaseSpace.end(), globalHistogramValues,
-                localHistogramValues, d, numParticles99_99);
-
-        normalizedEps68Percentile_m[d] =
-            computeNormalizedEmittance(oneDPhaseSpace.begin(), endSixtyEight);
-        normalizedEps95Percentile_m[d] =
-            computeNormalizedEmittance(oneDPhaseSpace.begin(), endNinetyFive);
-        normalizedEps99Percentile_m[d] =
-            computeNormalizedEmittance(oneDPhaseSpace.begin(), endNinetyNine);
-        normalizedEps99_99Percentile_m[d] =
-            computeNormalizedEmittance(oneDPhaseSpace.begin(), endNinetyNine_NinetyNine);
+    Kokkos::Array<double, 3> meanR, meanP;
+    for (unsigned int d = 0; d < 3; ++d) {
+        meanR[d] = meanR_m[d];
+        meanP[d] = meanP_m[d];
     }
-}
 
-/** Computes the percentile and the range of all local particles that are contained therein.
- *  In a first step the container globalAccumulatedHistogram is looped through until accumulated
- *  histogram value exceeds the required number of particles. The percentile then is between the
- *  boundaries of the last histogram bin before the loop stopped. Then all particle coordinates
- *  that are between the boundaries of this bin are communicated acros all nodes and sorted.
- *  The exact percentile is then determined by counting the n smallest coordinates such that
- *  the total number of partiles results is equal to 'numRequiredParticles'. In accordance with
- *  matlab (?) the percentile is the midpoint between the last particle within the percentile and
- *  tje first particle outside. Finally each node determines which of its particles are contained
- *  in the percentile.
- *
- *  To determine the histogram, the coordinates should not be used directly. Instead, the
- *  absolute value of the difference between a coordinate and the mean, |x - <x>|, should be used
- *  so that the percentile values are similar to the standard deviation.
-
- * @param begin: begin of a container containing the one dimensional phase space of all local
- *               particles.
- * @param end:   end of the container.
- * @param globalAccumulatedHistogram: container with partial sum of histogram values of position
- *                                    coordinates summed up across all nodes. The first value
- *                                    should be 0.
- * @param localAccumulatedHistogram: container with partial sum of histogram values of position
- *                                   coordinates of all local particles. The first value should be
- 0.
- * @param dimension: dimension of the one dimensional phase space.
- * @param numRequiredParticles: number of particles that are contained in the requested percentile.
- *                              Is determined by the total number of particles and the percentile.
- * @return: pair of percentile and iterator pointing to the element after the range contained in the
- *          percentile.
- */
-std::pair<double, DistributionMoments::iterator_t> DistributionMoments::determinePercentilesDetail(
-    const DistributionMoments::iterator_t& begin, const DistributionMoments::iterator_t& end,
-    const std::vector<int>& globalAccumulatedHistogram,
-    const std::vector<int>& localAccumulatedHistogram, unsigned int dimension,
-    int numRequiredParticles) const {
-    unsigned int numBins     = globalAccumulatedHistogram.size() / 3;
-    double percentile        = 0.0;
-    iterator_t endPercentile = end;
-    for (unsigned int i = 1; i < numBins; ++i) {
-        unsigned int idx = dimension * numBins + i;
-        if (globalAccumulatedHistogram[idx] > numRequiredParticles) {
-            iterator_t beginBin = begin + localAccumulatedHistogram[idx - 1];
-            iterator_t endBin   = begin + localAccumulatedHistogram[idx];
-            unsigned int numMissingParticles =
-                numRequiredParticles - globalAccumulatedHistogram[idx - 1];
-            unsigned int shift = 2;
-            while (numMissingParticles == 0) {
-                beginBin = begin + localAccumulatedHistogram[idx - shift];
-                numMissingParticles =
-                    numRequiredParticles - globalAccumulatedHistogram[idx - shift];
-                ++shift;
-            }
+    // largest deviation from the mean
+    double maxDeviation[3] = {0.0, 0.0, 0.0};
+    Kokkos::parallel_reduce(
+        "percentile range", Nlocal,
+        KOKKOS_LAMBDA(const size_t i, double& max0, double& max1, double& max2) {
+            max0 = Kokkos::max(max0, Kokkos::abs(Rview(i)[0] - meanR[0]));
+            max1 = Kokkos::max(max1, Kokkos::abs(Rview(i)[1] - meanR[1]));
+            max2 = Kokkos::max(max2, Kokkos::abs(Rview(i)[2] - meanR[2]));
+        },
+        Kokkos::Max<double>(maxDeviation[0]), Kokkos::Max<double>(maxDeviation[1]),
+        Kokkos::Max<double>(maxDeviation[2]));
+    ippl::Comm->allreduce(maxDeviation, 3, std::greater<double>());
+
+    // search windows: lower bound, bin width and number of particles below the window
+    Kokkos::Array<double, numPercentileWindows> lower, invBinWidth;
+    double binWidth[numPercentileWindows];
+    size_t numRequired[numPercentileWindows];
+    // the (N + 1)-th particle is outside of the window of the N-th one
+    bool lastInWindow[numPercentileWindows];
+    for (unsigned int d = 0; d < 3; ++d) {
+        for (unsigned int t = 0; t < numPercentiles; ++t) {
+            const unsigned int w = d * numPercentiles + t;
+            lower[w]       = 0.0;
+            binWidth[w]    = std::max(1.0000001 * maxDeviation[d], 1e-300) / numPercentileBins;
+            invBinWidth[w] = 1.0 / binWidth[w];
+            numRequired[w] = std::max<size_t>(static_cast<size_t>(std::floor(Np * fractions[t] + 0.5)), 1);
+        }
+    }
 
-            std::vector<unsigned int> numParticlesInBin(ippl::Comm->size() + 1);
-            numParticlesInBin[ippl::Comm->rank() + 1] = endBin - beginBin;
-
-            ippl::Comm->allreduce(
-                &(numParticlesInBin[1]), ippl::Comm->size(), std::plus<unsigned int>());
-
-            std::partial_sum(
-                numParticlesInBin.begin(), numParticlesInBin.end(), numParticlesInBin.begin());
-
-            std::vector<double> positions(numParticlesInBin.back());
-            std::transform(
-                beginBin, endBin, positions.begin() + numParticlesInBin[ippl::Comm->rank()],
-                [&dimension, this](Vector_t<double, 2> const& particle) {
-                    return std::abs(particle[0] - meanR_m[dimension]);
-                });
-            ippl::Comm->allreduce(&(positions[0]), positions.size(), std::plus<double>());
-            std::sort(positions.begin(), positions.end());
-
-            percentile = (*(positions.begin() + numMissingParticles - 1)
-                          + *(positions.begin() + numMissingParticles))
-                         / 2;
-            for (iterator_t it = beginBin; it != endBin; ++it) {
-                if (std::abs((*it)[0] - meanR_m[dimension]) > percentile) {
-                    return std::make_pair(percentile, it);
+    histogram_type histogram("percentileHistogram", numPercentileWindows, numPercentileBins);
+    auto hostHistogram = Kokkos::create_mirror_view(histogram);
+
+    for (unsigned int level = 0; level < numPercentileLevels; ++level) {
+        Kokkos::deep_copy(histogram, 0);
+        auto scatter = Kokkos::Experimental::create_scatter_view(histogram);
+        Kokkos::parallel_for(
+            "percentile histogram", Nlocal, KOKKOS_LAMBDA(const size_t i) {
+                auto access = scatter.access();
+                for (unsigned int d = 0; d < 3; ++d) {
+                    const double a = Kokkos::abs(Rview(i)[d] - meanR[d]);
+                    for (unsigned int t = 0; t < numPercentiles; ++t) {
+                        const unsigned int w = d * numPercentiles + t;
+                        const double bin = (a - lower[w]) * invBinWidth[w];
+                        if (bin >= 0.0 && bin < numPercentileBins) {
+                            access(w, static_cast<unsigned int>(bin)) += 1;
+                        }
+                    }
+                }
+            });
+        Kokkos::Experimental::contribute(histogram, scatter);
+        Kokkos::deep_copy(hostHistogram, histogram);
+
+        ippl::Comm->allreduce(
+            hostHistogram.data(), numPercentileWindows * numPercentileBins, std::plus<size_t>());
+
+        bool resolved = true;
+        for (unsigned int w = 0; w < numPercentileWindows; ++w) {
+            // shrink the window to the bin containing the numRequired-th particle
+            size_t accumulated = 0;
+            unsigned int bin   = 0;
+            for (; bin + 1 < numPercentileBins; ++bin) {
+                if (accumulated + hostHistogram(w, bin) >= numRequired[w]) {
+                    break;
                 }
+                accumulated += hostHistogram(w, bin);
             }
-            endPercentile = endBin;
+            numRequired[w] -= std::min(accumulated, numRequired[w] - 1);
+            lower[w] += bin * binWidth[w];
+            resolved = resolved && hostHistogram(w, bin) <= 1;
+            lastInWindow[w] = numRequired[w] >= hostHistogram(w, bin);
+
+            binWidth[w] /= numPercentileBins;
+            invBinWidth[w] = 1.0 / binWidth[w];
+        }
+
+        // a single particle in the bin is located by one more refinement
+        if (resolved && level > 0) {
             break;
         }
     }
-    return std::make_pair(percentile, endPercentile);
-}
 
-double DistributionMoments::computeNormalizedEmittance(
-    const DistributionMoments::iterator_t& begin,
-    const DistributionMoments::iterator_t& end) const {
-    double localStatistics[] = {0.0, 0.0, 0.0, 0.0};
-    localStatistics[0]       = end - begin;
-    for (iterator_t it = begin; it < end; ++it) {
-        const Vector_t<double, 2>& rp = *it;
-        localStatistics[1] += rp(0);
-        localStatistics[2] += rp(1);
-        localStatistics[3] += rp(0) * rp(1);
+    PercentileNeighbours neighboursFunctor;
+    neighboursFunctor.Rview = Rview;
+    neighboursFunctor.meanR = meanR;
+    for (unsigned int w = 0; w < numPercentileWindows; ++w) {
+        neighboursFunctor.upper[w] = lower[w] + numPercentileBins * binWidth[w];
     }
-    ippl::Comm->allreduce(&(localStatistics[0]), 4, std::plus<double>());
-
-    double numParticles = localStatistics[0];
-    double perParticle  = 1 / localStatistics[0];
-    double meanR        = localStatistics[1] * perParticle;
-    double meanP        = localStatistics[2] * perParticle;
-    double RP           = localStatistics[3] * perParticle;
-
-    localStatistics[0] = 0.0;
-    localStatistics[1] = 0.0;
-    for (iterator_t it = begin; it < end; ++it) {
-        const Vector_t<double, 2>& rp = *it;
-        localStatistics[0] += std::pow(rp(0) - meanR, 2);
-        localStatistics[1] += std::pow(rp(1) - meanP, 2);
+
+    Kokkos::View<double*, Kokkos::HostSpace> neighbours(
+        "percentileNeighbours", neighboursFunctor.value_count);
+    Kokkos::parallel_reduce("percentile neighbours", Nlocal, neighboursFunctor, neighbours);
+    ippl::Comm->allreduce(neighbours.data(), numPercentileWindows, std::greater<double>());
+    ippl::Comm->allreduce(
+        neighbours.data() + numPercentileWindows, numPercentileWindows, std::less<double>());
+
+    PercentileEmittanceSums sumsFunctor;
+    sumsFunctor.Rview = Rview;
+    sumsFunctor.Pview = Pview;
+    sumsFunctor.meanR = meanR;
+    sumsFunctor.meanP = meanP;
+    for (unsigned int w = 0; w < numPercentileWindows; ++w) {
+        const double above = neighbours(numPercentileWindows + w);
+        if (lastInWindow[w] && above < Kokkos::reduction_identity<double>::min()) {
+            sumsFunctor.percentiles[w] = 0.5 * (neighbours(w) + above);
+        } else {
+            sumsFunctor.percentiles[w] = lower[w] + 0.5 * numPercentileBins * binWidth[w];
+        }
     }
-    ippl::Comm->allreduce(&(localStatistics[0]), 2, std::plus<double>());
 
-    double stdR          = std::sqrt(localStatistics[0] / numParticles);
-    double stdP          = std::sqrt(localStatistics[1] / numParticles);
-    double sumRP         = RP - meanR * meanP;
-    double squaredEps    = std::pow(stdR * stdP, 2) - std::pow(sumRP, 2);
-    double normalizedEps = std::sqrt(std::max(squaredEps, 0.0));
+    Kokkos::View<double*, Kokkos::HostSpace> sums("percentileSums", sumsFunctor.value_count);
+    Kokkos::parallel_reduce("percentile emittance", Nlocal, sumsFunctor, sums);
+    ippl::Comm->allreduce(sums.data(), sumsFunctor.value_count, std::plus<double>());
+
+    Vector_t<double, 3>* percentiles[]  = {&sixtyEightPercentile_m, &ninetyFivePercentile_m,
+                                           &ninetyNinePercentile_m,
+                                           &ninetyNine_NinetyNinePercentile_m};
+    Vector_t<double, 3>* emittances[]   = {&normalizedEps68Percentile_m, &normalizedEps95Percentile_m,
+                                           &normalizedEps99Percentile_m,
+                                           &normalizedEps99_99Percentile_m};
+    for (unsigned int d = 0; d < 3; ++d) {
+        for (unsigned int t = 0; t < numPercentiles; ++t) {
+            const unsigned int w = d * numPercentiles + t;
+            const double* s      = sums.data() + w * numEmittanceSums;
+            const double perParticle = 1.0 / std::max(s[0], 1.0);
+            const double meanX = s[1] * perParticle;
+            const double meanPx = s[2] * perParticle;
+            const double varX = s[3] * perParticle - meanX * meanX;
+            const double varP = s[4] * perParticle - meanPx * meanPx;
+            const double covXP = s[5] * perParticle - meanX * meanPx;
+
+            (*percentiles[t])[d] = sumsFunctor.percentiles[w];
+            (*emittances[t])[d]  = std::sqrt(std::max(varX * varP - covXP * covXP, 0.0));
+        }
+    }
 
-    return normalizedEps;
+    IpplTimings::stopTimer(percentileTimer);
 }
 
 void DistributionMoments::fillMembers(std::vector<double>& localMoments) {
@@ -63,6 +63,7 @@ public:
     Vector_t<double, 3> getNormalizedEmittance() const;
     Vector_t<double, 3> getGeometricEmittance() const;
     Vector_t<double, 3> getStandardDeviationRP() const;
+    /// kurtosis <(x-<x>)^4> / <(x-<x>)^2>^2 minus HALOSHIFT, i.e. 3 - HALOSHIFT for a Gaussian
     Vector_t<double, 3> getHalo() const;
     Vector_t<double, 3> getMinPosition() const;
     Vector_t<double, 3> getMaxPosition() const;
@@ -109,15 +110,10 @@ private:
     //void computeMeans(const InputIt&, const InputIt&);
     // template <class InputIt>
     // void computeStatistics(const InputIt&, const InputIt&);
-    template <class InputIt>
-    void computePercentiles(const InputIt&, const InputIt&);
-    using iterator_t = std::vector<Vector_t<double, 2>>::const_iterator;
-    std::pair<double, iterator_t> determinePercentilesDetail(
-        const iterator_t& begin, const iterator_t& end,
-        const std::vector<int>& globalAccumulatedHistogram,
-        const std::vector<int>& localAccumulatedHistogram, unsigned int dimension,
-        int numRequiredParticles) const;
-    double computeNormalizedEmittance(const iterator_t& begin, const iterator_t& end) const;
+    void computePercentiles(ippl::ParticleAttrib<Vector_t<double,3>>::view_type& Rview,
+                            ippl::ParticleAttrib<Vector_t<double,3>>::view_type& Pview,
+                            size_t Np,
+                            size_t Nlocal);
 
     void fillMembers(std::vector<double>&);
 
@@ -0,0 +1,93 @@
+//
+// Class ExternalFieldFunction
+//   The field function of the steppers (see Steppers/Stepper.h) for the
+//   ParallelTracker. It sums the fields of all elements that overlap with the
+//   bunch at the position of a particle and adds the self fields of the
+//   particle. The self fields are computed once at the start of a step and
+//   are frozen for all stages of the step, e.g. the four stages of RK4 see the
+//   space charge fields of the initial positions.
+//
+//   The elements are evaluated through their virtual apply methods through
+//   host pointers, hence the function is only callable on the host and
+//   ParallelTracker::timeIntegrationStepper advances the particles in a host
+//   execution space. ParallelTracker::setTimeIntegrator rejects RK4 if the
+//   particles don't live in host accessible memory.
+//
+// This file is part of OPAL.
+//
+// OPAL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// You should have received a copy of the GNU General Public License
+// along with OPAL. If not, see <https://www.gnu.org/licenses/>.
+//
+#ifndef OPAL_EXTERNAL_FIELD_FUNCTION_H
+#define OPAL_EXTERNAL_FIELD_FUNCTION_H
+
+#include "AbsBeamline/Component.h"
+#include "Algorithms/CoordinateSystemTrafo.h"
+#include "OPALTypes.h"
+
+#include <vector>
+
+class ExternalFieldFunction {
+public:
+    using field_view_type = ippl::ParticleAttrib<Vector_t<double, 3>>::view_type;
+
+    struct Element {
+        Element(Component* component, const CoordinateSystemTrafo& refToLocal)
+            : component(component),
+              refToLocal(refToLocal),
+              localToRef(refToLocal.inverted()) {
+        }
+
+        Component* component;
+        DeviceCoordinateSystemTrafo refToLocal;
+        DeviceCoordinateSystemTrafo localToRef;
+    };
+
+    /// the elements have to outlive the function object
+    ExternalFieldFunction(
+        const std::vector<Element>& elements, const field_view_type& selfE,
+        const field_view_type& selfB)
+        : elements_m(elements.data()),
+          numElements_m(elements.size()),
+          selfE_m(selfE),
+          selfB_m(selfB) {
+    }
+
+    /// returns true if the particle is lost
+    bool operator()(
+        const double& t, const size_t& i, const Vector_t<double, 3>& R,
+        const Vector_t<double, 3>& P, Vector_t<double, 3>& E, Vector_t<double, 3>& B) const {
+        E = selfE_m(i);
+        B = selfB_m(i);
+
+        for (size_t k = 0; k < numElements_m; ++k) {
+            const Element& element = elements_m[k];
+
+            Vector_t<double, 3> localE(0.0), localB(0.0);
+            if (element.component->apply(
+                    element.refToLocal.transformTo(R), element.refToLocal.rotateTo(P), t, localE,
+                    localB)) {
+                return true;
+            }
+
+            E += element.localToRef.rotateTo(localE);
+            B += element.localToRef.rotateTo(localB);
+        }
+
+        return false;
+    }
+
+private:
+    const Element* elements_m;
+    size_t numElements_m;
+
+    field_view_type selfE_m;
+    field_view_type selfB_m;
+};
+
+#endif
@@ -22,6 +22,7 @@
 //
 #include <map>
 #include <limits>
+#include <iomanip>
 #include <iostream>
 #include <fstream>
 #include <tuple>
@@ -159,6 +160,68 @@ void IndexMap::tidyUp(double zstop) {
     }
 }
 
+void IndexMap::write(std::ostream &out) const {
+    out << std::setprecision(17) << totalPathLength_m << "\n";
+
+    out << mapRange2Element_m.size() << "\n";
+    for (const auto &entry: mapRange2Element_m) {
+        out << entry.first.begin << " " << entry.first.end << " " << entry.second.size();
+        for (const auto &element: entry.second) {
+            out << " " << element->getName();
+        }
+        out << "\n";
+    }
+
+    out << mapElement2Range_m.size() << "\n";
+    for (const auto &entry: mapElement2Range_m) {
+        out << entry.first->getName() << " " << entry.second.begin << " " << entry.second.end << "\n";
+    }
+}
+
+void IndexMap::read(std::istream &in,
+                    const std::map<std::string, value_t::value_type> &elements) {
+    auto getElement = [&elements](const std::string &name) {
+        auto it = elements.find(name);
+        if (it == elements.end()) {
+            throw OpalException("IndexMap::read()",
+                                "Element \"" + name + "\" not found in beamline");
+        }
+        return it->second;
+    };
+
+    mapRange2Element_m.clear();
+    mapElement2Range_m.clear();
+
+    size_t numRanges = 0;
+    in >> totalPathLength_m >> numRanges;
+    for (size_t i = 0; i < numRanges; ++ i) {
+        key_t key;
+        size_t numElements = 0;
+        in >> key.begin >> key.end >> numElements;
+
+        value_t val;
+        for (size_t j = 0; j < numElements; ++ j) {
+            std::string name;
+            in >> name;
+            val.insert(getElement(name));
+        }
+        mapRange2Element_m.insert(std::make_pair(key, val));
+    }
+
+    size_t numPassages = 0;
+    in >> numPassages;
+    for (size_t i = 0; i < numPassages; ++ i) {
+        std::string name;
+        key_t key;
+        in >> name >> key.begin >> key.end;
+        mapElement2Range_m.insert(std::make_pair(getElement(name), key));
+    }
+
+    if (!in) {
+        throw OpalException("IndexMap::read()", "Failed to read index map");
+    }
+}
+
 enum elements {
     DIPOLE = 0,
     QUADRUPOLE,
@@ -23,8 +23,10 @@
 #ifndef OPAL_INDEXMAP_H
 #define OPAL_INDEXMAP_H
 
+#include <istream>
 #include <ostream>
 #include <map>
+#include <string>
 
 #include "AbsBeamline/Component.h"
 #include "Utilities/OpalException.h"
@@ -56,6 +58,10 @@ public:
 
     void print(std::ostream&) const;
     void saveSDDS(double startS) const;
+
+    /// writes the ranges with the names of the elements such that read can restore them
+    void write(std::ostream&) const;
+    void read(std::istream&, const std::map<std::string, value_t::value_type>& elements);
     size_t size() const;
 
     size_t numElements() const;
@@ -23,7 +23,9 @@
 #include "Algorithms/OrbitThreader.h"
 
 #include "AbsBeamline/RFCavity.h"
+#include "AbsBeamline/Solenoid.h"
 #include "AbsBeamline/TravelingWave.h"
+#include "AbstractObjects/Object.h"
 #include "AbstractObjects/OpalData.h"
 #include "Algorithms/CavityAutophaser.h"
 #include "BasicActions/Option.h"
@@ -35,9 +37,12 @@
 
 #include <boost/filesystem.hpp>
 
+#include <algorithm>
 #include <cmath>
+#include <cstdio>
 #include <iostream>
 #include <limits>
+#include <sstream>
 
 #define HITMATERIAL 0x80000000
 #define EOL 0x40000000
@@ -117,6 +122,16 @@ void OrbitThreader::checkElementLengths(const std::set<std::shared_ptr<Component
 void OrbitThreader::execute() {
     double initialPathLength = pathLength_m;
 
+    const bool useCache    = !Options::designPathCache.empty();
+    const std::string key  = useCache ? computeCacheKey() : std::string();
+    const int numMaxPhases = OpalData::getInstance()->getNumberOfMaxPhases();
+    if (useCache && loadFromCache(key)) {
+        *gmsg << level1 << "\n" << imap_m << endl;
+        imap_m.saveSDDS(initialPathLength);
+        processElementRegister();
+        return;
+    }
+
     auto allElements = itsOpalBeamline_m.getElementByType(ElementType::ANY);
     std::set<std::string> visitedElements;
 
@@ -190,6 +205,10 @@ void OrbitThreader::execute() {
     *gmsg << level1 << "\n" << imap_m << endl;
     imap_m.saveSDDS(initialPathLength);
     processElementRegister();
+
+    if (useCache) {
+        storeInCache(key, numMaxPhases);
+    }
 }
 
 void OrbitThreader::integrate(const IndexMap::value_t& activeSet, double /*maxDrift*/) {
@@ -198,6 +217,12 @@ void OrbitThreader::integrate(const IndexMap::value_t& activeSet, double /*maxDr
     do {
         errorFlag_m = EVERYTHINGFINE;
 
+        // in field free regions the reference particle moves on a straight line, jump
+        // to a few steps before the next element boundary
+        if (isFieldFree(activeSet)) {
+            drift(activeSet, computeNumberOfDriftSteps(activeSet));
+        }
+
         IndexMap::value_t::const_iterator it        = activeSet.begin();
         const IndexMap::value_t::const_iterator end = activeSet.end();
         Vector_t<double, 3> oldR                    = r_m;
@@ -224,25 +249,11 @@ void OrbitThreader::integrate(const IndexMap::value_t& activeSet, double /*maxDr
             Bf += itsOpalBeamline_m.rotateFromLocalCS(*it, localB);
         }
 
-        if (((pathLength_m > 0.0 && pathLength_m < zstop_m) || dt_m < 0.0)
-            && currentStep_m % loggingFrequency_m == 0 && ippl::Comm->rank() == 0
-            && !OpalData::getInstance()->isOptimizerRun()) {
+        if (isLoggingStep(pathLength_m, currentStep_m)) {
             const Vector<double, 3> d = r_m - oldR;
-
-            logger_m << std::setw(18) << std::setprecision(8)
-                     << pathLength_m + std::copysign(euclidean_norm(d), dt_m) << std::setw(18)
-                     << std::setprecision(8) << r_m(0) << std::setw(18) << std::setprecision(8)
-                     << r_m(1) << std::setw(18) << std::setprecision(8) << r_m(2) << std::setw(18)
-                     << std::setprecision(8) << p_m(0) << std::setw(18) << std::setprecision(8)
-                     << p_m(1) << std::setw(18) << std::setprecision(8) << p_m(2) << std::setw(18)
-                     << std::setprecision(8) << Ef(0) << std::setw(18) << std::setprecision(8)
-                     << Ef(1) << std::setw(18) << std::setprecision(8) << Ef(2) << std::setw(18)
-                     << std::setprecision(8) << Bf(0) << std::setw(18) << std::setprecision(8)
-                     << Bf(1) << std::setw(18) << std::setprecision(8) << Bf(2) << std::setw(18)
-                     << std::setprecision(8)
-                     << reference_m.getM() * (sqrt(dot(p_m, p_m) + 1) - 1) * Units::eV2MeV
-                     << std::setw(18) << std::setprecision(8) << (time_m + 0.5 * dt_m) * Units::s2ns
-                     << names << std::endl;
+            logDesignPath(
+                pathLength_m + std::copysign(euclidean_norm(d), dt_m), r_m, Ef, Bf,
+                time_m + 0.5 * dt_m, names);
         }
 
         r_m /= Physics::c * dt_m;
@@ -272,6 +283,144 @@ void OrbitThreader::integrate(const IndexMap::value_t& activeSet, double /*maxDr
     } while (activeSet == itsOpalBeamline_m.getElements(nextR));
 }
 
+bool OrbitThreader::isFieldFree(const IndexMap::value_t& activeSet) const {
+    return std::all_of(
+        activeSet.begin(), activeSet.end(), [](const std::shared_ptr<Component>& element) {
+            return element->getType() == ElementType::DRIFT;
+        });
+}
+
+double OrbitThreader::computeDistanceToNextElement(
+    const IndexMap::value_t& activeSet, const Vector_t<double, 3>& direction) const {
+    double distance = std::numeric_limits<double>::max();
+    for (const std::shared_ptr<Component>& element : allElements_m) {
+        const CoordinateSystemTrafo toLocal = element->getCSTrafoGlobal2Local();
+        const double z                      = toLocal.transformTo(r_m)(2);
+        const double dz                     = toLocal.rotateTo(direction)(2);
+        const double length                 = element->getElementLength();
+
+        if (activeSet.find(element) != activeSet.end()) {
+            // only drifts are active, they occupy [0, length) in local coordinates
+            if (dz > 0.0) {
+                distance = std::min(distance, (length - z) / dz);
+            } else if (dz < 0.0) {
+                distance = std::min(distance, z / -dz);
+            }
+            continue;
+        }
+
+        // isInside of any element is limited to this longitudinal window, the margin
+        // covers elements which are centered at their origin, e.g. monitors
+        const double begin =
+            std::min(0.0, element->getEdgeToBegin().getOrigin()(2)) - 0.5 * length;
+        const double end =
+            std::max(length, element->getEdgeToEnd().getOrigin()(2)) + 0.5 * length;
+        if (z >= begin && z <= end) {
+            return 0.0;
+        }
+        if (dz > 0.0 && z < begin) {
+            distance = std::min(distance, (begin - z) / dz);
+        } else if (dz < 0.0 && z > end) {
+            distance = std::min(distance, (z - end) / -dz);
+        }
+    }
+
+    return distance;
+}
+
+long OrbitThreader::computeNumberOfDriftSteps(const IndexMap::value_t& activeSet) {
+    const Vector_t<double, 3> dR = Physics::c * dt_m * p_m / Util::getGamma(p_m);
+    const double stepLength      = euclidean_norm(dR);
+    if (stepLength == 0.0) {
+        return 0;
+    }
+
+    double distance = computeDistanceToNextElement(activeSet, dR / stepLength);
+    long maxSteps   = std::numeric_limits<long>::max();
+    if (activeSet.empty()) {
+        // integrate stops as soon as the path length or the step leave their range
+        distance = std::min(
+            distance, dt_m > 0.0 ? pathLengthRange_m.getMax() - pathLength_m
+                                 : pathLength_m - pathLengthRange_m.getMin());
+        if (currentStep_m + 1 <= stepRange_m.getMin()) {
+            return 0;
+        }
+        maxSteps = stepRange_m.getMax() - currentStep_m - 1;
+    }
+
+    // the position half a step ahead decides whether integrate continues, one step is
+    // kept as margin for round-off errors
+    const double steps = std::floor(distance / stepLength - 0.5) - 1.0;
+    if (!(steps > 1.0)) {
+        return 0;
+    }
+    const long numSteps = steps < maxSteps ? static_cast<long>(steps) : maxSteps;
+    if (numSteps <= 1) {
+        return 0;
+    }
+
+    // the active drifts are convex, the whole path is inside if its end is
+    if (itsOpalBeamline_m.getElements(r_m + (numSteps + 0.5) * dR) != activeSet) {
+        return 0;
+    }
+
+    return numSteps;
+}
+
+void OrbitThreader::drift(const IndexMap::value_t& activeSet, long numSteps) {
+    if (numSteps <= 0) {
+        return;
+    }
+
+    const Vector_t<double, 3> dR = Physics::c * dt_m * p_m / Util::getGamma(p_m);
+    const double stepLength      = std::copysign(euclidean_norm(dR), dt_m);
+
+    if (loggingFrequency_m != std::numeric_limits<size_t>::max()) {
+        std::string names("\t");
+        for (const std::shared_ptr<Component>& element : activeSet) {
+            names += element->getName() + ", ";
+        }
+
+        const Vector_t<double, 3> zero(0.0);
+        for (long k = 0; k < numSteps; ++k) {
+            const double s = pathLength_m + k * stepLength;
+            if (isLoggingStep(s, currentStep_m + k)) {
+                logDesignPath(
+                    s + 0.5 * stepLength, r_m + (k + 0.5) * dR, zero, zero,
+                    time_m + (k + 0.5) * dt_m, names);
+            }
+        }
+    }
+
+    r_m += numSteps * dR;
+    pathLength_m += numSteps * stepLength;
+    currentStep_m += numSteps;
+    time_m += numSteps * dt_m;
+}
+
+bool OrbitThreader::isLoggingStep(double pathLength, long step) const {
+    return ((pathLength > 0.0 && pathLength < zstop_m) || dt_m < 0.0)
+           && step % loggingFrequency_m == 0 && ippl::Comm->rank() == 0
+           && !OpalData::getInstance()->isOptimizerRun();
+}
+
+void OrbitThreader::logDesignPath(
+    double pathLength, const Vector_t<double, 3>& R, const Vector_t<double, 3>& Ef,
+    const Vector_t<double, 3>& Bf, double t, const std::string& names) {
+    logger_m << std::setw(18) << std::setprecision(8) << pathLength << std::setw(18)
+             << std::setprecision(8) << R(0) << std::setw(18) << std::setprecision(8) << R(1)
+             << std::setw(18) << std::setprecision(8) << R(2) << std::setw(18)
+             << std::setprecision(8) << p_m(0) << std::setw(18) << std::setprecision(8) << p_m(1)
+             << std::setw(18) << std::setprecision(8) << p_m(2) << std::setw(18)
+             << std::setprecision(8) << Ef(0) << std::setw(18) << std::setprecision(8) << Ef(1)
+             << std::setw(18) << std::setprecision(8) << Ef(2) << std::setw(18)
+             << std::setprecision(8) << Bf(0) << std::setw(18) << std::setprecision(8) << Bf(1)
+             << std::setw(18) << std::setprecision(8) << Bf(2) << std::setw(18)
+             << std::setprecision(8)
+             << reference_m.getM() * (sqrt(dot(p_m, p_m) + 1) - 1) * Units::eV2MeV
+             << std::setw(18) << std::setprecision(8) << t * Units::s2ns << names << std::endl;
+}
+
 bool OrbitThreader::containsCavity(const IndexMap::value_t& activeSet) {
     IndexMap::value_t::const_iterator it        = activeSet.begin();
     const IndexMap::value_t::const_iterator end = activeSet.end();
@@ -446,6 +595,7 @@ void OrbitThreader::computeBoundingBox() {
         if (it->getElement()->getType() == ElementType::MARKER) {
             continue;
         }
+        allElements_m.push_back(it->getElement());
         BoundingBox other = it->getBoundingBoxInLabCoords();
         globalBoundingBox_m.enlargeToContainBoundingBox(other);
     }
@@ -478,4 +628,252 @@ double OrbitThreader::computeDriftLengthToBoundingBox(
     }
 
     return std::numeric_limits<double>::max();
-}
\ No newline at end of file
+}
+
+std::string OrbitThreader::computeCacheKey() {
+    if (ippl::Comm->rank() != 0) {
+        return std::string();
+    }
+
+    std::ostringstream key;
+    key << std::setprecision(17);
+    key << Util::getGitRevision() << " " << Options::autoPhase << "\n"
+        << reference_m.getQ() << " " << reference_m.getM() << "\n";
+    for (unsigned int d = 0; d < 3; ++d) {
+        key << r_m(d) << " " << p_m(d) << " ";
+    }
+    key << pathLength_m << " " << time_m << " " << dt_m << " " << zstop_m << " "
+        << distTrackBack_m << "\n";
+
+    StepSizeConfig stepSizes(stepSizes_m);
+    for (; !stepSizes.reachedEnd(); ++stepSizes) {
+        key << stepSizes.getdT() << " " << stepSizes.getZStop() << " "
+            << stepSizes.getNumSteps() << "\n";
+    }
+
+    FieldList elements = itsOpalBeamline_m.getElementByType(ElementType::ANY);
+    for (ClassicField& field : elements) {
+        std::shared_ptr<Component> element = field.getElement();
+        const CoordinateSystemTrafo toLocal = element->getCSTrafoGlobal2Local();
+        const Vector_t<double, 3> origin    = toLocal.getOrigin();
+        const Vector_t<double, 3> ex        = toLocal.rotateTo(Vector_t<double, 3>({1, 0, 0}));
+        const Vector_t<double, 3> ez        = toLocal.rotateTo(Vector_t<double, 3>({0, 0, 1}));
+
+        key << element->getName() << " " << static_cast<int>(element->getType()) << " "
+            << element->getElementLength();
+        for (unsigned int d = 0; d < 3; ++d) {
+            key << " " << origin(d) << " " << ex(d) << " " << ez(d);
+        }
+
+        // the definition of the element in the input file
+        Object* object = OpalData::getInstance()->find(element->getName());
+        if (object != nullptr) {
+            key << " ";
+            object->print(key);
+        }
+
+        if (element->getType() == ElementType::RFCAVITY
+            || element->getType() == ElementType::TRAVELINGWAVE) {
+            const RFCavity* cavity = static_cast<const RFCavity*>(element.get());
+            key << " " << std::hex << Util::hashFile(cavity->getFieldMapFN()) << std::dec << " "
+                << cavity->getAmplitudem() << " " << cavity->getFrequencym() << " "
+                << cavity->getPhasem() << " " << cavity->getDesignEnergy() << " "
+                << cavity->getAutophaseVeto();
+        } else if (element->getType() == ElementType::SOLENOID) {
+            const Solenoid* solenoid = static_cast<const Solenoid*>(element.get());
+            key << " " << std::hex << Util::hashFile(solenoid->getFieldMapFN()) << std::dec;
+        }
+        key << "\n";
+    }
+
+    std::ostringstream header;
+    header << "OPAL design path " << std::hex << Util::hashString(key.str());
+
+    return header.str();
+}
+
+bool OrbitThreader::loadFromCache(const std::string& key) {
+    std::string content;
+    if (ippl::Comm->rank() == 0) {
+        std::ifstream in(Options::designPathCache);
+        std::string header;
+        if (std::getline(in, header) && header == key) {
+            std::ostringstream buffer;
+            buffer << in.rdbuf();
+            content = buffer.str();
+        }
+    }
+
+    unsigned long size = content.size();
+    MPI_Bcast(&size, 1, MPI_UNSIGNED_LONG, 0, ippl::Comm->getCommunicator());
+    if (size == 0) {
+        return false;
+    }
+    content.resize(size);
+    MPI_Bcast(&content[0], size, MPI_CHAR, 0, ippl::Comm->getCommunicator());
+
+    std::map<std::string, std::shared_ptr<Component>> elements;
+    FieldList allElements = itsOpalBeamline_m.getElementByType(ElementType::ANY);
+    for (ClassicField& field : allElements) {
+        // the elements are identified by their names
+        if (!elements.insert(std::make_pair(field.getElement()->getName(), field.getElement()))
+                 .second) {
+            return false;
+        }
+    }
+    auto getElement = [&elements](const std::string& name) {
+        auto it = elements.find(name);
+        if (it == elements.end()) {
+            throw OpalException(
+                "OrbitThreader::loadFromCache()",
+                "Element \"" + name + "\" not found in beamline");
+        }
+        return it->second;
+    };
+
+    // read everything before anything is changed
+    std::istringstream in(content);
+    Vector_t<double, 3> lowerLeft, upperRight;
+    for (unsigned int d = 0; d < 3; ++d) {
+        in >> lowerLeft(d);
+    }
+    for (unsigned int d = 0; d < 3; ++d) {
+        in >> upperRight(d);
+    }
+
+    IndexMap imap;
+    imap.read(in, elements);
+
+    std::multimap<std::string, elementPosition> registry;
+    size_t num = 0;
+    in >> num;
+    for (size_t i = 0; i < num; ++i) {
+        std::string name;
+        elementPosition ep;
+        in >> name >> ep.startField_m >> ep.endField_m >> ep.elementEdge_m;
+        registry.insert(std::make_pair(name, ep));
+    }
+
+    std::vector<std::pair<std::shared_ptr<Component>, double>> designEnergies;
+    in >> num;
+    for (size_t i = 0; i < num; ++i) {
+        std::string name;
+        double energy;
+        in >> name >> energy;
+        designEnergies.push_back(std::make_pair(getElement(name), energy));
+    }
+
+    struct CavityState {
+        std::shared_ptr<Component> cavity;
+        double phase;
+        double amplitude;
+        bool veto;
+    };
+    std::vector<CavityState> cavities;
+    in >> num;
+    for (size_t i = 0; i < num; ++i) {
+        std::string name;
+        CavityState state;
+        in >> name >> state.phase >> state.amplitude >> state.veto;
+        state.cavity = getElement(name);
+        cavities.push_back(state);
+    }
+
+    std::vector<MaxPhasesT> maxPhases;
+    in >> num;
+    for (size_t i = 0; i < num; ++i) {
+        MaxPhasesT maxPhase;
+        in >> maxPhase.first >> maxPhase.second;
+        maxPhases.push_back(maxPhase);
+    }
+
+    if (!in) {
+        throw OpalException(
+            "OrbitThreader::loadFromCache()",
+            "Failed to read the design path from '" + Options::designPathCache + "'");
+    }
+
+    globalBoundingBox_m = BoundingBox::getBoundingBox({lowerLeft, upperRight});
+    imap_m              = imap;
+    elementRegistry_m   = registry;
+    for (const auto& designEnergy : designEnergies) {
+        designEnergy.first->setDesignEnergy(designEnergy.second);
+    }
+    for (const CavityState& state : cavities) {
+        RFCavity* cavity = static_cast<RFCavity*>(state.cavity.get());
+        cavity->setPhasem(state.phase);
+        cavity->setAmplitudem(state.amplitude);
+        cavity->setAutophaseVeto(state.veto);
+    }
+    for (const MaxPhasesT& maxPhase : maxPhases) {
+        OpalData::getInstance()->setMaxPhase(maxPhase.first, maxPhase.second);
+    }
+
+    *gmsg << level2 << "* Design path taken from '" << Options::designPathCache << "'" << endl;
+
+    return true;
+}
+
+void OrbitThreader::storeInCache(const std::string& key, int numMaxPhasesBefore) {
+    if (ippl::Comm->rank() != 0) {
+        return;
+    }
+
+    std::ostringstream out;
+    out << key << "\n" << std::setprecision(17);
+
+    const auto corners = globalBoundingBox_m.getCorners();
+    for (unsigned int d = 0; d < 3; ++d) {
+        out << corners.first(d) << " ";
+    }
+    for (unsigned int d = 0; d < 3; ++d) {
+        out << corners.second(d) << (d < 2 ? " " : "\n");
+    }
+
+    imap_m.write(out);
+
+    out << elementRegistry_m.size() << "\n";
+    for (const auto& entry : elementRegistry_m) {
+        out << entry.first << " " << entry.second.startField_m << " " << entry.second.endField_m
+            << " " << entry.second.elementEdge_m << "\n";
+    }
+
+    std::vector<std::shared_ptr<Component>> others, cavities;
+    FieldList elements = itsOpalBeamline_m.getElementByType(ElementType::ANY);
+    for (ClassicField& field : elements) {
+        std::shared_ptr<Component> element = field.getElement();
+        if (element->getType() == ElementType::RFCAVITY
+            || element->getType() == ElementType::TRAVELINGWAVE) {
+            cavities.push_back(element);
+        } else {
+            others.push_back(element);
+        }
+    }
+
+    out << others.size() << "\n";
+    for (const std::shared_ptr<Component>& element : others) {
+        out << element->getName() << " " << element->getDesignEnergy() << "\n";
+    }
+
+    out << cavities.size() << "\n";
+    for (const std::shared_ptr<Component>& element : cavities) {
+        const RFCavity* cavity = static_cast<const RFCavity*>(element.get());
+        out << cavity->getName() << " " << cavity->getPhasem() << " " << cavity->getAmplitudem()
+            << " " << cavity->getAutophaseVeto() << "\n";
+    }
+
+    auto opal = OpalData::getInstance();
+    out << opal->getNumberOfMaxPhases() - numMaxPhasesBefore << "\n";
+    for (auto it = opal->getFirstMaxPhases() + numMaxPhasesBefore; it != opal->getLastMaxPhases();
+         ++it) {
+        out << it->first << " " << it->second << "\n";
+    }
+
+    // replace the file at once such that concurrent runs never read a partial file
+    const std::string tmpFileName = Options::designPathCache + ".tmp";
+    {
+        std::ofstream file(tmpFileName);
+        file << out.str();
+    }
+    std::rename(tmpFileName.c_str(), Options::designPathCache.c_str());
+}
@@ -32,6 +32,7 @@
 #include <fstream>
 #include <string>
 #include <map>
+#include <vector>
 
 class OrbitThreader
 {
@@ -92,6 +93,8 @@ private:
     size_t loggingFrequency_m;
 
     BoundingBox globalBoundingBox_m;
+    /// all elements except markers, used to find the next element on a straight path
+    std::vector<std::shared_ptr<Component>> allElements_m;
 
     struct elementPosition {
         double startField_m;
@@ -109,6 +112,15 @@ private:
 
     void trackBack();
     void integrate(const IndexMap::value_t &activeSet, double maxDrift = 10.0);
+    bool isFieldFree(const IndexMap::value_t &activeSet) const;
+    double computeDistanceToNextElement(const IndexMap::value_t &activeSet,
+                                        const Vector_t<double, 3> &direction) const;
+    long computeNumberOfDriftSteps(const IndexMap::value_t &activeSet);
+    void drift(const IndexMap::value_t &activeSet, long numSteps);
+    bool isLoggingStep(double pathLength, long step) const;
+    void logDesignPath(double pathLength, const Vector_t<double, 3> &R,
+                       const Vector_t<double, 3> &Ef, const Vector_t<double, 3> &Bf,
+                       double t, const std::string &names);
     bool containsCavity(const IndexMap::value_t &activeSet);
     void autophaseCavities(const IndexMap::value_t &activeSet, const std::set<std::string> &visitedElements);
     double getMaxDesignEnergy(const IndexMap::value_t &elementSet) const;
@@ -123,6 +135,12 @@ private:
                                            const Vector_t<double, 3> & direction) const;
 
     void checkElementLengths(const std::set<std::shared_ptr<Component>>& elements);
+
+    /// the key is only complete on rank 0, it is not needed on the other ranks
+    std::string computeCacheKey();
+    /// has to be called by all ranks
+    bool loadFromCache(const std::string &key);
+    void storeInCache(const std::string &key, int numMaxPhasesBefore);
 };
 
 inline
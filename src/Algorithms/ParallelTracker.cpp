@@ -44,14 +44,18 @@
 
 #include "Structure/BoundaryGeometry.h"
 #include "Structure/BoundingBox.h"
+#include "Utilities/EarlyLeaveException.h"
+#include "Utilities/MemoryAccounting.h"
 #include "Utilities/OpalException.h"
 #include "Utilities/Options.h"
+#include "Utilities/PerformanceTrace.h"
 #include "Utilities/Timer.h"
 #include "Utilities/Util.h"
 #include "ValueDefinitions/RealVariable.h"
 
 #include "AbsBeamline/Offset.h"
 #include "AbsBeamline/PluginElement.h"
+#include "AbsBeamline/Probe.h"
 #include "AbsBeamline/VerticalFFAMagnet.h"
 
 extern Inform* gmsg;
@@ -79,7 +83,10 @@ ParallelTracker::ParallelTracker(
       fieldEvaluationTimer_m(IpplTimings::getTimer("External field eval")),
       PluginElemTimer_m(IpplTimings::getTimer("PluginElements")),
       BinRepartTimer_m(IpplTimings::getTimer("Binaryrepart")),
-      OrbThreader_m(IpplTimings::getTimer("OrbThreader")) {
+      OrbThreader_m(IpplTimings::getTimer("OrbThreader")),
+      resumeFromCheckpoint_m(false),
+      timeIntegrator_m(Steppers::TimeIntegrator::LF2),
+      turnnumber_m(1) {
 }
 
 ParallelTracker::ParallelTracker(
@@ -103,8 +110,12 @@ ParallelTracker::ParallelTracker(
       timeIntegrationTimer1_m(IpplTimings::getTimer("TIntegration1")),
       timeIntegrationTimer2_m(IpplTimings::getTimer("TIntegration2")),
       fieldEvaluationTimer_m(IpplTimings::getTimer("External field eval")),
+      PluginElemTimer_m(IpplTimings::getTimer("PluginElements")),
       BinRepartTimer_m(IpplTimings::getTimer("Binaryrepart")),
-      OrbThreader_m(IpplTimings::getTimer("OrbThreader")) {
+      OrbThreader_m(IpplTimings::getTimer("OrbThreader")),
+      resumeFromCheckpoint_m(false),
+      timeIntegrator_m(Steppers::TimeIntegrator::LF2),
+      turnnumber_m(1) {
     
       for (unsigned int i = 0; i < zstop.size(); ++i) {
           stepSizes_m.push_back(dt[i], zstop[i], maxSteps[i]);
@@ -115,6 +126,9 @@ ParallelTracker::ParallelTracker(
 }
 
 ParallelTracker::~ParallelTracker() {
+    for (PluginElement* element : pluginElements_m) {
+        delete element;
+    }
 }
 
 void ParallelTracker::visitScalingFFAMagnet(const ScalingFFAMagnet& bend) {
@@ -218,6 +232,14 @@ void ParallelTracker::visitVerticalFFAMagnet(const VerticalFFAMagnet& mag) {
             "Need to define a RINGDEFINITION to use VerticalFFAMagnet element");
 }
 
+void ParallelTracker::visitProbe(const Probe& prob) {
+    *gmsg << "* Adding Probe " << prob.getName() << endl;
+
+    Probe* elptr = dynamic_cast<Probe*>(prob.clone());
+    elptr->initialise(itsBunch_m);
+    pluginElements_m.push_back(elptr);
+}
+
 void ParallelTracker::visitBeamline(const Beamline& bl) {
     const FlaggedBeamline* fbl = static_cast<const FlaggedBeamline*>(&bl);
     if (fbl->getRelativeFlag()) {
@@ -289,7 +311,8 @@ void ParallelTracker::saveCavityPhases() {
 void ParallelTracker::restoreCavityPhases() {
     typedef std::vector<MaxPhasesT>::iterator iterator_t;
 
-    if (OpalData::getInstance()->hasPriorTrack() || OpalData::getInstance()->inRestartRun()) {
+    if (OpalData::getInstance()->hasPriorTrack() || OpalData::getInstance()->inRestartRun()
+        || OpalData::getInstance()->inCheckpointRestart()) {
         iterator_t it  = OpalData::getInstance()->getFirstMaxPhases();
         iterator_t end = OpalData::getInstance()->getLastMaxPhases();
         for (; it < end; ++it) {
@@ -298,26 +321,78 @@ void ParallelTracker::restoreCavityPhases() {
     }
 }
 
+void ParallelTracker::resumeFromCheckpoint(const Checkpoint::TrackerState& state) {
+    resumeFromCheckpoint_m = true;
+    resumeState_m          = state;
+    pathLength_m           = state.pathLength;
+    zstart_m               = state.pathLength;
+}
+
+void ParallelTracker::setTimeIntegrator(Steppers::TimeIntegrator timeIntegrator) {
+    if (timeIntegrator != Steppers::TimeIntegrator::LF2
+        && timeIntegrator != Steppers::TimeIntegrator::RK4) {
+        throw OpalException(
+            "ParallelTracker::setTimeIntegrator",
+            "Only the time integrators LF2 and RK4 are supported by the ParallelTracker");
+    }
+    if (timeIntegrator == Steppers::TimeIntegrator::RK4
+        && !Kokkos::SpaceAccessibility<
+            Kokkos::HostSpace, Kokkos::DefaultExecutionSpace::memory_space>::accessible) {
+        throw OpalException(
+            "ParallelTracker::setTimeIntegrator",
+            "The time integrator RK4 evaluates the elements on the host and is only supported "
+            "if OPAL is built for a host execution space, use LF2");
+    }
+    timeIntegrator_m = timeIntegrator;
+}
+
+void ParallelTracker::writeCheckpoint(bool segmentDone, unsigned long long stepsInSegment) {
+    PerformanceTrace::Region traceRegion("writeCheckpoint");
+
+    // a finished segment is resumed at the beginning of the next one
+    Checkpoint::TrackerState state;
+    state.pathLength     = pathLength_m;
+    state.stepSizeIndex  = stepSizes_m.getIndex() + (segmentDone ? 1 : 0);
+    state.stepsInSegment = segmentDone ? 0 : stepsInSegment;
+
+    // an emission in progress is resumed by a new sampler
+    std::shared_ptr<SamplingBase> sampler = itsBunch_m->getSampler();
+    state.emittedParticles = sampler ? sampler->getNumberOfEmittedParticles() : 0;
+    state.emittedSteps     = sampler ? sampler->getNumberOfEmittedSteps() : 0;
+
+    // the statistics of a restart continue from the rows on disk
+    itsDataSink_m->flush();
+
+    checkpoint_m->write(itsBunch_m, state);
+}
+
 void ParallelTracker::execute() {
     Inform msg("ParallelTracker ", *gmsg);
     OpalData::getInstance()->setInPrepState(true);
     bool back_track = false;
 
     BorisPusher pusher(itsReference);
-    const double globalTimeShift =
-        itsBunch_m->weHaveEnergyBins() ? OpalData::getInstance()->getGlobalPhaseShift() : 0.0;
+    // the time of a checkpoint has already been shifted
+    const double globalTimeShift = (itsBunch_m->weHaveEnergyBins() && !resumeFromCheckpoint_m)
+                                       ? OpalData::getInstance()->getGlobalPhaseShift()
+                                       : 0.0;
     OpalData::getInstance()->setGlobalPhaseShift(0.0);
 
     // the time step needs to be positive in the setup
     itsBunch_m->setdT(std::abs(itsBunch_m->getdT()));
     dtCurrentTrack_m = itsBunch_m->getdT();
 
-    if (OpalData::getInstance()->hasPriorTrack() || OpalData::getInstance()->inRestartRun()) {
+    if (OpalData::getInstance()->hasPriorTrack() || OpalData::getInstance()->inRestartRun()
+        || OpalData::getInstance()->inCheckpointRestart()) {
         OpalData::getInstance()->setOpenMode(OpalData::OpenMode::APPEND);
     }
 
     prepareSections();
 
+    if (resumeFromCheckpoint_m) {
+        restoreCavityPhases();
+    }
+
     double minTimeStep = stepSizes_m.getMinTimeStep();
 
     itsOpalBeamline_m.activateElements();
@@ -326,8 +401,13 @@ void ParallelTracker::execute() {
 
     itsBunch_m->toLabTrafo_m = beamlineToLab;
 
-    itsBunch_m->RefPartR_m = beamlineToLab.transformTo(itsBunch_m->getParticleContainer()->getMeanR());
-    itsBunch_m->RefPartP_m = beamlineToLab.rotateTo(itsBunch_m->getParticleContainer()->getMeanP());
+    // the reference particle of a checkpoint is restored, not recomputed from the bunch
+    if (!resumeFromCheckpoint_m) {
+        itsBunch_m->RefPartR_m =
+            beamlineToLab.transformTo(itsBunch_m->getParticleContainer()->getMeanR());
+        itsBunch_m->RefPartP_m =
+            beamlineToLab.rotateTo(itsBunch_m->getParticleContainer()->getMeanP());
+    }
 
     if (itsBunch_m->getTotalNum() > 0) {
         if (zstart_m > pathLength_m) {
@@ -338,6 +418,9 @@ void ParallelTracker::execute() {
     }
 
     stepSizes_m.advanceToPos(zstart_m);
+    if (resumeFromCheckpoint_m) {
+        stepSizes_m.advanceToIndex(resumeState_m.stepSizeIndex);
+    }
 
     Vector_t<double, 3> rmin(0.0), rmax(0.0);
     if (itsBunch_m->getTotalNum() > 0) {
@@ -353,8 +436,11 @@ void ParallelTracker::execute() {
     bool const psDump0 = 0;
     bool const statDump0 = 0;
 
-    writePhaseSpace(0, psDump0, statDump0);
-    msg << level2 << "Dump initial phase space" << endl;
+    // the initial phase space of a checkpoint restart is already on disk
+    if (!resumeFromCheckpoint_m) {
+        writePhaseSpace(0, psDump0, statDump0);
+        msg << level2 << "Dump initial phase space" << endl;
+    }
 
 
     OrbitThreader oth(
@@ -386,41 +472,74 @@ void ParallelTracker::execute() {
 
     setOptionalVariables();
 
+    if (OpalData::getInstance()->hasGlobalGeometry()) {
+        wallLossDs_m = std::make_unique<LossDataSink>(
+            OpalData::getInstance()->getInputBasename() + std::string("_wall"),
+            !Options::asciidump, CollectionType::SPATIAL);
+    }
+
     globalEOL_m        = false;
     wakeStatus_m       = false;
     deletedParticles_m = false;
     OpalData::getInstance()->setInPrepState(false);
 
     stepSizes_m.printDirect(*gmsg);
-    
+
+    if (Options::checkpointFreq > 0) {
+        checkpoint_m = std::make_unique<Checkpoint>(Checkpoint::getDefaultDirectory());
+        Checkpoint::installSignalHandler();
+    }
+
+    // steps of the current segment that were already done before the checkpoint was written
+    unsigned long long resumedSteps = resumeFromCheckpoint_m ? resumeState_m.stepsInSegment : 0;
+
+    PerformanceTrace::getInstance().initialize(OpalData::getInstance()->getInputBasename());
+
     while (!stepSizes_m.reachedEnd()) {
 
-        unsigned long long trackSteps = stepSizes_m.getNumSteps() + step;
+        const unsigned long long segmentStart = step - resumedSteps;
+        resumedSteps                          = 0;
+
+        unsigned long long trackSteps = stepSizes_m.getNumSteps() + segmentStart;
         dtCurrentTrack_m              = stepSizes_m.getdT();
         changeDT(back_track);
         
         for (; step < trackSteps; ++step) {
+            PerformanceTrace::getInstance().beginStep(step);
+
             Vector_t<double, 3> rmin(0.0), rmax(0.0);
             if (itsBunch_m->getTotalNum() > 0) {
+                PerformanceTrace::Region traceRegion("calcBeamParameters");
                 itsBunch_m->calcBeamParameters(); // TODO check if this can be put somewhere else
                                                   // this is needed since the get_bounds are now calculated in here
                 itsBunch_m->get_bounds(rmin, rmax);
             }
-            // ADA
-            timeIntegration1(pusher); // works
-       
-            resetFields();
+            if (timeIntegrator_m == Steppers::TimeIntegrator::RK4) {
+                timeIntegrationStepper<RK4<ExternalFieldFunction>>(oth, step, back_track);
+            } else {
+                // ADA
+                timeIntegration1(pusher); // works, also resets the fields
 
-            computeSpaceChargeFields(step);
-            
-            // emit particles
-            selectDT(back_track);
+                absorbParticlesAtWall();
+
+                computeSpaceChargeFields(step);
 
-            computeExternalFields(oth); // works
+                selectDT(back_track);
 
-            timeIntegration2(pusher); // works
+                emitParticles(step);
+
+                computeExternalFields(oth); // works
+
+                timeIntegration2(pusher); // works
+
+                absorbParticlesAtWall();
+            }
+
+            if (!pluginElements_m.empty()) {
+                // the widths of the probes are computed from the time step in ns
+                applyPluginElements(itsBunch_m->getdT() * Units::s2ns);
+            }
 
-           
             itsBunch_m->incrementT();
 
             if (itsBunch_m->getT() > 0.0 || itsBunch_m->getdT() < 0.0) {
@@ -442,6 +561,10 @@ void ParallelTracker::execute() {
             bool const statDump =
                 ((itsBunch_m->getGlobalTrackStep() % Options::statDumpFreq) + 1
                  == Options::statDumpFreq);
+
+            itsBunch_m->updateMemoryAccounting();
+            MemoryAccounting::getInstance().checkBudget(itsBunch_m->getGlobalTrackStep());
+
             dumpStats(step, psDump, statDump);
 
             itsBunch_m->incTrackSteps();
@@ -450,7 +573,32 @@ void ParallelTracker::execute() {
             double beta = euclidean_norm(pdivg);
             double driftPerTimeStep = std::abs(itsBunch_m->getdT()) * Physics::c * beta;
 
-            if (std::abs(stepSizes_m.getZStop() - pathLength_m) < 0.5 * driftPerTimeStep) {
+            const bool reachedZStop =
+                std::abs(stepSizes_m.getZStop() - pathLength_m) < 0.5 * driftPerTimeStep;
+
+            if (checkpoint_m) {
+                // polling the signal is collective, only do it where a checkpoint or the
+                // statistics are written anyway
+                const bool checkpointDue =
+                    itsBunch_m->getGlobalTrackStep() % Options::checkpointFreq == 0;
+                const bool terminate =
+                    (checkpointDue || statDump) && Checkpoint::terminationRequested();
+                if (terminate || checkpointDue) {
+                    writeCheckpoint(reachedZStop || step + 1 == trackSteps, step + 1 - segmentStart);
+                }
+                if (terminate) {
+                    checkpoint_m->wait();
+                    *gmsg << "* Termination requested, wrote checkpoint at step "
+                          << itsBunch_m->getGlobalTrackStep() << " to '"
+                          << checkpoint_m->getDirectory() << "'" << endl;
+                    throw EarlyLeaveException(
+                        "ParallelTracker::execute", "termination requested by signal");
+                }
+            }
+
+            PerformanceTrace::getInstance().endStep();
+
+            if (reachedZStop) {
                 break;
             }
         }
@@ -471,10 +619,34 @@ void ParallelTracker::execute() {
 
     writePhaseSpace((step + 1), psDump, statDump);
 
+    itsDataSink_m->flush();
+
+    PerformanceTrace::getInstance().finalize();
+
+    MemoryAccounting::getInstance().printSummary(*gmsg);
+
+    if (wallLossDs_m) {
+        wallLossDs_m->save(1);
+        wallLossDs_m->close();
+
+        BoundaryGeometry* geometry = OpalData::getInstance()->getGlobalGeometry();
+        geometry->gatherTriangleHits();
+        itsDataSink_m->writeGeomToVtk(
+            *geometry, OpalData::getInstance()->getInputBasename() + std::string("_wall.vtk"));
+    }
+
     *gmsg << "* Dump phase space of last step" << endl;
 
+    for (PluginElement* element : pluginElements_m) {
+        element->finalise();
+    }
+
     itsOpalBeamline_m.switchElementsOff();
 
+    if (checkpoint_m) {
+        checkpoint_m->wait();
+    }
+
     OPALTimer::Timer myt3;
     *gmsg << endl << "* Done executing ParallelTracker at " << myt3.time() << endl << endl;
 }
@@ -491,61 +663,83 @@ void ParallelTracker::prepareSections() {
 }
 
 void ParallelTracker::timeIntegration1(BorisPusher& pusher) {
+    PerformanceTrace::Region traceRegion("timeIntegration1");
+
     IpplTimings::startTimer(timeIntegrationTimer1_m);
-    pushParticles(pusher);
+    // the fields of the last step are not needed anymore, reset them in the same sweep
+    pushParticles(pusher, true);
     IpplTimings::stopTimer(timeIntegrationTimer1_m);
 }
-void ParallelTracker::pushParticles(const BorisPusher& pusher) {
-    itsBunch_m->switchToUnitlessPositions(true);
 
+void ParallelTracker::pushParticles(const BorisPusher& pusher, bool clearFields) {
     auto Rview  = itsBunch_m->getParticleContainer()->R.getView();
     auto Pview  = itsBunch_m->getParticleContainer()->P.getView();
-    auto dtview = itsBunch_m->getParticleContainer()->dt.getView();
+    auto Eview  = itsBunch_m->getParticleContainer()->E.getView();
+    auto Bview  = itsBunch_m->getParticleContainer()->B.getView();
+    auto dtview = itsBunch_m->getParticleContainer()->getTimeSteps(itsBunch_m->getdT());
+
+    const bool saveStart = wallLossDs_m != nullptr;
+    auto startR          = getWallStartPositions();
 
+    // the pusher works on positions in units of c * dt, the scaling is done in registers
     Kokkos::parallel_for("pushParticles", ippl::getRangePolicy(Rview), KOKKOS_LAMBDA(const int i) {
-        auto x = Rview(i);
-        auto p = Pview(i);
-        auto dt = dtview(i);
-        
-        pusher.push(x, p, dt);
-           
-        Rview(i) = x;
-    });
+        const double dt    = dtview(i);
+        const double scale = Physics::c * dt;
 
-    itsBunch_m->switchOffUnitlessPositions(true);
-    //itsBunch_m->getParticleContainer()->update(); //\TODO
-    ippl::Comm->barrier();
+        if (saveStart) {
+            startR(i) = Rview(i);
+        }
+
+        Vector_t<double, 3> x = Rview(i) / scale;
+        pusher.push(x, Pview(i), dt);
+        Rview(i) = x * scale;
+
+        if (clearFields) {
+            Eview(i) = 0;
+            Bview(i) = 0;
+        }
+    });
 }
 
-void ParallelTracker::kickParticles(const BorisPusher& pusher) {
+void ParallelTracker::kickAndPushParticles(const BorisPusher& pusher, double newdT) {
     auto Rview  = itsBunch_m->getParticleContainer()->R.getView();
     auto Pview  = itsBunch_m->getParticleContainer()->P.getView();
 
     auto Eview  = itsBunch_m->getParticleContainer()->E.getView();
     auto Bview  = itsBunch_m->getParticleContainer()->B.getView();
 
-    auto dtview = itsBunch_m->getParticleContainer()->dt.getView();
+    auto dtview = itsBunch_m->getParticleContainer()->getTimeSteps(itsBunch_m->getdT());
 
     const double mass = itsReference.getM();
     const double charge = itsReference.getQ();
 
-    Kokkos::parallel_for("kickParticles", ippl::getRangePolicy(Rview), KOKKOS_LAMBDA(const int i) {
-        const auto x = Rview(i);
-        auto p = Pview(i); // only p changes
+    const bool saveStart = wallLossDs_m != nullptr;
+    auto startR          = getWallStartPositions();
 
-        const auto e = Eview(i);
-        const auto b = Bview(i);
+    // kick, half push and the time step of the next step in one sweep over the particles
+    Kokkos::parallel_for("kickAndPushParticles", ippl::getRangePolicy(Rview), KOKKOS_LAMBDA(const int i) {
+        const double dt    = dtview(i);
+        const double scale = Physics::c * dt;
 
-        const auto dt = dtview(i);
-        
-        pusher.kick(x, p, e, b, dt, mass, charge);
+        if (saveStart) {
+            startR(i) = Rview(i);
+        }
+
+        Vector_t<double, 3> x = Rview(i) / scale;
+        Vector_t<double, 3> p = Pview(i);
+
+        pusher.kick(x, p, Eview(i), Bview(i), dt, mass, charge);
+        pusher.push(x, p, dt);
+
+        Rview(i) = x * scale;
         Pview(i) = p;
+        dtview.set(i, newdT);
     });
-        
-    ippl::Comm->barrier();
 }
 
 void ParallelTracker::timeIntegration2(BorisPusher& pusher) {
+    PerformanceTrace::Region traceRegion("timeIntegration2");
+
     /*
       transport and emit particles
       that passed the cathode in the first
@@ -565,24 +759,223 @@ void ParallelTracker::timeIntegration2(BorisPusher& pusher) {
     */
 
     IpplTimings::startTimer(timeIntegrationTimer2_m);
-    kickParticles(pusher);
     // switchElements();
-    pushParticles(pusher);
+    kickAndPushParticles(pusher, itsBunch_m->getdT());
+    IpplTimings::stopTimer(timeIntegrationTimer2_m);
+}
 
-    
-    auto dtview  = itsBunch_m->getParticleContainer()->dt.getView();
-    double newdT = itsBunch_m->getdT();
+template <class Integrator>
+void ParallelTracker::timeIntegrationStepper(
+    OrbitThreader& oth, unsigned long long step, bool backTrack) {
+    PerformanceTrace::Region traceRegion("timeIntegrationStepper");
+
+    // the self fields are computed at the start of the step and kept during the step
+    resetFields();
+
+    computeSpaceChargeFields(step);
+
+    selectDT(backTrack);
+
+    emitParticles(step);
+
+    IpplTimings::startTimer(timeIntegrationTimer2_m);
+
+    std::vector<ExternalFieldFunction::Element> elements;
+    if (!collectFieldElements(oth, elements)) {
+        IpplTimings::stopTimer(timeIntegrationTimer2_m);
+        return;
+    }
+
+    // the elements are evaluated through their virtual apply methods, hence the particles are
+    // advanced in a host execution space, see setTimeIntegrator
+    auto pc     = itsBunch_m->getParticleContainer();
+    auto Rview  = pc->R.getView();
+    auto Pview  = pc->P.getView();
+    auto dtview = pc->getTimeSteps(itsBunch_m->getdT());
+    auto Qview  = pc->getCharges();
+    auto Mview  = pc->getMasses();
+
+    const Integrator integrator(ExternalFieldFunction(elements, pc->E.getView(), pc->B.getView()));
+
+    const double t     = itsBunch_m->getT();
+    const double newdT = itsBunch_m->getdT();
+
+    const bool saveStart = wallLossDs_m != nullptr;
+    auto startR          = getWallStartPositions();
+
+    int locPartOutOfBounds = 0;
+    Kokkos::parallel_reduce(
+        "advanceParticles",
+        Kokkos::RangePolicy<Kokkos::DefaultHostExecutionSpace>(0, pc->getLocalNum()),
+        [=](const int i, int& outOfBounds) {
+            Vector_t<double, 3> x = Rview(i);
+            Vector_t<double, 3> p = Pview(i);
+            if (saveStart) {
+                startR(i) = x;
+            }
+
+            // the steppers take the charge in units of q_e and the rest energy in eV, only
+            // their ratio matters, hence the macro particle constants can be used
+            const double charge = Qview(i) / Physics::q_e;
+            const double mass   = Mview(i) * Units::GeV2eV;
+            if (integrator.advance(x, p, i, t, dtview(i), mass, charge)) {
+                outOfBounds = 1;
+            }
+
+            Rview(i) = x;
+            Pview(i) = p;
+            dtview.set(i, newdT);
+        },
+        Kokkos::Max<int>(locPartOutOfBounds));
 
-    Kokkos::parallel_for(
-                         "changeDT", ippl::getRangePolicy(dtview),
-                         KOKKOS_LAMBDA(const int i) {
-                             dtview(i) = newdT;
-                         });
-    
     IpplTimings::stopTimer(timeIntegrationTimer2_m);
+
+    absorbParticlesAtWall();
+
+    ippl::Comm->allreduce(locPartOutOfBounds, 1, std::greater<int>());
+
+    size_t ne = 0;
+    if (locPartOutOfBounds > 0) {
+        if (itsBunch_m->hasFieldSolver()) {
+            ne = itsBunch_m->boundp_destroyT();
+        }
+        deletedParticles_m = true;
+    }
+
+    numParticlesInSimulation_m = itsBunch_m->getTotalNum();
+
+    if (ne > 0) {
+        *gmsg << level1 << "* Deleted " << ne << " particles, "
+              << "remaining " << numParticlesInSimulation_m << " particles" << endl;
+    }
+}
+
+bool ParallelTracker::collectFieldElements(
+    OrbitThreader& oth, std::vector<ExternalFieldFunction::Element>& elements) {
+    Vector_t<double, 3> rmin(0.0), rmax(0.0);
+    if (itsBunch_m->getTotalNum() > 0)
+        itsBunch_m->get_bounds(rmin, rmax);
+
+    IndexMap::value_t overlapping;
+    try {
+        overlapping = oth.query(pathLength_m + 0.5 * (rmax(2) + rmin(2)), rmax(2) - rmin(2));
+    } catch (IndexMap::OutOfBounds& e) {
+        globalEOL_m = true;
+        return false;
+    }
+
+    elements.reserve(overlapping.size());
+    for (const std::shared_ptr<Component>& element : overlapping) {
+        CoordinateSystemTrafo refToLocalCSTrafo =
+            (itsOpalBeamline_m.getMisalignment(element)
+             * (itsOpalBeamline_m.getCSTrafoLab2Local(element) * itsBunch_m->toLabTrafo_m));
+
+        element->setCurrentSCoordinate(pathLength_m + rmin(2));
+
+        // the midpoint of the step is the time at which the steppers evaluate the fields twice
+        element->updateTimeDependence(itsBunch_m->getT() + 0.5 * itsBunch_m->getdT());
+
+        elements.emplace_back(element.get(), refToLocalCSTrafo);
+    }
+
+    return true;
+}
+
+void ParallelTracker::absorbParticlesAtWall() {
+    PerformanceTrace::Region traceRegion("absorbParticlesAtWall");
+
+    if (!wallLossDs_m) {
+        return;
+    }
+
+    // the particles are tested along the push they just did, see getWallStartPositions
+    BoundaryGeometry* geometry = OpalData::getInstance()->getGlobalGeometry();
+    const size_t numHits       = geometry->collideParticles(
+        itsBunch_m, wallStartR_m, wallTriangle_m, wallIntersection_m);
+
+    size_t totalHits = numHits;
+    ippl::Comm->allreduce(totalHits, 1, std::plus<size_t>());
+    if (totalHits == 0) {
+        return;
+    }
+
+    if (numHits > 0) {
+        auto pc             = itsBunch_m->getParticleContainer();
+        const size_t nLocal = pc->getLocalNum();
+        auto Pview          = pc->P.getView();
+        auto Qview          = pc->getCharges();
+        auto Mview          = pc->getMasses();
+        auto IDview         = pc->ID.getView();
+        auto triangle       = wallTriangle_m;
+        auto intersection   = wallIntersection_m;
+        const double t      = itsBunch_m->getT();
+
+        // the intersections are in the lab frame already, the momenta are rotated to it
+        const DeviceCoordinateSystemTrafo toLab(itsBunch_m->toLabTrafo_m);
+
+        Kokkos::View<bool*> invalid("wallInvalid", nLocal);
+        Kokkos::View<double* [9]> hitData("wallHitData", numHits);
+        Kokkos::View<int64_t*> hitID("wallHitID", numHits);
+
+        // compact the hits, the particles are stored with the intersection point
+        Kokkos::parallel_scan(
+            "absorbParticlesAtWall", nLocal,
+            KOKKOS_LAMBDA(const size_t i, size_t& hit, const bool final) {
+                const bool isHit = triangle(i) >= 0;
+                if (final) {
+                    invalid(i) = isHit;
+                    if (isHit) {
+                        const Vector_t<double, 3> P = toLab.rotateFrom(Pview(i));
+                        for (unsigned int d = 0; d < 3; ++d) {
+                            hitData(hit, d)     = intersection(i)[d];
+                            hitData(hit, d + 3) = P[d];
+                        }
+                        hitData(hit, 6) = t;
+                        hitData(hit, 7) = Qview(i);
+                        hitData(hit, 8) = Mview(i);
+                        hitID(hit)      = IDview(i);
+                    }
+                }
+                if (isHit) {
+                    ++hit;
+                }
+            });
+
+        auto hostData = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), hitData);
+        auto hostID   = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), hitID);
+
+        std::vector<OpalParticle> particles;
+        particles.reserve(numHits);
+        for (size_t h = 0; h < numHits; ++h) {
+            particles.emplace_back(
+                hostID(h), Vector_t<double, 3>(hostData(h, 0), hostData(h, 1), hostData(h, 2)),
+                Vector_t<double, 3>(hostData(h, 3), hostData(h, 4), hostData(h, 5)),
+                hostData(h, 6), hostData(h, 7), hostData(h, 8));
+        }
+        wallLossDs_m->addParticles(std::move(particles));
+
+        pc->destroy(invalid, numHits);
+    }
+
+    deletedParticles_m = true;
+    *gmsg << level2 << "* " << totalHits << " particles hit the boundary geometry" << endl;
+}
+
+Kokkos::View<Vector_t<double, 3>*> ParallelTracker::getWallStartPositions() {
+    if (!wallLossDs_m) {
+        return wallStartR_m;
+    }
+
+    const size_t nLocal = itsBunch_m->getParticleContainer()->getLocalNum();
+    if (wallStartR_m.extent(0) < nLocal) {
+        Kokkos::realloc(Kokkos::WithoutInitializing, wallStartR_m, nLocal + nLocal / 4);
+    }
+    return wallStartR_m;
 }
 
 void ParallelTracker::selectDT(bool backTrack) {
+    PerformanceTrace::Region traceRegion("selectDT");
+
     double dt = dtCurrentTrack_m;
     itsBunch_m->setdT(dt);
 
@@ -606,10 +999,21 @@ void ParallelTracker::changeDT(bool backTrack) {
 }
 
 void ParallelTracker::emitParticles(long long step) {
+    PerformanceTrace::Region traceRegion("emitParticles");
+
+    if (!itsBunch_m->getIfBeamEmitting()) {
+        return;
+    }
 
+    const size_t numEmitted = itsBunch_m->emitParticles();
+    if (numEmitted > 0) {
+        *gmsg << level3 << "* Step " << step << ": emitted " << numEmitted
+              << " particles, energy bin " << itsBunch_m->getLastEmittedEnergyBin() << endl;
+    }
 }
 
 void ParallelTracker::computeSpaceChargeFields(unsigned long long step) {
+    PerformanceTrace::Region traceRegion("computeSpaceChargeFields");
 
     if (!itsBunch_m->hasFieldSolver()) {
         *gmsg << "no solver avaidable " << endl;
@@ -714,6 +1118,8 @@ void ParallelTracker::computeSpaceChargeFields(unsigned long long step) {
 }
 
 void ParallelTracker::computeExternalFields(OrbitThreader& oth) {
+    PerformanceTrace::Region traceRegion("computeExternalFields");
+
     IpplTimings::startTimer(fieldEvaluationTimer_m);
     Inform msg("ParallelTracker ", *gmsg);
 
@@ -738,7 +1144,7 @@ void ParallelTracker::computeExternalFields(OrbitThreader& oth) {
     }
 
     // get the views
-    auto dtview = itsBunch_m->getParticleContainer()->dt.getView(); 
+    auto dtview = itsBunch_m->getParticleContainer()->getTimeSteps(itsBunch_m->getdT());
     auto Rview  = itsBunch_m->getParticleContainer()->R.getView();
     auto Pview  = itsBunch_m->getParticleContainer()->P.getView();
     auto Eview  = itsBunch_m->getParticleContainer()->E.getView();
@@ -757,6 +1163,8 @@ void ParallelTracker::computeExternalFields(OrbitThreader& oth) {
 
         (*it)->setCurrentSCoordinate(pathLength_m + rmin(2));   
 
+        // time dependence models once per step instead of once per particle
+        (*it)->updateTimeDependence(itsBunch_m->getT() + 0.5 * itsBunch_m->getdT());
 
         Kokkos::parallel_for("computeExternalField", ippl::getRangePolicy(Rview), KOKKOS_LAMBDA(const int i) {
 
@@ -842,6 +1250,8 @@ void ParallelTracker::doBinaryRepartition() {
 }
 
 void ParallelTracker::dumpStats(long long step, bool psDump, bool statDump) {
+    PerformanceTrace::Region traceRegion("dumpStats");
+
     OPALTimer::Timer myt2;
 
     /*
@@ -1026,6 +1436,8 @@ void ParallelTracker::writePhaseSpace(const long long /*step*/, bool psDump, boo
 }
 
 void ParallelTracker::updateReference(const BorisPusher& pusher) {
+    PerformanceTrace::Region traceRegion("updateReference");
+
     updateReferenceParticle(pusher);
     updateRefToLabCSTrafo();
 }
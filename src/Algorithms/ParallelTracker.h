@@ -22,10 +22,14 @@
 #ifndef OPAL_ParallelTracker_HH
 #define OPAL_ParallelTracker_HH
 
+#include "Algorithms/ExternalFieldFunction.h"
 #include "Algorithms/StepSizeConfig.h"
 #include "Algorithms/Tracker.h"
 #include "Steppers/BorisPusher.h"
+#include "Steppers/Steppers.h"
+#include "Structure/Checkpoint.h"
 #include "Structure/DataSink.h"
+#include "Structure/LossDataSink.h"
 
 #include "BasicActions/Option.h"
 #include "Utilities/Options.h"
@@ -112,6 +116,23 @@ class ParallelTracker : public Tracker {
     std::set<ParticleMatterInteractionHandler*> activeParticleMatterInteractionHandlers_m;
     bool particleMatterStatus_m;
 
+    /// writes the restart checkpoints if CHECKPOINTFREQ > 0
+    std::unique_ptr<Checkpoint> checkpoint_m;
+
+    /// set if the bunch was loaded from a checkpoint
+    bool resumeFromCheckpoint_m;
+    Checkpoint::TrackerState resumeState_m;
+
+    /// LF2 splits the Boris push around the space charge solve, RK4 uses the stepper
+    Steppers::TimeIntegrator timeIntegrator_m;
+
+    /// particles absorbed by the BOUNDARYGEOMETRY of the run, only if there is one
+    std::unique_ptr<LossDataSink> wallLossDs_m;
+    Kokkos::View<int*> wallTriangle_m;
+    Kokkos::View<Vector_t<double, 3>*> wallIntersection_m;
+    /// the positions of the particles before the last push, in the frame of the bunch
+    Kokkos::View<Vector_t<double, 3>*> wallStartR_m;
+
 public:
     typedef std::vector<double> dvector_t;
     typedef std::vector<int> ivector_t;
@@ -144,6 +165,11 @@ public:
     //  overwrite the execute-methode from DefaultVisitor
     virtual void execute();
 
+    /// Continue tracking at the position stored in a checkpoint
+    void resumeFromCheckpoint(const Checkpoint::TrackerState& state);
+
+    void setTimeIntegrator(Steppers::TimeIntegrator timeIntegrator);
+
     /// Apply the algorithm to a beam line.
     //  overwrite the execute-methode from DefaultVisitor
     virtual void visitBeamline(const Beamline&);
@@ -181,10 +207,15 @@ public:
     /// Apply the algorithm to a vertical FFA magnet.
     virtual void visitVerticalFFAMagnet(const VerticalFFAMagnet& bend);
 
+    /// Apply the algorithm to a probe, the probes are checked after every step.
+    virtual void visitProbe(const Probe& prob);
+
     // made following public: __host__ __device__ lambda cannot have private or protected access within its class
-    void kickParticles(const BorisPusher& pusher);
+    /// kick followed by a half push, afterwards the particles carry the time step newdT
+    void kickAndPushParticles(const BorisPusher& pusher, double newdT);
 
-    void pushParticles(const BorisPusher& pusher);
+    /// half push, optionally resets E and B of the particles in the same sweep
+    void pushParticles(const BorisPusher& pusher, bool clearFields = false);
 
     void timeIntegration2(BorisPusher& pusher);
 
@@ -226,6 +257,7 @@ private:
 
     void buildupFieldList(double BcParameter[], ElementType elementType, Component* elptr);
 
+    /// the probes of the beamline, owned by the tracker
     std::vector<PluginElement*> pluginElements_m;
 
 
@@ -248,7 +280,27 @@ private:
     void prepareSections();
 
     void timeIntegration1(BorisPusher& pusher);
+
+    /// one step with an integrator of Steppers in a host execution space (host builds only), the
+    /// self fields of the start of the step are frozen for all stages
+    template <class Integrator>
+    void timeIntegrationStepper(OrbitThreader& oth, unsigned long long step, bool backTrack);
+
+    /// the elements that overlap with the bunch, false if the end of the line is reached
+    bool collectFieldElements(
+        OrbitThreader& oth, std::vector<ExternalFieldFunction::Element>& elements);
     void selectDT(bool backTrack = false);
+
+    /// removes the particles that hit the wall in the last push and stores them in *_wall, it
+    /// has to be called after every push before the particles are exchanged or deleted
+    void absorbParticlesAtWall();
+
+    /**
+       The view the pushes store the positions before the push in if there is a wall. The
+       Boris pusher is tested after each of its half pushes, since the particles are
+       repartitioned in between and the emitted particles only do the second one.
+     */
+    Kokkos::View<Vector_t<double, 3>*> getWallStartPositions();
     void emitParticles(long long step);
 public:
     void computeExternalFields(OrbitThreader& oth);
@@ -264,6 +316,7 @@ private:
     void setOptionalVariables();
     bool hasEndOfLineReached(const BoundingBox& globalBoundingBox);
     void handleRestartRun();
+    void writeCheckpoint(bool segmentDone, unsigned long long stepsInSegment);
 
     void doBinaryRepartition();
 
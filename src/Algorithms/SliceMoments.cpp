@@ -0,0 +1,221 @@
+//
+// Class SliceMoments
+//   Computes the statistics of longitudinal slices of a particle distribution.
+//
+// This file is part of OPAL.
+//
+// OPAL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// You should have received a copy of the GNU General Public License
+// along with OPAL. If not, see <https://www.gnu.org/licenses/>.
+//
+#include "Algorithms/SliceMoments.h"
+
+#include "Filters/Filter.h"
+#include "OPALTypes.h"
+#include "Physics/Physics.h"
+
+#include <Kokkos_ScatterView.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+    // per slice: N, Q, x, px, y, py, x^2, px^2, x*px, y^2, py^2, y*py, beta_z, Ekin, Ekin^2, z, z^2
+    enum SliceSum : unsigned int {
+        NUM,
+        CHARGE,
+        X,
+        PX,
+        Y,
+        PY,
+        XX,
+        PXPX,
+        XPX,
+        YY,
+        PYPY,
+        YPY,
+        BETAZ,
+        EKIN,
+        EKINEKIN,
+        Z,
+        ZZ,
+        NUMSUMS
+    };
+
+    template <class Access>
+    KOKKOS_INLINE_FUNCTION void accumulate(
+        Access& access, unsigned int slice, const ippl::Vector<double, 3>& R,
+        const ippl::Vector<double, 3>& P, double q, double m) {
+        const double gamma = Kokkos::sqrt(1.0 + P[0] * P[0] + P[1] * P[1] + P[2] * P[2]);
+        const double ekin  = (gamma - 1.0) * m;
+
+        access(slice, NUM) += 1.0;
+        access(slice, CHARGE) += q;
+        access(slice, X) += R[0];
+        access(slice, PX) += P[0];
+        access(slice, Y) += R[1];
+        access(slice, PY) += P[1];
+        access(slice, XX) += R[0] * R[0];
+        access(slice, PXPX) += P[0] * P[0];
+        access(slice, XPX) += R[0] * P[0];
+        access(slice, YY) += R[1] * R[1];
+        access(slice, PYPY) += P[1] * P[1];
+        access(slice, YPY) += R[1] * P[1];
+        access(slice, BETAZ) += P[2] / gamma;
+        access(slice, EKIN) += ekin;
+        access(slice, EKINEKIN) += ekin * ekin;
+        access(slice, Z) += R[2];
+        access(slice, ZZ) += R[2] * R[2];
+    }
+}  // namespace
+
+SliceMoments::SliceMoments() : numSlices_m(0), zMin_m(0.0), sliceWidth_m(0.0) {
+}
+
+void SliceMoments::compute(position_view_type& Rview, position_view_type& Pview,
+                           scalar_view_type& Qview, scalar_view_type& Mview, size_t Nlocal,
+                           unsigned int numSlices) {
+    using bin_index_type = PartBunch_t::AdaptBins_t::bin_index_type;
+
+    static IpplTimings::TimerRef sliceTimer = IpplTimings::getTimer("computeSliceMoments");
+    IpplTimings::startTimer(sliceTimer);
+
+    numSlices_m = numSlices;
+
+    // longitudinal extent of the bunch
+    double zMax = std::numeric_limits<double>::lowest();
+    double zMin = std::numeric_limits<double>::max();
+    Kokkos::parallel_reduce(
+        "slice limits", Nlocal,
+        KOKKOS_LAMBDA(const size_t i, double& max, double& min) {
+            max = Kokkos::max(max, Rview(i)[2]);
+            min = Kokkos::min(min, Rview(i)[2]);
+        },
+        Kokkos::Max<double>(zMax), Kokkos::Min<double>(zMin));
+    ippl::Comm->allreduce(zMax, 1, std::greater<double>());
+    ippl::Comm->allreduce(zMin, 1, std::less<double>());
+
+    if (zMax < zMin) {
+        zMin = zMax = 0.0;
+    }
+    zMin_m       = zMin;
+    sliceWidth_m = std::max(zMax - zMin, 1e-300) / numSlices;
+
+    const double binWidthInv     = 1.0 / sliceWidth_m;
+    const bin_index_type numBins = numSlices;
+
+    Kokkos::View<double**> sums("sliceSums", numSlices, NUMSUMS);
+    auto scatter = Kokkos::Experimental::create_scatter_view(sums);
+    Kokkos::parallel_for(
+        "slice moments", Nlocal, KOKKOS_LAMBDA(const size_t i) {
+            const bin_index_type slice =
+                PartBunch_t::AdaptBins_t::getBin(Rview(i)[2], zMin, zMax, binWidthInv, numBins);
+
+            auto access = scatter.access();
+            accumulate(access, slice, Rview(i), Pview(i), Qview(i), Mview(i));
+        });
+    Kokkos::Experimental::contribute(sums, scatter);
+
+    reduceAndFill(sums);
+
+    IpplTimings::stopTimer(sliceTimer);
+}
+
+void SliceMoments::computeEnsemble(position_view_type& Rview, position_view_type& Pview,
+                                   scalar_view_type& Qview, scalar_view_type& Mview,
+                                   species_view_type& Spview, size_t Nlocal,
+                                   unsigned int ensembleSize) {
+    static IpplTimings::TimerRef ensembleTimer = IpplTimings::getTimer("computeEnsembleMoments");
+    IpplTimings::startTimer(ensembleTimer);
+
+    // one slice per member, the slice width only enters the current
+    numSlices_m  = ensembleSize;
+    zMin_m       = 0.0;
+    sliceWidth_m = 1.0;
+
+    Kokkos::View<double**> sums("ensembleSums", ensembleSize, NUMSUMS);
+    auto scatter = Kokkos::Experimental::create_scatter_view(sums);
+    Kokkos::parallel_for(
+        "ensemble moments", Nlocal, KOKKOS_LAMBDA(const size_t i) {
+            const short member = Spview(i);
+            if (member < 0 || static_cast<unsigned int>(member) >= ensembleSize) {
+                return;
+            }
+            auto access = scatter.access();
+            accumulate(access, member, Rview(i), Pview(i), Qview(i), Mview(i));
+        });
+    Kokkos::Experimental::contribute(sums, scatter);
+
+    reduceAndFill(sums);
+
+    IpplTimings::stopTimer(ensembleTimer);
+}
+
+void SliceMoments::reduceAndFill(const Kokkos::View<double**>& sums) {
+    auto hostSums = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), sums);
+    std::vector<double> globalSums(hostSums.data(), hostSums.data() + numSlices_m * NUMSUMS);
+    ippl::Comm->allreduce(globalSums.data(), globalSums.size(), std::plus<double>());
+
+    fillMembers(globalSums);
+}
+
+void SliceMoments::fillMembers(const std::vector<double>& sums) {
+    numParticles_m.assign(numSlices_m, 0.0);
+    current_m.assign(numSlices_m, 0.0);
+    meanKineticEnergy_m.assign(numSlices_m, 0.0);
+    stdKineticEnergy_m.assign(numSlices_m, 0.0);
+    meanZ_m.assign(numSlices_m, 0.0);
+    stdZ_m.assign(numSlices_m, 0.0);
+    meanR_m.assign(2 * numSlices_m, 0.0);
+    stdR_m.assign(2 * numSlices_m, 0.0);
+    normalizedEps_m.assign(2 * numSlices_m, 0.0);
+
+    for (unsigned int s = 0; s < numSlices_m; ++s) {
+        const double* sum = sums.data() + s * NUMSUMS;
+
+        numParticles_m[s] = sum[NUM];
+        if (sum[NUM] == 0.0) {
+            continue;
+        }
+        const double perParticle = 1.0 / sum[NUM];
+
+        // I = dQ/dz * <beta_z> * c
+        current_m[s] = std::abs(sum[CHARGE]) / sliceWidth_m * sum[BETAZ] * perParticle * Physics::c;
+
+        meanKineticEnergy_m[s] = sum[EKIN] * perParticle;
+        stdKineticEnergy_m[s]  = std::sqrt(std::max(
+            sum[EKINEKIN] * perParticle - std::pow(meanKineticEnergy_m[s], 2), 0.0));
+
+        meanZ_m[s] = sum[Z] * perParticle;
+        stdZ_m[s]  = std::sqrt(std::max(sum[ZZ] * perParticle - meanZ_m[s] * meanZ_m[s], 0.0));
+
+        const unsigned int first[] = {X, Y};
+        for (unsigned int d = 0; d < 2; ++d) {
+            const unsigned int x = first[d];
+            const unsigned int p = x + 1;
+            const unsigned int xx = XX + 3 * d, pp = xx + 1, xp = xx + 2;
+
+            const double meanX = sum[x] * perParticle;
+            const double meanP = sum[p] * perParticle;
+            const double varX  = sum[xx] * perParticle - meanX * meanX;
+            const double varP  = sum[pp] * perParticle - meanP * meanP;
+            const double covXP = sum[xp] * perParticle - meanX * meanP;
+
+            meanR_m[2 * s + d]         = meanX;
+            stdR_m[2 * s + d]          = std::sqrt(std::max(varX, 0.0));
+            normalizedEps_m[2 * s + d] = std::sqrt(std::max(varX * varP - covXP * covXP, 0.0));
+        }
+    }
+}
+
+void SliceMoments::smoothCurrent(Filter& filter) {
+    if (current_m.empty()) {
+        return;
+    }
+    filter.apply(current_m);
+}
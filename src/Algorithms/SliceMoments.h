@@ -0,0 +1,130 @@
+//
+// Class SliceMoments
+//   Computes the statistics of longitudinal slices of a particle distribution.
+//
+//   The particles are binned along z on the device. The first and second moments
+//   of all slices are accumulated in a single pass and summed over all ranks
+//   with one reduction, i.e. the cost does not depend on the number of slices.
+//
+// This file is part of OPAL.
+//
+// OPAL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// You should have received a copy of the GNU General Public License
+// along with OPAL. If not, see <https://www.gnu.org/licenses/>.
+//
+#ifndef OPAL_SLICE_MOMENTS_H
+#define OPAL_SLICE_MOMENTS_H
+
+#include "Ippl.h"
+
+#include <vector>
+
+class Filter;
+
+class SliceMoments {
+public:
+    using position_view_type = ippl::ParticleAttrib<ippl::Vector<double, 3>>::view_type;
+    using scalar_view_type   = ippl::ParticleAttrib<double>::view_type;
+    using species_view_type  = ippl::ParticleAttrib<short>::view_type;
+
+    SliceMoments();
+
+    void compute(position_view_type& Rview, position_view_type& Pview, scalar_view_type& Qview,
+                 scalar_view_type& Mview, size_t Nlocal, unsigned int numSlices);
+
+    /// Computes the statistics of the members of an ensemble instead of slices, member r
+    /// is the species Sp = r, see ParticleContainer::Sp
+    void computeEnsemble(position_view_type& Rview, position_view_type& Pview,
+                         scalar_view_type& Qview, scalar_view_type& Mview,
+                         species_view_type& Spview, size_t Nlocal, unsigned int ensembleSize);
+
+    /// Smooths the current profile, e.g. with a Savitzky-Golay or FFT low pass filter
+    void smoothCurrent(Filter& filter);
+
+    unsigned int getNumSlices() const;
+    double getSliceWidth() const;
+
+    double getZ(unsigned int slice) const;
+    double getNumParticles(unsigned int slice) const;
+    double getCurrent(unsigned int slice) const;
+    double getMeanKineticEnergy(unsigned int slice) const;
+    double getStdKineticEnergy(unsigned int slice) const;
+    double getMeanZ(unsigned int slice) const;
+    double getStandardDeviationZ(unsigned int slice) const;
+    double getMeanPosition(unsigned int slice, unsigned int dim) const;
+    double getStandardDeviationPosition(unsigned int slice, unsigned int dim) const;
+    double getNormalizedEmittance(unsigned int slice, unsigned int dim) const;
+
+private:
+    void reduceAndFill(const Kokkos::View<double**>& sums);
+    void fillMembers(const std::vector<double>& sums);
+
+    unsigned int numSlices_m;
+    double zMin_m;
+    double sliceWidth_m;
+
+    std::vector<double> numParticles_m;
+    std::vector<double> current_m;
+    std::vector<double> meanKineticEnergy_m;
+    std::vector<double> stdKineticEnergy_m;
+    std::vector<double> meanZ_m;
+    std::vector<double> stdZ_m;
+    // transverse quantities, two entries (x, y) per slice
+    std::vector<double> meanR_m;
+    std::vector<double> stdR_m;
+    std::vector<double> normalizedEps_m;
+};
+
+inline unsigned int SliceMoments::getNumSlices() const {
+    return numSlices_m;
+}
+
+inline double SliceMoments::getSliceWidth() const {
+    return sliceWidth_m;
+}
+
+inline double SliceMoments::getZ(unsigned int slice) const {
+    return zMin_m + (slice + 0.5) * sliceWidth_m;
+}
+
+inline double SliceMoments::getNumParticles(unsigned int slice) const {
+    return numParticles_m[slice];
+}
+
+inline double SliceMoments::getCurrent(unsigned int slice) const {
+    return current_m[slice];
+}
+
+inline double SliceMoments::getMeanKineticEnergy(unsigned int slice) const {
+    return meanKineticEnergy_m[slice];
+}
+
+inline double SliceMoments::getStdKineticEnergy(unsigned int slice) const {
+    return stdKineticEnergy_m[slice];
+}
+
+inline double SliceMoments::getMeanZ(unsigned int slice) const {
+    return meanZ_m[slice];
+}
+
+inline double SliceMoments::getStandardDeviationZ(unsigned int slice) const {
+    return stdZ_m[slice];
+}
+
+inline double SliceMoments::getMeanPosition(unsigned int slice, unsigned int dim) const {
+    return meanR_m[2 * slice + dim];
+}
+
+inline double SliceMoments::getStandardDeviationPosition(unsigned int slice, unsigned int dim) const {
+    return stdR_m[2 * slice + dim];
+}
+
+inline double SliceMoments::getNormalizedEmittance(unsigned int slice, unsigned int dim) const {
+    return normalizedEps_m[2 * slice + dim];
+}
+
+#endif  // OPAL_SLICE_MOMENTS_H
@@ -24,6 +24,7 @@
 #include <numeric>
 #include <iterator>
 #include <cmath>
+#include <string>
 
 void StepSizeConfig::sortAscendingZStop() {
     configurations_m.sort([] (const entry_t &a,
@@ -48,6 +49,22 @@ StepSizeConfig& StepSizeConfig::advanceToPos(double spos) {
     return *this;
 }
 
+unsigned int StepSizeConfig::getIndex() const {
+    return std::distance(configurations_m.begin(), container_t::const_iterator(it_m));
+}
+
+StepSizeConfig& StepSizeConfig::advanceToIndex(unsigned int index) {
+    if (index >= configurations_m.size()) {
+        throw OpalException("StepSizeConfig::advanceToIndex",
+                            "index " + std::to_string(index) + " is beyond the list of configurations");
+    }
+
+    it_m = configurations_m.begin();
+    std::advance(it_m, index);
+
+    return *this;
+}
+
 StepSizeConfig& StepSizeConfig::operator++() {
     if (reachedEnd()) {
         throw OpalException("StepSizeConfig::operator++",
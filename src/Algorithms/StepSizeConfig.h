@@ -52,6 +52,11 @@ public:
 
     StepSizeConfig& advanceToPos(double spos);
 
+    /// position of the current configuration, used by checkpoints
+    unsigned int getIndex() const;
+
+    StepSizeConfig& advanceToIndex(unsigned int index);
+
     StepSizeConfig& operator++();
 
     StepSizeConfig& operator--();
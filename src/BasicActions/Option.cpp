@@ -32,6 +32,7 @@
 
 #include <boost/assign.hpp>
 
+#include <algorithm>
 #include <cstddef>
 #include <ctime>
 #include <iostream>
@@ -93,6 +94,24 @@ namespace {
         BINNINGALPHA,
         BINNINGBETA,
         DESIREDWIDTH,
+        CELLSORTFREQ,
+        CELLSORTCURVE,
+        DEPOSITION,
+        CHECKPOINTFREQ,
+        SDDSFLUSHFREQ,
+        STATFORMAT,
+        SLICES,
+        SLICEFILTER,
+        LOSSFORMAT,
+        LOSSBUFFERSIZE,
+        AUTOPHASECACHE,
+        DESIGNPATHCACHE,
+        ENSEMBLE,
+        GEOMETRYCACHE,
+        PERFTRACE,
+        PERFTRACEKERNELS,
+        MEMORYBUDGET,
+        COMPACTPARTICLES,
         SIZE
     };
 }  // namespace
@@ -300,11 +319,16 @@ Option::Option()
     itsAttr[VERSION] = Attributes::makeReal(
         "VERSION", "Version of OPAL for which input file was written", version);
 
-    itsAttr[MEMORYDUMP] =
-        Attributes::makeBool("MEMORYDUMP", "If true, write memory to SDDS file", memoryDump);
+    itsAttr[MEMORYDUMP] = Attributes::makeBool(
+        "MEMORYDUMP",
+        "If true, write the memory of the process and the memory per subsystem to SDDS file",
+        memoryDump);
 
     itsAttr[HALOSHIFT] = Attributes::makeReal(
-        "HALOSHIFT", "Constant parameter to shift halo value (default: 0.0)", haloShift);
+        "HALOSHIFT",
+        "Constant parameter to shift halo value, the halo is the kurtosis "
+        "<(x-<x>)^4> / <(x-<x>)^2>^2 minus HALOSHIFT (default: 0.0)",
+        haloShift);
 
     itsAttr[DELPARTFREQ] = Attributes::makeReal(
         "DELPARTFREQ",
@@ -340,7 +364,126 @@ Option::Option()
         "DESIREDWIDTH",
         "A bias [0, 1] that tries to steer the bin size to the given variable.",
         desiredWidth);
-    
+
+    itsAttr[CELLSORTFREQ] = Attributes::makeReal(
+        "CELLSORTFREQ",
+        "The frequency (in steps) to reorder the particles in memory by grid cell, "
+        "which improves the locality of scatter and gather. Default: 0 (never)",
+        cellSortFreq);
+
+    itsAttr[CELLSORTCURVE] = Attributes::makePredefinedString(
+        "CELLSORTCURVE",
+        "The space filling curve used to order the grid cells when CELLSORTFREQ > 0.",
+        {"MORTON", "HILBERT"}, cellSortCurve);
+
+    itsAttr[DEPOSITION] = Attributes::makePredefinedString(
+        "DEPOSITION",
+        "The charge deposition scheme. ATOMIC uses atomic adds into the shared grid, "
+        "TILED deposits into thread private tiles (OpenMP/Serial builds only, works best "
+        "together with CELLSORTFREQ > 0). Default: ATOMIC",
+        {"ATOMIC", "TILED"}, deposition);
+
+    itsAttr[CHECKPOINTFREQ] = Attributes::makeReal(
+        "CHECKPOINTFREQ",
+        "The frequency (in steps) to write a per rank restart checkpoint. A checkpoint is "
+        "also written at the next statistics dump after the job receives SIGTERM or "
+        "SIGUSR1. Restart with --restart-checkpoint <dir>. Default: 0 (never)",
+        checkpointFreq);
+
+    itsAttr[SDDSFLUSHFREQ] = Attributes::makeReal(
+        "SDDSFLUSHFREQ",
+        "The number of rows the SDDS writers (*.stat, *.lbal, ...) buffer in memory before "
+        "they are written to disk. Default: 1",
+        sddsFlushFreq);
+
+    itsAttr[STATFORMAT] = Attributes::makePredefinedString(
+        "STATFORMAT",
+        "The data mode of the statistics file. BINARY writes SDDS binary data in the byte "
+        "order of the machine. Default: ASCII",
+        {"ASCII", "BINARY"}, statFormat);
+
+    itsAttr[SLICES] = Attributes::makeReal(
+        "SLICES",
+        "The number of longitudinal slices for which current, energy spread and emittances "
+        "are written to *.slice together with the statistics. Default: 0 (no slice analysis)",
+        numSlices);
+
+    itsAttr[SLICEFILTER] = Attributes::makeString(
+        "SLICEFILTER", "The name of a FILTER to smooth the slice current profile with.",
+        sliceFilter);
+
+    itsAttr[LOSSFORMAT] = Attributes::makePredefinedString(
+        "LOSSFORMAT",
+        "The format of the files written by monitors and other loss data sinks. BINARY "
+        "writes the particle data column by column with collective MPI-IO to *.lossbin. "
+        "Only used if ASCIIDUMP is false. Default: HDF5",
+        {"HDF5", "BINARY"}, lossFormat);
+
+    itsAttr[LOSSBUFFERSIZE] = Attributes::makeReal(
+        "LOSSBUFFERSIZE",
+        "The memory in MB per rank that monitors and other loss data sinks may use to keep "
+        "data in memory. The files are only opened once the buffer is full and at the end. "
+        "Default: 0 (write at every passage)",
+        lossBufferSize);
+
+    itsAttr[AUTOPHASECACHE] = Attributes::makeString(
+        "AUTOPHASECACHE",
+        "File in which the phases found by the autophasing are stored. Runs with the same "
+        "cavity, field map, amplitude, frequency and entry energy take the phase from this "
+        "file instead of searching it again. Default: empty (no caching)",
+        autoPhaseCache);
+
+    itsAttr[DESIGNPATHCACHE] = Attributes::makeString(
+        "DESIGNPATHCACHE",
+        "File in which the result of the orbit threading (positions of the elements along the "
+        "design path, design energies and phases of the cavities) is stored. Runs with the "
+        "same lattice, field maps, reference particle and time steps load it instead of "
+        "threading the orbit again. Default: empty (no caching)",
+        designPathCache);
+
+    itsAttr[ENSEMBLE] = Attributes::makeReal(
+        "ENSEMBLE",
+        "The number of independent replicas of the distribution that are sampled with "
+        "different random numbers and tracked together in one bunch. The space charge is "
+        "computed for each replica separately, their statistics are written to *.ensemble. "
+        "Only GAUSS and MULTIVARIATEGAUSS distributions can be replicated. The charge in "
+        "*.stat is the one of a single replica. Default: 1",
+        ensembleSize);
+
+    itsAttr[GEOMETRYCACHE] = Attributes::makeString(
+        "GEOMETRYCACHE",
+        "Directory in which the oriented triangle mesh and the voxelization of a "
+        "BOUNDARYGEOMETRY are stored. Runs with the same geometry file, scaling and voxel "
+        "size load them instead of computing them again. Default: empty (no caching)",
+        geometryCache);
+
+    itsAttr[PERFTRACE] = Attributes::makeReal(
+        "PERFTRACE",
+        "Every how many steps the times of the regions of the tracker and of the Kokkos "
+        "kernels are written per rank to *.trace.<rank>.json (Chrome trace format). A summary "
+        "of the load imbalance between the ranks is written to *.trace_summary next to them. "
+        "Default: 0 (no tracing)",
+        perfTraceInterval);
+
+    itsAttr[PERFTRACEKERNELS] = Attributes::makeBool(
+        "PERFTRACEKERNELS",
+        "If true, the performance trace records the Kokkos kernels through the Kokkos Tools "
+        "callbacks. Default: true",
+        perfTraceKernels);
+
+    itsAttr[MEMORYBUDGET] = Attributes::makeReal(
+        "MEMORYBUDGET",
+        "The memory in MB per rank, separately for host and device memory, that the particles, "
+        "fields, field solver, field maps, binning and I/O buffers may use. A warning is printed "
+        "when 90% of it is reached. Default: 0 (no check)",
+        memoryBudget);
+
+    itsAttr[COMPACTPARTICLES] = Attributes::makeBool(
+        "COMPACTPARTICLES",
+        "If true, the charge and the mass are looked up per species and all particles use the "
+        "time step of the bunch, the attributes Q, M and dt are neither stored nor exchanged "
+        "between the ranks. Has to be set before the bunch is created. Default: false",
+        compactParticles);
 
     registerOwnership(AttributeHandler::STATEMENT);
 
@@ -392,6 +535,25 @@ Option::Option(const std::string& name, Option* parent) : Action(name, parent) {
     Attributes::setReal(itsAttr[BINNINGALPHA], binningAlpha);
     Attributes::setReal(itsAttr[BINNINGBETA], binningBeta);
     Attributes::setReal(itsAttr[DESIREDWIDTH], desiredWidth);
+
+    Attributes::setReal(itsAttr[CELLSORTFREQ], cellSortFreq);
+    Attributes::setPredefinedString(itsAttr[CELLSORTCURVE], cellSortCurve);
+    Attributes::setPredefinedString(itsAttr[DEPOSITION], deposition);
+    Attributes::setReal(itsAttr[CHECKPOINTFREQ], checkpointFreq);
+    Attributes::setReal(itsAttr[SDDSFLUSHFREQ], sddsFlushFreq);
+    Attributes::setPredefinedString(itsAttr[STATFORMAT], statFormat);
+    Attributes::setReal(itsAttr[SLICES], numSlices);
+    Attributes::setString(itsAttr[SLICEFILTER], sliceFilter);
+    Attributes::setPredefinedString(itsAttr[LOSSFORMAT], lossFormat);
+    Attributes::setReal(itsAttr[LOSSBUFFERSIZE], lossBufferSize);
+    Attributes::setString(itsAttr[AUTOPHASECACHE], autoPhaseCache);
+    Attributes::setString(itsAttr[DESIGNPATHCACHE], designPathCache);
+    Attributes::setReal(itsAttr[ENSEMBLE], ensembleSize);
+    Attributes::setString(itsAttr[GEOMETRYCACHE], geometryCache);
+    Attributes::setReal(itsAttr[PERFTRACE], perfTraceInterval);
+    Attributes::setBool(itsAttr[PERFTRACEKERNELS], perfTraceKernels);
+    Attributes::setReal(itsAttr[MEMORYBUDGET], memoryBudget);
+    Attributes::setBool(itsAttr[COMPACTPARTICLES], compactParticles);
 }
 
 Option::~Option() {
@@ -419,6 +581,7 @@ void Option::execute() {
     version               = Attributes::getReal(itsAttr[VERSION]);
     seed                  = Attributes::getReal(itsAttr[SEED]);
     writeBendTrajectories = Attributes::getBool(itsAttr[LOGBENDTRAJECTORY]);
+    memoryDump            = Attributes::getBool(itsAttr[MEMORYDUMP]);
 
     haloShift          = Attributes::getReal(itsAttr[HALOSHIFT]);
     delPartFreq        = Attributes::getReal(itsAttr[DELPARTFREQ]);
@@ -429,6 +592,26 @@ void Option::execute() {
     binningBeta   = Attributes::getReal(itsAttr[BINNINGBETA]);
     desiredWidth  = Attributes::getReal(itsAttr[DESIREDWIDTH]);
 
+    cellSortFreq  = Attributes::getReal(itsAttr[CELLSORTFREQ]);
+    cellSortCurve = Attributes::getString(itsAttr[CELLSORTCURVE]);
+    deposition    = Attributes::getString(itsAttr[DEPOSITION]);
+    checkpointFreq = Attributes::getReal(itsAttr[CHECKPOINTFREQ]);
+    sddsFlushFreq  = Attributes::getReal(itsAttr[SDDSFLUSHFREQ]);
+    statFormat     = Attributes::getString(itsAttr[STATFORMAT]);
+    numSlices      = Attributes::getReal(itsAttr[SLICES]);
+    sliceFilter    = Attributes::getString(itsAttr[SLICEFILTER]);
+    lossFormat     = Attributes::getString(itsAttr[LOSSFORMAT]);
+    lossBufferSize = Attributes::getReal(itsAttr[LOSSBUFFERSIZE]);
+    autoPhaseCache  = Attributes::getString(itsAttr[AUTOPHASECACHE]);
+    designPathCache = Attributes::getString(itsAttr[DESIGNPATHCACHE]);
+    ensembleSize    = Attributes::getReal(itsAttr[ENSEMBLE]);
+    geometryCache   = Attributes::getString(itsAttr[GEOMETRYCACHE]);
+
+    perfTraceInterval = Attributes::getReal(itsAttr[PERFTRACE]);
+    perfTraceKernels  = Attributes::getBool(itsAttr[PERFTRACEKERNELS]);
+    memoryBudget      = Attributes::getReal(itsAttr[MEMORYBUDGET]);
+    compactParticles  = Attributes::getBool(itsAttr[COMPACTPARTICLES]);
+
     /// note: rangen is used only for the random number generator in the OPAL language
     ///       not for the distributions
 
@@ -551,6 +734,43 @@ void Option::execute() {
         desiredWidth = Attributes::getReal(itsAttr[DESIREDWIDTH]);
     }
 
+    if (itsAttr[CELLSORTFREQ]) {
+        cellSortFreq = int(Attributes::getReal(itsAttr[CELLSORTFREQ]));
+        cellSortFreq = (cellSortFreq < 0) ? 0 : cellSortFreq;
+    }
+
+    if (itsAttr[CHECKPOINTFREQ]) {
+        checkpointFreq = int(Attributes::getReal(itsAttr[CHECKPOINTFREQ]));
+        checkpointFreq = (checkpointFreq < 0) ? 0 : checkpointFreq;
+    }
+
+    if (itsAttr[SDDSFLUSHFREQ]) {
+        sddsFlushFreq = int(Attributes::getReal(itsAttr[SDDSFLUSHFREQ]));
+        sddsFlushFreq = (sddsFlushFreq < 1) ? 1 : sddsFlushFreq;
+    }
+
+    if (itsAttr[SLICES]) {
+        numSlices = int(Attributes::getReal(itsAttr[SLICES]));
+        numSlices = (numSlices < 0) ? 0 : numSlices;
+    }
+
+    if (itsAttr[ENSEMBLE]) {
+        ensembleSize = int(Attributes::getReal(itsAttr[ENSEMBLE]));
+        ensembleSize = std::clamp(ensembleSize, 1, int(std::numeric_limits<short>::max()));
+    }
+
+    if (itsAttr[PERFTRACE]) {
+        perfTraceInterval = std::max(int(Attributes::getReal(itsAttr[PERFTRACE])), 0);
+    }
+
+    if (itsAttr[MEMORYBUDGET]) {
+        memoryBudget = std::max(Attributes::getReal(itsAttr[MEMORYBUDGET]), 0.0);
+    }
+
+    if (itsAttr[LOSSBUFFERSIZE]) {
+        lossBufferSize = std::max(Attributes::getReal(itsAttr[LOSSBUFFERSIZE]), 0.0);
+    }
+
     // Set message flags.
     FileStream::setEcho(echo);
 
@@ -0,0 +1,265 @@
+//
+// Counter-based sampling
+//   Philox4x32-10 random numbers and a driver that samples a distribution
+//   particle by particle from the global particle index.
+//
+//   Every random number is a pure function of (seed, particle index, stream),
+//   i.e. any rank can reproduce any particle. Each rank creates a block of
+//   indices, the first bunch update moves the particles to their owners. As
+//   the position of a particle is only known once it is drawn, a rank can't
+//   restrict itself to the indices that land in its region. The mean is
+//   removed using fixed-point sums and the result does not depend on the
+//   number of ranks.
+//
+//   A sampler provides
+//     void operator()(uint64_t id, Vector_t<double, 3>& R, Vector_t<double, 3>& P) const;
+//   (callable on the device) and
+//     double bound(unsigned int d) const;
+//   an upper bound of |R_d| (d < 3) and |P_{d-3}| (d >= 3) on the host.
+//
+// This file is part of OPAL.
+//
+// OPAL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// You should have received a copy of the GNU General Public License
+// along with OPAL. If not, see <https://www.gnu.org/licenses/>.
+//
+#ifndef OPAL_COUNTER_BASED_SAMPLING_HPP
+#define OPAL_COUNTER_BASED_SAMPLING_HPP
+
+#include "SamplingBase.hpp"
+
+#include <Kokkos_Core.hpp>
+#include <mpi.h>
+
+#include <cmath>
+#include <cstdint>
+
+namespace CounterBasedSampling {
+
+    using counter_type = Kokkos::Array<uint32_t, 4>;
+
+    /// Philox4x32 with 10 rounds, see Salmon et al., SC'11
+    KOKKOS_INLINE_FUNCTION counter_type philox4x32(counter_type ctr, uint64_t seed) {
+        uint32_t key0 = static_cast<uint32_t>(seed);
+        uint32_t key1 = static_cast<uint32_t>(seed >> 32);
+        for (unsigned int round = 0; round < 10; ++round) {
+            const uint64_t p0 = static_cast<uint64_t>(0xD2511F53u) * ctr[0];
+            const uint64_t p1 = static_cast<uint64_t>(0xCD9E8D57u) * ctr[2];
+
+            counter_type next;
+            next[0] = static_cast<uint32_t>(p1 >> 32) ^ ctr[1] ^ key0;
+            next[1] = static_cast<uint32_t>(p1);
+            next[2] = static_cast<uint32_t>(p0 >> 32) ^ ctr[3] ^ key1;
+            next[3] = static_cast<uint32_t>(p0);
+            ctr     = next;
+
+            key0 += 0x9E3779B9u;
+            key1 += 0xBB67AE85u;
+        }
+        return ctr;
+    }
+
+    /// Uniform number in [0, 1) with 53 random bits
+    KOKKOS_INLINE_FUNCTION double toUnit(uint32_t a, uint32_t b) {
+        return ((a >> 5) * 67108864.0 + (b >> 6)) * (1.0 / 9007199254740992.0);
+    }
+
+    /// Cumulative distribution function of the standard normal distribution
+    KOKKOS_INLINE_FUNCTION double normalCDF(double x) {
+        return 0.5 * Kokkos::erfc(-x * 0.7071067811865476);
+    }
+
+    /// Inverse of normalCDF, Acklam's rational approximation refined by one Halley step
+    KOKKOS_INLINE_FUNCTION double inverseNormalCDF(double p) {
+        constexpr double a[] = {-3.969683028665376e+01, 2.209460984245205e+02,
+                                -2.759285104469687e+02, 1.383577518672690e+02,
+                                -3.066479806614716e+01, 2.506628277459239e+00};
+        constexpr double b[] = {-5.447609879822406e+01, 1.615858368580409e+02,
+                                -1.556989798598866e+02, 6.680131188771972e+01,
+                                -1.328068155288572e+01};
+        constexpr double c[] = {-7.784894002430293e-03, -3.223964580411365e-01,
+                                -2.400758277161838e+00, -2.549732539343734e+00,
+                                4.374664141464968e+00,  2.938163982698783e+00};
+        constexpr double d[] = {7.784695709041462e-03, 3.224671290700398e-01,
+                                2.445134137142996e+00, 3.754408661907416e+00};
+        constexpr double pLow = 0.02425;
+
+        if (p <= 0.0) {
+            return -Kokkos::Experimental::infinity_v<double>;
+        }
+        if (p >= 1.0) {
+            return Kokkos::Experimental::infinity_v<double>;
+        }
+
+        double x;
+        if (p < pLow || p > 1.0 - pLow) {
+            const double q = Kokkos::sqrt(-2.0 * Kokkos::log(p < pLow ? p : 1.0 - p));
+            x = (((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5])
+                / ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1.0);
+            if (p > 1.0 - pLow) {
+                x = -x;
+            }
+        } else {
+            const double q = p - 0.5;
+            const double r = q * q;
+            x = (((((a[0] * r + a[1]) * r + a[2]) * r + a[3]) * r + a[4]) * r + a[5]) * q
+                / (((((b[0] * r + b[1]) * r + b[2]) * r + b[3]) * r + b[4]) * r + 1.0);
+        }
+
+        const double e = normalCDF(x) - p;
+        const double u = e * 2.5066282746310002 * Kokkos::exp(0.5 * x * x);
+        return x - u / (1.0 + 0.5 * x * u);
+    }
+
+    /// Standard normal number of stream \p stream of particle \p id truncated to [lo, hi].
+    /// Drawn by rejection; if none of maxAttempts tries falls into [lo, hi] the CDF is
+    /// inverted instead.
+    KOKKOS_INLINE_FUNCTION double truncatedNormal(
+        uint64_t seed, uint64_t id, uint32_t stream, double lo, double hi) {
+        constexpr uint32_t maxAttempts = 64;
+        constexpr double twoPi         = 6.283185307179586;
+        counter_type ctr;
+        ctr[0] = static_cast<uint32_t>(id);
+        ctr[1] = static_cast<uint32_t>(id >> 32);
+        ctr[2] = stream;
+        for (uint32_t attempt = 0; attempt < maxAttempts; ++attempt) {
+            ctr[3]               = attempt;
+            const counter_type r = philox4x32(ctr, seed);
+
+            // Box-Muller, 1 - u is in (0, 1]
+            const double radius = Kokkos::sqrt(-2.0 * Kokkos::log(1.0 - toUnit(r[0], r[1])));
+            const double angle  = twoPi * toUnit(r[2], r[3]);
+            const double z0     = radius * Kokkos::cos(angle);
+            if (z0 >= lo && z0 <= hi) {
+                return z0;
+            }
+            const double z1 = radius * Kokkos::sin(angle);
+            if (z1 >= lo && z1 <= hi) {
+                return z1;
+            }
+        }
+
+        // the CDF is inverted in the lower tail where it is accurate
+        const bool mirror = lo > 0.0;
+        const double a    = mirror ? -hi : lo;
+        const double b    = mirror ? -lo : hi;
+        ctr[3]               = maxAttempts;
+        const counter_type r = philox4x32(ctr, seed);
+        const double cdfA    = normalCDF(a);
+        const double z = inverseNormalCDF(cdfA + toUnit(r[0], r[1]) * (normalCDF(b) - cdfA));
+        const double clamped = Kokkos::fmin(Kokkos::fmax(z, a), b);
+        return mirror ? -clamped : clamped;
+    }
+
+    /// Standard normal number of stream \p stream of particle \p id
+    KOKKOS_INLINE_FUNCTION double normal(uint64_t seed, uint64_t id, uint32_t stream) {
+        return truncatedNormal(
+            seed, id, stream, -Kokkos::Experimental::infinity_v<double>,
+            Kokkos::Experimental::infinity_v<double>);
+    }
+
+    /// Fixed-point sums of R and P
+    struct Statistics {
+        int64_t sum[6];
+    };
+
+    template <class Sampler>
+    struct StatisticsFunctor {
+        using value_type = Statistics;
+
+        Sampler sampler;
+        uint64_t first;
+        double scale[6];
+
+        KOKKOS_INLINE_FUNCTION void init(value_type& v) const {
+            for (unsigned int d = 0; d < 6; ++d) {
+                v.sum[d] = 0;
+            }
+        }
+
+        KOKKOS_INLINE_FUNCTION void join(value_type& dst, const value_type& src) const {
+            for (unsigned int d = 0; d < 6; ++d) {
+                dst.sum[d] += src.sum[d];
+            }
+        }
+
+        KOKKOS_INLINE_FUNCTION void operator()(const size_t i, value_type& v) const {
+            Vector_t<double, 3> R, P;
+            sampler(first + i, R, P);
+            for (unsigned int d = 0; d < 3; ++d) {
+                v.sum[d] += static_cast<int64_t>(Kokkos::round(R[d] * scale[d]));
+                v.sum[d + 3] += static_cast<int64_t>(Kokkos::round(P[d] * scale[d + 3]));
+            }
+        }
+    };
+
+    /**
+     * @brief Samples \p numberOfParticles particles with the given sampler.
+     *
+     * @param removeMeanP if true the mean momentum is subtracted as well
+     * @param avrgpz added to P_z after removing the mean
+     * @param firstIndex index of the first particle, the particles are appended to the
+     *        container, such that several ensemble members can be sampled one after another
+     */
+    template <class Sampler>
+    void generate(
+        ParticleContainer_t& pc, const Sampler& sampler, size_t numberOfParticles,
+        bool removeMeanP, double avrgpz, uint64_t firstIndex = 0) {
+        MPI_Comm comm    = ippl::Comm->getCommunicator();
+        const int rank   = ippl::Comm->rank();
+        const int nranks = ippl::Comm->size();
+        const uint64_t N = numberOfParticles;
+
+        if (N == 0) {
+            return;
+        }
+
+        // moments from the block of indices of this rank, the fixed-point scale
+        // leaves room for N summands
+        StatisticsFunctor<Sampler> functor;
+        functor.sampler = sampler;
+        functor.first   = firstIndex + N * rank / nranks;
+        const int bits  = 62 - static_cast<int>(std::ceil(std::log2(N + 1.0)));
+        for (unsigned int d = 0; d < 6; ++d) {
+            const double bound = sampler.bound(d);
+            functor.scale[d]   = bound > 0.0 ? std::ldexp(1.0, bits) / bound : 0.0;
+        }
+        const uint64_t blockSize = firstIndex + N * (rank + 1) / nranks - functor.first;
+
+        Statistics stats;
+        Kokkos::parallel_reduce("CounterBasedSampling::statistics", blockSize, functor, stats);
+        MPI_Allreduce(MPI_IN_PLACE, stats.sum, 6, MPI_INT64_T, MPI_SUM, comm);
+
+        Vector_t<double, 3> meanR, meanP;
+        for (unsigned int d = 0; d < 3; ++d) {
+            meanR[d] = functor.scale[d] > 0.0 ? stats.sum[d] / functor.scale[d] / N : 0.0;
+            meanP[d] = (removeMeanP && functor.scale[d + 3] > 0.0)
+                           ? stats.sum[d + 3] / functor.scale[d + 3] / N
+                           : 0.0;
+        }
+        meanP[2] -= avrgpz;
+
+        const size_t offset  = pc.getLocalNum();
+        const uint64_t first = functor.first;
+        pc.create(blockSize);
+
+        auto Rview  = pc.R.getView();
+        auto Pview  = pc.P.getView();
+        auto IDview = pc.ID.getView();
+        Kokkos::parallel_for(
+            "CounterBasedSampling::block", blockSize, KOKKOS_LAMBDA(const size_t k) {
+                Vector_t<double, 3> R, P;
+                sampler(first + k, R, P);
+                Rview(offset + k)  = R - meanR;
+                Pview(offset + k)  = P - meanP;
+                IDview(offset + k) = first + k;
+            });
+        Kokkos::fence();
+    }
+}  // namespace CounterBasedSampling
+
+#endif  // OPAL_COUNTER_BASED_SAMPLING_HPP
@@ -62,7 +62,8 @@ using view_type = typename ippl::detail::ViewType<ippl::Vector<double, Dim>, 1>:
 namespace DISTRIBUTION {
     enum { TYPE, FNAME, SIGMAX, SIGMAY, SIGMAZ, SIGMAPX, SIGMAPY, SIGMAPZ, CORR,
            CUTOFFPX, CUTOFFPY, CUTOFFPZ, CUTOFFX, CUTOFFY, CUTOFFLONG, CORRX, CORRY,
-           CORRZ, CORRT, SIGMAT, TPULSEFWHM, TRISE, TFALL, FTOSCAMPLITUDE, FTOSCPERIODS, EMITTED, SIZE };
+           CORRZ, CORRT, SIGMAT, TPULSEFWHM, TRISE, TFALL, FTOSCAMPLITUDE, FTOSCPERIODS, EMITTED,
+           LASERPROFFN, IMAGENAME, INTENSITYCUT, FLIPX, FLIPY, ROTATE90, ROTATE180, ROTATE270, NBIN, SIZE };
 }
 
 /*
@@ -131,6 +132,28 @@ Distribution::Distribution()
         = Attributes::makeBool("EMITTED", "Emitted beam, from cathode, as opposed to "
                                "an injected beam.", false);
 
+    itsAttr[DISTRIBUTION::LASERPROFFN]
+        = Attributes::makeString("LASERPROFFN", "File containing a measured laser image "
+                                 "profile (x,y) to sample the emitted FLATTOP distribution from.", "");
+    itsAttr[DISTRIBUTION::IMAGENAME]
+        = Attributes::makeString("IMAGENAME", "Name of the laser image in an HDF5 file.", "");
+    itsAttr[DISTRIBUTION::INTENSITYCUT]
+        = Attributes::makeReal("INTENSITYCUT", "Relative intensity cut off for laser image.", 0.0);
+    itsAttr[DISTRIBUTION::FLIPX]
+        = Attributes::makeBool("FLIPX", "Flip laser profile horizontally.", false);
+    itsAttr[DISTRIBUTION::FLIPY]
+        = Attributes::makeBool("FLIPY", "Flip laser profile vertically.", false);
+    itsAttr[DISTRIBUTION::ROTATE90]
+        = Attributes::makeBool("ROTATE90", "Rotate laser profile 90 degrees counter clockwise.", false);
+    itsAttr[DISTRIBUTION::ROTATE180]
+        = Attributes::makeBool("ROTATE180", "Rotate laser profile 180 degrees counter clockwise.", false);
+    itsAttr[DISTRIBUTION::ROTATE270]
+        = Attributes::makeBool("ROTATE270", "Rotate laser profile 270 degrees counter clockwise.", false);
+
+    itsAttr[DISTRIBUTION::NBIN]
+        = Attributes::makeReal("NBIN", "Number of energy bins of an emitted beam, the particles "
+                               "emitted in the same fraction of the emission time share a bin.", 0.0);
+
     registerOwnership(AttributeHandler::STATEMENT);
 }
 
@@ -376,6 +399,22 @@ void Distribution::setDistParametersFlatTop() {
         // For an emitted beam, the longitudinal cutoff >= 0.
         cutoffR_m[2] = std::abs(cutoffR_m[2]);
 
+        numberOfEnergyBins_m = std::abs(Attributes::getReal(itsAttr[DISTRIBUTION::NBIN]));
+    }
+
+    // The transverse profile of an emitted beam can be taken from a laser image.
+    const std::string laserProfileFileName = Attributes::getString(itsAttr[DISTRIBUTION::LASERPROFFN]);
+    if (!laserProfileFileName.empty()) {
+        short flags = 0;
+        if (Attributes::getBool(itsAttr[DISTRIBUTION::FLIPX])) flags |= LaserProfile::FLIPX;
+        if (Attributes::getBool(itsAttr[DISTRIBUTION::FLIPY])) flags |= LaserProfile::FLIPY;
+        if (Attributes::getBool(itsAttr[DISTRIBUTION::ROTATE90])) flags |= LaserProfile::ROTATE90;
+        if (Attributes::getBool(itsAttr[DISTRIBUTION::ROTATE180])) flags |= LaserProfile::ROTATE180;
+        if (Attributes::getBool(itsAttr[DISTRIBUTION::ROTATE270])) flags |= LaserProfile::ROTATE270;
+
+        laserProfile_m = std::make_shared<LaserProfile>(
+            laserProfileFileName, Attributes::getString(itsAttr[DISTRIBUTION::IMAGENAME]),
+            std::abs(Attributes::getReal(itsAttr[DISTRIBUTION::INTENSITYCUT])), flags);
     }
     /*
     cutoffR_m = Vector_t(Attributes::getReal(itsAttr[Attrib::Distribution::CUTOFFX]),
@@ -422,24 +461,6 @@ void Distribution::setDistParametersFlatTop() {
         cutoffR_m[2] = std::abs(cutoffR_m[2]);
     }
 
-    // Set laser profile/
-    laserProfileFileName_m = Attributes::getString(itsAttr[Attrib::Distribution::LASERPROFFN]);
-    if (!(laserProfileFileName_m == std::string(""))) {
-        laserImageName_m = Attributes::getString(itsAttr[Attrib::Distribution::IMAGENAME]);
-        laserIntensityCut_m = std::abs(Attributes::getReal(itsAttr[Attrib::Distribution::INTENSITYCUT]));
-        short flags = 0;
-        if (Attributes::getBool(itsAttr[Attrib::Distribution::FLIPX])) flags |= LaserProfile::FLIPX;
-        if (Attributes::getBool(itsAttr[Attrib::Distribution::FLIPY])) flags |= LaserProfile::FLIPY;
-        if (Attributes::getBool(itsAttr[Attrib::Distribution::ROTATE90])) flags |= LaserProfile::ROTATE90;
-        if (Attributes::getBool(itsAttr[Attrib::Distribution::ROTATE180])) flags |= LaserProfile::ROTATE180;
-        if (Attributes::getBool(itsAttr[Attrib::Distribution::ROTATE270])) flags |= LaserProfile::ROTATE270;
-
-        laserProfile_m = new LaserProfile(laserProfileFileName_m,
-                                          laserImageName_m,
-                                          laserIntensityCut_m,
-                                          flags);
-    }
-
     // Legacy for ASTRAFLATTOPTH.
     if (distrTypeT_m == DistributionType::ASTRAFLATTOPTH)
         tRise_m = std::abs(Attributes::getReal(itsAttr[Attrib::Distribution::TRISE]));
@@ -489,6 +510,10 @@ void Distribution::printDistFlatTop(Inform& os)  const {
     os << "* " << endl;
     os << "* SIGMAX     = " << sigmaR_m[0] << " [m]" << endl;
     os << "* SIGMAY     = " << sigmaR_m[1] << " [m]" << endl;
+    if (laserProfile_m) {
+        os << "* Transverse profile from laser image "
+           << Attributes::getString(itsAttr[DISTRIBUTION::LASERPROFFN]) << endl;
+    }
 
     if (emitting_m) {
             os << "* Sigma Time Rise               = " << sigmaTRise_m
@@ -499,6 +524,7 @@ void Distribution::printDistFlatTop(Inform& os)  const {
                << " [sec]" << endl;
             os << "* Longitudinal cutoff           = " << cutoffR_m[2]
                << " [units of Sigma Time]" << endl;
+            os << "* Number of energy bins         = " << numberOfEnergyBins_m << endl;
             //os << "* Flat top modulation amplitude = "
             //   << Attributes::getReal(itsAttr[DISTRIBUTION::FTOSCAMPLITUDE])
             //   << " [Percent of distribution amplitude]" << endl;
@@ -48,6 +48,7 @@
 class Beam;
 class Beamline;
 class H5PartWrapper;
+class LaserProfile;
 
 enum class DistributionType : short { NODIST = -1, GAUSS, MULTIVARIATEGAUSS, FLATTOP, FROMFILE };
 
@@ -116,6 +117,11 @@ public:
     double getTEmission() const;
     void setTEmission(double tEmission);
 
+    /// Measured transverse profile of an emitted beam, nullptr if not given
+    std::shared_ptr<LaserProfile> getLaserProfile() const;
+
+    int getNumberOfEnergyBins() const;
+
 private:
     enum class EmissionModel : unsigned short { NONE, ASTRA, NONEQUIL };
 
@@ -223,6 +229,10 @@ private:
     double FTOSCPeriods_m;
 
     double tEmission_m;
+
+    std::shared_ptr<LaserProfile> laserProfile_m;
+
+    int numberOfEnergyBins_m = 0;
 };
 
 inline Inform& operator<<(Inform& os, const Distribution& d) {
@@ -285,6 +295,14 @@ inline std::string Distribution::getTypeofDistribution() {
     return distT_m;
 }
 
+inline std::shared_ptr<LaserProfile> Distribution::getLaserProfile() const {
+    return laserProfile_m;
+}
+
+inline int Distribution::getNumberOfEnergyBins() const {
+    return numberOfEnergyBins_m;
+}
+
 #endif  
 /*
 // OPAL_Distribution_HH
@@ -1,6 +1,7 @@
 #include "Distribution.h"
 #include "SamplingBase.hpp"
 #include "FlatTop.h"
+#include <algorithm>
 #include <memory>
 #include <cmath>
 
@@ -35,6 +36,7 @@ size_t FlatTop::determineRandInit() {
 
 void FlatTop::setParameters(const std::shared_ptr<Distribution_t> &opalDist) {
     emitting_m = opalDist->emitting_m;
+    laserProfile_m = opalDist->getLaserProfile();
     // time span of fall is [0, riseTime, riseTime+flattopTime, fallTime+flattopTime+riseTime ]
     sigmaTFall_m = opalDist_m->getSigmaTFall();
     sigmaTRise_m = opalDist_m->getSigmaTRise();
@@ -74,6 +76,34 @@ void FlatTop::generateUniformDisk(size_type nlocal, size_t nNew) {
 
     double pi = Physics::pi;
     Vector_t<double, 3> sigmaR = opalDist_m->getSigmaR();
+
+    if (laserProfile_m) {
+        // Sample (Rx,Ry) from the laser image in units of its standard deviation, then
+        // scale with sigmaRx and sigmaRy, set Px=Py=0
+        const LaserProfileSampler<> sampler = laserProfile_m->getSampler();
+        Kokkos::parallel_for(
+            "laserProfile", Kokkos::RangePolicy<>(nlocal, nlocal + nNew), KOKKOS_LAMBDA(const size_t j) {
+                auto generator = rand_pool.get_state();
+                const double u0 = generator.drand(0., 1.);
+                const double u1 = generator.drand(0., 1.);
+                const double u2 = generator.drand(0., 1.);
+                const double u3 = generator.drand(0., 1.);
+                rand_pool.free_state(generator);
+
+                double x, y;
+                sampler.sample(u0, u1, u2, u3, x, y);
+
+                Rview(j)[0] = x * sigmaR[0];
+                Rview(j)[1] = y * sigmaR[1];
+                Rview(j)[2] = 0.0;
+                Pview(j)[0] = 0.0;
+                Pview(j)[1] = 0.0;
+                Pview(j)[2] = 0.0;
+            });
+        Kokkos::fence();
+        return;
+    }
+
     // Sample (Rx,Ry) on a unit ring, then scale with sigmaRx and sigmaRy, set Px=Py=0
     Kokkos::parallel_for(
                "unitDisk", Kokkos::RangePolicy<>(nlocal, nlocal+nNew), KOKKOS_LAMBDA(const size_t j) {
@@ -176,11 +206,15 @@ void FlatTop::initDomainDecomp(double BoxIncr) {
 }
 
 double FlatTop::countEnteringParticlesPerRank(double t0, double tf){
-    size_type nlocalNew=0;
     double tArea = 0.0;
     tArea = integrateTrapezoidal(t0, tf, FlatTopProfile(t0), FlatTopProfile(tf));
     size_type totalNew = floor(totalN_m * tArea / distArea_m);
-    nlocalNew = 0;
+
+    return distributeAmongRanks(totalNew, t0, tf);
+}
+
+FlatTop::size_type FlatTop::distributeAmongRanks(size_type totalNew, double t0, double tf){
+    size_type nlocalNew = 0;
 
     if(totalNew>0){
         if(!withDomainDecomp_m){
@@ -237,7 +271,7 @@ double FlatTop::countEnteringParticlesPerRank(double t0, double tf){
                 if (x2 >= x1 && y2 >= y1 && z2 >= z1) {
                     double locpvolume = (x2 - x1) * (y2 - y1) * (z2 - z1);
                     if (globalpvolume > 0) {
-                        nlocalNew = static_cast<int>(totalNew * locpvolume / globalpvolume);
+                        nlocalNew = std::floor(totalNew * locpvolume / globalpvolume);
                     }
                     else{
                         nlocalNew = 0;
@@ -246,6 +280,13 @@ double FlatTop::countEnteringParticlesPerRank(double t0, double tf){
                     nlocalNew = 0;
                 }
             }
+
+            // the particles lost by rounding down the shares are emitted by the last rank
+            size_type assigned = nlocalNew;
+            ippl::Comm->allreduce(&assigned, 1, std::plus<size_type>());
+            if (ippl::Comm->rank() == ippl::Comm->size() - 1 && assigned < totalNew) {
+                nlocalNew += totalNew - assigned;
+            }
         }
     }
     return nlocalNew;
@@ -261,23 +302,122 @@ void FlatTop::allocateParticles(size_t numberOfParticles){
     pc_m->create(nlocal);
 }
 
-void FlatTop::emitParticles(double t, double dt) {
+void FlatTop::setupEmissionSchedule(double t, double dt) {
     extern Inform* gmsg;
 
-    // count number of new particles to be emitted
-    size_type nNew = countEnteringParticlesPerRank(t, t + dt);
+    // the steps of the previous schedule up to the last emission have been emitted
+    if (scheduleDt_m > 0.0) {
+        scheduleStart_m      = t;
+        scheduleStepOffset_m = emittedSteps_m;
+    }
+    scheduleDt_m = dt;
+    emissionSchedule_m.clear();
+    scheduleTargets_m.clear();
+    if (!emitting_m || dt <= 0.0 || scheduleStart_m >= emissionTime_m) {
+        return;
+    }
+
+    const size_type numSteps = std::ceil((emissionTime_m - scheduleStart_m) / dt);
+    emissionSchedule_m.resize(numSteps, 0);
+    scheduleTargets_m.resize(numSteps, 0);
+
+    std::vector<double> area(numSteps);
+    double remainingArea = 0.0;
+    for (size_type k = 0; k < numSteps; ++k) {
+        const double t0 = scheduleStart_m + k * dt;
+        const double tf = t0 + dt;
+        remainingArea += integrateTrapezoidal(t0, tf, FlatTopProfile(t0), FlatTopProfile(tf));
+        area[k] = remainingArea;
+    }
+
+    // Round the cumulative number of emitted particles rather than the number of every step,
+    // s.t. exactly totalN_m particles are emitted.
+    const size_type remaining = totalN_m - totalEmitted_m;
+    size_type totalEmitted = totalEmitted_m, localEmitted = 0;
+    for (size_type k = 0; k < numSteps; ++k) {
+        const double t0 = scheduleStart_m + k * dt;
+        const double tf = t0 + dt;
+
+        size_type target = totalN_m;
+        if (k + 1 < numSteps && remainingArea > 0.0) {
+            const size_type share = std::floor(remaining * area[k] / remainingArea);
+            target                = totalEmitted_m + std::min(remaining, share);
+        }
+        emissionSchedule_m[k] = distributeAmongRanks(target - totalEmitted, t0, tf);
+        scheduleTargets_m[k]  = target;
+        totalEmitted = target;
+        localEmitted += emissionSchedule_m[k];
+    }
+
+    pc_m->reserve(pc_m->getLocalNum() + localEmitted);
+
+    *gmsg << "* Emission of " << remaining << " particles in " << numSteps << " steps" << endl;
+}
+
+void FlatTop::emitParticles(double t, double dt) {
+    if (std::abs(dt - scheduleDt_m) > 1e-9 * std::abs(dt)) {
+        setupEmissionSchedule(t, dt);
+    }
+    if (emissionSchedule_m.empty()) {
+        return;
+    }
+
+    const long step = std::lround((t - scheduleStart_m) / scheduleDt_m);
+    if (step < 0 || static_cast<size_t>(step) >= emissionSchedule_m.size()) {
+        return;
+    }
+    const size_t k = step;
+    emittedSteps_m = scheduleStepOffset_m + k + 1;
+    totalEmitted_m = scheduleTargets_m[k];
+
+    size_type nNew = emissionSchedule_m[k];
+    if (nNew == 0) {
+        return;
+    }
 
     // current number of particles per rank
     size_type nlocal = pc_m->getLocalNum();
 
-    // extend particle container to accomodate new particles
+    // the capacity is reserved, this only moves the end of the active range
     pc_m->create(nNew);
 
     // generate new particles on uniform disc
-    *gmsg << "* generate particles on a disc" << endl;
     generateUniformDisk(nlocal, nNew);
+}
+
+bool FlatTop::isEmitting(double t) const {
+    return emitting_m && t >= 0.0 && t < emissionTime_m;
+}
+
+size_t FlatTop::getNumberOfEmissionSteps() const {
+    return scheduleStepOffset_m + emissionSchedule_m.size();
+}
+
+size_t FlatTop::getLastEmissionStep() const {
+    return emittedSteps_m > 0 ? emittedSteps_m - 1 : 0;
+}
+
+size_t FlatTop::getNumberOfEmittedParticles() const {
+    return totalEmitted_m;
+}
+
+size_t FlatTop::getNumberOfEmittedSteps() const {
+    return emittedSteps_m;
+}
+
+void FlatTop::resumeEmission(
+    size_t numberOfParticles, size_t emittedParticles, size_t emittedSteps, double t) {
+    totalN_m       = numberOfParticles;
+    totalEmitted_m = emittedParticles;
+    emittedSteps_m = emittedSteps;
+
+    // the next schedule starts at the checkpoint, see setupEmissionSchedule
+    scheduleDt_m         = 0.0;
+    scheduleStart_m      = t;
+    scheduleStepOffset_m = emittedSteps;
 
-    *gmsg << "* new particles emmitted" << endl;
+    // the state of the random pool isn't stored, don't draw the numbers of the first steps again
+    rand_pool_m = GeneratorPool(determineRandInit() + emittedSteps);
 }
 
 void FlatTop::testNumEmitParticles(size_type nsteps, double dt) {
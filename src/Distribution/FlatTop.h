@@ -8,12 +8,14 @@
 
 #include "Distribution.h"
 #include "SamplingBase.hpp"
+#include "LaserProfile.h"
 #include <Kokkos_Random.hpp>
 #include "Ippl.h"
 #include "Utilities/Options.h"
 #include "OPALTypes.h"
 #include <memory>
 #include <cmath>
+#include <vector>
 
 using ParticleContainer_t = ParticleContainer<double, 3>;
 using FieldContainer_t = FieldContainer<double, 3>;
@@ -70,10 +72,18 @@ private:
     double riseTime_m; ///< Time duration for the rise phase.
     bool emitting_m; ///< Flag for particle emission status.
     size_type totalN_m; ///< Total number of particles.
-    bool withDomainDecomp_m; ///< Flag for domain decomposition.
+    bool withDomainDecomp_m = false; ///< Flag for domain decomposition.
     double emissionTime_m; ///< Total emission time.
     Vector_t<double, 3> nr_m; ///< Number of grid points per direction.
     Vector_t<double, 3> hr_m; ///< Grid spacing.
+    std::shared_ptr<LaserProfile> laserProfile_m; ///< Measured transverse profile, if any.
+    std::vector<size_type> emissionSchedule_m; ///< Number of local particles emitted per step.
+    std::vector<size_type> scheduleTargets_m; ///< Number of particles of all ranks emitted after every step.
+    double scheduleDt_m = 0.0; ///< Time step the emission schedule was computed for.
+    double scheduleStart_m = 0.0; ///< Start time of the first step of the emission schedule.
+    size_type scheduleStepOffset_m = 0; ///< Steps emitted before the emission schedule was computed.
+    size_type totalEmitted_m = 0; ///< Number of particles emitted by all ranks so far.
+    size_type emittedSteps_m = 0; ///< Number of emission steps up to the last emission.
 
     /**
      * @brief Sets whether to use domain decomposition.
@@ -81,6 +91,24 @@ private:
      */
     void setWithDomainDecomp(bool withDomainDecomp) override;
 
+    /**
+     * @brief Splits the particles emitted globally in [t0, tf] among the ranks.
+     * @param totalNew Number of particles emitted by all ranks.
+     * @param t0 Start time.
+     * @param tf End time.
+     * @return Number of particles emitted by this rank.
+     */
+    size_type distributeAmongRanks(size_type totalNew, double t0, double tf);
+
+    /**
+     * @brief Computes the number of local particles of every remaining emission step and
+     *        reserves the memory for all of them at once. The particles emitted so far are
+     *        not emitted again when the time step changes during the emission.
+     * @param t Start time of the schedule, the first schedule starts at 0.
+     * @param dt Time step.
+     */
+    void setupEmissionSchedule(double t, double dt);
+
     /**
      * @brief Determines the random seed initialization.
      * @return The seed value.
@@ -95,7 +123,8 @@ private:
 
 public:
     /**
-     * @brief Generates particles (x,y) uniformly on a disk distribution.
+     * @brief Generates particles (x,y) uniformly on a disk distribution, or from
+     *        the laser image if the distribution has one.
      * @param nlocal Number of local particles.
      * @param nNew Number of new particles to generate.
      */
@@ -159,11 +188,35 @@ public:
     void allocateParticles(size_t numberOfParticles);
 
     /**
-     * @brief Emits new particles within a given time interval.
+     * @brief Emits new particles within a given time interval. The particles of
+     *        the step are written in place into the memory that was reserved for
+     *        the whole emission, see setupEmissionSchedule.
      * @param t Start time.
      * @param dt Time step.
      */
     void emitParticles(double t, double dt) override;
+
+    bool isEmitting(double t) const override;
+
+    size_t getNumberOfEmissionSteps() const override;
+
+    size_t getLastEmissionStep() const override;
+
+    size_t getNumberOfEmittedParticles() const override;
+
+    size_t getNumberOfEmittedSteps() const override;
+
+    /**
+     * @brief Restores the emission state of a checkpoint, the remaining particles are
+     *        scheduled from time t on when the next step emits.
+     * @param numberOfParticles Total number of particles of the emission.
+     * @param emittedParticles Number of particles of all ranks emitted before the checkpoint.
+     * @param emittedSteps Number of emission steps up to the last emission.
+     * @param t Time of the checkpoint.
+     */
+    void resumeEmission(
+        size_t numberOfParticles, size_t emittedParticles, size_t emittedSteps,
+        double t) override;
 };
 
 #endif // IPPL_FLAT_TOP_H
@@ -1,6 +1,7 @@
 #include "Distribution.h"
 #include "SamplingBase.hpp"
 #include "Gaussian.h"
+#include "CounterBasedSampling.hpp"
 #include <memory>
 #include <cmath>
 
@@ -18,9 +19,37 @@ Gaussian::Gaussian(std::shared_ptr<ParticleContainer_t> &pc,
     samperTimer_m = IpplTimings::getTimer("SamplingTimer");
 }
 
+namespace {
+    /// R_d ~ SigmaR_d * N(0, 1) truncated to CutoffR_d, P_d ~ SigmaP_d * N(0, 1)
+    struct GaussianSampler {
+        uint64_t seed;
+        Vector_t<double, 3> sigmaR;
+        Vector_t<double, 3> cutoffR;
+        Vector_t<double, 3> sigmaP;
+
+        KOKKOS_INLINE_FUNCTION void operator()(
+            uint64_t id, Vector_t<double, 3>& R, Vector_t<double, 3>& P) const {
+            for (unsigned int d = 0; d < 3; ++d) {
+                R[d] = sigmaR[d]
+                       * CounterBasedSampling::truncatedNormal(
+                           seed, id, d, -cutoffR[d], cutoffR[d]);
+                P[d] = sigmaP[d] * CounterBasedSampling::normal(seed, id, 3 + d);
+            }
+        }
+
+        double bound(unsigned int d) const {
+            // Box-Muller with 53 bit uniforms gives |z| < 8.6
+            return d < 3 ? sigmaR[d] * cutoffR[d] : 8.6 * sigmaP[d - 3];
+        }
+    };
+}  // namespace
+
 /**
  * @brief Generates particles following a Gaussian distribution.
  *
+ * The random numbers of a particle only depend on the seed and the global
+ * particle index, i.e. the distribution is the same for any number of ranks.
+ *
  * @param numberOfParticles The total number of particles to generate.
  * @param nr The number of grid points in each dimension (not used here).
  */
@@ -29,108 +58,23 @@ void Gaussian::generateParticles(size_t& numberOfParticles, Vector_t<double, 3>
 
     IpplTimings::startTimer(samperTimer_m);
 
-    size_t randInit;
-
+    uint64_t seed;
     if (Options::seed == -1) {
-        randInit = 1234567;
-        *gmsg << "* Seed = " << randInit << " on all ranks" << endl;
+        seed = 1234567;
+        *gmsg << "* Seed = " << seed << " on all ranks" << endl;
     } else {
-        randInit = static_cast<size_t>(Options::seed + 100 * ippl::Comm->rank());
+        seed = static_cast<uint64_t>(Options::seed);
     }
 
-    GeneratorPool rand_pool64(randInit);
-
-    double mu[3], sd[3];
-
-    Vector_t<double, 3> rmin = -opalDist_m->getCutoffR();
-    Vector_t<double, 3> rmax = opalDist_m->getCutoffR();
+    GaussianSampler sampler;
+    sampler.seed    = seed;
+    sampler.sigmaR  = opalDist_m->getSigmaR();
+    sampler.cutoffR = opalDist_m->getCutoffR();
+    sampler.sigmaP  = opalDist_m->getSigmaP();
 
-    for (int i = 0; i < 3; i++) {
-        mu[i] = 0.0;
-        sd[i] = opalDist_m->getSigmaR()[i];
-        rmin(i) = (rmin(i) + mu[i]) * opalDist_m->getSigmaR()[i];
-        rmax(i) = (rmax(i) + mu[i]) * opalDist_m->getSigmaR()[i];
-    }
-
-    view_type &Rview = pc_m->R.getView();
-    const double par[6] = {mu[0], sd[0], mu[1], sd[1], mu[2], sd[2]};
-
-    using Dist_t = ippl::random::NormalDistribution<double, 3>;
-    using sampling_t = ippl::random::InverseTransformSampling<double, 3, Kokkos::DefaultExecutionSpace, Dist_t>;
-    Dist_t dist(par);
-
-    MPI_Comm comm = MPI_COMM_WORLD;
-    int nranks, rank;
-    MPI_Comm_size(comm, &nranks);
-    MPI_Comm_rank(comm, &rank);
-
-    size_t nlocal = floor(numberOfParticles / nranks);
-    size_t remaining = numberOfParticles - nlocal * nranks;
-
-    if (remaining > 0 && rank == 0) {
-        nlocal += remaining;
-    }
-
-    sampling_t sampling(dist, rmax, rmin, rmax, rmin, nlocal);
-    nlocal = sampling.getLocalSamplesNum();
-    pc_m->create(nlocal);
-    sampling.generate(Rview, rand_pool64);
-
-    double meanR[3], loc_meanR[3];
-    for(int i=0; i<3; i++){
-        meanR[i] = 0.0;
-        loc_meanR[i] = 0.0;
-    }
-
-    Kokkos::parallel_reduce(
-            "calc moments of particle distr.", nlocal,
-            KOKKOS_LAMBDA(
-                    const int k, double& cent0, double& cent1, double& cent2) {
-                    cent0 += Rview(k)[0];
-                    cent1 += Rview(k)[1];
-                    cent2 += Rview(k)[2];
-            },
-            Kokkos::Sum<double>(loc_meanR[0]), Kokkos::Sum<double>(loc_meanR[1]), Kokkos::Sum<double>(loc_meanR[2]));
-    Kokkos::fence();
-
-    MPI_Allreduce(loc_meanR, meanR, 3, MPI_DOUBLE, MPI_SUM, ippl::Comm->getCommunicator());
-    ippl::Comm->barrier();
-
-    for(int i=0; i<3; i++){
-       meanR[i] = meanR[i]/(1.0*numberOfParticles);
-    }
-
-    Kokkos::parallel_for(
-                nlocal, KOKKOS_LAMBDA(
-                    const int k) {
-                    Rview(k)[0] -= meanR[0];
-                    Rview(k)[1] -= meanR[1];
-                    Rview(k)[2] -= meanR[2];
-                }
-    );
-    Kokkos::fence();
-
-    for (int i = 0; i < 3; i++) {
-        mu[i] = 0.0;
-        sd[i] = opalDist_m->getSigmaP()[i];
-    }
-
-    view_type &Pview = pc_m->P.getView();
-    Kokkos::parallel_for(
-        nlocal,
-        ippl::random::randn<double, 3>(Pview, rand_pool64, mu, sd)
-    );
-    Kokkos::fence();
-
-    double avrgpz = opalDist_m->getAvrgpz();
-    Kokkos::parallel_for(
-        nlocal,
-        KOKKOS_LAMBDA(const int k) {
-            Pview(k)[2] += avrgpz;
-        }
-    );
-    Kokkos::fence();
+    CounterBasedSampling::generate(
+        *pc_m, sampler, numberOfParticles, false, opalDist_m->getAvrgpz(),
+        ensembleMember_m * static_cast<uint64_t>(numberOfParticles));
 
     IpplTimings::stopTimer(samperTimer_m);
 }
-
@@ -35,6 +35,9 @@ using Dist_t = ippl::random::NormalDistribution<double, 3>;
  * Here, R is sampled in a bounded domains R \in [-CutoffR*SigmaR, CutoffR*SigmaR]^3
  * and corrected by translation to ensure mean = [0,0,0].
  *
+ * The samples are drawn with a counter-based generator keyed by the global particle
+ * index.
+ *
  * @param numberOfParticles The total number of particles to generate.
  * @param nr The number of grid points in each dimension (not used here).
  */
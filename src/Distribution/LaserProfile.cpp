@@ -19,10 +19,12 @@
 
 #include <boost/filesystem.hpp>
 
+#include <algorithm>
 #include <cmath>
 #include <cstdio>
 #include <fstream>
 #include <iostream>
+#include <vector>
 
 // #define TESTLASEREMISSION
 
@@ -32,7 +34,6 @@ LaserProfile::LaserProfile(
       sizeY_m(0),
       hist2d_m(nullptr),
       rng_m(nullptr),
-      pdf_m(nullptr),
       centerMass_m(0.0),
       standardDeviation_m(0.0) {
     unsigned short* image = readFile(fileName, imageName);
@@ -60,6 +61,7 @@ LaserProfile::LaserProfile(
     computeProfileStatistics(image);
     // saveData("processedLaserProfile", image);
     fillHistrogram(image);
+    fillAliasTable();
 
     delete[] image;
 
@@ -74,7 +76,6 @@ LaserProfile::LaserProfile(
 }
 
 LaserProfile::~LaserProfile() {
-    gsl_histogram2d_pdf_free(pdf_m);
     gsl_histogram2d_free(hist2d_m);
     gsl_rng_free(rng_m);
 }
@@ -303,16 +304,115 @@ void LaserProfile::fillHistrogram(unsigned short* image) {
     saveHistogram();
 }
 
-void LaserProfile::setupRNG() {
-    unsigned int histSizeX = hist2d_m->nx, histSizeY = hist2d_m->ny;
+LaserProfileSampler<Kokkos::HostSpace> makeLaserProfileSampler(
+    const double* bins, unsigned int nx, unsigned int ny, double xmin, double ymin, double dx,
+    double dy) {
+    const unsigned int numBins = nx * ny;
+
+    double sum = 0.0;
+    for (unsigned int k = 0; k < numBins; ++k) {
+        sum += bins[k];
+    }
+    if (!(sum > 0.0)) {
+        throw OpalException("makeLaserProfileSampler", "laser profile has no intensity");
+    }
+
+    // Vose's variant of Walker's alias method; the bins are stored as bin[i * ny + j]
+    LaserProfileSampler<Kokkos::HostSpace> sampler;
+    sampler.probability_m =
+        Kokkos::View<double*, Kokkos::HostSpace>("laserAliasProbability", numBins);
+    sampler.alias_m = Kokkos::View<unsigned int*, Kokkos::HostSpace>("laserAlias", numBins);
+    auto& probability = sampler.probability_m;
+    auto& alias       = sampler.alias_m;
+
+    std::vector<double> scaled(numBins);
+    std::vector<unsigned int> small, large;
+    for (unsigned int k = 0; k < numBins; ++k) {
+        scaled[k] = bins[k] * numBins / sum;
+        alias(k)  = k;
+        if (scaled[k] < 1.0) {
+            small.push_back(k);
+        } else {
+            large.push_back(k);
+        }
+    }
+    while (!small.empty() && !large.empty()) {
+        unsigned int s = small.back();
+        small.pop_back();
+        unsigned int l = large.back();
+
+        probability(s) = scaled[s];
+        alias(s)       = l;
+
+        scaled[l] -= 1.0 - scaled[s];
+        if (scaled[l] < 1.0) {
+            large.pop_back();
+            small.push_back(l);
+        }
+    }
+    // what is left over is 1 up to round-off
+    for (unsigned int k : large) {
+        probability(k) = 1.0;
+    }
+    for (unsigned int k : small) {
+        probability(k) = 1.0;
+    }
+
+    // corner intensities are the mean of the adjacent pixels
+    sampler.corners_m =
+        Kokkos::View<double*, Kokkos::HostSpace>("laserCorners", (nx + 1) * (ny + 1));
+    auto& corners = sampler.corners_m;
+    for (unsigned int i = 0; i <= nx; ++i) {
+        for (unsigned int j = 0; j <= ny; ++j) {
+            double val         = 0.0;
+            unsigned int count = 0;
+            for (unsigned int ii = (i > 0 ? i - 1 : 0); ii < std::min(i + 1, nx); ++ii) {
+                for (unsigned int jj = (j > 0 ? j - 1 : 0); jj < std::min(j + 1, ny); ++jj) {
+                    val += bins[ii * ny + jj];
+                    ++count;
+                }
+            }
+            corners(i * (ny + 1) + j) = val / count;
+        }
+    }
+
+    sampler.nx_m   = nx;
+    sampler.ny_m   = ny;
+    sampler.xmin_m = xmin;
+    sampler.ymin_m = ymin;
+    sampler.dx_m   = dx;
+    sampler.dy_m   = dy;
+
+    return sampler;
+}
+
+void LaserProfile::fillAliasTable() {
+    const unsigned int nx = hist2d_m->nx, ny = hist2d_m->ny;
+
+    hostSampler_m = makeLaserProfileSampler(
+        hist2d_m->bin, nx, ny, hist2d_m->xrange[0], hist2d_m->yrange[0],
+        (hist2d_m->xrange[nx] - hist2d_m->xrange[0]) / nx,
+        (hist2d_m->yrange[ny] - hist2d_m->yrange[0]) / ny);
+
+    using memory_space = LaserProfileSampler<>::memory_space_type;
+    sampler_m.probability_m =
+        Kokkos::create_mirror_view_and_copy(memory_space(), hostSampler_m.probability_m);
+    sampler_m.alias_m = Kokkos::create_mirror_view_and_copy(memory_space(), hostSampler_m.alias_m);
+    sampler_m.corners_m =
+        Kokkos::create_mirror_view_and_copy(memory_space(), hostSampler_m.corners_m);
+    sampler_m.nx_m   = hostSampler_m.nx_m;
+    sampler_m.ny_m   = hostSampler_m.ny_m;
+    sampler_m.xmin_m = hostSampler_m.xmin_m;
+    sampler_m.ymin_m = hostSampler_m.ymin_m;
+    sampler_m.dx_m   = hostSampler_m.dx_m;
+    sampler_m.dy_m   = hostSampler_m.dy_m;
+}
 
+void LaserProfile::setupRNG() {
     gsl_rng_env_setup();
 
     const gsl_rng_type* T = gsl_rng_default;
     rng_m                 = gsl_rng_alloc(T);
-
-    pdf_m = gsl_histogram2d_pdf_alloc(histSizeX, histSizeY);
-    gsl_histogram2d_pdf_init(pdf_m, hist2d_m);
 }
 
 void LaserProfile::printInfo() {
@@ -372,9 +472,11 @@ void LaserProfile::sampleDist() {
 }
 
 void LaserProfile::getXY(double& x, double& y) {
-    double u = gsl_rng_uniform(rng_m);
-    double v = gsl_rng_uniform(rng_m);
-    gsl_histogram2d_pdf_sample(pdf_m, u, v, &x, &y);
+    double u[4];
+    for (double& ui : u) {
+        ui = gsl_rng_uniform(rng_m);
+    }
+    hostSampler_m.sample(u[0], u[1], u[2], u[3], x, y);
 }
 
 unsigned short LaserProfile::getProfileMax(unsigned short* image) {
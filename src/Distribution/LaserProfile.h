@@ -14,11 +14,75 @@
 
 #include "OPALTypes.h"
 
+#include <Kokkos_Core.hpp>
+
 #include <gsl/gsl_histogram2d.h>
 #include <gsl/gsl_rng.h>
 #include <string>
 #include "hdf5.h"
 
+/*
+ * Walker alias table of the laser image together with the intensity at the
+ * pixel corners. It is cheap to copy and can be captured by value in a kernel:
+ * one pixel is drawn in O(1) from two uniform numbers, the position inside the
+ * pixel is drawn from the bilinear interpolation of the corner intensities
+ * using two more. Coordinates are in units of the standard deviation of the
+ * image, like the ones returned by LaserProfile::getXY.
+ */
+template <class MemorySpace = Kokkos::DefaultExecutionSpace::memory_space>
+struct LaserProfileSampler {
+    using memory_space_type = MemorySpace;
+
+    Kokkos::View<double*, MemorySpace> probability_m;
+    Kokkos::View<unsigned int*, MemorySpace> alias_m;
+    Kokkos::View<double*, MemorySpace> corners_m;  // (nx + 1) x (ny + 1), column-major in x
+
+    unsigned int nx_m = 0, ny_m = 0;
+    double xmin_m = 0.0, ymin_m = 0.0;
+    double dx_m = 0.0, dy_m = 0.0;
+
+    KOKKOS_INLINE_FUNCTION
+    void sample(double u0, double u1, double u2, double u3, double& x, double& y) const {
+        const unsigned int numBins = nx_m * ny_m;
+        unsigned int bin = static_cast<unsigned int>(u0 * numBins);
+        if (bin >= numBins) {
+            bin = numBins - 1;
+        }
+        if (u1 >= probability_m(bin)) {
+            bin = alias_m(bin);
+        }
+        const unsigned int i = bin / ny_m;
+        const unsigned int j = bin % ny_m;
+
+        const double c00 = corners_m(i * (ny_m + 1) + j);
+        const double c01 = corners_m(i * (ny_m + 1) + j + 1);
+        const double c10 = corners_m((i + 1) * (ny_m + 1) + j);
+        const double c11 = corners_m((i + 1) * (ny_m + 1) + j + 1);
+
+        // marginal in x, then y conditional on x
+        const double s = invertLinear(c00 + c01, c10 + c11, u2);
+        const double t = invertLinear((1.0 - s) * c00 + s * c10, (1.0 - s) * c01 + s * c11, u3);
+
+        x = xmin_m + (i + s) * dx_m;
+        y = ymin_m + (j + t) * dy_m;
+    }
+
+    /// inverse of the cumulative distribution of the density a (1 - s) + b s on [0, 1]
+    KOKKOS_INLINE_FUNCTION
+    static double invertLinear(double a, double b, double u) {
+        if (Kokkos::abs(a - b) <= 1e-12 * (a + b)) {
+            return u;
+        }
+        return (a - Kokkos::sqrt(a * a * (1.0 - u) + b * b * u)) / (a - b);
+    }
+};
+
+/// Builds the alias table of the nx x ny intensities bins[i * ny + j] on the host,
+/// pixel (i, j) starts at (xmin + i dx, ymin + j dy)
+LaserProfileSampler<Kokkos::HostSpace> makeLaserProfileSampler(
+    const double* bins, unsigned int nx, unsigned int ny, double xmin, double ymin, double dx,
+    double dy);
+
 class LaserProfile {
 public:
     LaserProfile(
@@ -29,6 +93,9 @@ public:
 
     void getXY(double& x, double& y);
 
+    /// Sampler for use inside Kokkos kernels
+    const LaserProfileSampler<>& getSampler() const;
+
     enum { FLIPX = 1, FLIPY = 2, ROTATE90 = 4, ROTATE180 = 8, ROTATE270 = 16 };
 
 private:
@@ -42,6 +109,7 @@ private:
     void normalizeProfileData(double intensityCut, unsigned short* image);
     void computeProfileStatistics(unsigned short* image);
     void fillHistrogram(unsigned short* image);
+    void fillAliasTable();
     void setupRNG();
     void printInfo();
 
@@ -54,9 +122,15 @@ private:
     hsize_t sizeX_m, sizeY_m;
     gsl_histogram2d* hist2d_m;
     gsl_rng* rng_m;
-    gsl_histogram2d_pdf* pdf_m;
+
+    LaserProfileSampler<Kokkos::HostSpace> hostSampler_m;
+    LaserProfileSampler<> sampler_m;
 
     Vector_t<double, 3> centerMass_m;
     Vector_t<double, 3> standardDeviation_m;
 };
+
+inline const LaserProfileSampler<>& LaserProfile::getSampler() const {
+    return sampler_m;
+}
 #endif
\ No newline at end of file
@@ -1,6 +1,8 @@
 #include "MultiVariateGaussian.h"
+#include "CounterBasedSampling.hpp"
 #include <Kokkos_Core.hpp>
 #include <mpi.h>
+#include <algorithm>
 
 /**
  * @brief Constructs the MultiVariateGaussian class.
@@ -83,21 +85,61 @@ void MultiVariateGaussian::ComputeCenteredBounds() {
     }
 }
 
+namespace {
+    /// (x, px, y, py, z, pz) = L * n where n_i ~ N(0, 1) truncated to [lo_i, hi_i]
+    struct MultiVariateGaussianSampler {
+        uint64_t seed;
+        Kokkos::Array<double, 36> L;
+        Kokkos::Array<double, 6> lo;
+        Kokkos::Array<double, 6> hi;
+
+        KOKKOS_INLINE_FUNCTION double coordinate(const double* n, unsigned int i) const {
+            double x = 0.0;
+            for (unsigned int j = 0; j <= i; ++j) {
+                x += L[6 * i + j] * n[j];
+            }
+            return x;
+        }
+
+        KOKKOS_INLINE_FUNCTION void operator()(
+            uint64_t id, Vector_t<double, 3>& R, Vector_t<double, 3>& P) const {
+            double n[6];
+            for (unsigned int j = 0; j < 6; ++j) {
+                n[j] = CounterBasedSampling::truncatedNormal(seed, id, j, lo[j], hi[j]);
+            }
+            for (unsigned int i = 0; i < 3; ++i) {
+                R[i] = coordinate(n, 2 * i);
+                P[i] = coordinate(n, 2 * i + 1);
+            }
+        }
+
+        double bound(unsigned int d) const {
+            const unsigned int i = d < 3 ? 2 * d : 2 * (d - 3) + 1;
+            double b             = 0.0;
+            for (unsigned int j = 0; j <= i; ++j) {
+                b += std::abs(L[6 * i + j]) * std::max(std::abs(lo[j]), std::abs(hi[j]));
+            }
+            return b;
+        }
+    };
+}  // namespace
+
 /**
  * @brief Generates particles following a multivariate Gaussian distribution.
+ *
+ * The random numbers of a particle only depend on the seed and the global
+ * particle index, i.e. the distribution is the same for any number of ranks.
  */
 void MultiVariateGaussian::generateParticles(size_t &numberOfParticles, Vector_t<double, 3> nr) {
     extern Inform* gmsg;
-    size_t randInit;
+    uint64_t seed;
     if (Options::seed == -1) {
-        randInit = 1234567;
-        *gmsg << "* Seed = " << randInit << " on all ranks" << endl;
+        seed = 1234567;
+        *gmsg << "* Seed = " << seed << " on all ranks" << endl;
     } else {
-        randInit = (size_t)(Options::seed + 100 * ippl::Comm->rank());
+        seed = static_cast<uint64_t>(Options::seed);
     }
 
-    GeneratorPool rand_pool64(randInit);
-
     // Initialize covariance matrix from the distribution.
     for (unsigned int i = 0; i < 6; i++) {
         for (unsigned int j = 0; j < 6; j++) {
@@ -111,137 +153,21 @@ void MultiVariateGaussian::generateParticles(size_t &numberOfParticles, Vector_t
     // compute boundaries of normal random numbers
     ComputeCenteredBounds();
 
-    view_type &Rview = pc_m->R.getView();
-    view_type &Pview = pc_m->P.getView();
-
-    const double par[6] = {0.0, 1.0, 0.0, 1.0, 0.0, 1.0};
-    using Dist_t = ippl::random::NormalDistribution<double, 3>;
-    using sampling_t = ippl::random::InverseTransformSampling<double, 3, Kokkos::DefaultExecutionSpace, Dist_t>;
-    Dist_t dist(par);
-
-    MPI_Comm comm = MPI_COMM_WORLD;
-    int nranks, rank;
-    MPI_Comm_size(comm, &nranks);
-    MPI_Comm_rank(comm, &rank);
-
-    // if nlocal*nranks > numberOfParticles, put the remaining in rank 0
-    size_t nlocal = floor(numberOfParticles / nranks);
-    size_t remaining = numberOfParticles - nlocal * nranks;
-    if (remaining > 0 && rank == 0) {
-        nlocal += remaining;
-    }
-
-    sampling_t sampling(dist, normRmax_m, normRmin_m, normRmax_m, normRmin_m, nlocal);
-    pc_m->create(nlocal);
-    sampling.generate(Rview, rand_pool64);
-
-    sampling.updateBounds(normPmax_m, normPmin_m, normPmax_m, normPmin_m);
-    sampling.generate(Pview, rand_pool64);
-
-    Matrix_t L;
+    MultiVariateGaussianSampler sampler;
+    sampler.seed = seed;
     for (unsigned int i = 0; i < 6; i++) {
         for (unsigned int j = 0; j < 6; j++) {
-            L[i][j] = L_m[i][j];
-        }
-    }
-
-    // Apply Cholesky transformation
-    Kokkos::parallel_for(nlocal, KOKKOS_LAMBDA(const int k) {
-        double vec_old[6], vec[6] = {0.0};
-        for (unsigned i = 0; i < 3; ++i) {
-            vec_old[2 * i] = Rview(k)[i];
-            vec_old[2 * i + 1] = Pview(k)[i];
+            sampler.L[6 * i + j] = L_m[i][j];
         }
-        for (unsigned i = 0; i < 6; ++i) {
-            for (unsigned j = 0; j < i + 1; ++j) {
-                vec[i] += L[i][j] * vec_old[j];
-            }
-        }
-        for (unsigned i = 0; i < 3; ++i) {
-            Rview(k)[i] = vec[2 * i];
-            Pview(k)[i] = vec[2 * i + 1];
-        }
-    });
-
-    Kokkos::fence();
-
-
-    // zero mean of R
-    double meanR[3], loc_meanR[3];
-    for(int i=0; i<3; i++){
-       meanR[i] = 0.0;
-       loc_meanR[i] = 0.0;
     }
-
-    Kokkos::parallel_reduce(
-            "calc moments of particle distr.", nlocal,
-            KOKKOS_LAMBDA(
-                    const int k, double& cent0, double& cent1, double& cent2) {
-                    cent0 += Rview(k)[0];
-                    cent1 += Rview(k)[1];
-                    cent2 += Rview(k)[2];
-            },
-            Kokkos::Sum<double>(loc_meanR[0]), Kokkos::Sum<double>(loc_meanR[1]), Kokkos::Sum<double>(loc_meanR[2]));
-    Kokkos::fence();
-
-    MPI_Allreduce(loc_meanR, meanR, 3, MPI_DOUBLE, MPI_SUM, ippl::Comm->getCommunicator());
-    ippl::Comm->barrier();
-
-    for(int i=0; i<3; i++){
-       meanR[i] = meanR[i]/(1.*numberOfParticles);
+    for (unsigned int i = 0; i < 3; i++) {
+        sampler.lo[2 * i]     = normRmin_m(i);
+        sampler.hi[2 * i]     = normRmax_m(i);
+        sampler.lo[2 * i + 1] = normPmin_m(i);
+        sampler.hi[2 * i + 1] = normPmax_m(i);
     }
 
-    Kokkos::parallel_for(
-            nlocal, KOKKOS_LAMBDA(
-                    const int k) {
-                    Rview(k)[0] -= meanR[0];
-                    Rview(k)[1] -= meanR[1];
-                    Rview(k)[2] -= meanR[2];
-            }
-    );
-    Kokkos::fence();
-
-    // zero mean of P
-    double meanP[3], loc_meanP[3];
-    for(int i=0; i<3; i++){
-       meanP[i] = 0.0;
-       loc_meanP[i] = 0.0;
-    }
-    Kokkos::parallel_reduce(
-            "calc moments of particle distr.", nlocal,
-            KOKKOS_LAMBDA(
-                    const int k, double& cent0, double& cent1, double& cent2) {
-                    cent0 += Pview(k)[0];
-                    cent1 += Pview(k)[1];
-                    cent2 += Pview(k)[2];
-            },
-	    Kokkos::Sum<double>(loc_meanP[0]), Kokkos::Sum<double>(loc_meanP[1]), Kokkos::Sum<double>(loc_meanP[2]));
-    Kokkos::fence();
-
-    MPI_Allreduce(loc_meanP, meanP, 3, MPI_DOUBLE, MPI_SUM, ippl::Comm->getCommunicator());
-    ippl::Comm->barrier();
-
-    for(int i=0; i<3; i++){
-       meanP[i] = meanP[i]/(1.*numberOfParticles);
-    }
-
-    Kokkos::parallel_for(
-            nlocal, KOKKOS_LAMBDA(
-                    const int k) {
-                    Pview(k)[0] -= meanP[0];
-                    Pview(k)[1] -= meanP[1];
-                    Pview(k)[2] -= meanP[2];
-            }
-    );
-    Kokkos::fence();
-
-    // correct the means of R and P
-    double avrgpz = opalDist_m->getAvrgpz();
-    Kokkos::parallel_for(
-            nlocal, KOKKOS_LAMBDA(
-                    const int k) {
-                    Pview(k)[2] += avrgpz;
-            }
-    );
-    Kokkos::fence();
+    CounterBasedSampling::generate(
+        *pc_m, sampler, numberOfParticles, true, opalDist_m->getAvrgpz(),
+        ensembleMember_m * static_cast<uint64_t>(numberOfParticles));
 }
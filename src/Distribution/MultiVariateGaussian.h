@@ -27,6 +27,7 @@ using Dist_t = ippl::random::NormalDistribution<double, 3>;
  * whose values are read from opalDist_m->correlationMatrix_m.
  * First, the Cholesky factorization is computed cov_m = L_m * L_m^T
  * Then, normally distribution particles R=P~N(0,I) are transformed to multivariate using L_m.
+ * The normal numbers are drawn with a counter-based generator keyed by the global particle index.
  */
 class MultiVariateGaussian : public SamplingBase {
 public:
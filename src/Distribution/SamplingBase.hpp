@@ -14,6 +14,8 @@ protected:
     std::shared_ptr<FieldContainer_t> fc_m;
     std::shared_ptr<Distribution_t> opalDist_m;
     std::string samplingMethod_m;
+    /// member of an ensemble of bunches, selects a disjoint range of random numbers
+    unsigned int ensembleMember_m = 0;
 public:
     
     SamplingBase(std::shared_ptr<ParticleContainer_t> &pc, std::shared_ptr<FieldContainer_t> &fc, std::shared_ptr<Distribution_t> &dist)
@@ -26,6 +28,24 @@ public:
 
     virtual void emitParticles(double t, double dt) {}
 
+    /// true while the step starting at time t still emits particles
+    virtual bool isEmitting(double t) const { return false; }
+
+    virtual size_t getNumberOfEmissionSteps() const { return 0; }
+
+    /// index of the step of the last call to emitParticles
+    virtual size_t getLastEmissionStep() const { return 0; }
+
+    /// particles of all ranks emitted so far, stored in checkpoints
+    virtual size_t getNumberOfEmittedParticles() const { return 0; }
+
+    /// emission steps up to the last emission, stored in checkpoints
+    virtual size_t getNumberOfEmittedSteps() const { return 0; }
+
+    /// continues the emission of numberOfParticles particles at time t after a checkpoint restart
+    virtual void resumeEmission(
+        size_t numberOfParticles, size_t emittedParticles, size_t emittedSteps, double t) {}
+
     // testNumEmitParticles is purely made for testing and should be removed
     virtual void testNumEmitParticles(size_t nsteps, double dt) {}
 
@@ -35,6 +55,8 @@ public:
     virtual void initDomainDecomp(double BoxIncr) {}
 
     virtual void setWithDomainDecomp(bool withDomainDecomp) {}
+
+    void setEnsembleMember(unsigned int member) { ensembleMember_m = member; }
 };
 #endif
 
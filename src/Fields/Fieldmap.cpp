@@ -30,6 +30,7 @@
 #include "Fields/FMDummy.h"
 #include "Physics/Physics.h"
 #include "Utilities/GeneralClassicException.h"
+#include "Utilities/MemoryAccounting.h"
 #include "Utilities/Options.h"
 #include "Utilities/Util.h"
 
@@ -239,6 +240,7 @@ void Fieldmap::clearDictionary() {
     for (; it != FieldmapDictionary.end(); ++it) {
         delete it->second.Map;
         it->second.Map = nullptr;
+        MemoryAccounting::getInstance().release(MemoryAccounting::FIELDMAPS, it->first);
     }
     FieldmapDictionary.clear();
 }
@@ -386,8 +388,17 @@ void Fieldmap::readMap(std::string Filename) {
         FieldmapDictionary.find(Filename);
     if (position != FieldmapDictionary.end())
         if (!(*position).second.read) {
+            // the field maps have no common storage, their size is the growth of the resident
+            // set size, which may include buffers of the parser that aren't returned to the OS
+            const size_t residentBefore = MemoryAccounting::getResidentSetSize();
             (*position).second.Map->readMap();
             (*position).second.read = true;
+            const size_t residentAfter = MemoryAccounting::getResidentSetSize();
+
+            MemoryAccounting::getInstance().setBytes(
+                MemoryAccounting::FIELDMAPS, Filename,
+                residentAfter > residentBefore ? residentAfter - residentBefore : 0,
+                MemoryAccounting::HOST);
         }
 }
 
@@ -406,6 +417,7 @@ void Fieldmap::freeMap(std::string Filename) {
             delete (*position).second.Map;
             (*position).second.Map = nullptr;
             FieldmapDictionary.erase(position);
+            MemoryAccounting::getInstance().release(MemoryAccounting::FIELDMAPS, Filename);
         }
     }
 }
@@ -118,6 +118,7 @@ namespace OPALXMAIN {
         *ippl::Info << "   --input <fname>          : Specifies the input file <fname>.\n";
         *ippl::Info << "   --restart <n>            : Performes a restart from step <n>.\n";
         *ippl::Info << "   --restartfn <fname>      : Uses the file <fname> to restart from.\n";
+        *ippl::Info << "   --restart-checkpoint <d> : Restarts from the checkpoint in directory <d>.\n";
         //*ippl::printHelp();
         *ippl::Info << "   --help-command <command> : Display the help for the command <command>\n";
         *ippl::Info << "   --help                   : Display this command-line summary.\n";
@@ -289,6 +290,9 @@ int main(int argc, char* argv[]) {
                     argStr == std::string("-restartfn") || argStr == std::string("--restartfn")) {
                     restartFileName = std::string(argv[++ii]);
                     continue;
+                } else if (argStr == std::string("--restart-checkpoint")) {
+                    opal->setCheckpointRestartDir(std::string(argv[++ii]));
+                    continue;
                 } else if (argStr == std::string("--info")) {
                     ++ii;
                     continue;
@@ -334,6 +338,12 @@ int main(int argc, char* argv[]) {
                 opal->setRestartFileName(restartFileName);
             }
 
+            if (opal->inCheckpointRestart() && !fs::is_directory(opal->getCheckpointRestartDir())) {
+                *ippl::Info << "Checkpoint directory '" << opal->getCheckpointRestartDir()
+                            << "' doesn't exist!" << endl;
+                exit(1);
+            }
+
             FileStream* is;
 
             try {
@@ -16,6 +16,7 @@
 #include "ParallelReduceTools.h" 
 #include "BinningTools.h"        
 #include "BinHisto.h"           
+#include "SpaceFillingCurves.h"
 
 namespace ParticleBinning {
 
@@ -104,6 +105,7 @@ namespace ParticleBinning {
             bExecuteHistoReductionT = IpplTimings::getTimer("bExecuteHistoReduction");
             bSortContainerByBinT    = IpplTimings::getTimer("bSortContainerByBin");
             bVerifySortingT         = IpplTimings::getTimer("bVerifySorting");
+            bSortContainerByCellT   = IpplTimings::getTimer("bSortContainerByCell");
         }
 
         /**
@@ -362,6 +364,36 @@ namespace ParticleBinning {
          */
         void sortContainerByBin();
 
+        /**
+         * @brief Physically reorders all particle attributes by grid cell along a space filling curve.
+         *
+         * In contrast to sortContainerByBin(), which only builds an index array, this function moves
+         * the particle data itself. Particles depositing to neighbouring cells are then neighbours
+         * in memory, which makes `scatter()` and `gather()` hit the grid in a cache friendly order.
+         * The (adaptive) bin index is used as secondary key, s.t. particles of the same cell are
+         * grouped by bin.
+         *
+         * Steps:
+         * 1. Computes a bucket index = curveKey(cell) * nBins + bin for every particle. The curve key
+         *    is coarsened if the number of buckets would exceed `maxCellSortBuckets`.
+         * 2. Builds the bucket histogram and its post sum (see computeFixSum in BinningTools.h).
+         * 3. Places every particle index at its target position (same bin sort as in sortContainerByBin()).
+         * 4. Permutes all attributes of the container with the resulting index array.
+         *
+         * @param origin Origin of the mesh.
+         * @param hr Mesh spacing.
+         * @param lFirst First (global) cell index of the local domain.
+         * @param lExtent Number of cells of the local domain in each dimension.
+         * @param curve The space filling curve used to order the cells.
+         *
+         * @note The local histogram stays valid, since the particles only change their position in
+         *       memory. However, the index array returned by getHashArray() does not, so
+         *       sortContainerByBin() has to be called again if per bin iteration is needed.
+         */
+        void sortContainerByCell(const Vector<double, 3>& origin, const Vector<double, 3>& hr,
+                                 const Vector<int, 3>& lFirst, const Vector<int, 3>& lExtent,
+                                 CellOrdering curve);
+
         /**
          * @brief Returns the bin iteration policy for a given bin index.
          * 
@@ -511,6 +543,7 @@ namespace ParticleBinning {
         IpplTimings::TimerRef bExecuteHistoReductionT;
         IpplTimings::TimerRef bSortContainerByBinT;
         IpplTimings::TimerRef bVerifySortingT;
+        IpplTimings::TimerRef bSortContainerByCellT;
     };
 
 }
@@ -388,6 +388,72 @@ namespace ParticleBinning {
         #endif
     }
 
+
+    template <typename BunchType, typename BinningSelector>
+    void AdaptBins<BunchType, BinningSelector>::sortContainerByCell(const Vector<double, 3>& origin, const Vector<double, 3>& hr,
+                                                                    const Vector<int, 3>& lFirst, const Vector<int, 3>& lExtent,
+                                                                    CellOrdering curve) {
+        Inform msg("AdaptBins");
+
+        size_type localNumParticles = bunch_m->getLocalNum();
+        if (curve == CellOrdering::None || localNumParticles <= 1) return;
+
+        IpplTimings::startTimer(bSortContainerByCellT);
+
+        // Number of bits per dimension needed to address all local cells (at most 21 for 64 bit keys)
+        int maxExtent = Kokkos::max(lExtent[0], Kokkos::max(lExtent[1], lExtent[2]));
+        unsigned bits = 1;
+        while ((1 << bits) < maxExtent && bits < 21) ++bits;
+
+        // Coarsen the curve key if the buckets (keys x bins) would not fit into maxCellSortBuckets
+        const std::uint64_t numBins = getCurrentBinCount();
+        unsigned keyBits            = 3 * bits;
+        unsigned shift              = 0;
+        while (shift < keyBits && (std::uint64_t(1) << (keyBits - shift)) * numBins > maxCellSortBuckets) ++shift;
+        const size_type numBuckets  = (std::uint64_t(1) << (keyBits - shift)) * numBins;
+
+        // Declare the variables locally before the Kokkos::parallel_for (to avoid implicit this capture in Kokkos lambda)
+        position_view_type R = bunch_m->R.getView();
+        bin_view_type bins   = getBinView();
+        const Vector<double, 3> hrInv(1.0 / hr[0], 1.0 / hr[1], 1.0 / hr[2]);
+        const Vector<double, 3> o = origin;
+        const Vector<int, 3> first = lFirst, extent = lExtent;
+
+        Kokkos::View<size_type*> bucketIndex(Kokkos::view_alloc(Kokkos::WithoutInitializing, "bucketIndex"), localNumParticles);
+        Kokkos::View<size_type*> bucketCounts("bucketCounts", numBuckets);
+        Kokkos::View<size_type*> bucketOffsets("bucketOffsets", numBuckets + 1);
+
+        // Assign every particle to its (cell, bin) bucket and count the bucket sizes
+        Kokkos::parallel_for("AssignCellBuckets", localNumParticles, KOKKOS_LAMBDA(const size_type& i) {
+            std::uint32_t cell[3];
+            for (unsigned d = 0; d < 3; ++d) {
+                int c   = static_cast<int>(Kokkos::floor((R(i)[d] - o[d]) * hrInv[d])) - first[d];
+                c       = (c < 0) ? 0 : ((c >= extent[d]) ? extent[d] - 1 : c); // particles on the domain edge
+                cell[d] = static_cast<std::uint32_t>(c);
+            }
+            size_type key    = cellKey3D(curve, cell[0], cell[1], cell[2], bits) >> shift;
+            size_type bucket = key * numBins + bins(i);
+
+            bucketIndex(i) = bucket;
+            Kokkos::atomic_increment(&bucketCounts(bucket));
+        });
+
+        computeFixSum(bucketCounts, bucketOffsets);
+
+        // Same bin sort as in sortContainerByBin, but on the (cell, bin) buckets
+        hash_type permutation("cellPermutation", localNumParticles);
+        Kokkos::parallel_for("SortIndicesByCell", localNumParticles, KOKKOS_LAMBDA(const size_type& i) {
+            size_type target_pos     = Kokkos::atomic_fetch_add(&bucketOffsets(bucketIndex(i)), 1);
+            permutation(target_pos)  = i;
+        });
+
+        bunch_m->applyPermutation(permutation);
+        IpplTimings::stopTimer(bSortContainerByCellT);
+
+        // called every CELLSORTFREQ steps, only visible at a high info level
+        msg << level4 << "Container sorted by cell with " << numBuckets << " buckets (key shift = " << shift << ")." << endl;
+    }
+
 }
 
 #endif // ADAPT_BINS_HPP
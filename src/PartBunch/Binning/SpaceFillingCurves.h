@@ -0,0 +1,125 @@
+/**
+ * @file SpaceFillingCurves.h
+ * @brief Device callable space filling curve keys used to order particles by grid cell.
+ *
+ * The keys are used by `AdaptBins::sortContainerByCell` to physically reorder the particle
+ * container, s.t. particles that deposit to (or gather from) neighbouring cells are also
+ * neighbours in memory. This improves the cache behaviour of `scatter()` and `gather()`.
+ */
+
+#ifndef SPACE_FILLING_CURVES_H
+#define SPACE_FILLING_CURVES_H
+
+#include <Kokkos_Core.hpp>
+
+#include <cstdint>
+#include <string>
+
+namespace ParticleBinning {
+
+    /**
+     * @brief Selects the space filling curve used to order the cells of the local grid.
+     */
+    enum class CellOrdering {
+        None,     // Do not reorder the container
+        Morton,   // Z-order curve: cheap bit interleaving
+        Hilbert   // Hilbert curve: better locality, a few more operations per key
+    };
+
+    /**
+     * @brief Converts the value of the CELLSORTCURVE option to a CellOrdering.
+     *
+     * @param name "MORTON" or "HILBERT", every other string disables the ordering.
+     */
+    inline CellOrdering getCellOrdering(const std::string& name) {
+        if (name == "MORTON")  return CellOrdering::Morton;
+        if (name == "HILBERT") return CellOrdering::Hilbert;
+        return CellOrdering::None;
+    }
+
+    /**
+     * @brief Maximum number of buckets used by the counting sort in `sortContainerByCell`.
+     *
+     * The curve keys are coarsened (lowest bits dropped) if the number of keys times the
+     * number of energy bins would exceed this number. A coarsened key still describes a
+     * compact block of cells, so locality is mostly preserved.
+     */
+    constexpr std::uint64_t maxCellSortBuckets = std::uint64_t(1) << 22;
+
+    /**
+     * @brief Spreads the lowest 21 bits of x, s.t. two zero bits separate every bit.
+     */
+    KOKKOS_INLINE_FUNCTION
+    std::uint64_t spreadBits3D(std::uint64_t x) {
+        x &= 0x1fffff;
+        x = (x | x << 32) & 0x1f00000000ffff;
+        x = (x | x << 16) & 0x1f0000ff0000ff;
+        x = (x | x << 8)  & 0x100f00f00f00f00f;
+        x = (x | x << 4)  & 0x10c30c30c30c30c3;
+        x = (x | x << 2)  & 0x1249249249249249;
+        return x;
+    }
+
+    /**
+     * @brief Returns the Morton (Z-order) key of the cell (x, y, z).
+     *
+     * @note Each coordinate must fit into 21 bits.
+     */
+    KOKKOS_INLINE_FUNCTION
+    std::uint64_t mortonKey3D(std::uint32_t x, std::uint32_t y, std::uint32_t z) {
+        return (spreadBits3D(x) << 2) | (spreadBits3D(y) << 1) | spreadBits3D(z);
+    }
+
+    /**
+     * @brief Returns the Hilbert key of the cell (x, y, z) on a grid with 2^bits cells per dimension.
+     *
+     * Uses the transposition algorithm by J. Skilling ("Programming the Hilbert curve", AIP Conf.
+     * Proc. 707, 2004): the coordinates are transformed in place and then interleaved like a
+     * Morton key.
+     *
+     * @note bits must be in [1, 21].
+     */
+    KOKKOS_INLINE_FUNCTION
+    std::uint64_t hilbertKey3D(std::uint32_t x, std::uint32_t y, std::uint32_t z, unsigned bits) {
+        std::uint32_t X[3] = {x, y, z};
+        const std::uint32_t M = std::uint32_t(1) << (bits - 1);
+
+        // Inverse undo excess work
+        for (std::uint32_t Q = M; Q > 1; Q >>= 1) {
+            const std::uint32_t P = Q - 1;
+            for (int i = 0; i < 3; ++i) {
+                if (X[i] & Q) {
+                    X[0] ^= P;
+                } else {
+                    const std::uint32_t t = (X[0] ^ X[i]) & P;
+                    X[0] ^= t;
+                    X[i] ^= t;
+                }
+            }
+        }
+
+        // Gray encode
+        X[1] ^= X[0];
+        X[2] ^= X[1];
+        std::uint32_t t = 0;
+        for (std::uint32_t Q = M; Q > 1; Q >>= 1) {
+            if (X[2] & Q) t ^= Q - 1;
+        }
+        X[0] ^= t;
+        X[1] ^= t;
+        X[2] ^= t;
+
+        return mortonKey3D(X[0], X[1], X[2]);
+    }
+
+    /**
+     * @brief Returns the key of the cell (x, y, z) for the chosen curve.
+     */
+    KOKKOS_INLINE_FUNCTION
+    std::uint64_t cellKey3D(CellOrdering curve, std::uint32_t x, std::uint32_t y, std::uint32_t z, unsigned bits) {
+        return (curve == CellOrdering::Hilbert) ? hilbertKey3D(x, y, z, bits) : mortonKey3D(x, y, z);
+    }
+
+} // namespace ParticleBinning
+
+#endif // SPACE_FILLING_CURVES_H
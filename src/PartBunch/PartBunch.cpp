@@ -1,7 +1,13 @@
 #include "PartBunch/PartBunch.h"
 #include <boost/numeric/ublas/io.hpp>
+#include "Utilities/MemoryAccounting.h"
+#include "Utilities/OpalException.h"
 #include "Utilities/Util.h"
 
+#include <Kokkos_ScatterView.hpp>
+
+#include <algorithm>
+
 #undef doDEBUG
 
 template <typename T, unsigned Dim>
@@ -26,7 +32,10 @@ PartBunch<T, Dim>::PartBunch(double qi, double mi, size_t totalP, int nt, double
       localTrackStep_m(0),
       globalTrackStep_m(0),
       OPALdist_m(OPALdistribution),
-      OPALFieldSolver_m(OPALFieldSolver) {
+      OPALFieldSolver_m(OPALFieldSolver),
+      numberOfEnergyBins_m(0),
+      lastEmittedEnergyBin_m(0),
+      ensembleSize_m(1) {
 
     static IpplTimings::TimerRef gatherInfoPartBunch = IpplTimings::getTimer("gatherInfoPartBunch");
     IpplTimings::startTimer(gatherInfoPartBunch);
@@ -62,7 +71,9 @@ PartBunch<T, Dim>::PartBunch(double qi, double mi, size_t totalP, int nt, double
     this->setFieldContainer( std::make_shared<FieldContainer_t>(hr_m, rmin_m, rmax_m, decomp_m, domain_m, origin_m, isAllPeriodic) );
 
     this->setParticleContainer(std::make_shared<ParticleContainer_t>(
-        this->fcontainer_m->getMesh(), this->fcontainer_m->getFL()));
+        this->fcontainer_m->getMesh(), this->fcontainer_m->getFL(), Options::compactParticles));
+    this->pcontainer_m->setCharge(qi_m);
+    this->pcontainer_m->setMass(mi_m);
 
     IpplTimings::stopTimer(gatherInfoPartBunch);
 
@@ -77,6 +88,11 @@ PartBunch<T, Dim>::PartBunch(double qi, double mi, size_t totalP, int nt, double
     ));
     this->getBins()->debug();
 
+    if (TiledScatter::getDepositionMode(Options::deposition) == TiledScatter::DepositionMode::Tiled
+        && !TiledScatter::isAvailable()) {
+        *gmsg << "* Warning: DEPOSITION=TILED needs a host execution space, using atomic deposition" << endl;
+    }
+
     this->setTempEField(std::make_shared<VField_t<T, Dim>>(this->fcontainer_m->getE())); // user copy constructor
     this->getTempEField()->initialize(this->fcontainer_m->getMesh(), this->fcontainer_m->getFL());
     // -----------------------------------------------
@@ -125,6 +141,59 @@ void  PartBunch<T, Dim>::gatherLoadBalanceStatistics() {
         ippl::Comm->allreduce(globalPartPerNode_m.get(), ippl::Comm->size(), std::plus<size_t>());
 }
 
+template <typename T, unsigned Dim>
+void PartBunch<T, Dim>::updateMemoryAccounting() {
+    MemoryAccounting& accounting = MemoryAccounting::getInstance();
+
+    // the attributes are accounted with their capacity, not the number of local particles
+    auto pc = this->pcontainer_m;
+    accounting.setView(MemoryAccounting::PARTICLES, "ID", pc->ID.getView());
+    accounting.setView(MemoryAccounting::PARTICLES, "R", pc->R.getView());
+    if (!pc->hasCompactLayout()) {
+        accounting.setView(MemoryAccounting::PARTICLES, "Q", pc->Q.getView());
+        accounting.setView(MemoryAccounting::PARTICLES, "M", pc->M.getView());
+        accounting.setView(MemoryAccounting::PARTICLES, "dt", pc->dt.getView());
+    }
+    accounting.setView(MemoryAccounting::PARTICLES, "Bin", pc->Bin.getView());
+    accounting.setView(MemoryAccounting::PARTICLES, "Sp", pc->Sp.getView());
+    accounting.setView(MemoryAccounting::PARTICLES, "P", pc->P.getView());
+    accounting.setView(MemoryAccounting::PARTICLES, "E", pc->E.getView());
+    accounting.setView(MemoryAccounting::PARTICLES, "B", pc->B.getView());
+
+    if (this->fcontainer_m) {
+        accounting.setView(MemoryAccounting::FIELDS, "E", this->fcontainer_m->getE().getView());
+        accounting.setView(MemoryAccounting::FIELDS, "rho", this->fcontainer_m->getRho().getView());
+        accounting.setView(MemoryAccounting::FIELDS, "phi", this->fcontainer_m->getPhi().getView());
+    }
+    if (Etmp_m) {
+        accounting.setView(MemoryAccounting::FIELDS, "Etmp", Etmp_m->getView());
+    }
+
+    if (this->fsolver_m && this->fsolver_m->getStype() != "NONE") {
+        /*
+         * The workspace of the open solver of IPPL isn't accessible. It is estimated from
+         * the local domain doubled in every direction: the charge density, the Green's
+         * function and the solution as real fields and four complex fields with half the
+         * number of points for the transforms.
+         */
+        const size_t numCells        = this->fcontainer_m->getFL().getLocalNDIndex().size();
+        const size_t numCellsDoubled = numCells << Dim;
+        const size_t bytes =
+            numCellsDoubled * (3 * sizeof(T) + 4 * sizeof(Kokkos::complex<T>) / 2);
+
+        accounting.setBytes(
+            MemoryAccounting::SOLVER, "openSolverWorkspace", bytes,
+            MemoryAccounting::hasDeviceSpace() ? MemoryAccounting::DEVICE
+                                               : MemoryAccounting::HOST);
+    } else {
+        accounting.release(MemoryAccounting::SOLVER, "openSolverWorkspace");
+    }
+
+    if (bins_m) {
+        accounting.setView(MemoryAccounting::BINNING, "sortedIndex", bins_m->getHashArray());
+    }
+}
+
 template <typename T, unsigned Dim>
 void PartBunch<T, Dim>::setSolver(std::string solver) {
     if (this->solver_m != "")
@@ -315,6 +384,56 @@ void PartBunch<T, Dim>::calcBeamParameters() {
     }
 }
 
+template <typename T, unsigned Dim>
+void PartBunch<T, Dim>::calcLineDensity(unsigned int nBins,
+                                        std::vector<double>& lineDensity,
+                                        std::pair<double, double>& meshInfo) {
+    /*
+      Cloud in cell deposition of the charge along z on the device. Needs the bounds of
+      calcBeamParameters(). Uses the number of grid points in z if nBins < 3, the first and
+      the last bin are guard bins.
+    */
+    if (nBins < 3) {
+        nBins = nr_m[2];
+    }
+    if (nBins < 3) {
+        throw OpalException("PartBunch::calcLineDensity",
+                            "the line density needs at least 3 bins, got " + std::to_string(nBins));
+    }
+
+    const double length   = rmax_m(2) - rmin_m(2);
+    const double hz       = std::max(length, 1e-300) / (nBins - 2);
+    const double perMeter = 1.0 / hz;
+    const double zmin     = rmin_m(2) - hz;
+
+    auto Rview = this->pcontainer_m->R.getView();
+    auto Qview = this->pcontainer_m->getCharges();
+
+    Kokkos::View<double*> density("lineDensity", nBins);
+    auto scatterDensity = Kokkos::Experimental::create_scatter_view(density);
+    Kokkos::parallel_for(
+        "calcLineDensity", this->getLocalNum(), KOKKOS_LAMBDA(const size_t i) {
+            const double z     = (Rview(i)[2] - 0.5 * hz - zmin) / hz;
+            const unsigned idx = Kokkos::min(static_cast<unsigned>(z), nBins - 2);
+            const double tau   = z - idx;
+
+            auto access = scatterDensity.access();
+            access(idx) += Qview(i) * (1.0 - tau) * perMeter;
+            access(idx + 1) += Qview(i) * tau * perMeter;
+        });
+    Kokkos::Experimental::contribute(density, scatterDensity);
+
+    lineDensity.resize(nBins);
+    Kokkos::View<double*, Kokkos::HostSpace, Kokkos::MemoryUnmanaged> hostDensity(
+        lineDensity.data(), nBins);
+    Kokkos::deep_copy(hostDensity, density);
+
+    ippl::Comm->allreduce(lineDensity.data(), nBins, std::plus<double>());
+
+    meshInfo.first  = zmin;
+    meshInfo.second = hz;
+}
+
 template <typename T, unsigned Dim>
 void PartBunch<T, Dim>::pre_run() {
     this->fcontainer_m->getRho() = 0.0;
@@ -481,6 +600,10 @@ void PartBunch<T, Dim>::computeSelfFields() {
     //pc->update();
     this->bunchUpdate();
 
+    if (Options::cellSortFreq > 0 && localTrackStep_m % Options::cellSortFreq == 0) {
+        sortParticlesByCell();
+    }
+
     /*
 
      scatterCIC start
@@ -490,13 +613,15 @@ void PartBunch<T, Dim>::computeSelfFields() {
     /// \todo Add binned field solver here (needs iteration over bins, scatterPerBin calls and Etmp build up)! See https://gitlab.psi.ch/OPAL/opal-x/src/-/blame/binnedFieldSolver/src/PartBunch/PartBunch.cpp?ref_type=heads#L376
 
 
-    ippl::ParticleAttrib<T>* Q               = &this->pcontainer_m->Q;
-    typename Base::particle_position_type* R = &this->pcontainer_m->R;
+    if (ensembleSize_m > 1) {
+        computeSelfFieldsPerEnsembleMember();
+        return;
+    }
 
     this->fcontainer_m->getRho()             = 0.0;
     Field_t<Dim>* rho                        = &this->fcontainer_m->getRho();
 
-    scatter(*Q, *rho, *R); /// \todo replace with scatterCIC? --> later with scatterPerBin!
+    scatterCharge(*rho); /// \todo replace with scatterCIC? --> later with scatterPerBin!
 
 #ifdef doDEBUG
     const double qtot                        = this->qi_m * this->getTotalNum();
@@ -542,6 +667,123 @@ void PartBunch<T, Dim>::computeSelfFields() {
     //IpplTimings::stopTimer(SolveTimer);
 }
 
+template <typename T, unsigned Dim>
+void PartBunch<T, Dim>::computeSelfFieldsPerEnsembleMember() {
+    /*
+      The members only see their own charge: the charge of all other particles is set to
+      zero during the deposition and only the particles of the member take the gathered
+      field. The mesh of the last bunchUpdate covers all members. In the compact layout the
+      members are the species, only the species table is masked.
+    */
+    static IpplTimings::TimerRef ensembleT = IpplTimings::getTimer("ensembleSelfFields");
+    IpplTimings::startTimer(ensembleT);
+
+    auto pc            = this->pcontainer_m;
+    const size_t nloc  = pc->getLocalNum();
+    const bool compact = pc->hasCompactLayout();
+    auto Qview         = pc->Q.getView();
+    auto Eview         = pc->E.getView();
+    auto Spview        = pc->Sp.getView();
+
+    Kokkos::View<T*> charge("ensembleCharge", compact ? 0 : nloc);
+    Kokkos::View<Vector_t<T, Dim>*> field("ensembleField", nloc);
+    if (!compact) {
+        Kokkos::parallel_for(
+            "ensemble save charge", nloc, KOKKOS_LAMBDA(const size_t i) { charge(i) = Qview(i); });
+    }
+
+    Field_t<Dim>& rho = this->fcontainer_m->getRho();
+    for (short member = 0; member < ensembleSize_m; ++member) {
+        if (compact) {
+            pc->selectChargedSpecies(member);
+        } else {
+            Kokkos::parallel_for(
+                "ensemble mask charge", nloc, KOKKOS_LAMBDA(const size_t i) {
+                    Qview(i) = Spview(i) == member ? charge(i) : 0.0;
+                });
+        }
+
+        rho = 0.0;
+        scatterCharge(rho);
+
+        this->fsolver_m->runSolver();
+
+        gather(pc->E, this->fcontainer_m->getE(), pc->R);
+
+        Kokkos::parallel_for(
+            "ensemble keep field", nloc, KOKKOS_LAMBDA(const size_t i) {
+                if (Spview(i) == member) {
+                    field(i) = Eview(i);
+                }
+            });
+    }
+
+    if (compact) {
+        pc->selectChargedSpecies(-1);
+    }
+    Kokkos::parallel_for(
+        "ensemble restore", nloc, KOKKOS_LAMBDA(const size_t i) {
+            if (!compact) {
+                Qview(i) = charge(i);
+            }
+            Eview(i) = field(i);
+        });
+    Kokkos::fence();
+
+    IpplTimings::stopTimer(ensembleT);
+}
+
+template <typename T, unsigned Dim>
+void PartBunch<T, Dim>::scatterCharge(Field_t<Dim>& rho) {
+    static IpplTimings::TimerRef atomicScatterT = IpplTimings::getTimer("scatterAtomic");
+
+    ippl::ParticleAttrib<T>& q               = this->pcontainer_m->Q;
+    typename Base::particle_position_type& R = this->pcontainer_m->R;
+    const auto charges                       = this->pcontainer_m->getCharges();
+
+    if (TiledScatter::getDepositionMode(Options::deposition) == TiledScatter::DepositionMode::Tiled
+        && TiledScatter::scatter(charges, rho, R, this->getLocalNum())) {
+        return;
+    }
+
+    IpplTimings::startTimer(atomicScatterT);
+    if (this->pcontainer_m->hasCompactLayout()) {
+        TiledScatter::scatterAtomic(
+            charges, rho, R, Kokkos::RangePolicy<>(0, this->getLocalNum()),
+            Kokkos::View<size_t*>());
+    } else {
+        scatter(q, rho, R);
+    }
+    IpplTimings::stopTimer(atomicScatterT);
+}
+
+template <typename T, unsigned Dim>
+void PartBunch<T, Dim>::sortParticlesByCell() {
+    /*
+      Needs the mesh and layout of the current step, i.e. has to be called after bunchUpdate().
+      The bin attribute is permuted together with the other attributes, hence the histograms
+      stay valid and only the bin index array has to be rebuilt.
+    */
+    static IpplTimings::TimerRef cellSortT = IpplTimings::getTimer("sortParticlesByCell");
+    IpplTimings::startTimer(cellSortT);
+
+    const ippl::NDIndex<Dim>& lDom = this->fcontainer_m->getFL().getLocalNDIndex();
+    Mesh_t<Dim>& mesh              = this->fcontainer_m->getMesh();
+
+    Vector_t<int, Dim> lFirst, lExtent;
+    for (unsigned d = 0; d < Dim; ++d) {
+        lFirst[d]  = lDom[d].first();
+        lExtent[d] = lDom[d].length();
+    }
+
+    std::shared_ptr<AdaptBins_t> bins = this->getBins();
+    bins->sortContainerByCell(mesh.getOrigin(), mesh.getMeshSpacing(), lFirst, lExtent,
+                              ParticleBinning::getCellOrdering(Options::cellSortCurve));
+    bins->sortContainerByBin();
+
+    IpplTimings::stopTimer(cellSortT);
+}
+
 template <typename T, unsigned Dim>
 void PartBunch<T,Dim>::scatterCICPerBin(PartBunch<T,Dim>::binIndex_t binIndex) {
     /**
@@ -564,11 +806,18 @@ void PartBunch<T,Dim>::scatterCICPerBin(PartBunch<T,Dim>::binIndex_t binIndex) {
     if (binIndex == -1) {
         // Use original scatterCIC logic for all particles
         Q = this->qi_m * this->getTotalNum();
-        scatter(*q, *rho, *R);
+        scatterCharge(*rho);
     } else {
         // Use per-bin scattering logic
         Q = this->qi_m * this->bins_m->getNPartInBin(binIndex, true);
-        scatter(*q, *rho, *R, this->bins_m->getBinIterationPolicy(binIndex), this->bins_m->getHashArray());
+        if (this->pcontainer_m->hasCompactLayout()) {
+            TiledScatter::scatterAtomic(
+                this->pcontainer_m->getCharges(), *rho, *R,
+                this->bins_m->getBinIterationPolicy(binIndex), this->bins_m->getHashArray());
+        } else {
+            scatter(*q, *rho, *R, this->bins_m->getBinIterationPolicy(binIndex),
+                    this->bins_m->getHashArray());
+        }
     }
 
     m << "gammz= " << this->pcontainer_m->getMeanP()[2] << endl;
@@ -615,7 +864,8 @@ void PartBunch<T, Dim>::switchToUnitlessPositions(bool use_dt_per_particle) {
 	auto dtview = getParticleContainer()->dt.getView();
 	auto rview  = getParticleContainer()->R.getView();
 
-    if (use_dt_per_particle) {
+    // in the compact layout all particles use the time step of the bunch
+    if (use_dt_per_particle && !getParticleContainer()->hasCompactLayout()) {
         Kokkos::parallel_for("switchToUnitlessPositionsPerParticle", ippl::getRangePolicy(rview), KOKKOS_LAMBDA(const int i){
             double dt = dtview(i);
             
@@ -634,7 +884,8 @@ void PartBunch<T, Dim>::switchOffUnitlessPositions(bool use_dt_per_particle) {
 	auto dtview = getParticleContainer()->dt.getView();
 	auto rview  = getParticleContainer()->R.getView();
 
-    if (use_dt_per_particle) {
+    // in the compact layout all particles use the time step of the bunch
+    if (use_dt_per_particle && !getParticleContainer()->hasCompactLayout()) {
         Kokkos::parallel_for("switchOffUnitlessPositionsPerParticle", ippl::getRangePolicy(rview), KOKKOS_LAMBDA(const int i){
             double dt = dtview(i);
             
@@ -648,5 +899,70 @@ void PartBunch<T, Dim>::switchOffUnitlessPositions(bool use_dt_per_particle) {
     }
 }
 
+template <typename T, unsigned Dim>
+size_t PartBunch<T, Dim>::emitParticles() {
+    if (!sampler_m) {
+        return 0;
+    }
+
+    static IpplTimings::TimerRef emissionTimer = IpplTimings::getTimer("emitParticles");
+    IpplTimings::startTimer(emissionTimer);
+
+    auto pc                = this->pcontainer_m;
+    const size_type nlocal = pc->getLocalNum();
+    const double dt        = getdT();
+
+    sampler_m->emitParticles(getT(), dt);
+
+    const size_type nNew = pc->getLocalNum() - nlocal;
+
+    // particles emitted in the same fraction of the emission share an energy bin
+    const size_t numSteps = sampler_m->getNumberOfEmissionSteps();
+    if (weHaveEnergyBins() && numSteps > 0) {
+        lastEmittedEnergyBin_m = std::min<int>(
+            sampler_m->getLastEmissionStep() * numberOfEnergyBins_m / numSteps,
+            numberOfEnergyBins_m - 1);
+    }
+
+    if (nNew > 0) {
+        auto Qview   = pc->Q.getView();
+        auto Mview   = pc->M.getView();
+        auto dtview  = pc->dt.getView();
+        auto binview = pc->Bin.getView();
+        auto spview  = pc->Sp.getView();
+        auto Eview   = pc->E.getView();
+        auto Bview   = pc->B.getView();
+
+        const bool compact   = pc->hasCompactLayout();
+        const double qi      = qi_m;
+        const double mi      = mi_m;
+        const binIndex_t bin = lastEmittedEnergyBin_m;
+        Kokkos::parallel_for(
+            "initEmittedParticles", Kokkos::RangePolicy<>(nlocal, nlocal + nNew),
+            KOKKOS_LAMBDA(const size_t i) {
+                // the emitted particles belong to the first species
+                spview(i) = 0;
+                if (!compact) {
+                    Qview(i)  = qi;
+                    Mview(i)  = mi;
+                    dtview(i) = dt;
+                }
+                binview(i) = bin;
+                // the fields of the step were reset before the emission, see
+                // ParallelTracker::timeIntegration1, the new slots may hold old values
+                Eview(i) = 0;
+                Bview(i) = 0;
+            });
+        Kokkos::fence();
+    }
+
+    size_t numEmitted = nNew;
+    ippl::Comm->allreduce(&numEmitted, 1, std::plus<size_t>());
+
+    IpplTimings::stopTimer(emissionTimer);
+
+    return numEmitted;
+}
+
 // Explicit instantiations
 template class PartBunch<double, 3>;
@@ -47,12 +47,14 @@ diagnostics(): calculate statistics and maybe write tp h5 and stat files
 #include "Algorithms/CoordinateSystemTrafo.h"
 #include "Attributes/Attributes.h"
 #include "Distribution/Distribution.h"
+#include "Distribution/SamplingBase.hpp"
 #include "Manager/BaseManager.h"
 #include "Manager/PicManager.h"
 #include "PartBunch/FieldContainer.hpp"
 #include "PartBunch/FieldSolver.hpp"
 #include "PartBunch/LoadBalancer.hpp"
 #include "PartBunch/ParticleContainer.hpp"
+#include "PartBunch/TiledScatter.hpp"
 #include "Physics/Physics.h"
 #include "Random/Distribution.h"
 #include "Random/InverseTransformSampling.h"
@@ -212,6 +214,16 @@ private:
     std::shared_ptr<Distribution> OPALdist_m;
 
     std::shared_ptr<FieldSolverCmd> OPALFieldSolver_m;
+
+    /// emits the particles of a cathode run, nullptr if the bunch is not emitted
+    std::shared_ptr<SamplingBase> sampler_m;
+
+    int numberOfEnergyBins_m;
+
+    int lastEmittedEnergyBin_m;
+
+    /// number of independent bunches in the container, member r is the species Sp = r
+    short ensembleSize_m;
     
     // unit state of PartBunch
     // UnitState_t unit_state_m;
@@ -313,6 +325,9 @@ public:
 
     void scatterCICPerBin(binIndex_t binIndex);
 
+    /// deposits the charge of all particles, either with atomics or tiled (see DEPOSITION option)
+    void scatterCharge(Field_t<Dim>& rho);
+
     /*
       Up to here it is like the opaltest
     */
@@ -330,11 +345,11 @@ public:
     void do_binaryRepart();
 
     void setCharge() {
-        this->getParticleContainer()->Q = qi_m;
+        this->getParticleContainer()->setCharge(qi_m);
     }
     
     void setMass() {
-        this->getParticleContainer()->M = mi_m;
+        this->getParticleContainer()->setMass(mi_m);
     }
 
     double getCharge() const {
@@ -379,6 +394,9 @@ public:
 
     void gatherLoadBalanceStatistics();
 
+    /// registers the particle attributes, fields, solver workspace and binning views of this rank
+    void updateMemoryAccounting();
+
     size_t getLoadBalance(int p) {
         return globalPartPerNode_m[p];
     }
@@ -441,9 +459,9 @@ public:
         return 0;
     }
 
+    /// 1D line density (charge per meter) along z with nBins bins, meshInfo = (zmin, hz)
     void calcLineDensity(
-        unsigned int nBins, std::vector<double>& lineDensity, std::pair<double, double>& meshInfo) {
-    }
+        unsigned int nBins, std::vector<double>& lineDensity, std::pair<double, double>& meshInfo);
 
     void setBeamFrequency(double v) {
     }
@@ -454,6 +472,21 @@ public:
 
     void computeSelfFields();
 
+    /// solves the space charge of every ensemble member on its own, all share the mesh
+    void computeSelfFieldsPerEnsembleMember();
+
+    /// every member is a species of its own, see ParticleContainer::Sp
+    void setEnsembleSize(short ensembleSize) {
+        ensembleSize_m = ensembleSize;
+        this->getParticleContainer()->setNumberOfSpecies(ensembleSize);
+    }
+    short getEnsembleSize() const {
+        return ensembleSize_m;
+    }
+
+    /// reorders the particle container along a space filling curve through the local grid cells
+    void sortParticlesByCell();
+
     Inform& print(Inform& os);
 
 
@@ -470,25 +503,26 @@ public:
     }
 
     bool getIfBeamEmitting() {
-        return false;
+        return sampler_m && sampler_m->isEmitting(getT());
     }
     int getLastEmittedEnergyBin() {
-        return 0;
+        return lastEmittedEnergyBin_m;
     }
     size_t getNumberOfEmissionSteps() {
-        return 0;
+        return sampler_m ? sampler_m->getNumberOfEmissionSteps() : 0;
     }
     int getNumberOfEnergyBins() {
-        return 0;
+        return numberOfEnergyBins_m;
     }
 
     void Rebin() {
     }
 
     void setEnergyBins(int numberOfEnergyBins) {
+        numberOfEnergyBins_m = numberOfEnergyBins;
     }
     bool weHaveEnergyBins() {
-        return false;
+        return numberOfEnergyBins_m > 0;
     }
     void setTEmission(double t) {
     }
@@ -499,15 +533,22 @@ public:
         return false;
     }
     // void setPBins(PartBins* pbin) {}
-    size_t emitParticles(double eZ) {
-        return 0;
+
+    void setSampler(std::shared_ptr<SamplingBase> sampler) {
+        sampler_m = sampler;
+    }
+    std::shared_ptr<SamplingBase> getSampler() const {
+        return sampler_m;
     }
+
+    /// emits the particles of the current time step, returns the global number of new particles
+    size_t emitParticles();
     void updateNumTotal() {
     }
     void rebin() {
     }
     int getLastemittedBin() {
-        return 0;
+        return lastEmittedEnergyBin_m;
     }
     void setLocalBinCount(size_t num, int bin) {
     }
@@ -670,31 +711,31 @@ public:
         return this->pcontainer_m->getNormEmit();
     }
     Vector_t<double, Dim> get_halo() const {
-        return Vector_t<double, Dim>(0.0);
+        return this->pcontainer_m->getHalo();
     }
     Vector_t<double, Dim> get_68Percentile() const {
-        return Vector_t<double, Dim>(0.0);
+        return this->pcontainer_m->get68Percentile();
     }
     Vector_t<double, Dim> get_95Percentile() const {
-        return Vector_t<double, Dim>(0.0);
+        return this->pcontainer_m->get95Percentile();
     }
     Vector_t<double, Dim> get_99Percentile() const {
-        return Vector_t<double, Dim>(0.0);
+        return this->pcontainer_m->get99Percentile();
     }
     Vector_t<double, Dim> get_99_99Percentile() const {
-        return Vector_t<double, Dim>(0.0);
+        return this->pcontainer_m->get99_99Percentile();
     }
     Vector_t<double, Dim> get_normalizedEps_68Percentile() const {
-        return Vector_t<double, Dim>(0.0);
+        return this->pcontainer_m->getNormEmit68Percentile();
     }
     Vector_t<double, Dim> get_normalizedEps_95Percentile() const {
-        return Vector_t<double, Dim>(0.0);
+        return this->pcontainer_m->getNormEmit95Percentile();
     }
     Vector_t<double, Dim> get_normalizedEps_99Percentile() const {
-        return Vector_t<double, Dim>(0.0);
+        return this->pcontainer_m->getNormEmit99Percentile();
     }
     Vector_t<double, Dim> get_normalizedEps_99_99Percentile() const {
-        return Vector_t<double, Dim>(0.0);
+        return this->pcontainer_m->getNormEmit99_99Percentile();
     }
     Vector_t<double, Dim> get_hr() const {
         return Vector_t<double, Dim>(0.0);
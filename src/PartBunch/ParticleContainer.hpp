@@ -2,7 +2,11 @@
 #ifndef OPAL_PARTICLE_CONTAINER_H
 #define OPAL_PARTICLE_CONTAINER_H
 
+#include <algorithm>
+#include <functional>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "Manager/BaseManager.h"
 
@@ -22,6 +26,9 @@ public:
     /// Defines which type to use as a particle bin.
     using bin_index_type = short int;  // Needed in AdaptBins class
 
+    /// Index array type of the permutations, the same as in AdaptBins
+    using hash_type = ippl::detail::hash_type<Kokkos::DefaultExecutionSpace::memory_space>;
+
 public:
     /// charge in [Cb]
     ippl::ParticleAttrib<double> Q;
@@ -32,13 +39,11 @@ public:
     /// timestep in [s]
     ippl::ParticleAttrib<double> dt;
 
-    /// the scalar potential in [Cb/s]
-    ippl::ParticleAttrib<double> Phi;
-
     /// the energy bin the particle is in
     ippl::ParticleAttrib<bin_index_type> Bin;
 
-    /// the particle specis
+    /// the particle species, the index into the species table. Every member of an ENSEMBLE
+    /// is a species of its own, all with the charge and the mass of the beam
     ippl::ParticleAttrib<short> Sp;
 
     /// particle momenta [\beta\gamma]
@@ -53,8 +58,57 @@ public:
     /// magnetic field at particle position
     typename Base::particle_position_type B;
 
-    ParticleContainer(Mesh_t<Dim>& mesh, FieldLayout_t<Dim>& FL) : pl_m(FL, mesh), distMoments_m() {
+    /**
+     * @brief Device-callable access to the charge or the mass of particle i.
+     *
+     * Reads the attribute in the full layout and the species table in the compact layout.
+     */
+    struct SpeciesConstant {
+        typename ippl::ParticleAttrib<double>::view_type values;
+        Kokkos::View<double*> table;
+        typename ippl::ParticleAttrib<short>::view_type species;
+        bool perParticle;
+
+        KOKKOS_INLINE_FUNCTION double operator()(const size_type i) const {
+            return perParticle ? values(i) : table(species(i));
+        }
+    };
+
+    /**
+     * @brief Device-callable access to the time step of particle i.
+     *
+     * All particles share the time step of the bunch, the attribute dt only holds a copy of it
+     * in the full layout.
+     */
+    struct TimeStep {
+        typename ippl::ParticleAttrib<double>::view_type values;
+        double uniform;
+        bool perParticle;
+
+        KOKKOS_INLINE_FUNCTION double operator()(const size_type i) const {
+            return perParticle ? values(i) : uniform;
+        }
+
+        KOKKOS_INLINE_FUNCTION void set(const size_type i, const double newdT) const {
+            if (perParticle) {
+                values(i) = newdT;
+            }
+        }
+    };
+
+    ParticleContainer(Mesh_t<Dim>& mesh, FieldLayout_t<Dim>& FL, bool compactLayout = false)
+        : pl_m(FL, mesh),
+          distMoments_m(),
+          compactLayout_m(compactLayout),
+          idOffset_m(0),
+          charge_m(0.0),
+          mass_m(0.0),
+          speciesCharge_m("speciesCharge", 1),
+          speciesMass_m("speciesMass", 1) {
         this->initialize(pl_m);
+        // ID and R are registered by the base class
+        trackAttribute(this->ID);
+        trackAttribute(this->R);
         registerAttributes();
         setupBCs();
     }
@@ -63,11 +117,12 @@ public:
     }
 
     void registerAttributes() {
-        // register the particle attributes
-        this->addAttribute(Q);
-        this->addAttribute(M);
-        this->addAttribute(dt);
-        this->addAttribute(Phi);
+        // in the compact layout Q, M and dt are neither stored nor exchanged, see COMPACTPARTICLES
+        if (!compactLayout_m) {
+            this->addAttribute(Q);
+            this->addAttribute(M);
+            this->addAttribute(dt);
+        }
         this->addAttribute(Bin);
         this->addAttribute(Sp);
         this->addAttribute(P);
@@ -80,6 +135,143 @@ public:
         setBCAllPeriodic();
     }
 
+    /// registers the attribute with IPPL and with applyPermutation and reserve
+    template <typename Attrib>
+    void addAttribute(Attrib& attrib) {
+        Base::addAttribute(attrib);
+        trackAttribute(attrib);
+    }
+
+    /// creates nLocal particles, see continueIDsAfterLocalParticles for their IDs
+    void create(size_type nLocal) {
+        const size_type first = this->getLocalNum();
+        Base::create(nLocal);
+
+        if (idOffset_m > 0) {
+            auto IDview       = this->ID.getView();
+            const auto offset = idOffset_m;
+            Kokkos::parallel_for(
+                "offsetParticleIDs", Kokkos::RangePolicy<>(first, first + nLocal),
+                KOKKOS_LAMBDA(const size_type i) { IDview(i) += offset; });
+        }
+    }
+
+    /**
+     * @brief The IDs of particles created from now on are larger than the IDs of the local
+     *        particles on all ranks, e.g. after the IDs were restored from a checkpoint.
+     *
+     * Collective.
+     */
+    void continueIDsAfterLocalParticles() {
+        using index_type = typename Base::index_type;
+
+        auto IDview      = this->ID.getView();
+        index_type maxID = -1;
+        Kokkos::parallel_reduce(
+            "maxParticleID", this->getLocalNum(),
+            KOKKOS_LAMBDA(const size_type i, index_type& localMax) {
+                localMax = Kokkos::max(localMax, IDview(i));
+            },
+            Kokkos::Max<index_type>(maxID));
+        ippl::Comm->allreduce(maxID, 1, std::greater<index_type>());
+
+        idOffset_m = maxID + 1;
+    }
+
+    /// whether Q, M and dt are replaced by the species table and the time step of the bunch
+    bool hasCompactLayout() const {
+        return compactLayout_m;
+    }
+
+    /// sets the number of species, i.e. the size of the species table indexed by Sp
+    void setNumberOfSpecies(short numSpecies) {
+        Kokkos::realloc(speciesCharge_m, std::max<short>(numSpecies, 1));
+        Kokkos::realloc(speciesMass_m, std::max<short>(numSpecies, 1));
+        Kokkos::deep_copy(speciesCharge_m, charge_m);
+        Kokkos::deep_copy(speciesMass_m, mass_m);
+    }
+
+    /// sets the charge of all particles
+    void setCharge(double charge) {
+        charge_m = charge;
+        Kokkos::deep_copy(speciesCharge_m, charge);
+        if (!compactLayout_m) {
+            Q = charge;
+        }
+    }
+
+    /// sets the mass of all particles
+    void setMass(double mass) {
+        mass_m = mass;
+        Kokkos::deep_copy(speciesMass_m, mass);
+        if (!compactLayout_m) {
+            M = mass;
+        }
+    }
+
+    /**
+     * @brief Only the particles of one species keep their charge in the species table.
+     *
+     * @param species The charged species, -1 restores the charge of all species.
+     */
+    void selectChargedSpecies(short species) {
+        auto table = Kokkos::create_mirror_view(speciesCharge_m);
+        for (size_t s = 0; s < table.extent(0); ++s) {
+            table(s) = (species < 0 || static_cast<short>(s) == species) ? charge_m : 0.0;
+        }
+        Kokkos::deep_copy(speciesCharge_m, table);
+    }
+
+    SpeciesConstant getCharges() {
+        return SpeciesConstant{Q.getView(), speciesCharge_m, Sp.getView(), !compactLayout_m};
+    }
+
+    SpeciesConstant getMasses() {
+        return SpeciesConstant{M.getView(), speciesMass_m, Sp.getView(), !compactLayout_m};
+    }
+
+    /// the time steps of the particles, uniformdT is the time step of the bunch
+    TimeStep getTimeSteps(double uniformdT) {
+        return TimeStep{dt.getView(), uniformdT, !compactLayout_m};
+    }
+
+    /// the charges of the local particles, a copy from the species table in the compact layout
+    typename ippl::ParticleAttrib<double>::view_type getChargeView() {
+        return compactLayout_m ? expand(getCharges(), "charges") : Q.getView();
+    }
+
+    /// the masses of the local particles, a copy from the species table in the compact layout
+    typename ippl::ParticleAttrib<double>::view_type getMassView() {
+        return compactLayout_m ? expand(getMasses(), "masses") : M.getView();
+    }
+
+    /**
+     * @brief Reorders all local particles, s.t. particle i afterwards holds the data of particle perm(i).
+     *
+     * All registered attributes are permuted.
+     *
+     * @param perm Permutation of [0, getLocalNum()), e.g. from AdaptBins::sortContainerByCell.
+     */
+    void applyPermutation(const hash_type& perm) {
+        const size_type nlocal = this->getLocalNum();
+
+        for (const auto& permute : permuteAttributes_m) {
+            permute(perm, nlocal);
+        }
+    }
+
+    /**
+     * @brief Grows all registered attributes to hold at least capacity particles, s.t. subsequent calls
+     *        to create() up to this size neither reallocate nor copy.
+     *
+     * @param capacity Number of local particles to reserve memory for.
+     */
+    void reserve(size_type capacity) {
+        for (const auto& grow : reserveAttributes_m) {
+            grow(capacity);
+        }
+    }
+
     PLayout_t<T, Dim>& getPL() {
         return pl_m;
     }
@@ -89,7 +281,8 @@ public:
         Np = (Np == 0) ? 1 : Np; // only used for normalization in the moments class --> avoid division by zero
 
         size_t Nlocal = this->getLocalNum();
-        distMoments_m.computeMoments(this->R.getView(), this->P.getView(), this->M.getView(), Np, Nlocal);
+        auto Mview = getMassView();
+        distMoments_m.computeMoments(this->R.getView(), this->P.getView(), Mview, Np, Nlocal);
     }
 
     Vector_t<double, 3> getMeanP() const{
@@ -149,6 +342,42 @@ public:
         return distMoments_m.getNormalizedEmittance();
     }
 
+    Vector_t<double, 3> getHalo() const {
+        return distMoments_m.getHalo();
+    }
+
+    Vector_t<double, 3> get68Percentile() const {
+        return distMoments_m.get68Percentile();
+    }
+
+    Vector_t<double, 3> get95Percentile() const {
+        return distMoments_m.get95Percentile();
+    }
+
+    Vector_t<double, 3> get99Percentile() const {
+        return distMoments_m.get99Percentile();
+    }
+
+    Vector_t<double, 3> get99_99Percentile() const {
+        return distMoments_m.get99_99Percentile();
+    }
+
+    Vector_t<double, 3> getNormEmit68Percentile() const {
+        return distMoments_m.getNormalizedEmittance68Percentile();
+    }
+
+    Vector_t<double, 3> getNormEmit95Percentile() const {
+        return distMoments_m.getNormalizedEmittance95Percentile();
+    }
+
+    Vector_t<double, 3> getNormEmit99Percentile() const {
+        return distMoments_m.getNormalizedEmittance99Percentile();
+    }
+
+    Vector_t<double, 3> getNormEmit99_99Percentile() const {
+        return distMoments_m.getNormalizedEmittance99_99Percentile();
+    }
+
    double getDx() const {
        return distMoments_m.getDx();
    }
@@ -191,13 +420,74 @@ public:
     }
 
 private:
+    template <typename Attrib>
+    void trackAttribute(Attrib& attrib) {
+        permuteAttributes_m.push_back([&attrib](const hash_type& perm, size_type nlocal) {
+            permuteAttribute(attrib, perm, nlocal);
+        });
+        reserveAttributes_m.push_back([&attrib](size_type capacity) {
+            reserveAttribute(attrib, capacity);
+        });
+    }
+
+    typename ippl::ParticleAttrib<double>::view_type expand(
+        const SpeciesConstant& constant, const std::string& name) const {
+        const size_type nlocal = this->getLocalNum();
+        typename ippl::ParticleAttrib<double>::view_type view(
+            Kokkos::view_alloc(Kokkos::WithoutInitializing, name), nlocal);
+        Kokkos::parallel_for(
+            "expandSpeciesConstant", nlocal,
+            KOKKOS_LAMBDA(const size_type i) { view(i) = constant(i); });
+        return view;
+    }
+
+    template <typename Attrib>
+    static void reserveAttribute(Attrib& attrib, size_type capacity) {
+        if (attrib.getView().extent(0) < capacity) {
+            Kokkos::resize(attrib.getView(), capacity);
+        }
+    }
+
+    template <typename Attrib, typename HashType>
+    static void permuteAttribute(Attrib& attrib, const HashType& perm, size_type nlocal) {
+        using attrib_view_type = typename Attrib::view_type;
+
+        attrib_view_type view = attrib.getView();
+        attrib_view_type tmp(Kokkos::view_alloc(Kokkos::WithoutInitializing, "permuteTmp"), nlocal);
+
+        Kokkos::parallel_for("permuteAttributeGather", nlocal, KOKKOS_LAMBDA(const size_type i) {
+            tmp(i) = view(perm(i));
+        });
+        Kokkos::parallel_for("permuteAttributeCopy", nlocal, KOKKOS_LAMBDA(const size_type i) {
+            view(i) = tmp(i);
+        });
+    }
+
     void setBCAllPeriodic() {
         this->setParticleBC(ippl::BC::PERIODIC);
     }
 
     PLayout_t<T, Dim> pl_m;
 
+    /// permutes one registered attribute, see applyPermutation
+    std::vector<std::function<void(const hash_type&, size_type)>> permuteAttributes_m;
+
+    /// grows one registered attribute, see reserve
+    std::vector<std::function<void(size_type)>> reserveAttributes_m;
+
     DistributionMoments distMoments_m;
+
+    bool compactLayout_m;
+
+    /// added to the IDs assigned by the base class, see continueIDsAfterLocalParticles
+    typename Base::index_type idOffset_m;
+
+    double charge_m;
+    double mass_m;
+
+    /// charge and mass per species, indexed by Sp
+    Kokkos::View<double*> speciesCharge_m;
+    Kokkos::View<double*> speciesMass_m;
 };
 
 #endif
@@ -0,0 +1,273 @@
+#ifndef OPAL_TILED_SCATTER_H
+#define OPAL_TILED_SCATTER_H
+
+/**
+ * @file TiledScatter.hpp
+ * @brief Contention free CIC charge deposition for host (OpenMP/Serial) builds.
+ *
+ * The generic `scatter()` from IPPL deposits every particle with atomic adds into the
+ * shared charge density. With many threads, the atomics on the densely populated central
+ * cells serialize the deposition. The tiled deposition instead splits the (cell sorted)
+ * particles into contiguous chunks, one per tile. Each tile deposits into a private buffer
+ * that covers the cells touched by its particles plus the CIC guard cells. Finally, the
+ * tiles are reduced into the field plane by plane, s.t. every grid plane is owned by
+ * exactly one thread and no atomics are needed.
+ *
+ * The tiles are only compact if the container is sorted by cell (see CELLSORTFREQ and
+ * AdaptBins::sortContainerByCell). If the tile buffers would become too large, the
+ * function falls back to the atomic scatter.
+ *
+ * The charge is passed as a device-callable q(i), s.t. the charge can be looked up in the
+ * species table of the compact particle layout. The atomic scatter of IPPL needs a particle
+ * attribute, scatterAtomic() is the equivalent for the compact layout.
+ */
+
+#include <algorithm>
+#include <limits>
+#include <string>
+
+#include "Ippl.h"
+
+namespace TiledScatter {
+
+    /// Deposition modes selectable with the DEPOSITION option
+    enum class DepositionMode { Atomic, Tiled };
+
+    inline DepositionMode getDepositionMode(const std::string& name) {
+        return (name == "TILED") ? DepositionMode::Tiled : DepositionMode::Atomic;
+    }
+
+    /// The tiled deposition needs direct host access to the particle and field data.
+    constexpr bool isAvailable() {
+        return Kokkos::SpaceAccessibility<Kokkos::DefaultHostExecutionSpace,
+                                          Kokkos::DefaultExecutionSpace::memory_space>::accessible;
+    }
+
+    /// Minimal number of particles per tile, smaller chunks are not worth the buffer setup
+    constexpr size_t minParticlesPerTile = 4096;
+
+    /// Fall back to the atomic scatter if the tile buffers exceed this multiple of the local field size
+    constexpr size_t maxTileVolumeFactor = 4;
+
+    /**
+     * @brief CIC scatter of the charge q(i) at positions R into field f without atomics.
+     *
+     * Uses the same index and weight convention as ippl::ParticleAttrib::scatter and
+     * accumulates the halo afterwards.
+     *
+     * @return false if the tiled deposition was not possible and nothing was deposited.
+     */
+    template <typename Charge, typename Field, typename PositionAttrib>
+    bool scatter(const Charge& q, Field& f, const PositionAttrib& R, size_t nlocal) {
+        constexpr unsigned Dim = 3;
+
+        using exec_space       = Kokkos::DefaultHostExecutionSpace;
+        using value_type       = typename Field::value_type;
+        using vector_type      = ippl::Vector<double, Dim>;
+        using tile_view_type   = Kokkos::View<value_type*, Kokkos::HostSpace>;
+        using box_view_type    = Kokkos::View<int* [2 * Dim], Kokkos::HostSpace>;
+        using offset_view_type = Kokkos::View<size_t*, Kokkos::HostSpace>;
+
+        if constexpr (!isAvailable()) {
+            return false;
+        } else {
+            static IpplTimings::TimerRef tiledScatterT = IpplTimings::getTimer("scatterTiled");
+
+            if (nlocal == 0) {
+                f.accumulateHalo();
+                return true;
+            }
+
+            IpplTimings::startTimer(tiledScatterT);
+
+            auto view  = f.getView();
+            auto qview = q;
+            auto rview = R.getView();
+
+            const auto& mesh           = f.get_mesh();
+            const vector_type& dx      = mesh.getMeshSpacing();
+            const vector_type& origin  = mesh.getOrigin();
+            const vector_type invdx    = 1.0 / dx;
+            const ippl::NDIndex<Dim>& lDom = f.getLayout().getLocalNDIndex();
+            const int nghost           = f.getNghost();
+
+            vector_type o = origin;
+            ippl::Vector<int, Dim> shift;
+            for (unsigned d = 0; d < Dim; ++d) {
+                shift[d] = nghost - lDom[d].first();
+            }
+
+            const size_t concurrency = exec_space().concurrency();
+            size_t nTiles            = std::min(concurrency, (nlocal + minParticlesPerTile - 1) / minParticlesPerTile);
+            nTiles                   = std::max<size_t>(nTiles, 1);
+
+            // 1. bounding box (in field view indices incl. the CIC guard cell) of every tile,
+            //    not clipped to the field, s.t. the deposition never leaves the tile buffer
+            box_view_type boxes("tileBoxes", nTiles);
+            Kokkos::parallel_for("tileBoundingBoxes", Kokkos::RangePolicy<exec_space>(0, nTiles), [=](const size_t t) {
+                const size_t begin = t * nlocal / nTiles;
+                const size_t end   = (t + 1) * nlocal / nTiles;
+                int lo[Dim], hi[Dim];
+                for (unsigned d = 0; d < Dim; ++d) {
+                    lo[d] = std::numeric_limits<int>::max();
+                    hi[d] = std::numeric_limits<int>::lowest();
+                }
+                for (size_t i = begin; i < end; ++i) {
+                    for (unsigned d = 0; d < Dim; ++d) {
+                        const int idx = static_cast<int>((rview(i)[d] - o[d]) * invdx[d] + 0.5) + shift[d];
+                        lo[d] = std::min(lo[d], idx - 1);
+                        hi[d] = std::max(hi[d], idx);
+                    }
+                }
+                for (unsigned d = 0; d < Dim; ++d) {
+                    boxes(t, d)       = lo[d];
+                    boxes(t, Dim + d) = hi[d];
+                }
+            });
+            Kokkos::fence();
+
+            // 2. offsets of the tile buffers, fall back if the tiles are not compact (e.g. unsorted container)
+            offset_view_type offsets("tileOffsets", nTiles + 1);
+            for (size_t t = 0; t < nTiles; ++t) {
+                size_t volume = 1;
+                for (unsigned d = 0; d < Dim; ++d) {
+                    volume *= std::max(boxes(t, Dim + d) - boxes(t, d) + 1, 0);
+                }
+                offsets(t + 1) = offsets(t) + volume;
+            }
+
+            const size_t fieldVolume = view.extent(0) * view.extent(1) * view.extent(2);
+            if (offsets(nTiles) > maxTileVolumeFactor * fieldVolume) {
+                IpplTimings::stopTimer(tiledScatterT);
+                return false;
+            }
+
+            tile_view_type tiles("tileBuffers", offsets(nTiles));
+
+            // 3. every tile deposits its particles into its private buffer
+            Kokkos::parallel_for("tileDeposit", Kokkos::RangePolicy<exec_space>(0, nTiles), [=](const size_t t) {
+                const size_t begin = t * nlocal / nTiles;
+                const size_t end   = (t + 1) * nlocal / nTiles;
+                const int x0 = boxes(t, 0), y0 = boxes(t, 1), z0 = boxes(t, 2);
+                const int ny = boxes(t, Dim + 1) - y0 + 1;
+                const int nz = boxes(t, Dim + 2) - z0 + 1;
+                value_type* tile = tiles.data() + offsets(t);
+
+                for (size_t i = begin; i < end; ++i) {
+                    vector_type l = (rview(i) - o) * invdx + 0.5;
+                    int idx[Dim];
+                    double whi[Dim], wlo[Dim];
+                    for (unsigned d = 0; d < Dim; ++d) {
+                        idx[d] = static_cast<int>(l[d]);
+                        whi[d] = l[d] - idx[d];
+                        wlo[d] = 1.0 - whi[d];
+                        idx[d] += shift[d] - 1;
+                    }
+                    const value_type val = qview(i);
+                    for (int a = 0; a < 2; ++a) {
+                        const int ix = idx[0] + a - x0;
+                        for (int b = 0; b < 2; ++b) {
+                            const int iy = idx[1] + b - y0;
+                            for (int c = 0; c < 2; ++c) {
+                                const int iz = idx[2] + c - z0;
+                                const double w = (a ? whi[0] : wlo[0]) * (b ? whi[1] : wlo[1]) * (c ? whi[2] : wlo[2]);
+                                tile[(ix * ny + iy) * nz + iz] += w * val;
+                            }
+                        }
+                    }
+                }
+            });
+            Kokkos::fence();
+
+            // 4. reduce the tiles into the field, every x-plane is written by exactly one thread
+            Kokkos::parallel_for("tileReduce", Kokkos::RangePolicy<exec_space>(0, view.extent(0)), [=](const size_t k) {
+                const int ix = static_cast<int>(k);
+                for (size_t t = 0; t < nTiles; ++t) {
+                    const int x0 = boxes(t, 0), y0 = boxes(t, 1), z0 = boxes(t, 2);
+                    const int x1 = boxes(t, Dim), y1 = boxes(t, Dim + 1), z1 = boxes(t, Dim + 2);
+                    if (ix < x0 || ix > x1) continue;
+
+                    // particles outside of the local domain (+ ghosts) are dropped, like in ippl::scatter
+                    const int ny = y1 - y0 + 1;
+                    const int nz = z1 - z0 + 1;
+                    const int yEnd = std::min(y1, static_cast<int>(view.extent(1)) - 1);
+                    const int zEnd = std::min(z1, static_cast<int>(view.extent(2)) - 1);
+                    const value_type* tile = tiles.data() + offsets(t);
+                    for (int iy = std::max(y0, 0); iy <= yEnd; ++iy) {
+                        for (int iz = std::max(z0, 0); iz <= zEnd; ++iz) {
+                            view(ix, iy, iz) += tile[((ix - x0) * ny + (iy - y0)) * nz + (iz - z0)];
+                        }
+                    }
+                }
+            });
+            Kokkos::fence();
+
+            f.accumulateHalo();
+
+            IpplTimings::stopTimer(tiledScatterT);
+            return true;
+        }
+    }
+
+    /**
+     * @brief CIC scatter of the charge q(i) at positions R into field f with atomic adds.
+     *
+     * Same as ippl::ParticleAttrib::scatter, the particles are mapped with the hash array
+     * if it isn't empty.
+     */
+    template <typename Charge, typename Field, typename PositionAttrib, typename Policy,
+              typename HashArray>
+    void scatterAtomic(const Charge& q, Field& f, const PositionAttrib& R, const Policy& policy,
+                       const HashArray& hash) {
+        constexpr unsigned Dim = 3;
+
+        using value_type  = typename Field::value_type;
+        using vector_type = ippl::Vector<double, Dim>;
+
+        auto view  = f.getView();
+        auto rview = R.getView();
+
+        const auto& mesh               = f.get_mesh();
+        const vector_type& dx          = mesh.getMeshSpacing();
+        const vector_type o            = mesh.getOrigin();
+        const vector_type invdx        = 1.0 / dx;
+        const ippl::NDIndex<Dim>& lDom = f.getLayout().getLocalNDIndex();
+        const int nghost               = f.getNghost();
+
+        ippl::Vector<int, Dim> shift;
+        for (unsigned d = 0; d < Dim; ++d) {
+            shift[d] = nghost - lDom[d].first();
+        }
+
+        const bool useHash = hash.extent(0) > 0;
+        Kokkos::parallel_for(
+            "scatterAtomic", policy, KOKKOS_LAMBDA(const size_t j) {
+                const size_t i = useHash ? hash(j) : j;
+
+                vector_type l = (rview(i) - o) * invdx + 0.5;
+                int idx[Dim];
+                double whi[Dim], wlo[Dim];
+                for (unsigned d = 0; d < Dim; ++d) {
+                    idx[d] = static_cast<int>(l[d]);
+                    whi[d] = l[d] - idx[d];
+                    wlo[d] = 1.0 - whi[d];
+                    idx[d] += shift[d] - 1;
+                }
+                const value_type val = q(i);
+                for (int a = 0; a < 2; ++a) {
+                    for (int b = 0; b < 2; ++b) {
+                        for (int c = 0; c < 2; ++c) {
+                            const double w = (a ? whi[0] : wlo[0]) * (b ? whi[1] : wlo[1])
+                                             * (c ? whi[2] : wlo[2]);
+                            Kokkos::atomic_add(&view(idx[0] + a, idx[1] + b, idx[2] + c), w * val);
+                        }
+                    }
+                }
+            });
+
+        f.accumulateHalo();
+    }
+
+}  // namespace TiledScatter
+
+#endif
@@ -23,25 +23,32 @@
 
 /// Leap-Frog 2nd order
 template <typename FieldFunction, typename ... Arguments>
-class LF2 : public Stepper<FieldFunction, Arguments...> {
+class LF2 : public Stepper<LF2<FieldFunction, Arguments...>, FieldFunction, Arguments...> {
     
+    friend class Stepper<LF2<FieldFunction, Arguments...>, FieldFunction, Arguments...>;
+
 public:
     
-    LF2(const FieldFunction& fieldfunc) : Stepper<FieldFunction, Arguments ...>(fieldfunc) { }
+    KOKKOS_INLINE_FUNCTION LF2(const FieldFunction& fieldfunc)
+        : Stepper<LF2<FieldFunction, Arguments...>, FieldFunction, Arguments ...>(fieldfunc) { }
     
 private:
-    bool doAdvance_m(PartBunch_t* bunch,
-                     const size_t& i,
-                     const double& t,
-                     const double dt,
-                     Arguments& ... args) const;
+    KOKKOS_INLINE_FUNCTION bool doAdvance_m(Vector_t<double, 3>& R,
+                                            Vector_t<double, 3>& P,
+                                            const size_t& i,
+                                            const double& t,
+                                            const double dt,
+                                            const double& mass,
+                                            const double& charge,
+                                            Arguments& ... args) const;
     
     
-    void push_m(Vector_t<double, 3>& R, const Vector_t<double, 3>& P, const double& h) const;
+    KOKKOS_INLINE_FUNCTION void push_m(Vector_t<double, 3>& R, const Vector_t<double, 3>& P, const double& h) const;
     
-    bool kick_m(PartBunch_t* bunch, const size_t& i,
-                const double& t, const double& h,
-                Arguments& ... args) const;
+    KOKKOS_INLINE_FUNCTION bool kick_m(const Vector_t<double, 3>& R, Vector_t<double, 3>& P,
+                                       const size_t& i, const double& t, const double& h,
+                                       const double& mass, const double& charge,
+                                       Arguments& ... args) const;
 };
 
 #include "LF2.hpp"
@@ -16,53 +16,48 @@
 // along with OPAL. If not, see <https://www.gnu.org/licenses/>.
 //
 #include "BorisPusher.h"
-#include "Physics/Units.h"
 
 template <typename FieldFunction, typename... Arguments>
-bool LF2<FieldFunction, Arguments...>::doAdvance_m(
-    PartBunch_t* bunch, const size_t& i, const double& t, const double dt,
-    Arguments&... args) const {
+KOKKOS_INLINE_FUNCTION bool LF2<FieldFunction, Arguments...>::doAdvance_m(
+    Vector_t<double, 3>& R, Vector_t<double, 3>& P, const size_t& i, const double& t,
+    const double dt, const double& mass, const double& charge, Arguments&... args) const {
     bool flagNoDeletion = true;
 
     // push for first LF2 half step
-    push_m(bunch->R(i), bunch->P(i), 0.5 * dt * Units::ns2s);
+    push_m(R, P, 0.5 * dt);
 
-    flagNoDeletion = kick_m(bunch, i, t, dt * Units::ns2s, args...);
+    flagNoDeletion = kick_m(R, P, i, t + 0.5 * dt, dt, mass, charge, args...);
 
     // push for second LF2 half step
-    push_m(bunch->R(i), bunch->P(i), 0.5 * dt * Units::ns2s);
+    push_m(R, P, 0.5 * dt);
 
     return flagNoDeletion;
 }
 
 template <typename FieldFunction, typename... Arguments>
-void LF2<FieldFunction, Arguments...>::push_m(
+KOKKOS_INLINE_FUNCTION void LF2<FieldFunction, Arguments...>::push_m(
     Vector_t<double, 3>& R, const Vector_t<double, 3>& P, const double& h) const {
-    double const gamma          = sqrt(1.0 + dot(P, P));
+    double const gamma          = Kokkos::sqrt(1.0 + dot(P, P));
     double const c_gamma        = Physics::c / gamma;
     Vector_t<double, 3> const v = P * c_gamma;
     R += h * v;
 }
 
 template <typename FieldFunction, typename... Arguments>
-bool LF2<FieldFunction, Arguments...>::kick_m(
-    PartBunch_t* bunch, const size_t& i, const double& t, const double& h,
-    Arguments&... args) const {
+KOKKOS_INLINE_FUNCTION bool LF2<FieldFunction, Arguments...>::kick_m(
+    const Vector_t<double, 3>& R, Vector_t<double, 3>& P, const size_t& i, const double& t,
+    const double& h, const double& mass, const double& charge, Arguments&... args) const {
     Vector_t<double, 3> externalE = Vector_t<double, 3>(0.0, 0.0, 0.0);
     Vector_t<double, 3> externalB = Vector_t<double, 3>(0.0, 0.0, 0.0);
 
-    bool outOfBound = this->fieldfunc_m(t, i, externalE, externalB, args...);
+    bool outOfBound = this->fieldfunc_m(t, i, R, P, externalE, externalB, args...);
 
     if (outOfBound)
         return false;
 
-    double const q = 1;  // \todo  = bunch->Q(0) / Physics::q_e;
-    double const M = 1;  // \todo  = bunch->M(0) * Units::GeV2eV;
-                         // same rest energy
-
     BorisPusher pusher;
 
-    // \todo pusher.kick(bunch->R(i), bunch->P(i), externalE, externalB, h, M, q);
+    pusher.kick(R, P, externalE, externalB, h, mass, charge);
 
     return true;
-}
\ No newline at end of file
+}
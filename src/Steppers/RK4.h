@@ -20,48 +20,50 @@
 
 #include "Stepper.h"
 #include "Physics/Physics.h"
-#include "Physics/Units.h"
 
 /// 4-th order Runnge-Kutta stepper
 template <typename FieldFunction, typename ... Arguments>
-class RK4 : public Stepper<FieldFunction, Arguments...> {
+class RK4 : public Stepper<RK4<FieldFunction, Arguments...>, FieldFunction, Arguments...> {
     
+    friend class Stepper<RK4<FieldFunction, Arguments...>, FieldFunction, Arguments...>;
+
 public:
     
-    RK4(const FieldFunction& fieldfunc) : Stepper<FieldFunction, Arguments ...>(fieldfunc) { }
+    KOKKOS_INLINE_FUNCTION RK4(const FieldFunction& fieldfunc)
+        : Stepper<RK4<FieldFunction, Arguments...>, FieldFunction, Arguments ...>(fieldfunc) { }
 
 private:
-    bool doAdvance_m(PartBunch_t* bunch,
-                     const size_t& i,
-                     const double& t,
-                     const double dt,
-                     Arguments& ... args) const;
+    KOKKOS_INLINE_FUNCTION bool doAdvance_m(Vector_t<double, 3>& R,
+                                            Vector_t<double, 3>& P,
+                                            const size_t& i,
+                                            const double& t,
+                                            const double dt,
+                                            const double& mass,
+                                            const double& charge,
+                                            Arguments& ... args) const;
     
     /**
-     * 
+     * Right hand side of the equations of motion
      *
-     * @param y
-     * @param t
-     * @param yp
-     * @param Pindex
+     * @param y      position [m] and momentum [beta gamma]
+     * @param t      time [s]
+     * @param yp     filled with the time derivative of y
+     * @param i      index of the particle
+     * @param qtom   charge times c over the rest energy [m/(V s)]
      *
-     * @return
+     * @return true if the particle is lost
      */
-    bool derivate_m(PartBunch_t* bunch,
-                    double *y,
-                    const double& t,
-                    double* yp,
-                    const size_t& i,
-                    Arguments& ... args) const;
-    
+    KOKKOS_INLINE_FUNCTION bool derivate_m(const double *y,
+                                           const double& t,
+                                           double* yp,
+                                           const size_t& i,
+                                           const double& qtom,
+                                           Arguments& ... args) const;
     
-    void copyTo(const Vector_t<double, 3>& R, const Vector_t<double, 3>& P, double* x) const;
     
-    void copyFrom(Vector_t<double, 3>& R, Vector_t<double, 3>& P, double* x) const;
+    KOKKOS_INLINE_FUNCTION void copyTo(const Vector_t<double, 3>& R, const Vector_t<double, 3>& P, double* x) const;
     
-    const double mass_coeff = 1.0e9 * Units::GeV2kg; // from GeV/c^2 to basic unit: GV*C*s^2/m^2, (1.0e9 converts V*C*s^2/m^2 to GV*C*s^2/m^2)
-    const double c_mmtns = Physics::c * Units::m2mm / Units::s2ns;
-    const double c_mtns = Physics::c / Units::s2ns;
+    KOKKOS_INLINE_FUNCTION void copyFrom(Vector_t<double, 3>& R, Vector_t<double, 3>& P, const double* x) const;
 };
 
 #include "RK4.hpp"
@@ -17,19 +17,21 @@
 //
 
 template <typename FieldFunction, typename... Arguments>
-bool RK4<FieldFunction, Arguments...>::doAdvance_m(
-    PartBunch_t* bunch, const size_t& i, const double& t, const double dt,
-    Arguments&... args) const {
+KOKKOS_INLINE_FUNCTION bool RK4<FieldFunction, Arguments...>::doAdvance_m(
+    Vector_t<double, 3>& R, Vector_t<double, 3>& P, const size_t& i, const double& t,
+    const double dt, const double& mass, const double& charge, Arguments&... args) const {
     // Fourth order Runge-Kutta integrator
     // arguments:
-    //   x          Current value of dependent variable
+    //   R, P       Current value of dependent variable
     //   t          Independent variable (usually time)
     //   dt         Step size (usually time step)
     //   i          index of particle
 
     double x[6];
 
-    // \todo this->copyTo(bunch->R(i), bunch->P(i), &x[0]);
+    this->copyTo(R, P, &x[0]);
+
+    const double qtom = charge * Physics::c / mass;
 
     double deriv1[6];
     double deriv2[6];
@@ -39,7 +41,7 @@ bool RK4<FieldFunction, Arguments...>::doAdvance_m(
 
     // Evaluate f1 = f(x,t).
 
-    bool outOfBound = derivate_m(bunch, x, t, deriv1, i, args...);
+    bool outOfBound = derivate_m(x, t, deriv1, i, qtom, args...);
     if (outOfBound)
         return false;
 
@@ -50,7 +52,7 @@ bool RK4<FieldFunction, Arguments...>::doAdvance_m(
     for (int j = 0; j < 6; ++j)
         xtemp[j] = x[j] + half_dt * deriv1[j];
 
-    outOfBound = derivate_m(bunch, xtemp, t_half, deriv2, i, args...);
+    outOfBound = derivate_m(xtemp, t_half, deriv2, i, qtom, args...);
     if (outOfBound)
         return false;
 
@@ -58,7 +60,7 @@ bool RK4<FieldFunction, Arguments...>::doAdvance_m(
     for (int j = 0; j < 6; ++j)
         xtemp[j] = x[j] + half_dt * deriv2[j];
 
-    outOfBound = derivate_m(bunch, xtemp, t_half, deriv3, i, args...);
+    outOfBound = derivate_m(xtemp, t_half, deriv3, i, qtom, args...);
     if (outOfBound)
         return false;
 
@@ -67,7 +69,7 @@ bool RK4<FieldFunction, Arguments...>::doAdvance_m(
     for (int j = 0; j < 6; ++j)
         xtemp[j] = x[j] + dt * deriv3[j];
 
-    outOfBound = derivate_m(bunch, xtemp, t_full, deriv4, i, args...);
+    outOfBound = derivate_m(xtemp, t_full, deriv4, i, qtom, args...);
     if (outOfBound)
         return false;
 
@@ -75,68 +77,57 @@ bool RK4<FieldFunction, Arguments...>::doAdvance_m(
     for (int j = 0; j < 6; ++j)
         x[j] += dt / 6. * (deriv1[j] + deriv4[j] + 2. * (deriv2[j] + deriv3[j]));
 
-    // \todo this->copyFrom(bunch->R(i), bunch->P(i), &x[0]);
+    this->copyFrom(R, P, &x[0]);
 
     return true;
 }
 
 template <typename FieldFunction, typename... Arguments>
-bool RK4<FieldFunction, Arguments...>::derivate_m(
-    PartBunch_t* bunch, double* y, const double& t, double* yp, const size_t& i,
+KOKKOS_INLINE_FUNCTION bool RK4<FieldFunction, Arguments...>::derivate_m(
+    const double* y, const double& t, double* yp, const size_t& i, const double& qtom,
     Arguments&... args) const {
-    // New for OPAL 2.0: Changing variables to m, T, s
-    // Currently: m, ns, kG
+    // Units: m, s, T, V/m
 
-    Vector_t<double, 3> externalE, externalB, tempR;
+    Vector_t<double, 3> externalE, externalB, tempR, tempP;
 
     externalB = Vector_t<double, 3>(0.0, 0.0, 0.0);
     externalE = Vector_t<double, 3>(0.0, 0.0, 0.0);
 
-    for (int j = 0; j < 3; ++j)
-        tempR(j) = y[j];
-
-    // \todo bunch->R(i) = tempR;
-
-    bool outOfBound = this->fieldfunc_m(t, i, externalE, externalB, args...);
-
-    double qtom = 1.0;  // \todo  = bunch->Q(i) / (bunch->M(i) * mass_coeff);  // m^2/s^2/GV
+    this->copyFrom(tempR, tempP, y);
 
-    double tempgamma = sqrt(1 + (y[3] * y[3] + y[4] * y[4] + y[5] * y[5]));
+    bool outOfBound = this->fieldfunc_m(t, i, tempR, tempP, externalE, externalB, args...);
 
-    yp[0] = c_mtns / tempgamma * y[3];  // [m/ns]
-    yp[1] = c_mtns / tempgamma * y[4];  // [m/ns]
-    yp[2] = c_mtns / tempgamma * y[5];  // [m/ns]
+    double tempgamma = Kokkos::sqrt(1 + (y[3] * y[3] + y[4] * y[4] + y[5] * y[5]));
 
-    /*
-        yp[0] = c_mmtns / tempgamma * y[3]; // [mm/ns]
-        yp[1] = c_mmtns / tempgamma * y[4]; // [mm/ns]
-        yp[2] = c_mmtns / tempgamma * y[5]; // [mm/ns]
-    */
+    yp[0] = Physics::c / tempgamma * y[3];  // [m/s]
+    yp[1] = Physics::c / tempgamma * y[4];  // [m/s]
+    yp[2] = Physics::c / tempgamma * y[5];  // [m/s]
 
-    yp[3] = (externalE(0) / Physics::c + (externalB(2) * y[4] - externalB(1) * y[5]) / tempgamma)
-            * qtom;  // [1/ns]
-    yp[4] = (externalE(1) / Physics::c - (externalB(2) * y[3] - externalB(0) * y[5]) / tempgamma)
-            * qtom;  // [1/ns];
-    yp[5] = (externalE(2) / Physics::c + (externalB(1) * y[3] - externalB(0) * y[4]) / tempgamma)
-            * qtom;  // [1/ns];
+    // dP/dt = q c / m (E + c P / gamma x B)
+    yp[3] = (externalE(0) + Physics::c * (externalB(2) * y[4] - externalB(1) * y[5]) / tempgamma)
+            * qtom;  // [1/s]
+    yp[4] = (externalE(1) - Physics::c * (externalB(2) * y[3] - externalB(0) * y[5]) / tempgamma)
+            * qtom;  // [1/s];
+    yp[5] = (externalE(2) + Physics::c * (externalB(1) * y[3] - externalB(0) * y[4]) / tempgamma)
+            * qtom;  // [1/s];
 
     return outOfBound;
 }
 
 template <typename FieldFunction, typename... Arguments>
-void RK4<FieldFunction, Arguments...>::copyTo(
+KOKKOS_INLINE_FUNCTION void RK4<FieldFunction, Arguments...>::copyTo(
     const Vector_t<double, 3>& R, const Vector_t<double, 3>& P, double* x) const {
     for (int j = 0; j < 3; j++) {
-        x[j]     = R(j);  // [x,y,z] (mm)
+        x[j]     = R(j);  // [x,y,z] (m)
         x[j + 3] = P(j);  // [px,py,pz] (beta*gamma)
     }
 }
 
 template <typename FieldFunction, typename... Arguments>
-void RK4<FieldFunction, Arguments...>::copyFrom(
-    Vector_t<double, 3>& R, Vector_t<double, 3>& P, double* x) const {
+KOKKOS_INLINE_FUNCTION void RK4<FieldFunction, Arguments...>::copyFrom(
+    Vector_t<double, 3>& R, Vector_t<double, 3>& P, const double* x) const {
     for (int j = 0; j < 3; j++) {
-        R(j) = x[j];      // [x,y,z] (mm)
+        R(j) = x[j];      // [x,y,z] (m)
         P(j) = x[j + 3];  // [px,py,pz] (beta*gamma)
     }
 }
@@ -20,54 +20,52 @@
 
 #include "OPALTypes.h"
 
-#include "PartBunch/PartBunch.h"
-
-#include <functional>
-
 /*!
- * @precondition The field function has to return a
- * boolean and take at least the following arguments in that order:
+ * The steppers advance a single particle and are meant to be called from the
+ * kernels of the trackers, the integrator is chosen at compile time by the
+ * template parameter Derived (static polymorphism, no virtual calls).
+ *
+ * Units: R in m, P = beta * gamma, t and dt in s, mass (rest energy) in eV
+ * and charge in units of the elementary charge.
+ *
+ * @precondition The field function has to return a boolean, true if the
+ * particle is lost, and take at least the following arguments in that order:
  *  - double    specifying the time
- *  - int       specifying the i-th particle
- *  - Vector_t<double, 3>  specifying the electric field
- *  - Vector_t<double, 3>  specifying the magnetic field
+ *  - size_t    specifying the i-th particle
+ *  - Vector_t<double, 3>  specifying the position
+ *  - Vector_t<double, 3>  specifying the momentum
+ *  - Vector_t<double, 3>  the electric field, to be filled
+ *  - Vector_t<double, 3>  the magnetic field, to be filled
+ * It is copied into the stepper such that the stepper can be captured by value.
  */
 
-template <typename FieldFunction, typename... Arguments>
+template <typename Derived, typename FieldFunction, typename... Arguments>
 class Stepper {
 public:
-    Stepper(const FieldFunction& fieldfunc) : fieldfunc_m(fieldfunc) {
+    KOKKOS_INLINE_FUNCTION Stepper(const FieldFunction& fieldfunc) : fieldfunc_m(fieldfunc) {
     }
 
-    virtual bool advance(
-        PartBunch_t* bunch, const size_t& i, const double& t, const double dt,
-        Arguments&... args) const {
-        bool isGood = doAdvance_m(bunch, i, t, dt, args...);
+    /// advances particle i by dt, returns true if the particle is lost
+    KOKKOS_INLINE_FUNCTION bool advance(
+        Vector_t<double, 3>& R, Vector_t<double, 3>& P, const size_t& i, const double& t,
+        const double dt, const double& mass, const double& charge, Arguments&... args) const {
+        bool isGood = static_cast<const Derived*>(this)->doAdvance_m(
+            R, P, i, t, dt, mass, charge, args...);
 
         bool isNaN = false;
         for (int j = 0; j < 3; ++j) {
-            // \todo  if (std::isnan(bunch->R(i)[j]) || std::isnan(bunch->P(i)[j])
-            //    || std::abs(bunch->R(i)[j]) > 1.0e10 || std::abs(bunch->P(i)[j]) > 1.0e10) {
-            //    isNaN = true;
-            //    break;
-            // }
+            if (Kokkos::isnan(R[j]) || Kokkos::isnan(P[j]) || Kokkos::abs(R[j]) > 1.0e10
+                || Kokkos::abs(P[j]) > 1.0e10) {
+                isNaN = true;
+                break;
+            }
         }
 
-        bool isBad = (!isGood || isNaN);
-        if (isBad) {
-            // \todo  bunch->Bin(i) = -1;
-        }
-        return isBad;
-    };
-    virtual ~Stepper(){};
+        return (!isGood || isNaN);
+    }
 
 protected:
-    const FieldFunction& fieldfunc_m;
-
-private:
-    virtual bool doAdvance_m(
-        PartBunch_t* bunch, const size_t& i, const double& t, const double dt,
-        Arguments&... args) const = 0;
+    FieldFunction fieldfunc_m;
 };
 
 #endif
@@ -23,7 +23,12 @@
 #include <algorithm>
 #include <cmath>
 #include <ctime>
+#include <cstring>
 #include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <limits>
+#include <sstream>
 #include <string>
 
 #include <cfloat>
@@ -1456,14 +1461,6 @@ int BoundaryGeometry::intersectRayBoundary(
   * hr_m:  is the  mesh size
   * nr_m:  number of mesh points
   */
-inline int BoundaryGeometry::mapVoxelIndices2ID(const int i, const int j, const int k) {
-    if (i < 0 || i >= voxelMesh_m.nr_m[0] || j < 0 || j >= voxelMesh_m.nr_m[1] || k < 0
-        || k >= voxelMesh_m.nr_m[2]) {
-        return 0;
-    }
-    return 1 + k * voxelMesh_m.nr_m[0] * voxelMesh_m.nr_m[1] + j * voxelMesh_m.nr_m[0] + i;
-}
-
 #define mapPoint2VoxelIndices(pt, i, j, k)                                                     \
     {                                                                                          \
         i = floor((pt[0] - voxelMesh_m.minExtent[0]) / voxelMesh_m.sizeOfVoxel[0]);            \
@@ -1494,33 +1491,69 @@ inline Vector_t<double, 3> BoundaryGeometry::mapPoint2Voxel(const Vector_t<doubl
 }
 
 inline void BoundaryGeometry::computeMeshVoxelization(void) {
-    for (unsigned int triangle_id = 0; triangle_id < Triangles_m.size(); triangle_id++) {
-        Vector_t<double, 3> v1       = getPoint(triangle_id, 1);
-        Vector_t<double, 3> v2       = getPoint(triangle_id, 2);
-        Vector_t<double, 3> v3       = getPoint(triangle_id, 3);
-        Vector_t<double, 3> bbox_min = {
-            std::min({v1[0], v2[0], v3[0]}), std::min({v1[1], v2[1], v3[1]}),
-            std::min({v1[2], v2[2], v3[2]})};
-        Vector_t<double, 3> bbox_max = {
-            std::max({v1[0], v2[0], v3[0]}), std::max({v1[1], v2[1], v3[1]}),
-            std::max({v1[2], v2[2], v3[2]})};
-        int i_min, j_min, k_min;
-        int i_max, j_max, k_max;
-        mapPoint2VoxelIndices(bbox_min, i_min, j_min, k_min);
-        mapPoint2VoxelIndices(bbox_max, i_max, j_max, k_max);
-
-        for (int i = i_min; i <= i_max; i++) {
-            for (int j = j_min; j <= j_max; j++) {
-                for (int k = k_min; k <= k_max; k++) {
-                    // test if voxel (i,j,k) has an intersection with triangle
-                    if (intersectTriangleVoxel(triangle_id, i, j, k) == INSIDE) {
-                        auto id = mapVoxelIndices2ID(i, j, k);
-                        voxelMesh_m.ids[id].insert(triangle_id);
+    // every rank voxelizes a contiguous block of triangles with all its threads
+    const size_t numTriangles = Triangles_m.size();
+    const size_t numRanks     = ippl::Comm->size();
+    const size_t rank         = ippl::Comm->rank();
+    const size_t first        = numTriangles * rank / numRanks;
+    const size_t last         = numTriangles * (rank + 1) / numRanks;
+
+    std::vector<std::vector<int>> voxelsOfTriangle(last - first);
+    Kokkos::parallel_for(
+        "voxelizeTriangles", Kokkos::RangePolicy<Kokkos::DefaultHostExecutionSpace>(first, last),
+        [&](const size_t triangle_id) {
+            Vector_t<double, 3> v1       = getPoint(triangle_id, 1);
+            Vector_t<double, 3> v2       = getPoint(triangle_id, 2);
+            Vector_t<double, 3> v3       = getPoint(triangle_id, 3);
+            Vector_t<double, 3> bbox_min = {
+                std::min({v1[0], v2[0], v3[0]}), std::min({v1[1], v2[1], v3[1]}),
+                std::min({v1[2], v2[2], v3[2]})};
+            Vector_t<double, 3> bbox_max = {
+                std::max({v1[0], v2[0], v3[0]}), std::max({v1[1], v2[1], v3[1]}),
+                std::max({v1[2], v2[2], v3[2]})};
+            int i_min, j_min, k_min;
+            int i_max, j_max, k_max;
+            mapPoint2VoxelIndices(bbox_min, i_min, j_min, k_min);
+            mapPoint2VoxelIndices(bbox_max, i_max, j_max, k_max);
+
+            std::vector<int>& voxels = voxelsOfTriangle[triangle_id - first];
+            for (int i = i_min; i <= i_max; i++) {
+                for (int j = j_min; j <= j_max; j++) {
+                    for (int k = k_min; k <= k_max; k++) {
+                        // test if voxel (i,j,k) has an intersection with triangle
+                        if (intersectTriangleVoxel(triangle_id, i, j, k) == INSIDE) {
+                            voxels.push_back(mapVoxelIndices2ID(i, j, k));
+                        }
                     }
                 }
             }
+        });
+
+    // gather the pairs (voxel id, triangle id) of all ranks
+    std::vector<int> localPairs;
+    for (size_t t = 0; t < voxelsOfTriangle.size(); ++t) {
+        for (int id : voxelsOfTriangle[t]) {
+            localPairs.push_back(id);
+            localPairs.push_back(first + t);
         }
-    }  // for_each triangle
+    }
+
+    MPI_Comm comm = ippl::Comm->getCommunicator();
+    int localSize = localPairs.size();
+    std::vector<int> sizes(numRanks), displacements(numRanks, 0);
+    MPI_Allgather(&localSize, 1, MPI_INT, sizes.data(), 1, MPI_INT, comm);
+    for (size_t r = 1; r < numRanks; ++r) {
+        displacements[r] = displacements[r - 1] + sizes[r - 1];
+    }
+
+    std::vector<int> pairs(displacements.back() + sizes.back());
+    MPI_Allgatherv(
+        localPairs.data(), localSize, MPI_INT, pairs.data(), sizes.data(), displacements.data(),
+        MPI_INT, comm);
+
+    for (size_t p = 0; p < pairs.size(); p += 2) {
+        voxelMesh_m.ids[pairs[p]].insert(pairs[p + 1]);
+    }
     *gmsg << level2 << "* Mesh voxelization done" << endl;
 
     // write voxel mesh into VTK file
@@ -1546,6 +1579,160 @@ inline void BoundaryGeometry::computeMeshVoxelization(void) {
     }
 }
 
+void BoundaryGeometry::buildDeviceVoxelMesh() {
+    const Vector_t<int, 3>& nr = voxelMesh_m.nr_m;
+    const size_t numVoxels     = size_t(nr[0]) * nr[1] * nr[2];
+
+    // count, prefix sum, fill; the ids of voxelMesh_m are the linear index + 1, 0 is outside
+    Kokkos::View<int*> offsets("voxelOffsets", numVoxels + 1);
+    auto hostOffsets = Kokkos::create_mirror_view(offsets);
+    Kokkos::deep_copy(hostOffsets, 0);
+    for (const auto& voxel : voxelMesh_m.ids) {
+        if (voxel.first > 0) {
+            hostOffsets(voxel.first) = voxel.second.size();
+        }
+    }
+    for (size_t v = 0; v < numVoxels; ++v) {
+        hostOffsets(v + 1) += hostOffsets(v);
+    }
+
+    Kokkos::View<int*> triangles("voxelTriangles", hostOffsets(numVoxels));
+    auto hostTriangles = Kokkos::create_mirror_view(triangles);
+    for (const auto& voxel : voxelMesh_m.ids) {
+        if (voxel.first == 0) {
+            continue;
+        }
+        // sorted such that the order of the hash set doesn't enter the results
+        std::vector<int> ids(voxel.second.begin(), voxel.second.end());
+        std::sort(ids.begin(), ids.end());
+        std::copy(ids.begin(), ids.end(), &hostTriangles(hostOffsets(voxel.first - 1)));
+    }
+
+    Kokkos::View<double* [9]> vertices("triangleVertices", Triangles_m.size());
+    auto hostVertices = Kokkos::create_mirror_view(vertices);
+    for (size_t t = 0; t < Triangles_m.size(); ++t) {
+        for (int corner = 0; corner < 3; ++corner) {
+            const Vector_t<double, 3>& pt = getPoint(t, corner + 1);
+            for (int d = 0; d < 3; ++d) {
+                hostVertices(t, 3 * corner + d) = pt[d];
+            }
+        }
+    }
+
+    Kokkos::deep_copy(offsets, hostOffsets);
+    Kokkos::deep_copy(triangles, hostTriangles);
+    Kokkos::deep_copy(vertices, hostVertices);
+
+    deviceMesh_m.offsets     = offsets;
+    deviceMesh_m.triangles   = triangles;
+    deviceMesh_m.vertices    = vertices;
+    deviceMesh_m.minExtent   = voxelMesh_m.minExtent;
+    deviceMesh_m.sizeOfVoxel = voxelMesh_m.sizeOfVoxel;
+    deviceMesh_m.nr          = nr;
+
+    triangleHits_m = Kokkos::View<unsigned int*>("triangleHits", Triangles_m.size());
+
+    *gmsg << level2 << "* Voxel mesh with " << hostOffsets(numVoxels)
+          << " voxel-triangle pairs copied to the device" << endl;
+}
+
+std::string BoundaryGeometry::makeCacheKey() {
+    // the key is only compared and written on rank 0
+    const std::uint64_t geometryHash = ippl::Comm->rank() == 0 ? Util::hashFile(h5FileName_m) : 0;
+
+    std::ostringstream key;
+    key << std::setprecision(17);
+    key << std::hex << geometryHash << std::dec << " " << Triangles_m.size() << " "
+        << Points_m.size();
+    for (unsigned int d = 0; d < 3; ++d) {
+        key << " " << voxelMesh_m.nr_m[d] << " " << voxelMesh_m.sizeOfVoxel[d] << " "
+            << voxelMesh_m.minExtent[d];
+    }
+
+    return key.str();
+}
+
+std::string BoundaryGeometry::getCacheFileName() const {
+    return Util::combineFilePath({Options::geometryCache, getOpalName() + ".geometry"});
+}
+
+bool BoundaryGeometry::readCache(const std::string& key) {
+    std::vector<char> buffer;
+    if (ippl::Comm->rank() == 0) {
+        std::ifstream in(getCacheFileName(), std::ios::binary);
+        std::string fileKey;
+        if (std::getline(in, fileKey) && fileKey == key) {
+            buffer.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        }
+        if (buffer.size() > static_cast<size_t>(std::numeric_limits<int>::max())) {
+            buffer.clear();
+        }
+    }
+
+    MPI_Comm comm          = ippl::Comm->getCommunicator();
+    unsigned long numBytes = buffer.size();
+    MPI_Bcast(&numBytes, 1, MPI_UNSIGNED_LONG, 0, comm);
+    if (numBytes == 0) {
+        return false;
+    }
+    buffer.resize(numBytes);
+    MPI_Bcast(buffer.data(), numBytes, MPI_CHAR, 0, comm);
+
+    // layout: triangles, number of voxels, per voxel the id, the number of triangles and their ids
+    const char* pos = buffer.data();
+    const char* end = buffer.data() + buffer.size();
+    auto read       = [&](void* data, size_t size) {
+        if (pos + size > end) {
+            throw OpalException(
+                "BoundaryGeometry::readCache", "The file '" + getCacheFileName() + "' is corrupt");
+        }
+        std::memcpy(data, pos, size);
+        pos += size;
+    };
+
+    read(Triangles_m.data(), Triangles_m.size() * sizeof(Triangles_m[0]));
+
+    std::uint64_t numVoxels = 0;
+    read(&numVoxels, sizeof(numVoxels));
+    voxelMesh_m.ids.clear();
+    voxelMesh_m.ids.reserve(numVoxels);
+    for (std::uint64_t v = 0; v < numVoxels; ++v) {
+        int id = 0, numTriangles = 0;
+        read(&id, sizeof(id));
+        read(&numTriangles, sizeof(numTriangles));
+
+        std::vector<int> triangles(numTriangles);
+        read(triangles.data(), numTriangles * sizeof(int));
+        voxelMesh_m.ids[id].insert(triangles.begin(), triangles.end());
+    }
+
+    return true;
+}
+
+void BoundaryGeometry::writeCache(const std::string& key) const {
+    if (ippl::Comm->rank() != 0) {
+        return;
+    }
+
+    boost::filesystem::create_directories(Options::geometryCache);
+    std::ofstream out(getCacheFileName(), std::ios::binary | std::ios::trunc);
+    out << key << "\n";
+    out.write(
+        reinterpret_cast<const char*>(Triangles_m.data()),
+        Triangles_m.size() * sizeof(Triangles_m[0]));
+
+    const std::uint64_t numVoxels = voxelMesh_m.ids.size();
+    out.write(reinterpret_cast<const char*>(&numVoxels), sizeof(numVoxels));
+    for (const auto& voxel : voxelMesh_m.ids) {
+        const std::vector<int> triangles(voxel.second.begin(), voxel.second.end());
+        const int numTriangles = triangles.size();
+        out.write(reinterpret_cast<const char*>(&voxel.first), sizeof(voxel.first));
+        out.write(reinterpret_cast<const char*>(&numTriangles), sizeof(numTriangles));
+        out.write(
+            reinterpret_cast<const char*>(triangles.data()), numTriangles * sizeof(int));
+    }
+}
+
 void BoundaryGeometry::initialize() {
     class Local {
     public:
@@ -1749,26 +1936,28 @@ Change orientation if diff is:
                 }
             }
 
-            for (unsigned int triangle_id = 0; triangle_id < bg->Triangles_m.size();
-                 triangle_id++) {
-                std::set<unsigned int> to_A = adjacencies_to_pt[bg->PointID(triangle_id, 1)];
-                std::set<unsigned int> to_B = adjacencies_to_pt[bg->PointID(triangle_id, 2)];
-                std::set<unsigned int> to_C = adjacencies_to_pt[bg->PointID(triangle_id, 3)];
-
-                std::set<unsigned int> intersect;
-                std::set_intersection(
-                    to_A.begin(), to_A.end(), to_B.begin(), to_B.end(),
-                    std::inserter(intersect, intersect.begin()));
-                std::set_intersection(
-                    to_B.begin(), to_B.end(), to_C.begin(), to_C.end(),
-                    std::inserter(intersect, intersect.begin()));
-                std::set_intersection(
-                    to_C.begin(), to_C.end(), to_A.begin(), to_A.end(),
-                    std::inserter(intersect, intersect.begin()));
-                intersect.erase(triangle_id);
-
-                neighbors[triangle_id] = intersect;
-            }
+            Kokkos::parallel_for(
+                "computeTriangleNeighbors",
+                Kokkos::RangePolicy<Kokkos::DefaultHostExecutionSpace>(0, bg->Triangles_m.size()),
+                [&](const size_t triangle_id) {
+                    const auto& to_A = adjacencies_to_pt[bg->PointID(triangle_id, 1)];
+                    const auto& to_B = adjacencies_to_pt[bg->PointID(triangle_id, 2)];
+                    const auto& to_C = adjacencies_to_pt[bg->PointID(triangle_id, 3)];
+
+                    std::set<unsigned int> intersect;
+                    std::set_intersection(
+                        to_A.begin(), to_A.end(), to_B.begin(), to_B.end(),
+                        std::inserter(intersect, intersect.begin()));
+                    std::set_intersection(
+                        to_B.begin(), to_B.end(), to_C.begin(), to_C.end(),
+                        std::inserter(intersect, intersect.begin()));
+                    std::set_intersection(
+                        to_C.begin(), to_C.end(), to_A.begin(), to_A.end(),
+                        std::inserter(intersect, intersect.begin()));
+                    intersect.erase(triangle_id);
+
+                    neighbors[triangle_id] = std::move(intersect);
+                });
             *gmsg << level2 << "* " << __func__ << ": Computing neighbors done" << endl;
         }
 
@@ -1799,19 +1988,30 @@ Change orientation if diff is:
                 bg->maxExtent_m[1] * (1.1 + gsl_rng_uniform(bg->randGen_m)),
                 bg->maxExtent_m[2] * (1.1 + gsl_rng_uniform(bg->randGen_m)));
 
-            std::vector<Vector_t<double, 3>> intersection_points;
-            // int num_intersections = 0;
+            /*
+              The random generator has the same state on all ranks, i.e. the
+              ranks can split the triangles and sum up their intersections.
+            */
+            const size_t numTriangles = bg->Triangles_m.size();
+            const size_t numRanks     = ippl::Comm->size();
+            const size_t rank         = ippl::Comm->rank();
+
+            int num_intersections = 0;
+            Kokkos::parallel_reduce(
+                "isInside",
+                Kokkos::RangePolicy<Kokkos::DefaultHostExecutionSpace>(
+                    numTriangles * rank / numRanks, numTriangles * (rank + 1) / numRanks),
+                [&](const size_t triangle_id, int& count) {
+                    Vector_t<double, 3> result;
+                    if (bg->intersectLineTriangle(SEGMENT, x, y, triangle_id, result)) {
+                        ++count;
+                    }
+                },
+                num_intersections);
+            ippl::Comm->allreduce(num_intersections, 1, std::plus<int>());
 
-            for (unsigned int triangle_id = 0; triangle_id < bg->Triangles_m.size();
-                 triangle_id++) {
-                Vector_t<double, 3> result;
-                if (bg->intersectLineTriangle(SEGMENT, x, y, triangle_id, result)) {
-                    intersection_points.push_back(result);
-                    // num_intersections++;
-                }
-            }
             IpplTimings::stopTimer(bg->TisInside_m);
-            return ((intersection_points.size() % 2) == 1);
+            return ((num_intersections % 2) == 1);
         }
 
         // helper for function  makeTriangleNormalInwardPointing()
@@ -1987,7 +2187,16 @@ edge_found:
     *gmsg << level2 << "* Reading mesh done" << endl;
 
     Local::computeGeometryInterval(this);
-    computeMeshVoxelization();
+
+    const std::string cacheKey = Options::geometryCache.empty() ? "" : makeCacheKey();
+    const bool isCached        = !cacheKey.empty() && readCache(cacheKey);
+    if (isCached) {
+        *gmsg << level2 << "* Oriented mesh and voxelization read from '" << getCacheFileName()
+              << "'" << endl;
+    } else {
+        computeMeshVoxelization();
+    }
+
     haveInsidePoint_m      = false;
     std::vector<double> pt = Attributes::getRealArray(itsAttr[INSIDEPOINT]);
     if (!pt.empty()) {
@@ -2013,7 +2222,13 @@ edge_found:
         *gmsg << level2 << "* no point inside the geometry found!" << endl;
     }
 
-    Local::makeTriangleNormalInwardPointing(this);
+    if (!isCached) {
+        Local::makeTriangleNormalInwardPointing(this);
+        if (!cacheKey.empty()) {
+            writeCache(cacheKey);
+        }
+    }
+    buildDeviceVoxelMesh();
 
     TriNormals_m.resize(Triangles_m.size());
     TriAreas_m.resize(Triangles_m.size());
@@ -2289,6 +2504,57 @@ int BoundaryGeometry::partInside(
     return ret;
 }
 
+size_t BoundaryGeometry::collideParticles(
+    PartBunch_t* bunch, const Kokkos::View<Vector_t<double, 3>*>& startR,
+    Kokkos::View<int*>& triangleId, Kokkos::View<Vector_t<double, 3>*>& intersection) {
+    IpplTimings::startTimer(TPartInside_m);
+
+    auto pc         = bunch->getParticleContainer();
+    const size_t n  = pc->getLocalNum();
+    auto Rview      = pc->R.getView();
+    auto startView  = startR;
+    const auto mesh = deviceMesh_m;
+
+    // the triangles are given in the lab frame
+    const DeviceCoordinateSystemTrafo toLab(bunch->toLabTrafo_m);
+
+    if (triangleId.extent(0) < n) {
+        Kokkos::realloc(Kokkos::WithoutInitializing, triangleId, n + n / 4);
+        Kokkos::realloc(Kokkos::WithoutInitializing, intersection, n + n / 4);
+    }
+    auto ids     = triangleId;
+    auto points  = intersection;
+    auto tallies = triangleHits_m;
+
+    // P0, P1: particle position before and after the push
+    size_t numHits = 0;
+    Kokkos::parallel_reduce(
+        "BoundaryGeometry::collideParticles", n,
+        KOKKOS_LAMBDA(const size_t i, size_t& hits) {
+            const Vector_t<double, 3> P0 = toLab.transformFrom(startView(i));
+            const Vector_t<double, 3> P1 = toLab.transformFrom(Rview(i));
+
+            Vector_t<double, 3> pt = 0.0;
+            ids(i)                 = mesh.intersectSegment(P0, P1, pt);
+            points(i)              = pt;
+            if (ids(i) >= 0) {
+                Kokkos::atomic_increment(&tallies(ids(i)));
+                ++hits;
+            }
+        },
+        numHits);
+
+    IpplTimings::stopTimer(TPartInside_m);
+    return numHits;
+}
+
+void BoundaryGeometry::gatherTriangleHits() {
+    auto hostHits = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), triangleHits_m);
+    globalTriangleHits_m.assign(hostHits.data(), hostHits.data() + hostHits.extent(0));
+    ippl::Comm->allreduce(
+        globalTriangleHits_m.data(), globalTriangleHits_m.size(), std::plus<unsigned int>());
+}
+
 void BoundaryGeometry::writeGeomToVtk(std::string fn) {
     std::ofstream of;
     of.open(fn.c_str());
@@ -2318,6 +2584,16 @@ void BoundaryGeometry::writeGeomToVtk(std::string fn) {
        << "default" << std::endl;
     for (size_t i = 0; i < Triangles_m.size(); i++)
         of << (float)(i) << std::endl;
+    if (globalTriangleHits_m.size() == Triangles_m.size()) {
+        of << "SCALARS "
+           << "hits"
+           << " int "
+           << "1" << std::endl;
+        of << "LOOKUP_TABLE "
+           << "default" << std::endl;
+        for (size_t i = 0; i < Triangles_m.size(); i++)
+            of << globalTriangleHits_m[i] << std::endl;
+    }
     of << std::endl;
 }
 
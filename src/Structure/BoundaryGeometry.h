@@ -38,12 +38,17 @@ class ElementBase;
 
 #include "AbstractObjects/Definition.h"
 #include "Attributes/Attributes.h"
+#include "OPALTypes.h"
 #include "Utilities/Util.h"
 #include "Utility/IpplTimings.h"
 #include "Utility/PAssert.h"
 
 #include <gsl/gsl_rng.h>
 
+#ifdef WITH_UNIT_TESTS
+#include <gtest/gtest_prod.h>
+#endif
+
 #include <array>
 #include <unordered_map>
 #include <unordered_set>
@@ -51,6 +56,32 @@ class ElementBase;
 
 enum class Topology : unsigned short { RECTANGULAR, BOXCORNER, ELLIPTIC };
 
+/**
+   The voxel mesh of BoundaryGeometry in compressed sparse row format, such
+   that the wall can be tested in device kernels. The triangles intersecting
+   the voxel with the linear index v = k * nx * ny + j * nx + i are
+   triangles(offsets(v)), ..., triangles(offsets(v + 1) - 1).
+ */
+struct DeviceVoxelMesh {
+    Kokkos::View<int*> offsets;
+    Kokkos::View<int*> triangles;
+    Kokkos::View<double* [9]> vertices;  // the three corners of every triangle
+
+    Vector_t<double, 3> minExtent;
+    Vector_t<double, 3> sizeOfVoxel;
+    Vector_t<int, 3> nr;
+
+    /// first intersection of the segment P -> Q with the wall, returns the triangle or -1
+    KOKKOS_INLINE_FUNCTION int intersectSegment(
+        const Vector_t<double, 3>& P, const Vector_t<double, 3>& Q,
+        Vector_t<double, 3>& intersection) const;
+
+private:
+    /// parameter r of P + r * (Q - P) at the intersection with triangle t, -1 if none
+    KOKKOS_INLINE_FUNCTION double intersectTriangle(
+        const Vector_t<double, 3>& P, const Vector_t<double, 3>& dir, int t) const;
+};
+
 class BoundaryGeometry : public Definition {
 public:
     BoundaryGeometry();
@@ -77,6 +108,24 @@ public:
         const Vector_t<double, 3>& r, const Vector_t<double, 3>& v, const double dt,
         Vector_t<double, 3>& intecoords, int& triId);
 
+    /**
+       Tests the segments startR(i) -> R(i) of all local particles against the wall in one
+       kernel, both are given in the frame of the bunch and are transformed to the lab frame
+       with bunch->toLabTrafo_m. triangleId(i) is set to the intersected triangle or -1,
+       intersection(i) to the first intersection in the lab frame. Returns the number of
+       local particles that hit the wall.
+     */
+    size_t collideParticles(
+        PartBunch_t* bunch, const Kokkos::View<Vector_t<double, 3>*>& startR,
+        Kokkos::View<int*>& triangleId, Kokkos::View<Vector_t<double, 3>*>& intersection);
+
+    const DeviceVoxelMesh& getDeviceVoxelMesh() const {
+        return deviceMesh_m;
+    }
+
+    /// sums the hits per triangle of all ranks, they are written by writeGeomToVtk (collective)
+    void gatherTriangleHits();
+
     Inform& printInfo(Inform& os) const;
 
     void writeGeomToVtk(std::string fn);
@@ -191,6 +240,10 @@ public:
     }
 
 private:
+#ifdef WITH_UNIT_TESTS
+    FRIEND_TEST(BoundaryGeometryTest, DeviceVoxelMeshLookup);
+#endif
+
     bool isInside(const Vector_t<double, 3>& P  // [in] point to test
     );
 
@@ -228,6 +281,11 @@ private:
 
     } voxelMesh_m;
 
+    DeviceVoxelMesh deviceMesh_m;
+
+    Kokkos::View<unsigned int*> triangleHits_m;     // local hits per triangle
+    std::vector<unsigned int> globalTriangleHits_m;  // after gatherTriangleHits
+
     int debugFlags_m;
 
     bool haveInsidePoint_m;
@@ -262,6 +320,15 @@ private:
     inline Vector_t<double, 3> mapIndices2Voxel(const int, const int, const int);
     inline Vector_t<double, 3> mapPoint2Voxel(const Vector_t<double, 3>&);
     inline void computeMeshVoxelization(void);
+    void buildDeviceVoxelMesh();
+
+    /// the key is only complete on rank 0, it is not needed on the other ranks
+    std::string makeCacheKey();
+    std::string getCacheFileName() const;
+    /// reads the oriented triangles and the voxelization on rank 0 and broadcasts them
+    bool readCache(const std::string& key);
+    /// only rank 0 writes
+    void writeCache(const std::string& key) const;
 
     enum {
         FGEOM,     // file holding the geometry
@@ -286,4 +353,93 @@ private:
 inline Inform& operator<<(Inform& os, const BoundaryGeometry& b) {
     return b.printInfo(os);
 }
+
+inline int BoundaryGeometry::mapVoxelIndices2ID(const int i, const int j, const int k) {
+    if (i < 0 || i >= voxelMesh_m.nr_m[0] || j < 0 || j >= voxelMesh_m.nr_m[1] || k < 0
+        || k >= voxelMesh_m.nr_m[2]) {
+        return 0;
+    }
+    return 1 + k * voxelMesh_m.nr_m[0] * voxelMesh_m.nr_m[1] + j * voxelMesh_m.nr_m[0] + i;
+}
+
+KOKKOS_INLINE_FUNCTION double DeviceVoxelMesh::intersectTriangle(
+    const Vector_t<double, 3>& P, const Vector_t<double, 3>& dir, int t) const {
+    // see BoundaryGeometry::intersectLineTriangle
+    const Vector_t<double, 3> V0(vertices(t, 0), vertices(t, 1), vertices(t, 2));
+    const Vector_t<double, 3> V1(vertices(t, 3), vertices(t, 4), vertices(t, 5));
+    const Vector_t<double, 3> V2(vertices(t, 6), vertices(t, 7), vertices(t, 8));
+    const Vector_t<double, 3> u = V1 - V0;
+    const Vector_t<double, 3> v = V2 - V0;
+    const Vector_t<double, 3> n = cross(u, v);
+
+    const double b = dot(n, dir);
+    if (b == 0.0) {  // parallel to the triangle or degenerated triangle
+        return -1.0;
+    }
+    const double r = -dot(n, P - V0) / b;
+    if (r < 0.0 || r > 1.0) {
+        return -1.0;
+    }
+
+    const Vector_t<double, 3> w = P + r * dir - V0;
+    const double uu = dot(u, u);
+    const double uv = dot(u, v);
+    const double vv = dot(v, v);
+    const double wu = dot(w, u);
+    const double wv = dot(w, v);
+    const double D  = uv * uv - uu * vv;
+
+    const double s = (uv * wv - vv * wu) / D;
+    if (s < 0.0 || s > 1.0) {
+        return -1.0;
+    }
+    const double q = (uv * wu - uu * wv) / D;
+    if (q < 0.0 || s + q > 1.0) {
+        return -1.0;
+    }
+    return r;
+}
+
+KOKKOS_INLINE_FUNCTION int DeviceVoxelMesh::intersectSegment(
+    const Vector_t<double, 3>& P, const Vector_t<double, 3>& Q,
+    Vector_t<double, 3>& intersection) const {
+    const Vector_t<double, 3> dir = Q - P;
+
+    // voxels covered by the bounding box of the segment
+    int lower[3], upper[3];
+    for (unsigned int d = 0; d < 3; ++d) {
+        const double a = (Kokkos::min(P[d], Q[d]) - minExtent[d]) / sizeOfVoxel[d];
+        const double b = (Kokkos::max(P[d], Q[d]) - minExtent[d]) / sizeOfVoxel[d];
+        if (b < 0.0 || a >= nr[d]) {
+            return -1;
+        }
+        lower[d] = Kokkos::max(static_cast<int>(Kokkos::floor(a)), 0);
+        upper[d] = Kokkos::min(static_cast<int>(Kokkos::floor(b)), nr[d] - 1);
+    }
+
+    int triangle = -1;
+    double rmin  = 2.0;
+    for (int k = lower[2]; k <= upper[2]; ++k) {
+        for (int j = lower[1]; j <= upper[1]; ++j) {
+            for (int i = lower[0]; i <= upper[0]; ++i) {
+                const int voxel = (k * nr[1] + j) * nr[0] + i;
+                // triangles shared by several voxels are tested more than once, this only
+                // costs time since the closest intersection is kept
+                for (int l = offsets(voxel); l < offsets(voxel + 1); ++l) {
+                    const int t    = triangles(l);
+                    const double r = intersectTriangle(P, dir, t);
+                    if (r >= 0.0 && r < rmin) {
+                        rmin     = r;
+                        triangle = t;
+                    }
+                }
+            }
+        }
+    }
+
+    if (triangle >= 0) {
+        intersection = P + rmin * dir;
+    }
+    return triangle;
+}
 #endif
@@ -0,0 +1,435 @@
+//
+// Class Checkpoint
+//   Writes and reads restart checkpoints of the tracking state.
+//
+// This file is part of OPAL.
+//
+// OPAL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// You should have received a copy of the GNU General Public License
+// along with OPAL. If not, see <https://www.gnu.org/licenses/>.
+//
+#include "Structure/Checkpoint.h"
+
+#include "AbstractObjects/OpalData.h"
+#include "Utilities/OpalException.h"
+#include "Utilities/Options.h"
+
+#include <boost/filesystem.hpp>
+#include <boost/system/error_code.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <type_traits>
+
+extern Inform* gmsg;
+
+namespace {
+    constexpr char checkpointMagic[8]        = "OPALXCK";
+    constexpr std::uint32_t checkpointFormat = 3;
+
+    // Fixed size part at the beginning of every checkpoint file
+    struct CheckpointHeader {
+        char magic[8];
+        std::uint32_t format;
+        std::int32_t numRanks;
+        std::int32_t rank;
+        std::int32_t seed;
+        std::uint64_t localNum;
+        std::uint64_t totalNum;
+        std::int64_t globalTrackStep;
+        std::int64_t localTrackStep;
+        double t;
+        double dt;
+        double spos;
+        double globalPhaseShift;
+        double refPartR[3];
+        double refPartP[3];
+        double pathLength;
+        std::uint32_t stepSizeIndex;
+        std::uint32_t numCavities;
+        std::uint64_t stepsInSegment;
+        std::int32_t ensembleSize;
+        std::uint64_t emittedParticles;
+        std::uint64_t emittedSteps;
+    };
+
+    template <class T>
+    void append(std::vector<char>& buffer, const T* data, size_t n) {
+        const char* bytes = reinterpret_cast<const char*>(data);
+        buffer.insert(buffer.end(), bytes, bytes + n * sizeof(T));
+    }
+
+    template <class T>
+    void extract(T* data, const char*& pos, size_t n) {
+        std::memcpy(data, pos, n * sizeof(T));
+        pos += n * sizeof(T);
+    }
+
+    template <class View>
+    size_t valueSize(const View&) {
+        return sizeof(typename View::value_type);
+    }
+
+    // true if the cavity phases at the end of the file are complete
+    bool cavitiesFit(const char* pos, const char* end, std::uint32_t numCavities) {
+        for (std::uint32_t i = 0; i < numCavities; ++i) {
+            std::uint32_t length;
+            if (static_cast<size_t>(end - pos) < sizeof(length)) {
+                return false;
+            }
+            extract(&length, pos, 1);
+            if (static_cast<size_t>(end - pos) < length + sizeof(double)) {
+                return false;
+            }
+            pos += length + sizeof(double);
+        }
+        return true;
+    }
+
+    // the compact layout drops the stored charges, masses and time steps, they have to agree with
+    // the species table and the time step of the bunch
+    void validateSpeciesConstants(PartBunch_t* bunch, const char* pos, size_t nlocal, double dt) {
+        auto pc = bunch->getParticleContainer();
+
+        std::vector<double> charges(nlocal), masses(nlocal), dts(nlocal);
+        extract(charges.data(), pos, nlocal);
+        extract(masses.data(), pos, nlocal);
+        extract(dts.data(), pos, nlocal);
+
+        const Kokkos::HostSpace host;
+        auto species     = Kokkos::create_mirror_view_and_copy(host, pc->Sp.getView());
+        auto chargeTable = Kokkos::create_mirror_view_and_copy(host, pc->getCharges().table);
+        auto massTable   = Kokkos::create_mirror_view_and_copy(host, pc->getMasses().table);
+
+        auto differ = [](double stored, double expected) {
+            return std::abs(stored - expected) > 1e-12 * std::abs(expected);
+        };
+
+        int numMismatches = 0;
+        for (size_t i = 0; i < nlocal; ++i) {
+            const short s = species(i);
+            if (differ(charges[i], chargeTable(s)) || differ(masses[i], massTable(s))
+                || differ(dts[i], dt)) {
+                ++numMismatches;
+            }
+        }
+
+        ippl::Comm->allreduce(numMismatches, 1, std::plus<int>());
+        if (numMismatches > 0) {
+            throw OpalException(
+                "Checkpoint::read",
+                std::to_string(numMismatches)
+                    + " particles of the checkpoint have a charge, a mass or a time step that "
+                      "differs from the constants of their species, restart without "
+                      "COMPACTPARTICLES");
+        }
+    }
+}  // namespace
+
+volatile std::sig_atomic_t Checkpoint::signalReceived_s = 0;
+
+Checkpoint::Checkpoint(const std::string& directory)
+    : directory_m(directory),
+      stageTimer_m(IpplTimings::getTimer("checkpointStage")),
+      readTimer_m(IpplTimings::getTimer("checkpointRead")) {
+    namespace fs = boost::filesystem;
+
+    if (ippl::Comm->rank() == 0 && !fs::exists(directory_m)) {
+        boost::system::error_code error_code;
+        fs::create_directories(directory_m, error_code);
+    }
+    ippl::Comm->barrier();
+
+    if (!fs::is_directory(directory_m)) {
+        throw OpalException(
+            "Checkpoint::Checkpoint", "unable to create checkpoint directory '" + directory_m + "'");
+    }
+}
+
+Checkpoint::~Checkpoint() {
+    try {
+        wait();
+    } catch (...) {
+        *ippl::Error << "Checkpoint: the last checkpoint could not be written" << endl;
+    }
+}
+
+std::string Checkpoint::getDefaultDirectory() {
+    return OpalData::getInstance()->getInputBasename() + ".checkpoint";
+}
+
+std::string Checkpoint::getFileName(int rank) const {
+    return directory_m + "/rank_" + std::to_string(rank) + ".ckpt";
+}
+
+void Checkpoint::installSignalHandler() {
+    auto handler = [](int) { signalReceived_s = 1; };
+    std::signal(SIGTERM, handler);
+    std::signal(SIGUSR1, handler);
+}
+
+bool Checkpoint::terminationRequested() {
+    int received = (signalReceived_s != 0) ? 1 : 0;
+    MPI_Allreduce(MPI_IN_PLACE, &received, 1, MPI_INT, MPI_MAX, ippl::Comm->getCommunicator());
+    return received != 0;
+}
+
+void Checkpoint::wait() {
+    if (pending_m.valid()) {
+        pending_m.get();
+    }
+}
+
+template <class View>
+void Checkpoint::stage(const View& view, size_t nlocal) {
+    using value_type = typename View::value_type;
+
+    auto hostView = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), view);
+    append(buffer_m, hostView.data(), nlocal);
+    static_assert(std::is_trivially_copyable<value_type>::value,
+                  "checkpointed attributes must be trivially copyable");
+}
+
+template <class View>
+void Checkpoint::restore(const View& view, const char*& pos, size_t nlocal) {
+    auto hostView = Kokkos::create_mirror_view(view);
+    extract(hostView.data(), pos, nlocal);
+    Kokkos::deep_copy(view, hostView);
+}
+
+void Checkpoint::write(PartBunch_t* bunch, const TrackerState& state) {
+    // the buffer is still in use by the previous write
+    wait();
+
+    IpplTimings::startTimer(stageTimer_m);
+
+    auto pc             = bunch->getParticleContainer();
+    const size_t nlocal = bunch->getLocalNum();
+    OpalData* opal      = OpalData::getInstance();
+
+    CheckpointHeader header = {};
+    std::memcpy(header.magic, checkpointMagic, sizeof(header.magic));
+    header.format           = checkpointFormat;
+    header.numRanks         = ippl::Comm->size();
+    header.rank             = ippl::Comm->rank();
+    header.seed             = Options::seed;
+    header.localNum         = nlocal;
+    header.totalNum         = bunch->getTotalNum();
+    header.globalTrackStep  = bunch->getGlobalTrackStep();
+    header.localTrackStep   = bunch->getLocalTrackStep();
+    header.t                = bunch->getT();
+    header.dt               = bunch->getdT();
+    header.spos             = bunch->get_sPos();
+    header.globalPhaseShift = opal->getGlobalPhaseShift();
+    for (unsigned d = 0; d < 3; ++d) {
+        header.refPartR[d] = bunch->RefPartR_m[d];
+        header.refPartP[d] = bunch->RefPartP_m[d];
+    }
+    header.pathLength     = state.pathLength;
+    header.stepSizeIndex  = state.stepSizeIndex;
+    header.numCavities    = opal->getNumberOfMaxPhases();
+    header.stepsInSegment = state.stepsInSegment;
+    header.ensembleSize   = bunch->getEnsembleSize();
+
+    header.emittedParticles = state.emittedParticles;
+    header.emittedSteps     = state.emittedSteps;
+
+    buffer_m.clear();
+    append(buffer_m, &header, 1);
+
+    stage(pc->ID.getView(), nlocal);
+    stage(pc->R.getView(), nlocal);
+    stage(pc->P.getView(), nlocal);
+    stage(pc->getChargeView(), nlocal);
+    stage(pc->getMassView(), nlocal);
+    if (pc->hasCompactLayout()) {
+        const std::vector<double> dt(nlocal, bunch->getdT());
+        append(buffer_m, dt.data(), nlocal);
+    } else {
+        stage(pc->dt.getView(), nlocal);
+    }
+    stage(pc->Bin.getView(), nlocal);
+    stage(pc->Sp.getView(), nlocal);
+
+    for (auto it = opal->getFirstMaxPhases(); it < opal->getLastMaxPhases(); ++it) {
+        const std::uint32_t length = it->first.size();
+        append(buffer_m, &length, 1);
+        append(buffer_m, it->first.data(), length);
+        append(buffer_m, &(it->second), 1);
+    }
+
+    IpplTimings::stopTimer(stageTimer_m);
+
+    const std::string fileName = getFileName(ippl::Comm->rank());
+    pending_m = std::async(std::launch::async, &Checkpoint::writeFile, this, fileName);
+}
+
+void Checkpoint::writeFile(const std::string& fileName) {
+    // runs on the background thread, errors are rethrown by wait()
+    const std::string tmpName = fileName + ".tmp";
+    {
+        std::ofstream out(tmpName, std::ios::binary | std::ios::trunc);
+        out.write(buffer_m.data(), buffer_m.size());
+        out.flush();
+        if (!out) {
+            throw OpalException("Checkpoint::writeFile", "writing '" + tmpName + "' failed");
+        }
+    }
+
+    if (std::rename(tmpName.c_str(), fileName.c_str()) != 0) {
+        throw OpalException("Checkpoint::writeFile", "renaming '" + tmpName + "' failed");
+    }
+}
+
+Checkpoint::TrackerState Checkpoint::read(PartBunch_t* bunch) {
+    IpplTimings::startTimer(readTimer_m);
+
+    const std::string fileName = getFileName(ippl::Comm->rank());
+    std::ifstream in(fileName, std::ios::binary);
+    if (!in) {
+        throw OpalException("Checkpoint::read", "unable to open '" + fileName + "'");
+    }
+    std::vector<char> buffer((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+    CheckpointHeader header;
+    if (buffer.size() < sizeof(header)) {
+        throw OpalException("Checkpoint::read", "'" + fileName + "' is truncated");
+    }
+    const char* pos = buffer.data();
+    extract(&header, pos, 1);
+
+    if (std::strncmp(header.magic, checkpointMagic, sizeof(header.magic)) != 0
+        || header.format != checkpointFormat) {
+        throw OpalException("Checkpoint::read", "'" + fileName + "' is not an OPAL checkpoint");
+    }
+    if (header.numRanks != ippl::Comm->size()) {
+        throw OpalException(
+            "Checkpoint::read", "the checkpoint was written with " + std::to_string(header.numRanks)
+                                    + " ranks, restart with the same number of ranks");
+    }
+
+    auto pc             = bunch->getParticleContainer();
+    const size_t nlocal = header.localNum;
+
+    // the counts of the header have to agree with the size of the file before the bulk load, the
+    // charges, masses and time steps are stored as doubles in both layouts
+    const size_t particleSize = valueSize(pc->ID.getView()) + valueSize(pc->R.getView())
+                                + valueSize(pc->P.getView()) + 3 * sizeof(double)
+                                + valueSize(pc->Bin.getView()) + valueSize(pc->Sp.getView());
+    const char* end       = buffer.data() + buffer.size();
+    const size_t bodySize = end - pos;
+    int corrupt           = 0;
+    if (nlocal > bodySize / particleSize
+        || !cavitiesFit(pos + nlocal * particleSize, end, header.numCavities)) {
+        corrupt = 1;
+    }
+    ippl::Comm->allreduce(corrupt, 1, std::greater<int>());
+    if (corrupt != 0) {
+        throw OpalException(
+            "Checkpoint::read", "the checkpoint files in '" + directory_m
+                                    + "' are shorter than their headers state");
+    }
+
+    // a preemption between the renames on different ranks leaves a mixed checkpoint
+    long long minStep = header.globalTrackStep;
+    long long maxStep = header.globalTrackStep;
+    ippl::Comm->allreduce(minStep, 1, std::less<long long>());
+    ippl::Comm->allreduce(maxStep, 1, std::greater<long long>());
+    if (minStep != maxStep) {
+        throw OpalException(
+            "Checkpoint::read", "the checkpoint files in '" + directory_m
+                                    + "' belong to different steps (" + std::to_string(minStep)
+                                    + " - " + std::to_string(maxStep) + ")");
+    }
+
+    size_t totalNum = nlocal;
+    ippl::Comm->allreduce(&totalNum, 1, std::plus<size_t>());
+    if (totalNum != header.totalNum) {
+        throw OpalException(
+            "Checkpoint::read", "the particles of the checkpoint files in '" + directory_m
+                                    + "' don't add up to the stored total of "
+                                    + std::to_string(header.totalNum));
+    }
+
+    pc->create(nlocal);
+
+    restore(pc->ID.getView(), pos, nlocal);
+    restore(pc->R.getView(), pos, nlocal);
+    restore(pc->P.getView(), pos, nlocal);
+    // the compact layout keeps the charge and the mass in the species table and the time step in
+    // the bunch, the stored values are validated once the species table is set up
+    const char* constantsPos = pos;
+    if (pc->hasCompactLayout()) {
+        pos += 3 * nlocal * sizeof(double);
+    } else {
+        restore(pc->Q.getView(), pos, nlocal);
+        restore(pc->M.getView(), pos, nlocal);
+        restore(pc->dt.getView(), pos, nlocal);
+    }
+    restore(pc->Bin.getView(), pos, nlocal);
+    restore(pc->Sp.getView(), pos, nlocal);
+
+    // particles emitted after the restart must not reuse the restored IDs
+    pc->continueIDsAfterLocalParticles();
+
+    // the members of an ensemble are species, the DataSink writes the *.ensemble file
+    Options::ensembleSize = header.ensembleSize;
+    bunch->setEnsembleSize(header.ensembleSize);
+
+    if (pc->hasCompactLayout()) {
+        // the species table has to cover the species of all ranks
+        int numSpecies = 1;
+        auto Spview    = pc->Sp.getView();
+        Kokkos::parallel_reduce(
+            "checkpointNumSpecies", nlocal,
+            KOKKOS_LAMBDA(const size_t i, int& maxSpecies) {
+                maxSpecies = Kokkos::max(maxSpecies, Spview(i) + 1);
+            },
+            Kokkos::Max<int>(numSpecies));
+        ippl::Comm->allreduce(numSpecies, 1, std::greater<int>());
+        pc->setNumberOfSpecies(std::max<int>(numSpecies, header.ensembleSize));
+
+        validateSpeciesConstants(bunch, constantsPos, nlocal, header.dt);
+    }
+
+    OpalData* opal = OpalData::getInstance();
+    for (std::uint32_t i = 0; i < header.numCavities; ++i) {
+        std::uint32_t length;
+        extract(&length, pos, 1);
+        std::string name(pos, length);
+        pos += length;
+        double phase;
+        extract(&phase, pos, 1);
+        opal->setMaxPhase(name, phase);
+    }
+    opal->setGlobalPhaseShift(header.globalPhaseShift);
+
+    Options::seed = header.seed;
+
+    bunch->setT(header.t);
+    bunch->setdT(header.dt);
+    bunch->set_sPos(header.spos);
+    bunch->setGlobalTrackStep(header.globalTrackStep);
+    bunch->setLocalTrackStep(header.localTrackStep);
+    for (unsigned d = 0; d < 3; ++d) {
+        bunch->RefPartR_m[d] = header.refPartR[d];
+        bunch->RefPartP_m[d] = header.refPartP[d];
+    }
+
+    IpplTimings::stopTimer(readTimer_m);
+
+    *gmsg << "* Restarted from checkpoint '" << directory_m << "' at step "
+          << header.globalTrackStep << " with " << header.totalNum << " particles" << endl;
+
+    return TrackerState{
+        header.pathLength, header.stepSizeIndex, header.stepsInSegment, header.emittedParticles,
+        header.emittedSteps};
+}
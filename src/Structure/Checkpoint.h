@@ -0,0 +1,101 @@
+//
+// Class Checkpoint
+//   Writes and reads restart checkpoints of the tracking state.
+//
+//   Every rank writes its local particles together with the bunch scalars, the
+//   position in the StepSizeConfig, the random seed, the cavity phases and the
+//   emission state of an emitted beam into its own binary file <dir>/rank_<r>.ckpt.
+//   The data is staged into a host buffer on the calling thread and written to
+//   disk by a background thread, s.t. tracking continues while the file system is
+//   busy. A restart reads the file back in one block and copies the attributes
+//   directly into the particle container, no H5 history is copied. The file has the same layout with and
+//   without COMPACTPARTICLES; a restart with COMPACTPARTICLES throws if the
+//   stored charges, masses or time steps differ from the species constants.
+//
+//   A file is first written to rank_<r>.ckpt.tmp and renamed when complete, i.e.
+//   a preemption during the write leaves the previous checkpoint intact. The
+//   restart checks that all ranks found the same step.
+//
+// This file is part of OPAL.
+//
+// OPAL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// You should have received a copy of the GNU General Public License
+// along with OPAL. If not, see <https://www.gnu.org/licenses/>.
+//
+#ifndef OPAL_CHECKPOINT_H
+#define OPAL_CHECKPOINT_H
+
+#include "OPALTypes.h"
+
+#include <csignal>
+#include <cstdint>
+#include <future>
+#include <string>
+#include <vector>
+
+class Checkpoint {
+public:
+    /// State of the tracker that is not stored in the bunch
+    struct TrackerState {
+        double pathLength;
+        unsigned int stepSizeIndex;   // see StepSizeConfig::getIndex
+        unsigned long long stepsInSegment; // steps done in the current StepSizeConfig entry
+        unsigned long long emittedParticles; // emission state of the sampler of the bunch
+        unsigned long long emittedSteps;
+    };
+
+    explicit Checkpoint(const std::string& directory);
+
+    ~Checkpoint();
+
+    /// Stages the state of bunch and tracker and writes it asynchronously.
+    void write(PartBunch_t* bunch, const TrackerState& state);
+
+    /// Restores bunch, cavity phases and random seed. Returns the tracker state.
+    TrackerState read(PartBunch_t* bunch);
+
+    /// Blocks until the last asynchronous write has finished.
+    void wait();
+
+    const std::string& getDirectory() const;
+
+    /// Installs the handler for SIGTERM and SIGUSR1 sent by the batch system before preemption
+    static void installSignalHandler();
+
+    /// True on all ranks if any rank received SIGTERM or SIGUSR1 (collective)
+    static bool terminationRequested();
+
+    /// Default directory of the checkpoints of the current input file
+    static std::string getDefaultDirectory();
+
+private:
+    std::string getFileName(int rank) const;
+
+    void writeFile(const std::string& fileName);
+
+    template <class View>
+    void stage(const View& view, size_t nlocal);
+
+    template <class View>
+    void restore(const View& view, const char*& pos, size_t nlocal);
+
+    std::string directory_m;
+
+    std::vector<char> buffer_m;
+    std::future<void> pending_m;
+
+    IpplTimings::TimerRef stageTimer_m;
+    IpplTimings::TimerRef readTimer_m;
+
+    static volatile std::sig_atomic_t signalReceived_s;
+};
+
+inline const std::string& Checkpoint::getDirectory() const {
+    return directory_m;
+}
+
+#endif  // OPAL_CHECKPOINT_H
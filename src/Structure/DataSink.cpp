@@ -35,6 +35,9 @@
 #include "Structure/BoundaryGeometry.h"
 #include "Structure/H5PartWrapper.h"
 #include "Structure/LBalWriter.h"
+#ifdef __linux__
+#include "Structure/MemoryProfiler.h"
+#endif
 #include "Utilities/Options.h"
 #include "Utilities/Timer.h"
 #include "Utilities/Util.h"
@@ -59,6 +62,12 @@ DataSink::DataSink(H5PartWrapper* h5wrapper, bool restart) {
 DataSink::DataSink(H5PartWrapper* h5wrapper) : DataSink(h5wrapper, false) {
 }
 
+DataSink::DataSink(H5PartWrapper* h5wrapper, double restartSpos) {
+    this->init(true, h5wrapper);
+
+    rewindLines(restartSpos);
+}
+
 void DataSink::dumpH5(PartBunch_t* beam, Vector_t<double, 3> FDext[]) const {
     if (!Options::enableHDF5)
         return;
@@ -96,6 +105,18 @@ void DataSink::dumpSDDS(
 
     statWriter_m->write(beam, FDext, losses, azimuth, npOutside);
 
+    if (sliceWriter_m) {
+        sliceWriter_m->write(beam, Options::numSlices);
+    }
+
+    if (ensembleWriter_m) {
+        ensembleWriter_m->write(beam);
+    }
+
+    if (memoryWriter_m) {
+        memoryWriter_m->write(beam);
+    }
+
     beam->gatherLoadBalanceStatistics();
 
     //for (size_t i = 0; i < sddsWriter_m.size(); ++i)
@@ -118,6 +139,26 @@ void DataSink::changeH5Wrapper(H5PartWrapper* h5wrapper) {
     h5Writer_m->changeH5Wrapper(h5wrapper);
 }
 
+void DataSink::flush() {
+    statWriter_m->flush();
+
+    for (size_t i = 0; i < sddsWriter_m.size(); ++i) {
+        sddsWriter_m[i]->flush();
+    }
+
+    if (sliceWriter_m) {
+        sliceWriter_m->flush();
+    }
+
+    if (ensembleWriter_m) {
+        ensembleWriter_m->flush();
+    }
+
+    if (memoryWriter_m) {
+        memoryWriter_m->flush();
+    }
+}
+
 void DataSink::writeGeomToVtk(BoundaryGeometry& bg, std::string fn) {
     if (ippl::Comm->rank() == 0 && Options::enableVTK) {
         bg.writeGeomToVtk(fn);
@@ -167,15 +208,32 @@ void DataSink::writeImpactStatistics(
 }
 
 void DataSink::rewindLines() {
+    double spos = h5Writer_m->getLastPosition();
+    h5Writer_m->close();
+
+    rewindLines(spos);
+}
+
+void DataSink::rewindLines(double spos) {
     unsigned int linesToRewind = 0;
 
-    double spos = h5Writer_m->getLastPosition();
     if (statWriter_m->exists()) {
         // use stat file to get position
         linesToRewind = statWriter_m->rewindToSpos(spos);
         statWriter_m->replaceVersionString();
     }
-    h5Writer_m->close();
+
+    // the slice file has several rows per step
+    if (sliceWriter_m && sliceWriter_m->exists()) {
+        sliceWriter_m->rewindToSpos(spos);
+        sliceWriter_m->replaceVersionString();
+    }
+
+    // as is the ensemble file
+    if (ensembleWriter_m && ensembleWriter_m->exists()) {
+        ensembleWriter_m->rewindToSpos(spos);
+        ensembleWriter_m->replaceVersionString();
+    }
 
     // rewind all others
     if (linesToRewind > 0) {
@@ -183,6 +241,11 @@ void DataSink::rewindLines() {
             sddsWriter_m[i]->rewindLines(linesToRewind);
             sddsWriter_m[i]->replaceVersionString();
         }
+
+        if (memoryWriter_m && memoryWriter_m->exists()) {
+            memoryWriter_m->rewindLines(linesToRewind);
+            memoryWriter_m->replaceVersionString();
+        }
     }
 }
 
@@ -196,6 +259,21 @@ void DataSink::init(bool restart, H5PartWrapper* h5wrapper) {
 
     sddsWriter_m.push_back(sddsWriter_t(new LBalWriter(fn + std::string(".lbal"), restart)));
 
+    if (Options::numSlices > 0) {
+        sliceWriter_m = sliceWriter_t(new SliceWriter(fn + std::string(".slice"), restart));
+    }
+
+    if (Options::ensembleSize > 1) {
+        ensembleWriter_m =
+            ensembleWriter_t(new EnsembleWriter(fn + std::string(".ensemble"), restart));
+    }
+
+#ifdef __linux__
+    if (Options::memoryDump) {
+        memoryWriter_m = sddsWriter_t(new MemoryProfiler(fn + std::string(".mem"), restart));
+    }
+#endif
+
     if (Options::enableHDF5) {
         h5Writer_m = h5Writer_t(new H5Writer(h5wrapper, restart));
     }
@@ -31,6 +31,8 @@
  
 #include "Structure/H5Writer.h"
 #include "Structure/SDDSWriter.h"
+#include "Structure/EnsembleWriter.h"
+#include "Structure/SliceWriter.h"
 #include "Structure/StatWriter.h"
 
 #include <iomanip>
@@ -46,6 +48,8 @@ private:
     typedef StatWriter::losses_t losses_t;
     typedef std::unique_ptr<StatWriter> statWriter_t;
     typedef std::unique_ptr<SDDSWriter> sddsWriter_t;
+    typedef std::unique_ptr<SliceWriter> sliceWriter_t;
+    typedef std::unique_ptr<EnsembleWriter> ensembleWriter_t;
     typedef std::unique_ptr<H5Writer> h5Writer_t;
 
 public:
@@ -58,6 +62,13 @@ public:
     DataSink(H5PartWrapper* h5wrapper, bool restart);
     DataSink(H5PartWrapper* h5wrapper);
 
+    /** \brief Constructor for a restart from a checkpoint.
+     *
+     * Appends to the existing output files after removing all lines
+     * beyond the path length restartSpos of the checkpoint.
+     */
+    DataSink(H5PartWrapper* h5wrapper, double restartSpos);
+
     void dumpH5(PartBunch_t* beam, Vector_t<double, 3> FDext[]) const;
 
     int dumpH5(
@@ -77,6 +88,10 @@ public:
 
     void changeH5Wrapper(H5PartWrapper* h5wrapper);
 
+    /** \brief Write the rows buffered by the SDDS writers to disk
+     */
+    void flush();
+
     /**
      * Write geometry points and surface triangles to vtk file
      *
@@ -101,6 +116,7 @@ private:
     DataSink& operator=(const DataSink&) = delete;
 
     void rewindLines();
+    void rewindLines(double spos);
 
     void init(bool restart = false, H5PartWrapper* h5wrapper = nullptr);
 
@@ -108,6 +124,15 @@ private:
     statWriter_t statWriter_m;
     std::vector<sddsWriter_t> sddsWriter_m;
 
+    /// in-situ slice analysis, only if Options::numSlices > 0
+    sliceWriter_t sliceWriter_m;
+
+    /// statistics of the members of an ensemble, only if Options::ensembleSize > 1
+    ensembleWriter_t ensembleWriter_m;
+
+    /// memory of the process and per subsystem, only if Options::memoryDump (Linux only)
+    sddsWriter_t memoryWriter_m;
+
     static std::string convertToString(int number, int setw = 5);
 
     /// needed to create index for vtk file
@@ -0,0 +1,118 @@
+//
+// Class EnsembleWriter
+//   This class writes the statistics of the members of an ensemble of bunches
+//   (*.ensemble), see the option ENSEMBLE.
+//
+// This file is part of OPAL.
+//
+// OPAL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// You should have received a copy of the GNU General Public License
+// along with OPAL. If not, see <https://www.gnu.org/licenses/>.
+//
+#include "EnsembleWriter.h"
+
+#include "AbstractObjects/OpalData.h"
+#include "PartBunch/PartBunch.h"
+#include "Physics/Units.h"
+#include "Utilities/Timer.h"
+
+#include <sstream>
+
+EnsembleWriter::EnsembleWriter(const std::string& fname, bool restart)
+    : StatBaseWriter(fname, restart) {
+}
+
+void EnsembleWriter::fillHeader() {
+    if (this->hasColumns()) {
+        return;
+    }
+
+    idx_m.t      = columns_m.addColumn("t", "double", "ns", "Time");
+    idx_m.s      = columns_m.addColumn("s", "double", "m", "Path length");
+    idx_m.member = columns_m.addColumn("member", "long", "1", "Index of the ensemble member");
+
+    idx_m.numParticles =
+        columns_m.addColumn(
+            "numParticles", "long64", "1", "Number of Macro Particles of the member");
+    idx_m.energy = columns_m.addColumn("energy", "double", "MeV", "Mean energy of the member");
+    idx_m.dE     = columns_m.addColumn("dE", "double", "MeV", "Energy spread of the member");
+
+    idx_m.mean[0] = columns_m.addColumn("mean_x", "double", "m", "Mean position of the member in x");
+    idx_m.mean[1] = columns_m.addColumn("mean_y", "double", "m", "Mean position of the member in y");
+    idx_m.mean[2] = columns_m.addColumn("mean_s", "double", "m", "Mean position of the member in s");
+
+    idx_m.rms[0] = columns_m.addColumn("rms_x", "double", "m", "RMS size of the member in x");
+    idx_m.rms[1] = columns_m.addColumn("rms_y", "double", "m", "RMS size of the member in y");
+    idx_m.rms[2] = columns_m.addColumn("rms_s", "double", "m", "RMS size of the member in s");
+
+    idx_m.emit[0] = columns_m.addColumn("emit_x", "double", "m", "Normalized emittance of the member in x");
+    idx_m.emit[1] = columns_m.addColumn("emit_y", "double", "m", "Normalized emittance of the member in y");
+
+    if (mode_m == std::ios::app)
+        return;
+
+    OPALTimer::Timer simtimer;
+    std::string dateStr(simtimer.date());
+    std::string timeStr(simtimer.time());
+
+    std::stringstream ss;
+    ss << "Ensemble statistics '" << OpalData::getInstance()->getInputFn() << "' " << dateStr
+       << " " << timeStr;
+
+    this->addDescription(ss.str(), "ensemble parameters");
+
+    this->addDefaultParameters();
+
+    this->addInfo("ascii", 1);
+}
+
+void EnsembleWriter::write(PartBunch_t* beam) {
+    auto pc     = beam->getParticleContainer();
+    auto Rview  = pc->R.getView();
+    auto Pview  = pc->P.getView();
+    auto Qview  = pc->getChargeView();
+    auto Mview  = pc->getMassView();
+    auto Spview = pc->Sp.getView();
+    members_m.computeEnsemble(
+        Rview, Pview, Qview, Mview, Spview, beam->getLocalNum(), beam->getEnsembleSize());
+
+    if (ippl::Comm->rank() != 0) {
+        return;
+    }
+
+    fillHeader();
+
+    this->open();
+
+    this->writeHeader();
+
+    const double t    = beam->getT() * Units::s2ns;
+    const double spos = beam->get_sPos();
+
+    for (unsigned int m = 0; m < members_m.getNumSlices(); ++m) {
+        columns_m.addColumnValue(idx_m.t, t);
+        columns_m.addColumnValue(idx_m.s, spos);
+        columns_m.addColumnValue(idx_m.member, static_cast<long unsigned int>(m));
+
+        columns_m.addColumnValue(
+            idx_m.numParticles, static_cast<long unsigned int>(members_m.getNumParticles(m)));
+        columns_m.addColumnValue(idx_m.energy, members_m.getMeanKineticEnergy(m));
+        columns_m.addColumnValue(idx_m.dE, members_m.getStdKineticEnergy(m));
+
+        for (unsigned int d = 0; d < 2; ++d) {
+            columns_m.addColumnValue(idx_m.mean[d], members_m.getMeanPosition(m, d));
+            columns_m.addColumnValue(idx_m.rms[d], members_m.getStandardDeviationPosition(m, d));
+            columns_m.addColumnValue(idx_m.emit[d], members_m.getNormalizedEmittance(m, d));
+        }
+        columns_m.addColumnValue(idx_m.mean[2], members_m.getMeanZ(m));
+        columns_m.addColumnValue(idx_m.rms[2], members_m.getStandardDeviationZ(m));
+
+        this->writeRow();
+    }
+
+    this->close();
+}
@@ -0,0 +1,47 @@
+//
+// Class EnsembleWriter
+//   This class writes the statistics of the members of an ensemble of bunches
+//   (*.ensemble), see the option ENSEMBLE.
+//
+//   Every call appends one row per member, all rows of a step share the columns
+//   t and s. The file can therefore be rewound like the statistics file.
+//
+// This file is part of OPAL.
+//
+// OPAL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// You should have received a copy of the GNU General Public License
+// along with OPAL. If not, see <https://www.gnu.org/licenses/>.
+//
+#ifndef OPAL_ENSEMBLE_WRITER_H
+#define OPAL_ENSEMBLE_WRITER_H
+
+#include "Algorithms/SliceMoments.h"
+#include "StatBaseWriter.h"
+
+#include <array>
+
+class EnsembleWriter : public StatBaseWriter {
+public:
+    EnsembleWriter(const std::string& fname, bool restart);
+
+    /// Computes the statistics of the members (collective) and writes them on rank 0
+    void write(PartBunch_t* beam);
+
+private:
+    void fillHeader();
+
+    SliceMoments members_m;
+
+    /// Indices of the columns, resolved once in fillHeader
+    struct ColumnIndices {
+        size_t t, s, member, numParticles, energy, dE;
+        std::array<size_t, 3> mean, rms;
+        std::array<size_t, 2> emit;
+    } idx_m;
+};
+
+#endif
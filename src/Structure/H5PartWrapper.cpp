@@ -15,6 +15,8 @@
 
 #include <boost/filesystem.hpp>
 
+#include "hdf5.h"
+
 #include <fstream>
 
 namespace {
@@ -34,6 +36,19 @@ H5PartWrapper::H5PartWrapper(const std::string& fileName, h5_int32_t flags)
       numSteps_m(0),
       startedFromExistingFile_m(false) {
     open(flags);
+
+    // an existing file is continued after its last step
+    if (flags == H5_O_RDWR || flags == H5_O_APPENDONLY) {
+        numSteps_m = H5GetNumSteps(file_m);
+        if (numSteps_m > 0) {
+            startedFromExistingFile_m = true;
+
+            REPORTONERROR(H5SetStep(file_m, numSteps_m - 1));
+            char opalFlavour[128];
+            READSTEPATTRIB(String, file_m, "OPAL_flavour", opalFlavour);
+            predecessorOPALFlavour_m = std::string(opalFlavour);
+        }
+    }
 }
 
 H5PartWrapper::H5PartWrapper(
@@ -126,6 +141,68 @@ void H5PartWrapper::storeCavityInformation() {
         close();
 }
 
+int H5PartWrapper::getLastStepAtPosition(const std::string& fileName, double spos) {
+    h5_prop_t props = H5CreateFileProp();
+    MPI_Comm comm   = ippl::Comm->getCommunicator();
+    h5_err_t h5err  = H5SetPropFileMPIOCollective(props, &comm);
+#if defined(NDEBUG)
+    (void)h5err;
+#endif
+    PAssert(h5err != H5_ERR);
+    h5_file_t file = H5OpenFile(fileName.c_str(), H5_O_RDONLY, props);
+    PAssert(file != (h5_file_t)H5_ERR);
+    H5CloseProp(props);
+
+    h5_ssize_t numSteps = H5GetNumSteps(file);
+    h5_ssize_t lastStep = -1;
+    for (h5_ssize_t step = numSteps - 1; step >= 0; --step) {
+        REPORTONERROR(H5SetStep(file, step));
+
+        h5_float64_t pathLength;
+        READSTEPATTRIB(Float64, file, "SPOS", &pathLength);
+        if (pathLength <= spos) {
+            lastStep = step;
+            break;
+        }
+    }
+
+    REPORTONERROR(H5CloseFile(file));
+
+    return static_cast<int>(lastStep);
+}
+
+void H5PartWrapper::removeStepsAfter(const std::string& fileName, int lastStep) {
+    // H5hut can't remove steps, the step groups are unlinked with HDF5 by one node. The space
+    // they took isn't reclaimed, the following steps are appended to the file
+    int failed = 0;
+    if (ippl::Comm->rank() == 0) {
+        hid_t file = H5Fopen(fileName.c_str(), H5F_ACC_RDWR, H5P_DEFAULT);
+        if (file < 0) {
+            failed = 1;
+        } else {
+            for (int step = lastStep + 1;; ++step) {
+                const std::string group = "Step#" + std::to_string(step);
+                if (H5Lexists(file, group.c_str(), H5P_DEFAULT) <= 0) {
+                    break;
+                }
+                if (H5Ldelete(file, group.c_str(), H5P_DEFAULT) < 0) {
+                    failed = 1;
+                    break;
+                }
+            }
+            H5Fclose(file);
+        }
+    }
+    MPI_Bcast(&failed, 1, MPI_INT, 0, ippl::Comm->getCommunicator());
+
+    if (failed) {
+        throw OpalException(
+            "H5PartWrapper::removeStepsAfter",
+            "could not remove the steps after step " + std::to_string(lastStep) + " from '"
+                + fileName + "'");
+    }
+}
+
 void H5PartWrapper::copyFile(const std::string& sourceFile, int lastStep, h5_int32_t flags) {
     namespace fs = boost::filesystem;
     if (!fs::exists(sourceFile)) {
@@ -42,6 +42,12 @@ public:
     void close();
 
     double getLastPosition();
+
+    /// the last step of fileName at or before the path length spos, -1 if there is none
+    static int getLastStepAtPosition(const std::string& fileName, double spos);
+    /// removes the steps after lastStep from fileName in place, collective
+    static void removeStepsAfter(const std::string& fileName, int lastStep);
+
     virtual void readHeader()                                                              = 0;
     virtual void readStep(PartBunch_t*, h5_ssize_t firstParticle, h5_ssize_t lastParticle) = 0;
 
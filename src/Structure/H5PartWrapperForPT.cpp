@@ -23,6 +23,7 @@
 #include "OPALconfig.h"
 #include "Physics/Physics.h"
 #include "Physics/Units.h"
+#include "Utilities/MemoryAccounting.h"
 #include "Utilities/OpalException.h"
 #include "Utilities/Options.h"
 #include "Utilities/Util.h"
@@ -32,6 +33,15 @@
 #include <set>
 #include <sstream>
 
+namespace {
+    /// create_mirror_view only allocates if the view isn't accessible from the host
+    template <class Mirror, class View>
+    size_t getMirrorBytes(const Mirror& mirror, const View& view) {
+        return mirror.data() == view.data() ? 0
+                                            : mirror.span() * sizeof(typename Mirror::value_type);
+    }
+}  // namespace
+
 H5PartWrapperForPT::H5PartWrapperForPT(const std::string& fileName, h5_int32_t flags)
     : H5PartWrapper(fileName, flags) {
 }
@@ -450,7 +460,7 @@ void H5PartWrapperForPT::writeStepData(PartBunch_t* bunch) {
         f64buffer[i] = pView(i)(2);
     WRITEDATA(Float64, file_m, "pz", f64buffer);
 
-    auto qViewDevice  = bunch->getParticleContainer()->Q.getView();
+    auto qViewDevice  = bunch->getParticleContainer()->getChargeView();
     auto qView = Kokkos::create_mirror_view(qViewDevice);
     Kokkos::deep_copy(qView,qViewDevice);
     
@@ -486,6 +496,12 @@ void H5PartWrapperForPT::writeStepData(PartBunch_t* bunch) {
     for (size_t i = 0; i < numLocalParticles; ++i)
         i32buffer[i] = spView(i);
     WRITEDATA(Int32, file_m, "sp", i32buffer);
+
+    // the buffer and the host mirrors live until the end of this function
+    size_t stagingBytes = buffer.size() + getMirrorBytes(rView, rViewDevice)
+                          + getMirrorBytes(pView, pViewDevice) + getMirrorBytes(qView, qViewDevice)
+                          + getMirrorBytes(binView, binViewDevice)
+                          + getMirrorBytes(spView, spViewDevice);
     
     if (Options::ebDump) {
         
@@ -520,7 +536,12 @@ void H5PartWrapperForPT::writeStepData(PartBunch_t* bunch) {
         for (size_t i = 0; i < numLocalParticles; ++i)
             f64buffer[i] = BView(i)(2);
         WRITEDATA(Float64, file_m, "Bz", f64buffer);
+
+        stagingBytes += getMirrorBytes(EView, EViewDevice) + getMirrorBytes(BView, BViewDevice);
     }
+
+    MemoryAccounting::getInstance().recordTransient(
+        MemoryAccounting::IO, stagingBytes, MemoryAccounting::HOST);
     
     /*
     /// Write space charge field map if asked for.
@@ -20,13 +20,18 @@
 #include "Algorithms/DistributionMoments.h"
 #include "OPALconfig.h"
 #include "Utilities/GeneralClassicException.h"
+#include "Utilities/MemoryAccounting.h"
 #include "Utilities/Options.h"
 #include "Utilities/Util.h"
 #include "Utility/IpplInfo.h"
 
 #include <boost/filesystem.hpp>
 
+#include <algorithm>
 #include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <limits>
 
 extern Inform* gmsg;
 
@@ -176,7 +181,8 @@ SetStatistics::SetStatistics()
 }
 
 LossDataSink::LossDataSink(std::string outfn, bool hdf5Save, CollectionType collectionType)
-    : h5hut_mode_m(hdf5Save),
+    : h5hut_mode_m(hdf5Save && Options::lossFormat != "BINARY"),
+      binary_mode_m(hdf5Save && Options::lossFormat == "BINARY"),
       H5file_m(0),
       outputName_m(outfn),
       H5call_m(0),
@@ -201,6 +207,7 @@ LossDataSink::LossDataSink(std::string outfn, bool hdf5Save, CollectionType coll
 
 LossDataSink::LossDataSink(const LossDataSink& rhs)
     : h5hut_mode_m(rhs.h5hut_mode_m),
+      binary_mode_m(rhs.binary_mode_m),
       H5file_m(rhs.H5file_m),
       outputName_m(rhs.outputName_m),
       H5call_m(rhs.H5call_m),
@@ -215,12 +222,21 @@ LossDataSink::LossDataSink(const LossDataSink& rhs)
     bunchNumber_m.clear();
 }
 
-LossDataSink::~LossDataSink() noexcept(false) {
+LossDataSink::~LossDataSink() {
+    // writing is collective and can't be done here, a rank might be unwinding
+    if (!pending_m.empty()) {
+        *ippl::Warn << "LossDataSink '" << outputName_m << "' destroyed with " << pending_m.size()
+                    << " unwritten save(s), close() was not called" << endl;
+    }
+}
+
+void LossDataSink::close() {
+    flush();
+
     if (H5file_m) {
         CLOSE_FILE();
         H5file_m = 0;
     }
-    ippl::Comm->barrier();
 }
 
 void LossDataSink::openH5(h5_int32_t mode) {
@@ -326,68 +342,156 @@ void LossDataSink::addParticle(
     particles_m.push_back(particle);
 }
 
+void LossDataSink::addParticles(std::vector<OpalParticle>&& particles) {
+    if (particles.empty()) {
+        return;
+    }
+    if (!turnNumber_m.empty()) {
+        throw GeneralClassicException(
+            "LossDataSink::addParticles",
+            "Either no particle or all have turn number and bunch number");
+    }
+
+    if (particles_m.empty()) {
+        particles_m = std::move(particles);
+    } else {
+        particles_m.reserve(particles_m.size() + particles.size());
+        particles_m.insert(
+            particles_m.end(), std::make_move_iterator(particles.begin()),
+            std::make_move_iterator(particles.end()));
+    }
+    particles.clear();
+}
+
+// Note: all ranks have to take the same decision whether to write a set
+// because there are two cases to be considered:
+// 1. ALL nodes have 0 lost particles -> nothing to be done.
+// 2. Some nodes have 0 lost particles, some not -> H5 can handle that but all
+// nodes HAVE to participate, otherwise H5 waits endlessly for a response from
+// the nodes that didn't enter the saveH5 function. -DW
+// The same reduction determines whether the buffered sets exceed the budget.
 void LossDataSink::save(unsigned int numSets, OpalData::OpenMode openMode) {
     if (outputName_m.empty())
         return;
-    if (hasNoParticlesToDump())
+
+    const size_t bytes = particles_m.size() * sizeof(OpalParticle);
+    size_t sizes[]     = {particles_m.size(), pendingBytes_m + bytes};
+    ippl::Comm->allreduce(sizes, 2, std::greater<size_t>());
+    if (sizes[0] == 0)
         return;
 
     if (openMode == OpalData::OpenMode::UNDEFINED) {
         openMode = OpalData::getInstance()->getOpenMode();
     }
+    if (pending_m.empty()) {
+        pendingOpenMode_m = openMode;
+    }
+
+    PendingSave records = takeRecords();
+    records.numSets     = numSets;
+    pending_m.push_back(std::move(records));
+    pendingBytes_m += bytes;
+    MemoryAccounting::getInstance().setBytes(
+        MemoryAccounting::IO, "LossDataSink " + outputName_m, pendingBytes_m,
+        MemoryAccounting::HOST);
+
+    if (sizes[1] > Options::lossBufferSize * 1024 * 1024) {
+        flush();
+    }
+}
+
+void LossDataSink::flush() {
+    if (pending_m.empty())
+        return;
+
+    // particles that have been added since the last save stay in memory
+    PendingSave current = takeRecords();
+
+    restoreRecords(std::move(pending_m.front()));
 
     namespace fs = boost::filesystem;
     if (h5hut_mode_m) {
         fileName_m = outputName_m + std::string(".h5");
-        if (openMode == OpalData::OpenMode::WRITE || !fs::exists(fileName_m)) {
+        if (pendingOpenMode_m == OpalData::OpenMode::WRITE || !fs::exists(fileName_m)) {
             openH5();
             writeHeaderH5();
         } else {
             openH5(H5_O_APPENDONLY);
             GET_NUM_STEPS();
         }
-
-        for (unsigned int i = 0; i < numSets; ++i) {
-            saveH5(i);
-        }
-        CLOSE_FILE();
-        H5file_m = 0;
-
+    } else if (binary_mode_m) {
+        fileName_m = outputName_m + std::string(".lossbin");
+        openBinary(pendingOpenMode_m);
     } else {
         fileName_m = outputName_m + std::string(".loss");
-        if (openMode == OpalData::OpenMode::WRITE || !fs::exists(fileName_m)) {
+        if (pendingOpenMode_m == OpalData::OpenMode::WRITE || !fs::exists(fileName_m)) {
             openASCII();
             writeHeaderASCII();
         } else {
             appendASCII();
         }
-        saveASCII();
+    }
+
+    for (size_t k = 0; k < pending_m.size(); ++k) {
+        const unsigned int numSets = pending_m[k].numSets;
+        if (k > 0) {
+            restoreRecords(std::move(pending_m[k]));
+        }
+
+        if (h5hut_mode_m) {
+            for (unsigned int i = 0; i < numSets; ++i) {
+                saveH5(i);
+            }
+        } else if (binary_mode_m) {
+            for (unsigned int i = 0; i < numSets; ++i) {
+                saveBinary(i);
+            }
+        } else {
+            saveASCII();
+        }
+    }
+
+    if (h5hut_mode_m) {
+        CLOSE_FILE();
+        H5file_m = 0;
+    } else if (binary_mode_m) {
+        closeBinary();
+    } else {
         closeASCII();
     }
     *gmsg << level2 << "Save '" << fileName_m << "'" << endl;
 
-    ippl::Comm->barrier();
+    pending_m.clear();
+    pendingBytes_m = 0;
+    MemoryAccounting::getInstance().release(MemoryAccounting::IO, "LossDataSink " + outputName_m);
+    restoreRecords(std::move(current));
+}
 
-    particles_m.clear();
-    turnNumber_m.clear();
-    bunchNumber_m.clear();
-    spos_m.clear();
-    refTime_m.clear();
-    RefPartR_m.clear();
-    RefPartP_m.clear();
-    globalTrackStep_m.clear();
+LossDataSink::PendingSave LossDataSink::takeRecords() {
+    PendingSave records;
+    records.particles.swap(particles_m);
+    records.bunchNumber.swap(bunchNumber_m);
+    records.turnNumber.swap(turnNumber_m);
+    records.RefPartR.swap(RefPartR_m);
+    records.RefPartP.swap(RefPartP_m);
+    records.globalTrackStep.swap(globalTrackStep_m);
+    records.refTime.swap(refTime_m);
+    records.spos.swap(spos_m);
+    records.startSet.swap(startSet_m);
+
+    return records;
 }
 
-// Note: This was changed to calculate the global number of dumped particles
-// because there are two cases to be considered:
-// 1. ALL nodes have 0 lost particles -> nothing to be done.
-// 2. Some nodes have 0 lost particles, some not -> H5 can handle that but all
-// nodes HAVE to participate, otherwise H5 waits endlessly for a response from
-// the nodes that didn't enter the saveH5 function. -DW
-bool LossDataSink::hasNoParticlesToDump() const {
-    size_t nLoc = particles_m.size();
-    ippl::Comm->reduce(nLoc, nLoc, 1, std::plus<size_t>());
-    return nLoc == 0;
+void LossDataSink::restoreRecords(PendingSave&& records) {
+    particles_m       = std::move(records.particles);
+    bunchNumber_m     = std::move(records.bunchNumber);
+    turnNumber_m      = std::move(records.turnNumber);
+    RefPartR_m        = std::move(records.RefPartR);
+    RefPartP_m        = std::move(records.RefPartP);
+    globalTrackStep_m = std::move(records.globalTrackStep);
+    refTime_m         = std::move(records.refTime);
+    spos_m            = std::move(records.spos);
+    startSet_m        = std::move(records.startSet);
 }
 
 bool LossDataSink::hasTurnInformations() const {
@@ -407,17 +511,6 @@ void LossDataSink::saveH5(unsigned int setIdx) {
         nLoc     = endIdx - startIdx;
     }
 
-    std::unique_ptr<size_t[]> locN(new size_t[ippl::Comm->size()]);
-    std::unique_ptr<size_t[]> globN(new size_t[ippl::Comm->size()]);
-
-    for (int i = 0; i < ippl::Comm->size(); i++) {
-        globN[i] = locN[i] = 0;
-    }
-
-    locN[ippl::Comm->rank()] = nLoc;
-
-    reduce(locN.get(), globN.get(), ippl::Comm->size(), std::plus<size_t>());
-
     DistributionMoments engine;
     engine.compute(particles_m.begin() + startIdx, particles_m.begin() + endIdx);
 
@@ -537,6 +630,168 @@ void LossDataSink::saveH5(unsigned int setIdx) {
     ++H5call_m;
 }
 
+void LossDataSink::openBinary(OpalData::OpenMode openMode) {
+    MPI_Comm comm = ippl::Comm->getCommunicator();
+    int rc        = MPI_File_open(
+        comm, fileName_m.c_str(), MPI_MODE_WRONLY | MPI_MODE_CREATE, MPI_INFO_NULL, &binaryFile_m);
+    if (rc != MPI_SUCCESS) {
+        throw GeneralClassicException(
+            "LossDataSink::openBinary", "failed to open file " + fileName_m);
+    }
+
+    if (openMode == OpalData::OpenMode::WRITE) {
+        rc             = MPI_File_set_size(binaryFile_m, 0);
+        binaryOffset_m = 0;
+    } else {
+        rc = MPI_File_get_size(binaryFile_m, &binaryOffset_m);
+    }
+    if (rc != MPI_SUCCESS) {
+        throw GeneralClassicException(
+            "LossDataSink::openBinary", "failed to prepare file " + fileName_m);
+    }
+}
+
+void LossDataSink::saveBinary(unsigned int setIdx) {
+    size_t nLoc     = particles_m.size();
+    size_t startIdx = 0;
+    if (setIdx + 1 < startSet_m.size()) {
+        startIdx = startSet_m[setIdx];
+        nLoc     = startSet_m[setIdx + 1] - startIdx;
+    }
+
+    // the particles of this rank start after those of all lower ranks
+    MPI_Comm comm       = ippl::Comm->getCommunicator();
+    uint64_t localNum   = nLoc;
+    uint64_t rankOffset = 0;
+    uint64_t totalNum   = 0;
+    MPI_Exscan(&localNum, &rankOffset, 1, MPI_UINT64_T, MPI_SUM, comm);
+    MPI_Allreduce(&localNum, &totalNum, 1, MPI_UINT64_T, MPI_SUM, comm);
+    if (ippl::Comm->rank() == 0) {
+        rankOffset = 0;
+    }
+
+    const bool hasTurn        = hasTurnInformations();
+    const uint32_t numColumns = hasTurn ? 12 : 10;
+    const size_t word         = sizeof(h5_float64_t);
+
+    // header
+    std::vector<char> header;
+    auto append = [&header](const void* data, size_t size) {
+        const char* bytes = static_cast<const char*>(data);
+        header.insert(header.end(), bytes, bytes + size);
+    };
+    double spos = 0.0, time = 0.0;
+    h5_int64_t globalTrackStep = 0;
+    Vector_t<double, 3> refR(0.0), refP(0.0);
+    if (setIdx < spos_m.size()) {
+        spos            = spos_m[setIdx];
+        time            = refTime_m[setIdx];
+        globalTrackStep = globalTrackStep_m[setIdx];
+        refR            = RefPartR_m[setIdx];
+        refP            = RefPartP_m[setIdx];
+    }
+    const uint32_t turnFlag = hasTurn;
+    append("OPALLOSS", 8);
+    append(&totalNum, sizeof(totalNum));
+    append(&numColumns, sizeof(numColumns));
+    append(&turnFlag, sizeof(turnFlag));
+    append(&spos, sizeof(spos));
+    append(&time, sizeof(time));
+    append(&globalTrackStep, sizeof(globalTrackStep));
+    for (unsigned int d = 0; d < 3; ++d) {
+        append(&refR[d], sizeof(double));
+    }
+    for (unsigned int d = 0; d < 3; ++d) {
+        append(&refP[d], sizeof(double));
+    }
+
+    if (ippl::Comm->rank() == 0) {
+        MPI_File_write_at(
+            binaryFile_m, binaryOffset_m, header.data(), header.size(), MPI_BYTE,
+            MPI_STATUS_IGNORE);
+    }
+
+    // columns, the local part of each column is contiguous
+    std::vector<char> buffer(numColumns * nLoc * word);
+    unsigned int column = 0;
+    auto f64column      = [&](std::function<h5_float64_t(const OpalParticle&)> select) {
+        h5_float64_t* dst = reinterpret_cast<h5_float64_t*>(buffer.data() + column++ * nLoc * word);
+        ::f64transform(particles_m, startIdx, nLoc, dst, select);
+    };
+    auto i64column = [&](std::function<h5_int64_t(const OpalParticle&)> select) {
+        h5_int64_t* dst = reinterpret_cast<h5_int64_t*>(buffer.data() + column++ * nLoc * word);
+        ::i64transform(particles_m, startIdx, nLoc, dst, select);
+    };
+
+    i64column([](const OpalParticle& particle) { return particle.getId(); });
+    f64column([](const OpalParticle& particle) { return particle.getX(); });
+    f64column([](const OpalParticle& particle) { return particle.getY(); });
+    f64column([](const OpalParticle& particle) { return particle.getZ(); });
+    f64column([](const OpalParticle& particle) { return particle.getPx(); });
+    f64column([](const OpalParticle& particle) { return particle.getPy(); });
+    f64column([](const OpalParticle& particle) { return particle.getPz(); });
+    f64column([](const OpalParticle& particle) { return particle.getCharge(); });
+    f64column([](const OpalParticle& particle) { return particle.getMass(); });
+    if (hasTurn) {
+        h5_int64_t* turn = reinterpret_cast<h5_int64_t*>(buffer.data() + column++ * nLoc * word);
+        std::copy(
+            turnNumber_m.begin() + startIdx, turnNumber_m.begin() + startIdx + nLoc, turn);
+        h5_int64_t* bunch = reinterpret_cast<h5_int64_t*>(buffer.data() + column++ * nLoc * word);
+        std::copy(
+            bunchNumber_m.begin() + startIdx, bunchNumber_m.begin() + startIdx + nLoc, bunch);
+    }
+    f64column([](const OpalParticle& particle) { return particle.getTime(); });
+
+    // collective writes of all columns. MPI counts are int, so the columns are written in
+    // chunks of at most maxChunk particles per rank, in units of one 8 byte word. The number
+    // of chunks follows from the global number of particles and is the same on all ranks.
+    MPI_Datatype wordType;
+    MPI_Type_contiguous(word, MPI_BYTE, &wordType);
+    MPI_Type_commit(&wordType);
+
+    const uint64_t maxChunk  = std::numeric_limits<int>::max() / numColumns;
+    const uint64_t numChunks = std::max<uint64_t>((totalNum + maxChunk - 1) / maxChunk, 1);
+    const MPI_Offset dataStart = binaryOffset_m + header.size();
+
+    int rc = MPI_SUCCESS;
+    for (uint64_t chunk = 0; chunk < numChunks; ++chunk) {
+        const uint64_t begin = std::min<uint64_t>(chunk * maxChunk, nLoc);
+        const uint64_t num   = std::min<uint64_t>(maxChunk, nLoc - begin);
+
+        MPI_Datatype fileType, memType;
+        MPI_Type_create_hvector(numColumns, num, totalNum * word, wordType, &fileType);
+        MPI_Type_create_hvector(numColumns, num, nLoc * word, wordType, &memType);
+        MPI_Type_commit(&fileType);
+        MPI_Type_commit(&memType);
+
+        MPI_File_set_view(
+            binaryFile_m, dataStart + (rankOffset + begin) * word, wordType, fileType, "native",
+            MPI_INFO_NULL);
+        const int chunkRc = MPI_File_write_all(
+            binaryFile_m, buffer.data() + begin * word, num > 0 ? 1 : 0, memType,
+            MPI_STATUS_IGNORE);
+        if (chunkRc != MPI_SUCCESS) {
+            rc = chunkRc;
+        }
+
+        MPI_Type_free(&memType);
+        MPI_Type_free(&fileType);
+    }
+    MPI_File_set_view(binaryFile_m, 0, MPI_BYTE, MPI_BYTE, "native", MPI_INFO_NULL);
+    MPI_Type_free(&wordType);
+
+    if (rc != MPI_SUCCESS) {
+        throw GeneralClassicException(
+            "LossDataSink::saveBinary", "failed to write data to file " + fileName_m);
+    }
+
+    binaryOffset_m += header.size() + numColumns * totalNum * word;
+}
+
+void LossDataSink::closeBinary() {
+    MPI_File_close(&binaryFile_m);
+}
+
 void LossDataSink::saveASCII() {
     /*
       ASCII output
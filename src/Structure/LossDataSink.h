@@ -33,6 +33,7 @@
 #include <vector>
 
 #include "H5hut.h"
+#include <mpi.h>
 
 struct SetStatistics {
     SetStatistics();
@@ -72,8 +73,20 @@ namespace std {
 enum class CollectionType : unsigned short { SPATIAL = 0, TEMPORAL };
 
 /*
-  - In the destructor we do ALL the file handling
-  - h5hut_mode_m defines h5hut or ASCII
+  - close() writes what is left and has to be called on all ranks before the
+    sink is destroyed; the destructor is not collective and only warns about
+    sets that were never written
+  - h5hut_mode_m defines h5hut or ASCII, binary_mode_m the binary columnar format
+  - save() keeps the sets in memory until LOSSBUFFERSIZE is exceeded; flush()
+    writes all of them with one open and close of the file
+
+  Layout of the binary format (*.lossbin, native byte order), one record per set:
+    header:  char[8] "OPALLOSS", uint64 number of particles N, uint32 number of
+             columns, uint32 has turn information, float64 spos, float64 time,
+             int64 global track step, float64[3] RefPartR, float64[3] RefPartP
+    columns: N values each, in the order id (int64), x, y, z, px, py, pz, q, m
+             (float64), [turn, bunchNumber (int64)], time (float64). The particles
+             of rank r follow those of ranks 0, ..., r - 1.
  */
 class LossDataSink {
 public:
@@ -82,7 +95,7 @@ public:
     LossDataSink(std::string outfn, bool hdf5Save, CollectionType = CollectionType::TEMPORAL);
 
     LossDataSink(const LossDataSink& rsh);
-    ~LossDataSink() noexcept(false);
+    ~LossDataSink();
 
     bool inH5Mode() {
         return h5hut_mode_m;
@@ -99,6 +112,15 @@ public:
         const OpalParticle&,
         const boost::optional<std::pair<int, short int>>& turnBunchNumPair = boost::none);
 
+    /// Appends a batch of particles, e.g. all hits of a monitor in one time step
+    void addParticles(std::vector<OpalParticle>&& particles);
+
+    /// Writes all sets kept in memory, has to be called on all ranks
+    void flush();
+
+    /// Writes all sets kept in memory and closes the files, has to be called on all ranks
+    void close();
+
     size_t size() const;
 
     std::set<SetStatistics> computeStatistics(unsigned int numSets);
@@ -123,17 +145,37 @@ private:
     void saveASCII();
     void saveH5(unsigned int setIdx);
 
+    void openBinary(OpalData::OpenMode openMode);
+    void saveBinary(unsigned int setIdx);
+    void closeBinary();
+
     void closeASCII() {
         if (ippl::Comm->rank() == 0) {
             os_m.close();
         }
     }
 
-    bool hasNoParticlesToDump() const;
     bool hasTurnInformations() const;
 
     void reportOnError(h5_int64_t rc, const char* file, int line);
 
+    /// The records of one call to save()
+    struct PendingSave {
+        unsigned int numSets = 1;
+        std::vector<OpalParticle> particles;
+        std::vector<size_t> bunchNumber;
+        std::vector<size_t> turnNumber;
+        std::vector<Vector_t<double, 3>> RefPartR;
+        std::vector<Vector_t<double, 3>> RefPartP;
+        std::vector<h5_int64_t> globalTrackStep;
+        std::vector<double> refTime;
+        std::vector<double> spos;
+        std::vector<unsigned long> startSet;
+    };
+
+    PendingSave takeRecords();
+    void restoreRecords(PendingSave&& records);
+
     void splitSets(unsigned int numSets);
     SetStatistics computeSetStatistics(unsigned int setIdx);
 
@@ -143,6 +185,14 @@ private:
     // write either in ASCII or H5hut format
     bool h5hut_mode_m;
 
+    // write in the binary columnar format using MPI-IO
+    bool binary_mode_m = false;
+
+    MPI_File binaryFile_m;
+
+    /// Position in the binary file where the next set starts
+    MPI_Offset binaryOffset_m = 0;
+
     // used to write out data in ASCII mode
     std::ofstream os_m;
 
@@ -167,6 +217,11 @@ private:
     std::vector<unsigned long> startSet_m;
 
     CollectionType collectionType_m;
+
+    /// Saved sets that have not been written to disk yet
+    std::vector<PendingSave> pending_m;
+    size_t pendingBytes_m                = 0;
+    OpalData::OpenMode pendingOpenMode_m = OpalData::OpenMode::UNDEFINED;
 };
 
 inline size_t LossDataSink::size() const {
@@ -28,6 +28,7 @@
 #include "AbstractObjects/OpalData.h"
 #include "PartBunch/PartBunch.h"
 #include "Physics/Units.h"
+#include "Utilities/MemoryAccounting.h"
 #include "Utilities/OpalException.h"
 #include "Utilities/Timer.h"
 
@@ -107,6 +108,14 @@ void MemoryProfiler::header() {
 
     columns_m.addColumn("VmStk-Avg", "double", unit_m[VirtualMemory::VMSTK], "Average stack size");
 
+    // accounted memory per subsystem, maxima over the ranks
+    const std::vector<std::string> columns = getAccountingColumns();
+    for (size_t i = 0; i < columns.size(); ++i) {
+        columns_m.addColumn(
+            columns[i], "double", "MB",
+            i % 2 == 0 ? "Maximum accounted memory" : "Maximum high-water mark of accounted memory");
+    }
+
     if (mode_m == std::ios::app)
         return;
 
@@ -176,6 +185,26 @@ void MemoryProfiler::compute(vm_t& vmMin, vm_t& vmMax, vm_t& vmAvg) {
     reduce(vmem_m.data(), vmMax.data(), vmem_m.size(), std::greater<double>());
 }
 
+std::vector<std::string> MemoryProfiler::getAccountingColumns() const {
+    const unsigned int numSpaces = MemoryAccounting::hasDeviceSpace() ? 2 : 1;
+
+    std::vector<std::string> columns;
+    for (unsigned int subsystem = 0; subsystem <= MemoryAccounting::SIZE; ++subsystem) {
+        const std::string name =
+            subsystem < MemoryAccounting::SIZE
+                ? MemoryAccounting::getName(MemoryAccounting::Subsystem(subsystem))
+                : "Total";
+        for (unsigned int space = 0; space < numSpaces; ++space) {
+            const std::string column =
+                name + "-" + MemoryAccounting::getName(MemoryAccounting::Space(space));
+            columns.push_back(column);
+            columns.push_back(column + "-Peak");
+        }
+    }
+
+    return columns;
+}
+
 void MemoryProfiler::write(const PartBunch_t* beam) {
     this->update();
 
@@ -185,6 +214,8 @@ void MemoryProfiler::write(const PartBunch_t* beam) {
 
     this->compute(vmMin, vmMax, vmAvg);
 
+    const std::vector<size_t> accounted = MemoryAccounting::getInstance().getMaxima();
+
     if (ippl::Comm->rank() != 0) {
         return;
     }
@@ -222,6 +253,17 @@ void MemoryProfiler::write(const PartBunch_t* beam) {
     columns_m.addColumnValue("VmStk-Max", toString(vmMax[VMSTK]));
     columns_m.addColumnValue("VmStk-Avg", toString(vmAvg[VMSTK]));
 
+    // the maxima are ordered as {current, peak} per space and subsystem, with both spaces
+    const std::vector<std::string> columns = getAccountingColumns();
+    const unsigned int numSpaces           = MemoryAccounting::hasDeviceSpace() ? 2 : 1;
+    for (size_t i = 0; i < columns.size(); ++i) {
+        const size_t entry  = i / 2;
+        const size_t offset = 2 * ((entry / numSpaces) * MemoryAccounting::NUMSPACES
+                                   + entry % numSpaces)
+                              + i % 2;
+        columns_m.addColumnValue(columns[i], accounted[offset] / (1024.0 * 1024.0));
+    }
+
     this->writeRow();
 
     this->close();
@@ -1,6 +1,8 @@
 //
 // Class MemoryProfiler
 //   This class writes a SDDS file with virtual memory usage information (Linux only).
+//   It also writes the memory per subsystem of MemoryAccounting, the maxima over
+//   the ranks of the current value and of the high-water mark.
 //
 // Copyright (c) 2019, Matthias Frey, Paul Scherrer Institut, Villigen PSI, Switzerland
 // All rights reserved
@@ -64,6 +66,8 @@ private:
     void header();
     void update();
     void compute(vm_t& vmMin, vm_t& vmMax, vm_t& vmAvg);
+
+    std::vector<std::string> getAccountingColumns() const;
     
 private:
     std::map<std::string, int> procinfo_m;
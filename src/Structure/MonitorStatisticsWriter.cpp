@@ -39,7 +39,7 @@ void MonitorStatisticsWriter::fillHeader() {
     columns_m.addColumn("name", "string", "", "Monitor name");
     columns_m.addColumn("s", "double", "m", "Longitudinal Position");
     columns_m.addColumn("t", "double", "ns", "Passage Time Reference Particle");
-    columns_m.addColumn("numParticles", "long", "1", "Number of Macro Particles");
+    columns_m.addColumn("numParticles", "long64", "1", "Number of Macro Particles");
     columns_m.addColumn("rms_x", "double", "m", "RMS Beamsize in x");
     columns_m.addColumn("rms_y", "double", "m", "RMS Beamsize in y");
     columns_m.addColumn("rms_s", "double", "m", "RMS Beamsize in s");
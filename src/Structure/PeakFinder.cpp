@@ -103,7 +103,8 @@ void PeakFinder::save() {
 
         *gmsg << level2 << "Save '" << fileName_m << "' and '" << hist_m << "'" << endl;
 
-        if (OpalData::getInstance()->inRestartRun())
+        if (OpalData::getInstance()->inRestartRun()
+            || OpalData::getInstance()->inCheckpointRestart())
             this->append_m();
         else
             this->open_m();
@@ -18,8 +18,31 @@
 #include "Structure/SDDSColumn.h"
 #include "Utilities/OpalException.h"
 
+#include <cstdint>
 #include <iomanip>
+#include <limits>
 #include <list>
+#include <sstream>
+
+namespace {
+    template <typename R>
+    struct CastVisitor: public boost::static_visitor<R> {
+        template <typename T>
+        R operator()(const T& val) const {
+            return static_cast<R>(val);
+        }
+
+        R operator()(const std::string&) const {
+            throw OpalException("SDDSColumn::writeBinaryValue",
+                                "can't write a string to a numeric column");
+        }
+    };
+
+    template <typename T>
+    void writeBinary(std::ostream& os, const T& val) {
+        os.write(reinterpret_cast<const char*>(&val), sizeof(T));
+    }
+}
 
 SDDSColumn::SDDSColumn(const std::string& name,
                        const std::string& type,
@@ -33,6 +56,25 @@ SDDSColumn::SDDSColumn(const std::string& name,
     writePrecision_m(prec),
     set_m(false)
 {
+    if (type == "double") {
+        binaryType_m = binary_t::DOUBLE;
+    } else if (type == "float") {
+        binaryType_m = binary_t::FLOAT;
+    } else if (type == "long") {
+        binaryType_m = binary_t::LONG;
+    } else if (type == "long64") {
+        binaryType_m = binary_t::LONG64;
+    } else if (type == "short") {
+        binaryType_m = binary_t::SHORT;
+    } else if (type == "character") {
+        binaryType_m = binary_t::CHARACTER;
+    } else if (type == "string") {
+        binaryType_m = binary_t::STRING;
+    } else {
+        throw OpalException("SDDSColumn::SDDSColumn",
+                            "unknown type '" + type + "' of column '" + name + "'");
+    }
+
     std::list<std::ios_base::fmtflags> numericalBase({std::ios_base::dec,
                                                       std::ios_base::hex,
                                                       std::ios_base::oct});
@@ -92,6 +134,52 @@ void SDDSColumn::writeValue(std::ostream& os) const {
     set_m = false;
 }
 
+void SDDSColumn::writeBinaryValue(std::ostream& os) const {
+    if (!set_m) {
+        throw OpalException("SDDSColumn::writeBinaryValue",
+                            "value for column '" + name_m + "' isn't set");
+    }
+
+    switch (binaryType_m) {
+    case binary_t::DOUBLE:
+        writeBinary(os, boost::apply_visitor(CastVisitor<double>(), value_m));
+        break;
+    case binary_t::FLOAT:
+        writeBinary(os, boost::apply_visitor(CastVisitor<float>(), value_m));
+        break;
+    case binary_t::LONG: {
+        // SDDS 'long' is a 32 bit integer, use 'long64' for larger values
+        const std::int64_t value = boost::apply_visitor(CastVisitor<std::int64_t>(), value_m);
+        if (value < std::numeric_limits<std::int32_t>::min()
+            || value > std::numeric_limits<std::int32_t>::max()) {
+            throw OpalException("SDDSColumn::writeBinaryValue",
+                                "value " + std::to_string(value) + " of column '" + name_m
+                                + "' doesn't fit into a 'long'");
+        }
+        writeBinary(os, static_cast<std::int32_t>(value));
+        break;
+    }
+    case binary_t::LONG64:
+        writeBinary(os, boost::apply_visitor(CastVisitor<std::int64_t>(), value_m));
+        break;
+    case binary_t::SHORT:
+        writeBinary(os, boost::apply_visitor(CastVisitor<std::int16_t>(), value_m));
+        break;
+    case binary_t::CHARACTER:
+        writeBinary(os, boost::apply_visitor(CastVisitor<char>(), value_m));
+        break;
+    case binary_t::STRING: {
+        std::ostringstream ss;
+        ss << value_m;
+        const std::string str = ss.str();
+        writeBinary(os, static_cast<std::int32_t>(str.size()));
+        os.write(str.data(), str.size());
+        break;
+    }
+    }
+    set_m = false;
+}
+
 std::ostream& operator<<(std::ostream& os,
                          const SDDSColumn& col) {
     col.writeValue(os);
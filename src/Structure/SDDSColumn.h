@@ -40,6 +40,9 @@ public:
                      unsigned int colNr,
                      const std::string& indent) const;
 
+    /// Writes the value in the SDDS binary representation of the column type
+    void writeBinaryValue(std::ostream& os) const;
+
 protected:
 
     void writeValue(std::ostream& os) const;
@@ -58,9 +61,20 @@ private:
                            long unsigned int,
                            char,
                            std::string> variant_t;
+    enum class binary_t {
+        DOUBLE,
+        FLOAT,
+        LONG,
+        LONG64,
+        SHORT,
+        CHARACTER,
+        STRING
+    };
+
     std::string name_m;
     desc_t description_m;
     variant_t value_m;
+    binary_t binaryType_m;
 
     std::ios_base::fmtflags writeFlags_m;
     unsigned short writePrecision_m;
@@ -17,20 +17,33 @@
 //
 #include "Structure/SDDSColumnSet.h"
 
-void SDDSColumnSet::addColumn(const std::string& name,
-                              const std::string& type,
-                              const std::string& unit,
-                              const std::string& desc,
-                              std::ios_base::fmtflags flags,
-                              unsigned short prec) {
+size_t SDDSColumnSet::addColumn(const std::string& name,
+                                const std::string& type,
+                                const std::string& unit,
+                                const std::string& desc,
+                                std::ios_base::fmtflags flags,
+                                unsigned short prec) {
 
     if (name2idx_m.find(name) != name2idx_m.end()) {
         throw OpalException("SDDSColumnSet::addColumn",
                             "column name '" + name + "' already exists");
     }
 
-    name2idx_m.insert(std::make_pair(name, columns_m.size()));
+    const size_t idx = columns_m.size();
+    name2idx_m.insert(std::make_pair(name, idx));
     columns_m.emplace_back(SDDSColumn(name, type, unit, desc, flags, prec));
+
+    return idx;
+}
+
+
+size_t SDDSColumnSet::getColumnIndex(const std::string& name) const {
+    auto it = name2idx_m.find(name);
+    if (it == name2idx_m.end()) {
+        throw OpalException("SDDSColumnSet::getColumnIndex",
+                            "column name '" + name + "' doesn't exists");
+    }
+    return it->second;
 }
 
 
@@ -47,5 +60,12 @@ void SDDSColumnSet::writeRow(std::ostream& os) const {
     for (auto & col: columns_m) {
         os << col;
     }
-    os << std::endl;
-}
\ No newline at end of file
+    os << "\n";
+}
+
+
+void SDDSColumnSet::writeBinaryRow(std::ostream& os) const {
+    for (auto & col: columns_m) {
+        col.writeBinaryValue(os);
+    }
+}
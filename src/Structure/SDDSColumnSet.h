@@ -30,22 +30,32 @@ class SDDSColumnSet {
 public:
     SDDSColumnSet();
 
-    void addColumn(const std::string& name,
-                   const std::string& type,
-                   const std::string& unit,
-                   const std::string& desc,
-                   std::ios_base::fmtflags flags = std::ios_base::scientific,
-                   unsigned short precision = 15);
+    /// Returns the index of the new column, see addColumnValue(size_t, const T&)
+    size_t addColumn(const std::string& name,
+                     const std::string& type,
+                     const std::string& unit,
+                     const std::string& desc,
+                     std::ios_base::fmtflags flags = std::ios_base::scientific,
+                     unsigned short precision = 15);
+
+    size_t getColumnIndex(const std::string& name) const;
 
     template<typename T>
     void addColumnValue(const std::string& name,
                         const T& val);
 
+    /// Sets the value of the column with index idx without the lookup by name
+    template<typename T>
+    void addColumnValue(size_t idx,
+                        const T& val);
+
     void writeHeader(std::ostream& os,
                      const std::string& indent) const;
 
     void writeRow(std::ostream& os) const;
 
+    void writeBinaryRow(std::ostream& os) const;
+
     bool hasColumns() const;
 
 private:
@@ -74,6 +84,13 @@ void SDDSColumnSet::addColumnValue(const std::string& name,
 }
 
 
+template<typename T>
+void SDDSColumnSet::addColumnValue(size_t idx,
+                                   const T& val) {
+    columns_m[idx].addValue(val);
+}
+
+
 inline
 bool SDDSColumnSet::hasColumns() const {
     return !name2idx_m.empty();
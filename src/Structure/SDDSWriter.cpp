@@ -21,62 +21,246 @@
 #include "AbstractObjects/OpalData.h"
 #include "PartBunch/PartBunch.h"
 #include "OPALconfig.h"
+#include "Utilities/OpalException.h"
+#include "Utilities/Options.h"
 #include "Utilities/SDDSParser.h"
 #include "Utilities/Util.h"
 
 #include "Utility/IpplInfo.h"
 
+#include "Physics/Physics.h"
+
+#include <algorithm>
+#include <cstdint>
 #include <queue>
 
 extern Inform* gmsg;
 
+namespace {
+    template <typename T>
+    void writeBinary(std::ostream& os, const T& val) {
+        os.write(reinterpret_cast<const char*>(&val), sizeof(T));
+    }
+
+    bool isLittleEndian() {
+        const std::uint16_t probe = 1;
+        return *reinterpret_cast<const char*>(&probe) == 1;
+    }
+}
+
 SDDSWriter::SDDSWriter(const std::string& fname, bool restart)
-    : fname_m(fname), mode_m(std::ios::out), indent_m("        ") {
+    : fname_m(fname),
+      mode_m(std::ios::out),
+      indent_m("        "),
+      bufferedRows_m(0),
+      flushFreq_m(std::max(Options::sddsFlushFreq, 1)),
+      binary_m(false),
+      numRows_m(0),
+      rowCountOffset_m(-1) {
     namespace fs = boost::filesystem;
 
     if (fs::exists(fname_m) && restart) {
         mode_m = std::ios::app;
         *gmsg<< "* Appending data to existing data file: '" << fname_m << "'" << endl;
+
+        if (ippl::Comm->rank() == 0) {
+            readDataLayout();
+        }
     } else {
         *gmsg << "* Creating new file for data: '" << fname_m << "'" << endl;
     }
 }
 
+SDDSWriter::~SDDSWriter() {
+    try {
+        flush();
+    } catch (const OpalException& ex) {
+        *ippl::Error << ex.where() << ": " << ex.what() << endl;
+    }
+}
+
+void SDDSWriter::readDataLayout() {
+    // the data mode of an existing file wins over the current options
+    std::ifstream in(fname_m.c_str(), std::ios::binary);
+    std::string line;
+    bool inData = false;
+    while (std::getline(in, line)) {
+        if (!inData) {
+            inData = (line.compare(0, 5, "&data") == 0);
+        }
+        if (inData) {
+            if (line.find("mode=binary") != std::string::npos) {
+                binary_m = true;
+            }
+            if (line.find("&end") != std::string::npos) {
+                break;
+            }
+        }
+    }
+
+    if (!binary_m || !in) {
+        return;
+    }
+
+    rowCountOffset_m = in.tellg();
+    std::int32_t numRows = 0;
+    in.read(reinterpret_cast<char*>(&numRows), sizeof(numRows));
+    numRows_m = numRows;
+}
+
+void SDDSWriter::flush() {
+    if (ippl::Comm->rank() != 0)
+        return;
+
+    if (bufferedRows_m > 0) {
+        open();
+        const std::string rows = rowBuffer_m.str();
+        os_m.write(rows.data(), rows.size());
+        rowBuffer_m.str("");
+        bufferedRows_m = 0;
+    }
+
+    if (os_m.is_open()) {
+        os_m.close();
+
+        if (binary_m) {
+            writeRowCount();
+        }
+    }
+}
+
+void SDDSWriter::writeRowCount() {
+    std::fstream fs(fname_m.c_str(), std::ios::in | std::ios::out | std::ios::binary);
+    if (!fs.is_open() || rowCountOffset_m < 0) {
+        throw OpalException("SDDSWriter::writeRowCount",
+                            "can't update the row count of '" + fname_m + "'");
+    }
+    fs.seekp(rowCountOffset_m);
+    writeBinary(fs, static_cast<std::int32_t>(numRows_m));
+}
+
 void SDDSWriter::rewindLines(size_t numberOfLines) {
     if (numberOfLines == 0 || ippl::Comm->rank() != 0) {
         return;
     }
 
-    std::string line;
-    std::queue<std::string> allLines;
-    std::fstream fs;
+    flush();
 
-    fs.open(fname_m.c_str(), std::fstream::in);
+    if (binary_m) {
+        SDDS::SDDSParser parser(fname_m);
+        parser.run();
+        const size_t numRows = parser.getData().sddsColumns_m.front().values_m.size();
+        truncateBinaryRows(parser, numRows - std::min(numberOfLines, numRows));
+        return;
+    }
 
-    if (!fs.is_open())
+    // find the beginning of the first line to delete by reading backwards from the end
+    std::ifstream in(fname_m.c_str(), std::ios::binary);
+
+    if (!in.is_open())
         return;
 
-    while (getline(fs, line)) {
-        allLines.push(line);
+    in.seekg(0, std::ios::end);
+    std::streamoff pos = in.tellg();
+    if (pos <= 0)
+        return;
+
+    char last;
+    in.seekg(pos - 1);
+    in.get(last);
+    // a last line without newline has to be deleted too
+    size_t newlinesToFind = numberOfLines + (last == '\n' ? 1 : 0);
+
+    std::streamoff newSize = 0;
+    std::vector<char> chunk(65536);
+    while (pos > 0 && newlinesToFind > 0) {
+        const std::streamoff length = std::min<std::streamoff>(pos, chunk.size());
+        pos -= length;
+        in.seekg(pos);
+        in.read(chunk.data(), length);
+        for (std::streamoff i = length - 1; i >= 0; --i) {
+            if (chunk[i] == '\n' && --newlinesToFind == 0) {
+                newSize = pos + i + 1;
+                break;
+            }
+        }
     }
-    fs.close();
+    in.close();
 
-    fs.open(fname_m.c_str(), std::fstream::out);
+    boost::filesystem::resize_file(fname_m, newSize);
+}
 
-    if (!fs.is_open())
-        return;
+unsigned int SDDSWriter::rewindBinaryToSpos(double maxSPos) {
+    if (ippl::Comm->rank() != 0)
+        return 0;
 
-    while (allLines.size() > numberOfLines) {
-        fs << allLines.front() << "\n";
-        allLines.pop();
+    flush();
+
+    SDDS::SDDSParser parser(fname_m);
+    parser.run();
+    SDDS::ast::columnData_t spos = parser.getColumnData("s");
+
+    size_t numRows = 0;
+    while (numRows < spos.size()
+           && (boost::get<double>(spos[numRows]) - maxSPos) <= 1e-20 * Physics::c) {
+        ++numRows;
     }
-    fs.close();
+
+    truncateBinaryRows(parser, numRows);
+
+    const unsigned int numDeleted = spos.size() - numRows;
+    if (numDeleted > 0)
+        *ippl::Info << level2 << "rewind " + fname_m + " to " + std::to_string(maxSPos) << " m"
+                    << endl;
+
+    return numDeleted;
+}
+
+void SDDSWriter::truncateBinaryRows(SDDS::SDDSParser& parser, size_t numberOfRows) {
+    size_t rowSize = 0;
+    for (const SDDS::column& col: parser.getData().sddsColumns_m) {
+        switch (*col.type_m) {
+        case SDDS::ast::FLOAT:
+            rowSize += sizeof(float);
+            break;
+        case SDDS::ast::DOUBLE:
+            rowSize += sizeof(double);
+            break;
+        case SDDS::ast::SHORT:
+            rowSize += sizeof(std::int16_t);
+            break;
+        case SDDS::ast::LONG:
+            rowSize += sizeof(std::int32_t);
+            break;
+        case SDDS::ast::LONG64:
+            rowSize += sizeof(std::int64_t);
+            break;
+        case SDDS::ast::CHARACTER:
+            rowSize += sizeof(char);
+            break;
+        case SDDS::ast::STRING:
+            throw OpalException("SDDSWriter::truncateBinaryRows",
+                                "can't rewind '" + fname_m + "', it has a string column");
+        }
+    }
+
+    boost::filesystem::resize_file(fname_m, parser.getFirstRowOffset() + numberOfRows * rowSize);
+
+    rowCountOffset_m = parser.getRowCountOffset();
+    numRows_m = numberOfRows;
+    writeRowCount();
 }
 
 void SDDSWriter::replaceVersionString() {
     if (ippl::Comm->rank() != 0)
         return;
 
+    // the revision is stored in binary form, its length can't change
+    if (binary_m)
+        return;
+
+    flush();
+
     std::string versionFile;
     SDDS::SDDSParser parser(fname_m);
     parser.run();
@@ -118,6 +302,8 @@ void SDDSWriter::replaceVersionString() {
 }
 
 double SDDSWriter::getLastValue(const std::string& column) {
+    flush();
+
     SDDS::SDDSParser parser(fname_m);
     parser.run();
     double val = 0.0;
@@ -129,15 +315,16 @@ void SDDSWriter::open() {
     if (ippl::Comm->rank() != 0 || os_m.is_open())
         return;
 
-    os_m.open(fname_m.c_str(), mode_m);
+    os_m.open(fname_m.c_str(), binary_m ? (mode_m | std::ios::binary) : mode_m);
     os_m.precision(precision_m);
     os_m.setf(std::ios::scientific, std::ios::floatfield);
 }
 
 void SDDSWriter::close() {
-    if (ippl::Comm->rank() == 0 && os_m.is_open()) {
-        os_m.close();
-    }
+    if (ippl::Comm->rank() != 0 || bufferedRows_m < flushFreq_m)
+        return;
+
+    flush();
 }
 
 void SDDSWriter::writeHeader() {
@@ -157,6 +344,9 @@ void SDDSWriter::writeHeader() {
 
 void SDDSWriter::writeDescription() {
     os_m << "SDDS1" << std::endl;
+    if (binary_m) {
+        os_m << (isLittleEndian() ? "!# little-endian" : "!# big-endian") << "\n";
+    }
     os_m << "&description\n"
          << indent_m << "text=\"" << desc_m.first << "\",\n"
          << indent_m << "contents=\"" << desc_m.second << "\"\n"
@@ -187,15 +377,51 @@ void SDDSWriter::writeInfo() {
          << indent_m << "no_row_counts=" << info_m.second << "\n"
          << "&end";
 
+    if (binary_m) {
+        // page header: row count, updated on every flush, and the parameter values
+        os_m << "\n";
+        rowCountOffset_m = os_m.tellp();
+        numRows_m = 0;
+        writeBinary(os_m, static_cast<std::int32_t>(0));
+
+        while (!paramValues_m.empty()) {
+            writeBinaryParameter(paramTypes_m.front(), paramValues_m.front());
+
+            paramTypes_m.pop();
+            paramValues_m.pop();
+        }
+        return;
+    }
+
     while (!paramValues_m.empty()) {
         os_m << "\n" << paramValues_m.front();
 
+        paramTypes_m.pop();
         paramValues_m.pop();
     }
 
     os_m << std::endl;
 }
 
+void SDDSWriter::writeBinaryParameter(const std::string& type, const std::string& value) {
+    if (type == "double") {
+        writeBinary(os_m, std::stod(value));
+    } else if (type == "float") {
+        writeBinary(os_m, std::stof(value));
+    } else if (type == "long") {
+        writeBinary(os_m, static_cast<std::int32_t>(std::stol(value)));
+    } else if (type == "long64") {
+        writeBinary(os_m, static_cast<std::int64_t>(std::stoll(value)));
+    } else if (type == "short") {
+        writeBinary(os_m, static_cast<std::int16_t>(std::stoi(value)));
+    } else if (type == "character") {
+        writeBinary(os_m, value.empty() ? '\0' : value.front());
+    } else {
+        writeBinary(os_m, static_cast<std::int32_t>(value.size()));
+        os_m.write(value.data(), value.size());
+    }
+}
+
 void SDDSWriter::addDefaultParameters() {
     std::stringstream revision;
     revision << OPAL_PROJECT_NAME << " " << OPAL_PROJECT_VERSION << " "
@@ -35,6 +35,10 @@
 #include "Structure/SDDSColumn.h"
 #include "Structure/SDDSColumnSet.h"
 
+namespace SDDS {
+    class SDDSParser;
+}
+
 class SDDSWriter {
 public:
     // order: text, content
@@ -51,12 +55,12 @@ public:
 
     SDDSWriter(const std::string& fname, bool restart);
 
-    virtual ~SDDSWriter(){};
+    virtual ~SDDSWriter();
 
     virtual void write(const PartBunch_t* /*beam*/){};
 
     /** \brief
-     *  delete the last 'numberOfLines' lines of the file 'fileName'
+     *  delete the last 'numberOfLines' lines (rows of binary files) of the file 'fileName'
      */
     void rewindLines(size_t numberOfLines);
 
@@ -66,6 +70,13 @@ public:
 
     bool exists() const;
 
+    /** \brief Write the buffered rows to disk.
+     *
+     * Rows are collected in memory and written in blocks of Options::sddsFlushFreq
+     * rows, see close().
+     */
+    void flush();
+
 protected:
     void addDescription(const std::string& text, const std::string& content);
 
@@ -85,8 +96,17 @@ protected:
 
     void open();
 
+    /// Writes the buffered rows and closes the file if the buffer is full
     void close();
 
+    bool isBinary() const;
+
+    /** \brief
+     *  delete all rows of a binary file beyond the path length 'maxSPos',
+     *  returns the number of deleted rows
+     */
+    unsigned int rewindBinaryToSpos(double maxSPos);
+
     /** \brief Write SDDS header.
      *
      * Writes the appropriate SDDS format header information, The SDDS tools can be used
@@ -123,15 +143,34 @@ private:
 
     void writeInfo();
 
+    void writeBinaryParameter(const std::string& type, const std::string& value);
+
+    void readDataLayout();
+
+    void writeRowCount();
+
+    void truncateBinaryRows(SDDS::SDDSParser& parser, size_t numberOfRows);
+
     std::ofstream os_m;
 
     std::string indent_m;
 
     desc_t desc_m;
     std::queue<param_t> params_m;
+    std::queue<std::string> paramTypes_m;
     std::queue<std::string> paramValues_m;
     data_t info_m;
 
+    /// rows that are not yet written to disk
+    std::ostringstream rowBuffer_m;
+    size_t bufferedRows_m;
+    size_t flushFreq_m;
+
+    /// SDDS binary data: rows of the single page and byte offset of the row count
+    bool binary_m;
+    size_t numRows_m;
+    std::streamoff rowCountOffset_m;
+
     static constexpr unsigned int precision_m = 15;
 };
 
@@ -147,17 +186,29 @@ template <typename T>
 void SDDSWriter::addParameter(
     const std::string& name, const std::string& type, const std::string& desc, const T& value) {
     params_m.push(std::make_tuple(name, type, desc));
+    paramTypes_m.push(type);
     std::stringstream ss;
     ss << value;
     paramValues_m.push(ss.str());
 }
 
 inline void SDDSWriter::addInfo(const std::string& mode, const size_t& no_row_counts) {
-    info_m = std::make_pair(mode, no_row_counts);
+    info_m   = std::make_pair(mode, no_row_counts);
+    binary_m = (mode == "binary");
 }
 
 inline void SDDSWriter::writeRow() {
-    columns_m.writeRow(os_m);
+    if (binary_m) {
+        columns_m.writeBinaryRow(rowBuffer_m);
+        ++numRows_m;
+    } else {
+        columns_m.writeRow(rowBuffer_m);
+    }
+    ++bufferedRows_m;
+}
+
+inline bool SDDSWriter::isBinary() const {
+    return binary_m;
 }
 
 template <typename T>
@@ -0,0 +1,122 @@
+//
+// Class SliceWriter
+//   This class writes the longitudinal slice statistics of the bunch (*.slice).
+//
+// This file is part of OPAL.
+//
+// OPAL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// You should have received a copy of the GNU General Public License
+// along with OPAL. If not, see <https://www.gnu.org/licenses/>.
+//
+#include "SliceWriter.h"
+
+#include "AbstractObjects/OpalData.h"
+#include "PartBunch/PartBunch.h"
+#include "Physics/Units.h"
+#include "Utilities/OpalFilter.h"
+#include "Utilities/Options.h"
+#include "Utilities/Timer.h"
+
+#include <sstream>
+
+SliceWriter::SliceWriter(const std::string& fname, bool restart) : StatBaseWriter(fname, restart) {
+}
+
+void SliceWriter::fillHeader() {
+    if (this->hasColumns()) {
+        return;
+    }
+
+    idx_m.t     = columns_m.addColumn("t", "double", "ns", "Time");
+    idx_m.s     = columns_m.addColumn("s", "double", "m", "Path length");
+    idx_m.slice = columns_m.addColumn("slice", "long", "1", "Slice index");
+    idx_m.z     = columns_m.addColumn("z", "double", "m", "Longitudinal center of the slice");
+
+    idx_m.numParticles =
+        columns_m.addColumn(
+            "numParticles", "long64", "1", "Number of Macro Particles in the slice");
+    idx_m.current = columns_m.addColumn("current", "double", "A", "Current of the slice");
+    idx_m.energy  = columns_m.addColumn("energy", "double", "MeV", "Mean energy of the slice");
+    idx_m.dE      = columns_m.addColumn("dE", "double", "MeV", "Energy spread of the slice");
+
+    idx_m.mean[0] = columns_m.addColumn("mean_x", "double", "m", "Mean position of the slice in x");
+    idx_m.mean[1] = columns_m.addColumn("mean_y", "double", "m", "Mean position of the slice in y");
+
+    idx_m.rms[0] = columns_m.addColumn("rms_x", "double", "m", "RMS size of the slice in x");
+    idx_m.rms[1] = columns_m.addColumn("rms_y", "double", "m", "RMS size of the slice in y");
+
+    idx_m.emit[0] = columns_m.addColumn("emit_x", "double", "m", "Normalized emittance of the slice in x");
+    idx_m.emit[1] = columns_m.addColumn("emit_y", "double", "m", "Normalized emittance of the slice in y");
+
+    if (mode_m == std::ios::app)
+        return;
+
+    OPALTimer::Timer simtimer;
+    std::string dateStr(simtimer.date());
+    std::string timeStr(simtimer.time());
+
+    std::stringstream ss;
+    ss << "Slice statistics '" << OpalData::getInstance()->getInputFn() << "' " << dateStr << " "
+       << timeStr;
+
+    this->addDescription(ss.str(), "slice parameters");
+
+    this->addDefaultParameters();
+
+    this->addInfo("ascii", 1);
+}
+
+void SliceWriter::write(PartBunch_t* beam, unsigned int numSlices) {
+    auto pc    = beam->getParticleContainer();
+    auto Rview = pc->R.getView();
+    auto Pview = pc->P.getView();
+    auto Qview = pc->getChargeView();
+    auto Mview = pc->getMassView();
+    slices_m.compute(Rview, Pview, Qview, Mview, beam->getLocalNum(), numSlices);
+
+    if (ippl::Comm->rank() != 0) {
+        return;
+    }
+
+    if (!Options::sliceFilter.empty()) {
+        OpalFilter* filter = OpalFilter::find(Options::sliceFilter);
+        filter->initOpalFilter();
+        slices_m.smoothCurrent(*filter->filter_m);
+    }
+
+    fillHeader();
+
+    this->open();
+
+    this->writeHeader();
+
+    const double t    = beam->getT() * Units::s2ns;
+    const double spos = beam->get_sPos();
+
+    for (unsigned int s = 0; s < slices_m.getNumSlices(); ++s) {
+        columns_m.addColumnValue(idx_m.t, t);
+        columns_m.addColumnValue(idx_m.s, spos);
+        columns_m.addColumnValue(idx_m.slice, static_cast<long unsigned int>(s));
+        columns_m.addColumnValue(idx_m.z, slices_m.getZ(s));
+
+        columns_m.addColumnValue(
+            idx_m.numParticles, static_cast<long unsigned int>(slices_m.getNumParticles(s)));
+        columns_m.addColumnValue(idx_m.current, slices_m.getCurrent(s));
+        columns_m.addColumnValue(idx_m.energy, slices_m.getMeanKineticEnergy(s));
+        columns_m.addColumnValue(idx_m.dE, slices_m.getStdKineticEnergy(s));
+
+        for (unsigned int d = 0; d < 2; ++d) {
+            columns_m.addColumnValue(idx_m.mean[d], slices_m.getMeanPosition(s, d));
+            columns_m.addColumnValue(idx_m.rms[d], slices_m.getStandardDeviationPosition(s, d));
+            columns_m.addColumnValue(idx_m.emit[d], slices_m.getNormalizedEmittance(s, d));
+        }
+
+        this->writeRow();
+    }
+
+    this->close();
+}
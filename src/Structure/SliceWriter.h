@@ -0,0 +1,45 @@
+//
+// Class SliceWriter
+//   This class writes the longitudinal slice statistics of the bunch (*.slice).
+//
+//   Every call appends one row per slice, all rows of a step share the columns
+//   t and s. The file can therefore be rewound like the statistics file.
+//
+// This file is part of OPAL.
+//
+// OPAL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// You should have received a copy of the GNU General Public License
+// along with OPAL. If not, see <https://www.gnu.org/licenses/>.
+//
+#ifndef OPAL_SLICE_WRITER_H
+#define OPAL_SLICE_WRITER_H
+
+#include "Algorithms/SliceMoments.h"
+#include "StatBaseWriter.h"
+
+#include <array>
+
+class SliceWriter : public StatBaseWriter {
+public:
+    SliceWriter(const std::string& fname, bool restart);
+
+    /// Computes the slice statistics (collective) and writes them on rank 0
+    void write(PartBunch_t* beam, unsigned int numSlices);
+
+private:
+    void fillHeader();
+
+    SliceMoments slices_m;
+
+    /// Indices of the columns, resolved once in fillHeader
+    struct ColumnIndices {
+        size_t t, s, slice, z, numParticles, current, energy, dE;
+        std::array<size_t, 2> mean, rms, emit;
+    } idx_m;
+};
+
+#endif
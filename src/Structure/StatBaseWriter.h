@@ -29,13 +29,18 @@ public:
     StatBaseWriter(const std::string& fname, bool restart);
 
     /** \brief
-     *  delete the last 'numberOfLines' lines of the statistics file
+     *  delete all lines of the statistics file beyond 'maxSpos',
+     *  returns the number of deleted lines
      */
     unsigned int rewindToSpos(double maxSpos);
 };
 
 inline unsigned int StatBaseWriter::rewindToSpos(double maxSPos) {
     if (ippl::Comm->rank() == 0) {
+        if (this->isBinary()) {
+            return this->rewindBinaryToSpos(maxSPos);
+        }
+        this->flush();
         return Util::rewindLinesSDDS(this->fname_m, maxSPos);
     }
     return 0;
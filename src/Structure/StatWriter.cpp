@@ -21,10 +21,27 @@
 #include "AbstractObjects/OpalData.h"
 #include "PartBunch/PartBunch.h"
 #include "Physics/Units.h"
+#include "Utilities/Options.h"
 #include "Utilities/Timer.h"
 
+#include <array>
 #include <sstream>
 
+namespace {
+    struct PercentileColumn {
+        const char* name;
+        const char* description;
+        const char* sigma;
+    };
+
+    const std::array<PercentileColumn, 4> percentileColumns = {{
+        {"68", "68.27", "1 sigma"},
+        {"95", "95.45", "2 sigma"},
+        {"99", "99.73", "3 sigma"},
+        {"99_99", "99.994", "4 sigma"},
+    }};
+}  // namespace
+
 StatWriter::StatWriter(const std::string& fname, bool restart) : StatBaseWriter(fname, restart) {
 }
 
@@ -33,147 +50,118 @@ void StatWriter::fillHeader(const losses_t& losses) {
         return;
     }
 
-    columns_m.addColumn("t", "double", "ns", "Time");
-    columns_m.addColumn("s", "double", "m", "Path length");
-    columns_m.addColumn("numParticles", "long", "1", "Number of Macro Particles");
-    columns_m.addColumn("charge", "double", "1", "Bunch Charge");
-    columns_m.addColumn("energy", "double", "MeV", "Mean Bunch Energy");
+    idx_m.t = columns_m.addColumn("t", "double", "ns", "Time");
+    idx_m.s = columns_m.addColumn("s", "double", "m", "Path length");
+    idx_m.numParticles = columns_m.addColumn("numParticles", "long64", "1", "Number of Macro Particles");
+    idx_m.charge = columns_m.addColumn("charge", "double", "1", "Bunch Charge");
+    idx_m.energy = columns_m.addColumn("energy", "double", "MeV", "Mean Bunch Energy");
 
-    columns_m.addColumn("rms_x", "double", "m", "RMS Beamsize in x");
-    columns_m.addColumn("rms_y", "double", "m", "RMS Beamsize in y");
-    columns_m.addColumn("rms_s", "double", "m", "RMS Beamsize in s");
+    idx_m.rms[0] = columns_m.addColumn("rms_x", "double", "m", "RMS Beamsize in x");
+    idx_m.rms[1] = columns_m.addColumn("rms_y", "double", "m", "RMS Beamsize in y");
+    idx_m.rms[2] = columns_m.addColumn("rms_s", "double", "m", "RMS Beamsize in s");
 
-    columns_m.addColumn("rms_px", "double", "1", "RMS Normalized Momenta in x");
-    columns_m.addColumn("rms_py", "double", "1", "RMS Normalized Momenta in y");
-    columns_m.addColumn("rms_ps", "double", "1", "RMS Normalized Momenta in s");
+    idx_m.rmsP[0] = columns_m.addColumn("rms_px", "double", "1", "RMS Normalized Momenta in x");
+    idx_m.rmsP[1] = columns_m.addColumn("rms_py", "double", "1", "RMS Normalized Momenta in y");
+    idx_m.rmsP[2] = columns_m.addColumn("rms_ps", "double", "1", "RMS Normalized Momenta in s");
 
-    columns_m.addColumn("emit_x", "double", "m", "Normalized Emittance x");
-    columns_m.addColumn("emit_y", "double", "m", "Normalized Emittance y");
-    columns_m.addColumn("emit_s", "double", "m", "Normalized Emittance s");
+    idx_m.emit[0] = columns_m.addColumn("emit_x", "double", "m", "Normalized Emittance x");
+    idx_m.emit[1] = columns_m.addColumn("emit_y", "double", "m", "Normalized Emittance y");
+    idx_m.emit[2] = columns_m.addColumn("emit_s", "double", "m", "Normalized Emittance s");
 
-    columns_m.addColumn("mean_x", "double", "m", "Mean Beam Position in x");
-    columns_m.addColumn("mean_y", "double", "m", "Mean Beam Position in y");
-    columns_m.addColumn("mean_s", "double", "m", "Mean Beam Position in s");
+    idx_m.mean[0] = columns_m.addColumn("mean_x", "double", "m", "Mean Beam Position in x");
+    idx_m.mean[1] = columns_m.addColumn("mean_y", "double", "m", "Mean Beam Position in y");
+    idx_m.mean[2] = columns_m.addColumn("mean_s", "double", "m", "Mean Beam Position in s");
 
-    columns_m.addColumn("ref_x", "double", "m", "x coordinate of reference particle in lab cs");
-    columns_m.addColumn("ref_y", "double", "m", "y coordinate of reference particle in lab cs");
-    columns_m.addColumn("ref_z", "double", "m", "z coordinate of reference particle in lab cs");
+    idx_m.ref[0] = columns_m.addColumn("ref_x", "double", "m", "x coordinate of reference particle in lab cs");
+    idx_m.ref[1] = columns_m.addColumn("ref_y", "double", "m", "y coordinate of reference particle in lab cs");
+    idx_m.ref[2] = columns_m.addColumn("ref_z", "double", "m", "z coordinate of reference particle in lab cs");
 
-    columns_m.addColumn("ref_px", "double", "1", "x momentum of reference particle in lab cs");
-    columns_m.addColumn("ref_py", "double", "1", "y momentum of reference particle in lab cs");
-    columns_m.addColumn("ref_pz", "double", "1", "z momentum of reference particle in lab cs");
+    idx_m.refP[0] = columns_m.addColumn("ref_px", "double", "1", "x momentum of reference particle in lab cs");
+    idx_m.refP[1] = columns_m.addColumn("ref_py", "double", "1", "y momentum of reference particle in lab cs");
+    idx_m.refP[2] = columns_m.addColumn("ref_pz", "double", "1", "z momentum of reference particle in lab cs");
 
-    columns_m.addColumn("max_x", "double", "m", "Max Beamsize in x");
-    columns_m.addColumn("max_y", "double", "m", "Max Beamsize in y");
-    columns_m.addColumn("max_s", "double", "m", "Max Beamsize in s");
+    idx_m.max[0] = columns_m.addColumn("max_x", "double", "m", "Max Beamsize in x");
+    idx_m.max[1] = columns_m.addColumn("max_y", "double", "m", "Max Beamsize in y");
+    idx_m.max[2] = columns_m.addColumn("max_s", "double", "m", "Max Beamsize in s");
 
-    columns_m.addColumn("xpx", "double", "1", "Correlation xpx");
-    columns_m.addColumn("ypy", "double", "1", "Correlation ypy");
-    columns_m.addColumn("zpz", "double", "1", "Correlation zpz");
+    idx_m.corr[0] = columns_m.addColumn("xpx", "double", "1", "Correlation xpx");
+    idx_m.corr[1] = columns_m.addColumn("ypy", "double", "1", "Correlation ypy");
+    idx_m.corr[2] = columns_m.addColumn("zpz", "double", "1", "Correlation zpz");
 
-    columns_m.addColumn("Dx", "double", "m", "Dispersion in x");
-    columns_m.addColumn("DDx", "double", "1", "Derivative of dispersion in x");
-    columns_m.addColumn("Dy", "double", "m", "Dispersion in y");
-    columns_m.addColumn("DDy", "double", "1", "Derivative of dispersion in y");
+    idx_m.Dx = columns_m.addColumn("Dx", "double", "m", "Dispersion in x");
+    idx_m.DDx = columns_m.addColumn("DDx", "double", "1", "Derivative of dispersion in x");
+    idx_m.Dy = columns_m.addColumn("Dy", "double", "m", "Dispersion in y");
+    idx_m.DDy = columns_m.addColumn("DDy", "double", "1", "Derivative of dispersion in y");
 
-    columns_m.addColumn("Bx_ref", "double", "T", "Bx-Field component of ref particle");
-    columns_m.addColumn("By_ref", "double", "T", "By-Field component of ref particle");
-    columns_m.addColumn("Bz_ref", "double", "T", "Bz-Field component of ref particle");
+    idx_m.Bref[0] = columns_m.addColumn("Bx_ref", "double", "T", "Bx-Field component of ref particle");
+    idx_m.Bref[1] = columns_m.addColumn("By_ref", "double", "T", "By-Field component of ref particle");
+    idx_m.Bref[2] = columns_m.addColumn("Bz_ref", "double", "T", "Bz-Field component of ref particle");
 
-    columns_m.addColumn("Ex_ref", "double", "MV/m", "Ex-Field component of ref particle");
-    columns_m.addColumn("Ey_ref", "double", "MV/m", "Ey-Field component of ref particle");
-    columns_m.addColumn("Ez_ref", "double", "MV/m", "Ez-Field component of ref particle");
+    idx_m.Eref[0] = columns_m.addColumn("Ex_ref", "double", "MV/m", "Ex-Field component of ref particle");
+    idx_m.Eref[1] = columns_m.addColumn("Ey_ref", "double", "MV/m", "Ey-Field component of ref particle");
+    idx_m.Eref[2] = columns_m.addColumn("Ez_ref", "double", "MV/m", "Ez-Field component of ref particle");
 
-    columns_m.addColumn("dE", "double", "MeV", "energy spread of the beam");
-    columns_m.addColumn("dt", "double", "ns", "time step size");
-    columns_m.addColumn("partsOutside", "double", "1", "outside n*sigma of the beam");
+    idx_m.dE = columns_m.addColumn("dE", "double", "MeV", "energy spread of the beam");
+    idx_m.dt = columns_m.addColumn("dt", "double", "ns", "time step size");
+    idx_m.partsOutside = columns_m.addColumn("partsOutside", "double", "1", "outside n*sigma of the beam");
 
-    columns_m.addColumn("DebyeLength", "double",  "m", "Debye length in the boosted frame");
-    columns_m.addColumn("plasmaParameter", "double",  "1", "Plasma parameter that gives no. of particles in a Debye sphere");
-    columns_m.addColumn("temperature", "double",  "K", "Temperature of the beam");
-    columns_m.addColumn("rmsDensity", "double",  "1", "RMS number density of the beam");
+    idx_m.debyeLength = columns_m.addColumn("DebyeLength", "double",  "m", "Debye length in the boosted frame");
+    idx_m.plasmaParameter = columns_m.addColumn("plasmaParameter", "double",  "1", "Plasma parameter that gives no. of particles in a Debye sphere");
+    idx_m.temperature = columns_m.addColumn("temperature", "double",  "K", "Temperature of the beam");
+    idx_m.rmsDensity = columns_m.addColumn("rmsDensity", "double",  "1", "RMS number density of the beam");
 
 
-    /// \todo Options::computePercentiles needs to be brought back
-    /*
     if (Options::computePercentiles) {
-        columns_m.addColumn("68_Percentile_x", "double", "m",
-                            "68.27 percentile (1 sigma of normal distribution) of x-component of
-    position"); columns_m.addColumn("68_Percentile_y", "double", "m", "68.27 percentile (1 sigma of
-    normal distribution) of y-component of position"); columns_m.addColumn("68_Percentile_z",
-    "double", "m", "68.27 percentile (1 sigma of normal distribution) of z-component of position");
-
-        columns_m.addColumn("95_Percentile_x", "double", "m",
-                            "95.45 percentile (2 sigma of normal distribution) of x-component of
-    position"); columns_m.addColumn("95_Percentile_y", "double", "m", "95.45 percentile (2 sigma of
-    normal distribution) of y-component of position"); columns_m.addColumn("95_Percentile_z",
-    "double", "m", "95.45 percentile (2 sigma of normal distribution) of z-component of position");
-
-        columns_m.addColumn("99_Percentile_x", "double", "m",
-                            "99.73 percentile (3 sigma of normal distribution) of x-component of
-    position"); columns_m.addColumn("99_Percentile_y", "double", "m", "99.73 percentile (3 sigma of
-    normal distribution) of y-component of position"); columns_m.addColumn("99_Percentile_z",
-    "double", "m", "99.73 percentile (3 sigma of normal distribution) of z-component of position");
-
-        columns_m.addColumn("99_99_Percentile_x", "double", "m",
-                            "99.994 percentile (4 sigma of normal distribution) of x-component of
-    position"); columns_m.addColumn("99_99_Percentile_y", "double", "m", "99.994 percentile (4 sigma
-    of normal distribution) of y-component of position"); columns_m.addColumn("99_99_Percentile_z",
-    "double", "m", "99.994 percentile (4 sigma of normal distribution) of z-component of position");
-
-        columns_m.addColumn("normalizedEps68Percentile_x", "double", "m",
-                            "x-component of normalized emittance at 68 percentile (1 sigma of normal
-    distribution)"); columns_m.addColumn("normalizedEps68Percentile_y", "double", "m", "y-component
-    of normalized emittance at 68 percentile (1 sigma of normal distribution)");
-        columns_m.addColumn("normalizedEps68Percentile_z", "double", "m",
-                            "z-component of normalized emittance at 68 percentile (1 sigma of normal
-    distribution)");
-
-        columns_m.addColumn("normalizedEps95Percentile_x", "double", "m",
-                            "x-component of normalized emittance at 95 percentile (2 sigma of normal
-    distribution)"); columns_m.addColumn("normalizedEps95Percentile_y", "double", "m", "y-component
-    of normalized emittance at 95 percentile (2 sigma of normal distribution)");
-        columns_m.addColumn("normalizedEps95Percentile_z", "double", "m",
-                            "z-component of normalized emittance at 95 percentile (2 sigma of normal
-    distribution)");
-
-        columns_m.addColumn("normalizedEps99Percentile_x", "double", "m",
-                            "x-component of normalized emittance at 99 percentile (3 sigma of normal
-    distribution)"); columns_m.addColumn("normalizedEps99Percentile_y", "double", "m", "y-component
-    of normalized emittance at 99 percentile (3 sigma of normal distribution)");
-        columns_m.addColumn("normalizedEps99Percentile_z", "double", "m",
-                            "z-component of normalized emittance at 99 percentile (3 sigma of normal
-    distribution)");
-
-        columns_m.addColumn("normalizedEps99_99Percentile_x", "double", "m",
-                            "x-component of normalized emittance at 99.99 percentile (4 sigma of
-    normal distribution)"); columns_m.addColumn("normalizedEps99_99Percentile_y", "double", "m",
-                            "y-component of normalized emittance at 99.99 percentile (4 sigma of
-    normal distribution)"); columns_m.addColumn("normalizedEps99_99Percentile_z", "double", "m",
-                            "z-component of normalized emittance at 99.99 percentile (4 sigma of
-    normal distribution)");
+        const char* axes[] = {"x", "y", "z"};
+        for (unsigned int t = 0; t < percentileColumns.size(); ++t) {
+            const PercentileColumn& column = percentileColumns[t];
+            for (unsigned int d = 0; d < 3; ++d) {
+                idx_m.percentile[t][d] = columns_m.addColumn(
+                    std::string(column.name) + "_Percentile_" + axes[d], "double", "m",
+                    std::string(column.description) + " percentile (" + column.sigma
+                        + " of normal distribution) of " + axes[d] + "-component of position");
+            }
+        }
+        for (unsigned int t = 0; t < percentileColumns.size(); ++t) {
+            const PercentileColumn& column = percentileColumns[t];
+            for (unsigned int d = 0; d < 3; ++d) {
+                idx_m.percentileEmit[t][d] = columns_m.addColumn(
+                    std::string("normalizedEps") + column.name + "Percentile_" + axes[d], "double",
+                    "m",
+                    std::string(axes[d]) + "-component of normalized emittance at "
+                        + column.description + " percentile (" + column.sigma
+                        + " of normal distribution)");
+            }
+        }
+
+        if (!OpalData::getInstance()->isInOPALCyclMode()) {
+            idx_m.halo[0] = columns_m.addColumn("halo_x", "double", "1", "Kurtosis minus HALOSHIFT in x");
+            idx_m.halo[1] = columns_m.addColumn("halo_y", "double", "1", "Kurtosis minus HALOSHIFT in y");
+            idx_m.halo[2] = columns_m.addColumn("halo_z", "double", "1", "Kurtosis minus HALOSHIFT in z");
+        }
     }
-    */
     if (OpalData::getInstance()->isInOPALCyclMode() && ippl::Comm->size() == 1) {
-        columns_m.addColumn("R0_x", "double", "m", "R0 Particle position in x");
-        columns_m.addColumn("R0_y", "double", "m", "R0 Particle position in y");
-        columns_m.addColumn("R0_s", "double", "m", "R0 Particle position in z");
+        idx_m.R0[0] = columns_m.addColumn("R0_x", "double", "m", "R0 Particle position in x");
+        idx_m.R0[1] = columns_m.addColumn("R0_y", "double", "m", "R0 Particle position in y");
+        idx_m.R0[2] = columns_m.addColumn("R0_s", "double", "m", "R0 Particle position in z");
 
-        columns_m.addColumn("P0_x", "double", "1", "R0 Particle momentum in x");
-        columns_m.addColumn("P0_y", "double", "1", "R0 Particle momentum in y");
-        columns_m.addColumn("P0_s", "double", "1", "R0 Particle momentum in z");
+        idx_m.P0[0] = columns_m.addColumn("P0_x", "double", "1", "R0 Particle momentum in x");
+        idx_m.P0[1] = columns_m.addColumn("P0_y", "double", "1", "R0 Particle momentum in y");
+        idx_m.P0[2] = columns_m.addColumn("P0_s", "double", "1", "R0 Particle momentum in z");
     }
 
     if (OpalData::getInstance()->isInOPALCyclMode()) {
-        columns_m.addColumn("halo_x", "double", "1", "Halo in x");
-        columns_m.addColumn("halo_y", "double", "1", "Halo in y");
-        columns_m.addColumn("halo_z", "double", "1", "Halo in z");
+        idx_m.halo[0] = columns_m.addColumn("halo_x", "double", "1", "Kurtosis minus HALOSHIFT in x");
+        idx_m.halo[1] = columns_m.addColumn("halo_y", "double", "1", "Kurtosis minus HALOSHIFT in y");
+        idx_m.halo[2] = columns_m.addColumn("halo_z", "double", "1", "Kurtosis minus HALOSHIFT in z");
 
-        columns_m.addColumn("azimuth", "double", "deg", "Azimuth in global coordinates");
+        idx_m.azimuth = columns_m.addColumn("azimuth", "double", "deg", "Azimuth in global coordinates");
     }
 
+    idx_m.losses.clear();
     for (size_t i = 0; i < losses.size(); ++i) {
-        columns_m.addColumn(losses[i].first, "long", "1", "Number of lost particles in element");
+        idx_m.losses.push_back(
+            columns_m.addColumn(losses[i].first, "long64", "1", "Number of lost particles in element"));
     }
 
     if (mode_m == std::ios::app)
@@ -191,7 +179,11 @@ void StatWriter::fillHeader(const losses_t& losses) {
 
     this->addDefaultParameters();
 
-    this->addInfo("ascii", 1);
+    if (Options::statFormat == "BINARY") {
+        this->addInfo("binary", 0);
+    } else {
+        this->addInfo("ascii", 1);
+    }
 }
 
 void StatWriter::write(
@@ -206,7 +198,9 @@ void StatWriter::write(
     /// Write data to files. If this is the first write to the beam statistics file, write SDDS
     /// header information.
 
-    double Q = beam->getCharge();
+    // the statistics of an ensemble describe the union of its members, the charge is
+    // the one of a single bunch
+    double Q = beam->getCharge() / beam->getEnsembleSize();
 
     if (ippl::Comm->rank() != 0) {
         return;
@@ -218,145 +212,131 @@ void StatWriter::write(
 
     this->writeHeader();
 
-    columns_m.addColumnValue("t", beam->getT() * Units::s2ns);      // 1
-    columns_m.addColumnValue("s", pathLength);                      // 2
-    columns_m.addColumnValue("numParticles", beam->getTotalNum());  // 3
-    columns_m.addColumnValue("charge", Q);                          // 4
-    columns_m.addColumnValue("energy", Ekin);                       // 5
+    const auto rmsR     = pc->getRmsR();
+    const auto rmsP     = pc->getRmsP();
+    const auto meanR    = pc->getMeanR();
+    const auto maxR     = pc->getMaxR();
+    const auto normEmit = beam->get_norm_emit();
+    const auto rprms    = beam->get_rprms();
 
-    columns_m.addColumnValue("rms_x", pc->getRmsR()(0));  // 6
-    columns_m.addColumnValue("rms_y", pc->getRmsR()(1));  // 7
-    columns_m.addColumnValue("rms_s", pc->getRmsR()(2));  // 8
+    columns_m.addColumnValue(idx_m.t, beam->getT() * Units::s2ns);      // 1
+    columns_m.addColumnValue(idx_m.s, pathLength);                      // 2
+    columns_m.addColumnValue(idx_m.numParticles, beam->getTotalNum());  // 3
+    columns_m.addColumnValue(idx_m.charge, Q);                          // 4
+    columns_m.addColumnValue(idx_m.energy, Ekin);                       // 5
 
-    columns_m.addColumnValue("rms_px", pc->getRmsP()(0));  // 9
-    columns_m.addColumnValue("rms_py", pc->getRmsP()(1));  // 10
-    columns_m.addColumnValue("rms_ps", pc->getRmsP()(2));  // 11
+    columns_m.addColumnValue(idx_m.rms[0], rmsR(0));  // 6
+    columns_m.addColumnValue(idx_m.rms[1], rmsR(1));  // 7
+    columns_m.addColumnValue(idx_m.rms[2], rmsR(2));  // 8
 
-    columns_m.addColumnValue("emit_x", beam->get_norm_emit()(0));  // 12
-    columns_m.addColumnValue("emit_y", beam->get_norm_emit()(1));  // 13
-    columns_m.addColumnValue("emit_s", beam->get_norm_emit()(2));  // 14
+    columns_m.addColumnValue(idx_m.rmsP[0], rmsP(0));  // 9
+    columns_m.addColumnValue(idx_m.rmsP[1], rmsP(1));  // 10
+    columns_m.addColumnValue(idx_m.rmsP[2], rmsP(2));  // 11
 
-    columns_m.addColumnValue("mean_x", pc->getMeanR()(0));  // 15
-    columns_m.addColumnValue("mean_y", pc->getMeanR()(1));  // 16
-    columns_m.addColumnValue("mean_s", pc->getMeanR()(2));  // 17
+    columns_m.addColumnValue(idx_m.emit[0], normEmit(0));  // 12
+    columns_m.addColumnValue(idx_m.emit[1], normEmit(1));  // 13
+    columns_m.addColumnValue(idx_m.emit[2], normEmit(2));  // 14
 
-    columns_m.addColumnValue("ref_x", beam->RefPartR_m(0));  // 18
-    columns_m.addColumnValue("ref_y", beam->RefPartR_m(1));  // 19
-    columns_m.addColumnValue("ref_z", beam->RefPartR_m(2));  // 20
+    columns_m.addColumnValue(idx_m.mean[0], meanR(0));  // 15
+    columns_m.addColumnValue(idx_m.mean[1], meanR(1));  // 16
+    columns_m.addColumnValue(idx_m.mean[2], meanR(2));  // 17
 
-    columns_m.addColumnValue("ref_px", beam->RefPartP_m(0));  // 21
-    columns_m.addColumnValue("ref_py", beam->RefPartP_m(1));  // 22
-    columns_m.addColumnValue("ref_pz", beam->RefPartP_m(2));  // 23
+    columns_m.addColumnValue(idx_m.ref[0], beam->RefPartR_m(0));  // 18
+    columns_m.addColumnValue(idx_m.ref[1], beam->RefPartR_m(1));  // 19
+    columns_m.addColumnValue(idx_m.ref[2], beam->RefPartR_m(2));  // 20
 
-    columns_m.addColumnValue("max_x", pc->getMaxR()(0));  // 24
-    columns_m.addColumnValue("max_y", pc->getMaxR()(1));  // 25
-    columns_m.addColumnValue("max_s", pc->getMaxR()(2));  // 26
+    columns_m.addColumnValue(idx_m.refP[0], beam->RefPartP_m(0));  // 21
+    columns_m.addColumnValue(idx_m.refP[1], beam->RefPartP_m(1));  // 22
+    columns_m.addColumnValue(idx_m.refP[2], beam->RefPartP_m(2));  // 23
+
+    columns_m.addColumnValue(idx_m.max[0], maxR(0));  // 24
+    columns_m.addColumnValue(idx_m.max[1], maxR(1));  // 25
+    columns_m.addColumnValue(idx_m.max[2], maxR(2));  // 26
 
     // Write out Courant Snyder parameters.
-    columns_m.addColumnValue("xpx", beam->get_rprms()(0));  // 27
-    columns_m.addColumnValue("ypy", beam->get_rprms()(1));  // 28
-    columns_m.addColumnValue("zpz", beam->get_rprms()(2));  // 29
+    columns_m.addColumnValue(idx_m.corr[0], rprms(0));  // 27
+    columns_m.addColumnValue(idx_m.corr[1], rprms(1));  // 28
+    columns_m.addColumnValue(idx_m.corr[2], rprms(2));  // 29
 
     // Write out dispersion.
-    columns_m.addColumnValue("Dx", beam->get_Dx());    // 30
-    columns_m.addColumnValue("DDx", beam->get_DDx());  // 31
-    columns_m.addColumnValue("Dy", beam->get_Dy());    // 32
-    columns_m.addColumnValue("DDy", beam->get_DDy());  // 33
+    columns_m.addColumnValue(idx_m.Dx, beam->get_Dx());    // 30
+    columns_m.addColumnValue(idx_m.DDx, beam->get_DDx());  // 31
+    columns_m.addColumnValue(idx_m.Dy, beam->get_Dy());    // 32
+    columns_m.addColumnValue(idx_m.DDy, beam->get_DDy());  // 33
 
     // Write head/reference particle/tail field information.
-    columns_m.addColumnValue("Bx_ref", FDext[0](0));  // 34 B-ref x
-    columns_m.addColumnValue("By_ref", FDext[0](1));  // 35 B-ref y
-    columns_m.addColumnValue("Bz_ref", FDext[0](2));  // 36 B-ref z
+    columns_m.addColumnValue(idx_m.Bref[0], FDext[0](0));  // 34 B-ref x
+    columns_m.addColumnValue(idx_m.Bref[1], FDext[0](1));  // 35 B-ref y
+    columns_m.addColumnValue(idx_m.Bref[2], FDext[0](2));  // 36 B-ref z
 
-    columns_m.addColumnValue("Ex_ref", FDext[1](0));  // 37 E-ref x
-    columns_m.addColumnValue("Ey_ref", FDext[1](1));  // 38 E-ref y
-    columns_m.addColumnValue("Ez_ref", FDext[1](2));  // 39 E-ref z
+    columns_m.addColumnValue(idx_m.Eref[0], FDext[1](0));  // 37 E-ref x
+    columns_m.addColumnValue(idx_m.Eref[1], FDext[1](1));  // 38 E-ref y
+    columns_m.addColumnValue(idx_m.Eref[2], FDext[1](2));  // 39 E-ref z
 
-    columns_m.addColumnValue("dE", beam->getdE());                // 40 dE energy spread
-    columns_m.addColumnValue("dt", beam->getdT() * Units::s2ns);  // 41 dt time step size
-    columns_m.addColumnValue("partsOutside", npOutside);  // 42 number of particles outside n*sigma
+    columns_m.addColumnValue(idx_m.dE, beam->getdE());                // 40 dE energy spread
+    columns_m.addColumnValue(idx_m.dt, beam->getdT() * Units::s2ns);  // 41 dt time step size
+    columns_m.addColumnValue(idx_m.partsOutside, npOutside);  // 42 number of particles outside n*sigma
 
-    columns_m.addColumnValue("DebyeLength", beam->get_debyeLength()); // 43 Debye length in the boosted frame
-    columns_m.addColumnValue("plasmaParameter", beam->get_plasmaParameter()); // 43 plasma parameter
-    columns_m.addColumnValue("temperature", beam->get_temperature()); // 44 Temperature 
-    columns_m.addColumnValue("rmsDensity", beam->get_rmsDensity()); // 45 RMS number density
+    columns_m.addColumnValue(idx_m.debyeLength, beam->get_debyeLength()); // 43 Debye length in the boosted frame
+    columns_m.addColumnValue(idx_m.plasmaParameter, beam->get_plasmaParameter()); // 43 plasma parameter
+    columns_m.addColumnValue(idx_m.temperature, beam->get_temperature()); // 44 Temperature 
+    columns_m.addColumnValue(idx_m.rmsDensity, beam->get_rmsDensity()); // 45 RMS number density
 
-    /*
     if (Options::computePercentiles) {
-        columns_m.addColumnValue("68_Percentile_x", beam->get_68Percentile()[0]);
-        columns_m.addColumnValue("68_Percentile_y", beam->get_68Percentile()[1]);
-        columns_m.addColumnValue("68_Percentile_z", beam->get_68Percentile()[2]);
-
-        columns_m.addColumnValue("95_Percentile_x", beam->get_95Percentile()[0]);
-        columns_m.addColumnValue("95_Percentile_y", beam->get_95Percentile()[1]);
-        columns_m.addColumnValue("95_Percentile_z", beam->get_95Percentile()[2]);
-
-        columns_m.addColumnValue("99_Percentile_x", beam->get_99Percentile()[0]);
-        columns_m.addColumnValue("99_Percentile_y", beam->get_99Percentile()[1]);
-        columns_m.addColumnValue("99_Percentile_z", beam->get_99Percentile()[2]);
-
-        columns_m.addColumnValue("99_99_Percentile_x", beam->get_99_99Percentile()[0]);
-        columns_m.addColumnValue("99_99_Percentile_y", beam->get_99_99Percentile()[1]);
-        columns_m.addColumnValue("99_99_Percentile_z", beam->get_99_99Percentile()[2]);
-
-        columns_m.addColumnValue(
-            "normalizedEps68Percentile_x", beam->get_normalizedEps_68Percentile()[0]);
-        columns_m.addColumnValue(
-            "normalizedEps68Percentile_y", beam->get_normalizedEps_68Percentile()[1]);
-        columns_m.addColumnValue(
-            "normalizedEps68Percentile_z", beam->get_normalizedEps_68Percentile()[2]);
-
-        columns_m.addColumnValue(
-            "normalizedEps95Percentile_x", beam->get_normalizedEps_95Percentile()[0]);
-        columns_m.addColumnValue(
-            "normalizedEps95Percentile_y", beam->get_normalizedEps_95Percentile()[1]);
-        columns_m.addColumnValue(
-            "normalizedEps95Percentile_z", beam->get_normalizedEps_95Percentile()[2]);
-
-        columns_m.addColumnValue(
-            "normalizedEps99Percentile_x", beam->get_normalizedEps_99Percentile()[0]);
-        columns_m.addColumnValue(
-            "normalizedEps99Percentile_y", beam->get_normalizedEps_99Percentile()[1]);
-        columns_m.addColumnValue(
-            "normalizedEps99Percentile_z", beam->get_normalizedEps_99Percentile()[2]);
-
-        columns_m.addColumnValue(
-            "normalizedEps99_99Percentile_x", beam->get_normalizedEps_99_99Percentile()[0]);
-        columns_m.addColumnValue(
-            "normalizedEps99_99Percentile_y", beam->get_normalizedEps_99_99Percentile()[1]);
-        columns_m.addColumnValue(
-            "normalizedEps99_99Percentile_z", beam->get_normalizedEps_99_99Percentile()[2]);
+        const Vector_t<double, 3> percentiles[] = {
+            beam->get_68Percentile(), beam->get_95Percentile(), beam->get_99Percentile(),
+            beam->get_99_99Percentile()};
+        const Vector_t<double, 3> percentileEmittances[] = {
+            beam->get_normalizedEps_68Percentile(), beam->get_normalizedEps_95Percentile(),
+            beam->get_normalizedEps_99Percentile(), beam->get_normalizedEps_99_99Percentile()};
+        for (unsigned int t = 0; t < percentileColumns.size(); ++t) {
+            for (unsigned int d = 0; d < 3; ++d) {
+                columns_m.addColumnValue(idx_m.percentile[t][d], percentiles[t](d));
+            }
+        }
+        for (unsigned int t = 0; t < percentileColumns.size(); ++t) {
+            for (unsigned int d = 0; d < 3; ++d) {
+                columns_m.addColumnValue(idx_m.percentileEmit[t][d], percentileEmittances[t](d));
+            }
+        }
+
+        if (!OpalData::getInstance()->isInOPALCyclMode()) {
+            Vector_t<double, 3> halo = beam->get_halo();
+            columns_m.addColumnValue(idx_m.halo[0], halo(0));
+            columns_m.addColumnValue(idx_m.halo[1], halo(1));
+            columns_m.addColumnValue(idx_m.halo[2], halo(2));
+        }
     }
-    */
+
     if (OpalData::getInstance()->isInOPALCyclMode()) {
         if (ippl::Comm->size() == 1) {
             if (beam->getLocalNum() > 0) {
-                columns_m.addColumnValue("R0_x", beam->R(0)[0]);
-                columns_m.addColumnValue("R0_y", beam->R(0)[1]);
-                columns_m.addColumnValue("R0_s", beam->R(0)[2]);
-                columns_m.addColumnValue("P0_x", beam->P(0)[0]);
-                columns_m.addColumnValue("P0_y", beam->P(0)[1]);
-                columns_m.addColumnValue("P0_s", beam->P(0)[2]);
+                columns_m.addColumnValue(idx_m.R0[0], beam->R(0)[0]);
+                columns_m.addColumnValue(idx_m.R0[1], beam->R(0)[1]);
+                columns_m.addColumnValue(idx_m.R0[2], beam->R(0)[2]);
+                columns_m.addColumnValue(idx_m.P0[0], beam->P(0)[0]);
+                columns_m.addColumnValue(idx_m.P0[1], beam->P(0)[1]);
+                columns_m.addColumnValue(idx_m.P0[2], beam->P(0)[2]);
             } else {
-                columns_m.addColumnValue("R0_x", 0.0);
-                columns_m.addColumnValue("R0_y", 0.0);
-                columns_m.addColumnValue("R0_s", 0.0);
-                columns_m.addColumnValue("P0_x", 0.0);
-                columns_m.addColumnValue("P0_y", 0.0);
-                columns_m.addColumnValue("P0_s", 0.0);
+                columns_m.addColumnValue(idx_m.R0[0], 0.0);
+                columns_m.addColumnValue(idx_m.R0[1], 0.0);
+                columns_m.addColumnValue(idx_m.R0[2], 0.0);
+                columns_m.addColumnValue(idx_m.P0[0], 0.0);
+                columns_m.addColumnValue(idx_m.P0[1], 0.0);
+                columns_m.addColumnValue(idx_m.P0[2], 0.0);
             }
         }
         Vector_t<double, 3> halo = beam->get_halo();
-        columns_m.addColumnValue("halo_x", halo(0));
-        columns_m.addColumnValue("halo_y", halo(1));
-        columns_m.addColumnValue("halo_z", halo(2));
+        columns_m.addColumnValue(idx_m.halo[0], halo(0));
+        columns_m.addColumnValue(idx_m.halo[1], halo(1));
+        columns_m.addColumnValue(idx_m.halo[2], halo(2));
 
-        columns_m.addColumnValue("azimuth", azimuth);
+        columns_m.addColumnValue(idx_m.azimuth, azimuth);
     }
 
     for (size_t i = 0; i < losses.size(); ++i) {
         long unsigned int loss = losses[i].second;
-        columns_m.addColumnValue(losses[i].first, loss);
+        columns_m.addColumnValue(idx_m.losses[i], loss);
     }
 
     this->writeRow();
@@ -21,6 +21,8 @@
 
 #include "StatBaseWriter.h"
 
+#include <array>
+
 class StatWriter : public StatBaseWriter {
 public:
     typedef std::vector<std::pair<std::string, unsigned int> > losses_t;
@@ -50,6 +52,20 @@ public:
 
 private:
     void fillHeader(const losses_t& losses = losses_t());
+
+    /// Indices of the columns, resolved once in fillHeader
+    struct ColumnIndices {
+        size_t t, s, numParticles, charge, energy;
+        std::array<size_t, 3> rms, rmsP, emit, mean, ref, refP, max, corr;
+        size_t Dx, DDx, Dy, DDy;
+        std::array<size_t, 3> Bref, Eref;
+        size_t dE, dt, partsOutside;
+        size_t debyeLength, plasmaParameter, temperature, rmsDensity;
+        std::array<size_t, 3> R0, P0, halo;
+        std::array<std::array<size_t, 3>, 4> percentile, percentileEmit;
+        size_t azimuth;
+        std::vector<size_t> losses;
+    } idx_m;
 };
 
 #endif
@@ -48,6 +48,16 @@ public:
         return !isInside(value);
     }
 
+    T getMin() const
+    {
+        return minValue_m;
+    }
+
+    T getMax() const
+    {
+        return maxValue_m;
+    }
+
     void print(Inform& out) const
     {
         out << "Value range between " << minValue_m << " and " << maxValue_m;
@@ -91,8 +91,11 @@ TrackCmd::TrackCmd() : Action(SIZE, "TRACK", "The \"TRACK\" command initiates tr
         "STEPSPERTURN", "The time steps per revolution period, only for opal-cycl.", 720);
 
     itsAttr[TIMEINTEGRATOR] = Attributes::makePredefinedString(
-        "TIMEINTEGRATOR", "Name of time integrator to be used.",
-        {"RK-4", "RK4", "LF-2", "LF2", "MTS"}, "RK4");
+        "TIMEINTEGRATOR",
+        "Name of time integrator to be used. LF2 is the Boris leap frog with the space charge "
+        "at the half step, RK4 evaluates the external fields four times per step and keeps "
+        "the space charge of the start of the step, it is only available in host builds.",
+        {"RK-4", "RK4", "LF-2", "LF2", "MTS"}, "LF2");
 
     itsAttr[MAP_ORDER] = Attributes::makeReal(
         "MAP_ORDER", "Truncation order of maps for ThickTracker (default: 1, i.e. linear).", 1);
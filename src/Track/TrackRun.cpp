@@ -45,6 +45,7 @@
 
 #include "Structure/Beam.h"
 #include "Structure/BoundaryGeometry.h"
+#include "Structure/Checkpoint.h"
 #include "Structure/DataSink.h"
 #include "Structure/H5PartWrapper.h"
 #include "Structure/H5PartWrapperForPT.h"
@@ -53,6 +54,7 @@
 #include "changes.h"
 
 #include <boost/assign.hpp>
+#include <boost/filesystem.hpp>
 
 #include <cmath>
 #include <fstream>
@@ -307,58 +309,29 @@ void TrackRun::execute() {
         *gmsg << "MPI_Comm_size " << world_size << endl;
     }
 
-    static IpplTimings::TimerRef samplingTime = IpplTimings::getTimer("samplingTime");
-    IpplTimings::startTimer(samplingTime);
-
-    // set distribution type
-    dist_m->setDist();
-    dist_m->setAvrgPz( beam->getMomentum()/beam->getMass() );
-
-    // sample particles
-    auto pc = bunch_m->getParticleContainer();
-    auto fc = bunch_m->getFieldContainer();
-    size_type Np = beam->getNumberOfParticles();
-    Vector_t<int, Dim> nr = bunch_m->nr_m;
+    Checkpoint::TrackerState checkpointState = {};
+    const bool fromCheckpoint = opal_m->inCheckpointRestart();
 
-    std::shared_ptr<Distribution> opalDist(dist_m);
+    if (fromCheckpoint) {
+        // bulk load of the particles, no sampling
+        Checkpoint checkpoint(opal_m->getCheckpointRestartDir());
+        checkpointState = checkpoint.read(bunch_m.get());
+        resumeEmission(beam, checkpointState);
+    } else {
+        sampleParticles(beam);
 
-    switch (opalDist->getType()){
-        case DistributionType::GAUSS:
-            sampler_m = std::make_shared<Gaussian>(pc, fc, opalDist);
-            break;
-        case DistributionType::MULTIVARIATEGAUSS:
-            sampler_m = std::make_shared<MultiVariateGaussian>(pc, fc, opalDist);
-            break;
-        case DistributionType::FLATTOP:
-            sampler_m = std::make_shared<FlatTop>(pc, fc, opalDist);
-            break;
-        default:
-            throw OpalException("Distribution::create", "Unknown \"TYPE\" of \"DISTRIBUTION\"");
+        bunch_m->setCharge();
+        bunch_m->setMass();
     }
 
-    *gmsg << "* About to create particles ..." << endl;
-    
-    static IpplTimings::TimerRef GenParticlesTimer  = IpplTimings::getTimer("GenParticles");
-    IpplTimings::startTimer(GenParticlesTimer);
-
-    sampler_m->generateParticles(Np, nr);
-
-    IpplTimings::stopTimer(GenParticlesTimer);
-
-    *gmsg << "* Particle creation done" << endl;
-    
-    IpplTimings::stopTimer(samplingTime);
-
     /* 
        reset the fieldsolver with correct hr_m
        based on the distribution
     */
 
-    bunch_m->setCharge();
-    bunch_m->setMass();
     bunch_m->bunchUpdate();
     bunch_m->print(*gmsg);
-    initDataSink();
+    initDataSink(fromCheckpoint ? checkpointState.pathLength : -1.0);
 
     /*
     if (!isFollowupTrack_m) {
@@ -367,7 +340,9 @@ void TrackRun::execute() {
     }
     */
 
-    if (bunch_m->getTotalNum() > 0) {
+    if (fromCheckpoint) {
+        // dt and the start position are taken from the checkpoint
+    } else if (bunch_m->getTotalNum() > 0) {
         double spos = Track::block->zstart;
         auto& zstop = Track::block->zstop;
         auto it     = Track::block->dT.begin();
@@ -390,11 +365,19 @@ void TrackRun::execute() {
 
     */
 
-    itsTracker_m = new ParallelTracker(
+    ParallelTracker* tracker = new ParallelTracker(
         *Track::block->use->fetchLine(), bunch_m.get(), *ds_m, Track::block->reference, false,
         Attributes::getBool(itsAttr[TRACKRUN::TRACKBACK]), Track::block->localTimeSteps,
         Track::block->zstart, Track::block->zstop, Track::block->dT);
 
+    tracker->setTimeIntegrator(Track::block->timeIntegrator);
+
+    if (fromCheckpoint) {
+        tracker->resumeFromCheckpoint(checkpointState);
+    }
+
+    itsTracker_m = tracker;
+
     itsTracker_m->execute();
 
     /*
@@ -406,6 +389,100 @@ void TrackRun::execute() {
     /// \todo do we delete here itsTracker_m;
 }
 
+void TrackRun::sampleParticles(Beam* beam) {
+    static IpplTimings::TimerRef samplingTime = IpplTimings::getTimer("samplingTime");
+    IpplTimings::startTimer(samplingTime);
+
+    // set distribution type
+    dist_m->setDist();
+    dist_m->setAvrgPz( beam->getMomentum()/beam->getMass() );
+
+    // sample particles
+    auto pc = bunch_m->getParticleContainer();
+    size_type Np = beam->getNumberOfParticles();
+    Vector_t<int, Dim> nr = bunch_m->nr_m;
+
+    std::shared_ptr<Distribution> opalDist(dist_m);
+
+    createSampler();
+
+    *gmsg << "* About to create particles ..." << endl;
+    
+    static IpplTimings::TimerRef GenParticlesTimer  = IpplTimings::getTimer("GenParticles");
+    IpplTimings::startTimer(GenParticlesTimer);
+
+    // only the counter based samplers draw a disjoint range of random numbers per member
+    const short ensembleSize = Options::ensembleSize;
+    if (ensembleSize > 1 && opalDist->getType() != DistributionType::GAUSS
+        && opalDist->getType() != DistributionType::MULTIVARIATEGAUSS) {
+        throw OpalException(
+            "TrackRun::sampleParticles",
+            "An ENSEMBLE can only be sampled from a GAUSS or a MULTIVARIATEGAUSS distribution");
+    }
+
+    // every member is a species of its own
+    for (short member = 0; member < ensembleSize; ++member) {
+        const size_t before = pc->getLocalNum();
+
+        sampler_m->setEnsembleMember(member);
+        sampler_m->generateParticles(Np, nr);
+
+        auto Spview = pc->Sp.getView();
+        Kokkos::parallel_for(
+            "ensemble member", Kokkos::RangePolicy<>(before, pc->getLocalNum()),
+            KOKKOS_LAMBDA(const size_t i) { Spview(i) = member; });
+    }
+    Kokkos::fence();
+    bunch_m->setEnsembleSize(ensembleSize);
+
+    IpplTimings::stopTimer(GenParticlesTimer);
+
+    // an emitted beam is created step by step by the tracker
+    bunch_m->setSampler(sampler_m);
+    bunch_m->setEnergyBins(opalDist->getNumberOfEnergyBins());
+
+    *gmsg << "* Particle creation done" << endl;
+    
+    IpplTimings::stopTimer(samplingTime);
+}
+
+void TrackRun::createSampler() {
+    auto pc = bunch_m->getParticleContainer();
+    auto fc = bunch_m->getFieldContainer();
+    std::shared_ptr<Distribution> opalDist(dist_m);
+
+    switch (opalDist->getType()){
+        case DistributionType::GAUSS:
+            sampler_m = std::make_shared<Gaussian>(pc, fc, opalDist);
+            break;
+        case DistributionType::MULTIVARIATEGAUSS:
+            sampler_m = std::make_shared<MultiVariateGaussian>(pc, fc, opalDist);
+            break;
+        case DistributionType::FLATTOP:
+            sampler_m = std::make_shared<FlatTop>(pc, fc, opalDist);
+            break;
+        default:
+            throw OpalException("Distribution::create", "Unknown \"TYPE\" of \"DISTRIBUTION\"");
+    }
+}
+
+void TrackRun::resumeEmission(Beam* beam, const Checkpoint::TrackerState& state) {
+    dist_m->setDist();
+    dist_m->setAvrgPz( beam->getMomentum()/beam->getMass() );
+    if (!dist_m->emitting_m) {
+        return;
+    }
+
+    // the sampler continues the emission schedule of the checkpointed run
+    createSampler();
+    sampler_m->resumeEmission(
+        beam->getNumberOfParticles(), state.emittedParticles, state.emittedSteps,
+        bunch_m->getT());
+
+    bunch_m->setSampler(sampler_m);
+    bunch_m->setEnergyBins(dist_m->getNumberOfEnergyBins());
+}
+
 void TrackRun::setRunMethod() {
     if (!itsAttr[TRACKRUN::METHOD]) {
         throw OpalException(
@@ -456,7 +533,24 @@ if (fs_m->hasPeriodicZ()) {
 }
 */
 
-void TrackRun::initDataSink() {
+void TrackRun::initDataSink(double checkpointSpos) {
+    if (opal_m->inCheckpointRestart()) {
+        // the steps of the phase space file after the checkpoint are removed in place and the
+        // run appends to it, the SDDS files are rewound by the DataSink
+        const std::string fileName = opal_m->getInputBasename() + std::string(".h5");
+        if (boost::filesystem::exists(fileName)) {
+            const int lastStep = H5PartWrapper::getLastStepAtPosition(fileName, checkpointSpos);
+            H5PartWrapper::removeStepsAfter(fileName, lastStep);
+            phaseSpaceSink_m = new H5PartWrapperForPT(fileName, H5_O_APPENDONLY);
+        } else {
+            phaseSpaceSink_m = new H5PartWrapperForPT(fileName, H5_O_WRONLY);
+            phaseSpaceSink_m->writeHeader();
+        }
+        opal_m->setDataSink(new DataSink(phaseSpaceSink_m, checkpointSpos));
+        ds_m = opal_m->getDataSink();
+        return;
+    }
+
     if (opal_m->inRestartRun()) {
         phaseSpaceSink_m = new H5PartWrapperForPT(
             opal_m->getInputBasename() + std::string(".h5"), opal_m->getRestartStep(),
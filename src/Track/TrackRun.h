@@ -24,6 +24,7 @@
 #include "PartBunch/PartBunch.h"
 #include "Distribution/SamplingBase.hpp"
 
+#include "Structure/Checkpoint.h"
 #include "Structure/FieldSolverCmd.h"
 
 #include <boost/bimap.hpp>
@@ -67,7 +68,15 @@ private:
     void setRunMethod();
     std::string getRunMethodName() const;
 
-    void initDataSink();
+    /// checkpointSpos is only used in a restart from a checkpoint
+    void initDataSink(double checkpointSpos = -1.0);
+
+    void sampleParticles(Beam* beam);
+
+    void createSampler();
+
+    /// rebuilds the sampler of an emitted beam after a restart from a checkpoint
+    void resumeEmission(Beam* beam, const Checkpoint::TrackerState& state);
 
     void setupBoundaryGeometry();
 
@@ -0,0 +1,221 @@
+#include "Utilities/MSLang/RasterizedMask.h"
+#include "Utilities/OpalException.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace mslang {
+    RasterizedMask::RasterizedMask(const QuadTree& tree, unsigned int nx, unsigned int ny):
+        tree_m(tree),
+        hostCells_m(nx * ny, DeviceRasterizedMask::OUTSIDE)
+    {
+        constexpr int numSubCells = DeviceRasterizedMask::numSubCells;
+
+        const BoundingBox2D& bb = tree_m.bb_m;
+        deviceMask_m.llc_m[0] = bb.center_m[0] - 0.5 * bb.width_m;
+        deviceMask_m.llc_m[1] = bb.center_m[1] - 0.5 * bb.height_m;
+        deviceMask_m.cellSize_m[0] = std::max(bb.width_m, std::numeric_limits<double>::min()) / nx;
+        deviceMask_m.cellSize_m[1] = std::max(bb.height_m, std::numeric_limits<double>::min()) / ny;
+        deviceMask_m.nr_m[0] = nx;
+        deviceMask_m.nr_m[1] = ny;
+
+        // every cell that intersects the bounding box of an object or of one of its holes and
+        // isn't completely inside of it can contain an edge of the shape. The objects are convex,
+        // hence a cell is completely inside if its four corners are.
+        std::vector<char> isBoundary(nx * ny, false);
+        std::vector<std::shared_ptr<Base>> objects;
+        collectObjects(tree_m, objects);
+        while (!objects.empty()) {
+            std::shared_ptr<Base> obj = objects.back();
+            objects.pop_back();
+            objects.insert(objects.end(), obj->divisor_m.begin(), obj->divisor_m.end());
+            markBoundaryCells(*obj, isBoundary);
+        }
+
+        // the other cells are either completely inside or outside, boundary cells are sampled
+        // with 8x8 sub-cells, the quad tree is read only and can be shared
+        std::vector<std::uint64_t> masks(nx * ny, 0);
+        const double subWidth = deviceMask_m.cellSize_m[0] / numSubCells;
+        const double subHeight = deviceMask_m.cellSize_m[1] / numSubCells;
+        Kokkos::parallel_for(
+            "rasterizeMask", Kokkos::RangePolicy<Kokkos::DefaultHostExecutionSpace>(0, nx * ny),
+            [&](const size_t cell) {
+                const unsigned int i = cell % nx;
+                const unsigned int j = cell / nx;
+                const double x0 = deviceMask_m.llc_m[0] + i * deviceMask_m.cellSize_m[0];
+                const double y0 = deviceMask_m.llc_m[1] + j * deviceMask_m.cellSize_m[1];
+
+                if (!isBoundary[cell]) {
+                    Vector_t<double, 3> R(x0 + 0.5 * deviceMask_m.cellSize_m[0],
+                                          y0 + 0.5 * deviceMask_m.cellSize_m[1],
+                                          0.0);
+                    masks[cell] = tree_m.isInside(R) ? ~std::uint64_t(0) : 0;
+                    return;
+                }
+
+                std::uint64_t mask = 0;
+                for (int sj = 0; sj < numSubCells; ++ sj) {
+                    for (int si = 0; si < numSubCells; ++ si) {
+                        Vector_t<double, 3> R(x0 + (si + 0.5) * subWidth,
+                                              y0 + (sj + 0.5) * subHeight,
+                                              0.0);
+                        if (tree_m.isInside(R)) {
+                            mask |= std::uint64_t(1) << (sj * numSubCells + si);
+                        }
+                    }
+                }
+                masks[cell] = mask;
+            });
+
+        // boundary cells stay boundary cells even if all of their samples agree, e.g. if a thin
+        // shape or a small hole lies between the samples
+        std::vector<std::uint64_t> subMasks;
+        for (size_t cell = 0; cell < masks.size(); ++ cell) {
+            if (isBoundary[cell]) {
+                hostCells_m[cell] = subMasks.size();
+                subMasks.push_back(masks[cell]);
+            } else if (masks[cell] == 0) {
+                hostCells_m[cell] = DeviceRasterizedMask::OUTSIDE;
+            } else {
+                hostCells_m[cell] = DeviceRasterizedMask::INSIDE;
+            }
+        }
+
+        deviceMask_m.cells_m = Kokkos::View<int**>("mslangMaskCells", nx, ny);
+        deviceMask_m.subMasks_m = Kokkos::View<std::uint64_t*>("mslangSubMasks", subMasks.size());
+
+        auto cells = Kokkos::create_mirror_view(deviceMask_m.cells_m);
+        for (unsigned int j = 0; j < ny; ++ j) {
+            for (unsigned int i = 0; i < nx; ++ i) {
+                cells(i, j) = hostCells_m[j * nx + i];
+            }
+        }
+        Kokkos::deep_copy(deviceMask_m.cells_m, cells);
+
+        auto hostSubMasks = Kokkos::create_mirror_view(deviceMask_m.subMasks_m);
+        std::copy(subMasks.begin(), subMasks.end(), hostSubMasks.data());
+        Kokkos::deep_copy(deviceMask_m.subMasks_m, hostSubMasks);
+    }
+
+    std::shared_ptr<RasterizedMask> RasterizedMask::compile(const std::string& expression,
+                                                            unsigned int nx,
+                                                            unsigned int ny) {
+        Function* fun = nullptr;
+        if (!parse(expression, fun)) {
+            throw OpalException("RasterizedMask::compile",
+                                "Couldn't parse the shape expression '" + expression + "'");
+        }
+
+        std::vector<std::shared_ptr<Base>> objects;
+        fun->apply(objects);
+        delete fun;
+
+        for (const std::shared_ptr<Base>& obj: objects) {
+            obj->computeBoundingBox();
+        }
+
+        if (objects.empty() || nx == 0 || ny == 0) {
+            throw OpalException("RasterizedMask::compile",
+                                "The shape expression '" + expression + "' is empty");
+        }
+
+        Vector_t<double, 3> llc(std::numeric_limits<double>::max());
+        Vector_t<double, 3> urc(std::numeric_limits<double>::lowest());
+        for (const std::shared_ptr<Base>& obj: objects) {
+            const BoundingBox2D& bb = obj->bb_m;
+            llc[0] = std::min(llc[0], bb.center_m[0] - 0.5 * bb.width_m);
+            llc[1] = std::min(llc[1], bb.center_m[1] - 0.5 * bb.height_m);
+            urc[0] = std::max(urc[0], bb.center_m[0] + 0.5 * bb.width_m);
+            urc[1] = std::max(urc[1], bb.center_m[1] + 0.5 * bb.height_m);
+        }
+        llc[2] = urc[2] = 0.0;
+
+        QuadTree tree;
+        tree.bb_m = BoundingBox2D(llc, urc);
+        tree.objects_m.insert(tree.objects_m.end(), objects.begin(), objects.end());
+        tree.buildUp();
+
+        return std::make_shared<RasterizedMask>(tree, nx, ny);
+    }
+
+    void RasterizedMask::collectObjects(const QuadTree& tree,
+                                        std::vector<std::shared_ptr<Base>>& objects) {
+        objects.insert(objects.end(), tree.objects_m.begin(), tree.objects_m.end());
+        for (const std::shared_ptr<QuadTree>& node: tree.nodes_m) {
+            collectObjects(*node, objects);
+        }
+    }
+
+    void RasterizedMask::markBoundaryCells(const Base& obj, std::vector<char>& isBoundary) const {
+        const BoundingBox2D& bb = obj.bb_m;
+        const int nx = deviceMask_m.nr_m[0];
+        const int ny = deviceMask_m.nr_m[1];
+
+        auto getIndex = [&](double x, int d, int n) {
+            const double u = std::floor((x - deviceMask_m.llc_m[d]) / deviceMask_m.cellSize_m[d]);
+            return int(std::clamp(u, 0.0, n - 1.0));
+        };
+        const int imin = getIndex(bb.center_m[0] - 0.5 * bb.width_m, 0, nx);
+        const int imax = getIndex(bb.center_m[0] + 0.5 * bb.width_m, 0, nx);
+        const int jmin = getIndex(bb.center_m[1] - 0.5 * bb.height_m, 1, ny);
+        const int jmax = getIndex(bb.center_m[1] + 0.5 * bb.height_m, 1, ny);
+
+        for (int j = jmin; j <= jmax; ++ j) {
+            for (int i = imin; i <= imax; ++ i) {
+                bool allCornersInside = true;
+                for (int corner = 0; corner < 4 && allCornersInside; ++ corner) {
+                    Vector_t<double, 3> R(
+                        deviceMask_m.llc_m[0] + (i + corner % 2) * deviceMask_m.cellSize_m[0],
+                        deviceMask_m.llc_m[1] + (j + corner / 2) * deviceMask_m.cellSize_m[1],
+                        0.0);
+                    allCornersInside = obj.isInside(R);
+                }
+
+                if (!allCornersInside) {
+                    isBoundary[j * nx + i] = true;
+                }
+            }
+        }
+    }
+
+    int RasterizedMask::getCell(const Vector_t<double, 3>& R) const {
+        const double u = (R[0] - deviceMask_m.llc_m[0]) / deviceMask_m.cellSize_m[0];
+        const double v = (R[1] - deviceMask_m.llc_m[1]) / deviceMask_m.cellSize_m[1];
+        if (!(u >= 0.0 && u < deviceMask_m.nr_m[0] && v >= 0.0 && v < deviceMask_m.nr_m[1])) {
+            return DeviceRasterizedMask::OUTSIDE;
+        }
+
+        return hostCells_m[int(v) * deviceMask_m.nr_m[0] + int(u)];
+    }
+
+    bool RasterizedMask::isInside(const Vector_t<double, 3>& R) const {
+        const int cell = getCell(R);
+        if (cell < 0) {
+            return cell == DeviceRasterizedMask::INSIDE;
+        }
+
+        return tree_m.isInside(R);
+    }
+
+    size_t RasterizedMask::flagOutside(const position_view_type& R,
+                                       Kokkos::View<bool*>& outside,
+                                       size_t n) const {
+        if (outside.extent(0) < n) {
+            Kokkos::realloc(Kokkos::WithoutInitializing, outside, n);
+        }
+
+        const DeviceRasterizedMask mask = deviceMask_m;
+        size_t numOutside = 0;
+        Kokkos::parallel_reduce(
+            "flagOutsideMask", n,
+            KOKKOS_LAMBDA(const size_t i, size_t& count) {
+                const bool isOutside = !mask.isInside(R(i)[0], R(i)[1]);
+                outside(i) = isOutside;
+                count += isOutside;
+            },
+            numOutside);
+
+        return numOutside;
+    }
+}
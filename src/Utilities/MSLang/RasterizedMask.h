@@ -0,0 +1,96 @@
+#ifndef MSLANG_RASTERIZEDMASK_H
+#define MSLANG_RASTERIZEDMASK_H
+
+#include "Utilities/MSLang.h"
+#include "Utilities/MSLang/QuadTree.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace mslang {
+    /*
+      Raster of a shape expression that can be evaluated in device kernels.
+      Every cell is either completely outside, completely inside or on the
+      boundary of the shape. A cell is a boundary cell if the bounding box or
+      an edge of any object or hole intersects it, no matter whether samples
+      inside of the cell see the edge. Boundary cells are resolved by a bitmask
+      of 8x8 sub-cells on the device and exactly by the quad tree on the host.
+      The shape is assumed to be inside the bounding box of the raster, points
+      outside of it are outside the shape.
+     */
+    struct DeviceRasterizedMask {
+        enum : int { OUTSIDE = -1, INSIDE = -2 };
+        static constexpr int numSubCells = 8;
+
+        Kokkos::View<int**> cells_m;                // OUTSIDE, INSIDE or index into subMasks_m
+        Kokkos::View<std::uint64_t*> subMasks_m;    // bit j * 8 + i for sub-cell (i, j)
+
+        double llc_m[2];
+        double cellSize_m[2];
+        int nr_m[2];
+
+        KOKKOS_INLINE_FUNCTION bool isInside(const double x, const double y) const {
+            const double u = (x - llc_m[0]) / cellSize_m[0];
+            const double v = (y - llc_m[1]) / cellSize_m[1];
+            if (!(u >= 0.0 && u < nr_m[0] && v >= 0.0 && v < nr_m[1])) {
+                return false;
+            }
+
+            const int i    = u;
+            const int j    = v;
+            const int cell = cells_m(i, j);
+            if (cell < 0) {
+                return cell == INSIDE;
+            }
+
+            const int si = Kokkos::min(int((u - i) * numSubCells), numSubCells - 1);
+            const int sj = Kokkos::min(int((v - j) * numSubCells), numSubCells - 1);
+            return (subMasks_m(cell) >> (sj * numSubCells + si)) & 1u;
+        }
+    };
+
+    struct RasterizedMask {
+        typedef ippl::ParticleAttrib<Vector_t<double, 3>>::view_type position_view_type;
+
+        /// rasterizes the objects of the tree in its bounding box with nx times ny cells
+        RasterizedMask(const QuadTree& tree, unsigned int nx, unsigned int ny);
+
+        /// parses and rasterizes a shape expression, throws if the expression is invalid
+        static std::shared_ptr<RasterizedMask> compile(
+            const std::string& expression, unsigned int nx, unsigned int ny);
+
+        /// exact test, the quad tree is only traversed in boundary cells
+        bool isInside(const Vector_t<double, 3>& R) const;
+
+        /// flags the first n positions that are outside of the shape, returns their number
+        size_t flagOutside(
+            const position_view_type& R, Kokkos::View<bool*>& outside, size_t n) const;
+
+        const DeviceRasterizedMask& getDeviceMask() const;
+        size_t getNumBoundaryCells() const;
+
+    private:
+        static void collectObjects(
+            const QuadTree& tree, std::vector<std::shared_ptr<Base>>& objects);
+
+        /// flags the cells that intersect the bounding box of obj and aren't completely inside obj
+        void markBoundaryCells(const Base& obj, std::vector<char>& isBoundary) const;
+
+        int getCell(const Vector_t<double, 3>& R) const;
+
+        QuadTree tree_m;
+        std::vector<int> hostCells_m;
+        DeviceRasterizedMask deviceMask_m;
+    };
+
+    inline const DeviceRasterizedMask& RasterizedMask::getDeviceMask() const {
+        return deviceMask_m;
+    }
+
+    inline size_t RasterizedMask::getNumBoundaryCells() const {
+        return deviceMask_m.subMasks_m.extent(0);
+    }
+}
+
+#endif
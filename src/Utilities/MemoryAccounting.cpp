@@ -0,0 +1,217 @@
+//
+// Class MemoryAccounting
+//   Keeps track of the memory per subsystem (particle attributes, fields,
+//   field solver, field maps, binning and I/O staging buffers) in host and
+//   device memory on this rank, together with the high-water mark of every
+//   subsystem.
+//
+// This file is part of OPAL.
+//
+// OPAL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// You should have received a copy of the GNU General Public License
+// along with OPAL. If not, see <https://www.gnu.org/licenses/>.
+//
+#include "Utilities/MemoryAccounting.h"
+
+#include "Utilities/Options.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace {
+    const double bytesPerMB = 1024.0 * 1024.0;
+
+    // the fractions of the budget at which a warning is printed
+    const double budgetFractions[] = {0.9, 1.0};
+
+    const char* subsystemNames[] = {"Particles", "Fields", "Solver", "Fieldmaps", "Binning", "IO"};
+    const char* spaceNames[]     = {"Host", "Device"};
+}  // namespace
+
+MemoryAccounting& MemoryAccounting::getInstance() {
+    static MemoryAccounting instance;
+    return instance;
+}
+
+MemoryAccounting::MemoryAccounting() {
+    warnedFraction_m.fill(0.0);
+}
+
+void MemoryAccounting::setBytes(
+    Subsystem subsystem, const std::string& name, size_t bytes, Space space) {
+    auto& allocations = allocations_m[subsystem];
+
+    auto it = allocations.find(name);
+    if (it != allocations.end() && it->second.second != space) {
+        const Space previous = it->second.second;
+        allocations.erase(it);
+        update(subsystem, previous);
+    }
+
+    allocations[name] = std::make_pair(bytes, space);
+    update(subsystem, space);
+}
+
+void MemoryAccounting::release(Subsystem subsystem, const std::string& name) {
+    auto& allocations = allocations_m[subsystem];
+
+    auto it = allocations.find(name);
+    if (it == allocations.end()) {
+        return;
+    }
+
+    const Space space = it->second.second;
+    allocations.erase(it);
+    update(subsystem, space);
+}
+
+void MemoryAccounting::recordTransient(Subsystem subsystem, size_t bytes, Space space) {
+    Usage& usage = usage_m[subsystem][space];
+    usage.peak   = std::max(usage.peak, usage.current + bytes);
+
+    Usage& total = total_m[space];
+    total.peak   = std::max(total.peak, total.current + bytes);
+}
+
+void MemoryAccounting::update(Subsystem subsystem, Space space) {
+    size_t current = 0;
+    for (const auto& allocation : allocations_m[subsystem]) {
+        if (allocation.second.second == space) {
+            current += allocation.second.first;
+        }
+    }
+
+    Usage& usage  = usage_m[subsystem][space];
+    Usage& total  = total_m[space];
+    total.current = total.current - usage.current + current;
+    total.peak    = std::max(total.peak, total.current);
+    usage.current = current;
+    usage.peak    = std::max(usage.peak, current);
+}
+
+size_t MemoryAccounting::getCurrentBytes(Subsystem subsystem, Space space) const {
+    return usage_m[subsystem][space].current;
+}
+
+size_t MemoryAccounting::getPeakBytes(Subsystem subsystem, Space space) const {
+    return usage_m[subsystem][space].peak;
+}
+
+size_t MemoryAccounting::getTotalCurrentBytes(Space space) const {
+    return total_m[space].current;
+}
+
+size_t MemoryAccounting::getTotalPeakBytes(Space space) const {
+    return total_m[space].peak;
+}
+
+void MemoryAccounting::checkBudget(unsigned long long step) {
+    if (Options::memoryBudget <= 0.0) {
+        return;
+    }
+
+    const double budget = Options::memoryBudget * bytesPerMB;
+    for (unsigned int space = 0; space < NUMSPACES; ++space) {
+        const double fraction = total_m[space].current / budget;
+
+        for (double threshold : budgetFractions) {
+            if (fraction < threshold || warnedFraction_m[space] >= threshold) {
+                continue;
+            }
+            warnedFraction_m[space] = threshold;
+
+            Inform msg("MemoryAccounting ", INFORM_ALL_NODES);
+            msg << "* Warning: rank " << ippl::Comm->rank() << " uses "
+                << std::fixed << std::setprecision(1) << total_m[space].current / bytesPerMB
+                << " MB of " << Options::memoryBudget << " MB "
+                << getName(Space(space)) << " memory at step " << step
+                << (fraction < 1.0 ? ", the budget is approached" : ", the budget is exceeded")
+                << endl;
+
+            for (unsigned int subsystem = 0; subsystem < SIZE; ++subsystem) {
+                msg << "*   " << std::left << std::setw(12)
+                    << getName(Subsystem(subsystem)) << std::right << std::setw(12)
+                    << usage_m[subsystem][space].current / bytesPerMB << " MB" << endl;
+            }
+        }
+    }
+}
+
+std::vector<size_t> MemoryAccounting::getMaxima() const {
+    std::vector<size_t> maxima;
+    maxima.reserve((SIZE + 1) * NUMSPACES * 2);
+    for (unsigned int subsystem = 0; subsystem < SIZE; ++subsystem) {
+        for (unsigned int space = 0; space < NUMSPACES; ++space) {
+            maxima.push_back(usage_m[subsystem][space].current);
+            maxima.push_back(usage_m[subsystem][space].peak);
+        }
+    }
+    for (unsigned int space = 0; space < NUMSPACES; ++space) {
+        maxima.push_back(total_m[space].current);
+        maxima.push_back(total_m[space].peak);
+    }
+
+    ippl::Comm->allreduce(maxima.data(), maxima.size(), std::greater<size_t>());
+
+    return maxima;
+}
+
+void MemoryAccounting::printSummary(Inform& os) const {
+    const std::vector<size_t> maxima = getMaxima();
+    const unsigned int numSpaces     = hasDeviceSpace() ? NUMSPACES : 1;
+
+    // formatted separately to leave the state of os untouched
+    std::ostringstream table;
+    table << "* " << std::left << std::setw(12) << "Subsystem" << std::right;
+    for (unsigned int space = 0; space < numSpaces; ++space) {
+        table << std::setw(14) << getName(Space(space)) << std::setw(14)
+              << getName(Space(space)) + "-Peak";
+    }
+    table << "\n";
+
+    table << std::fixed << std::setprecision(1);
+    for (unsigned int subsystem = 0; subsystem <= SIZE; ++subsystem) {
+        const std::string name = subsystem < SIZE ? getName(Subsystem(subsystem)) : "Total";
+
+        table << "* " << std::left << std::setw(12) << name << std::right;
+        for (unsigned int space = 0; space < numSpaces; ++space) {
+            const size_t offset = 2 * (subsystem * NUMSPACES + space);
+            table << std::setw(14) << maxima[offset] / bytesPerMB << std::setw(14)
+                  << maxima[offset + 1] / bytesPerMB;
+        }
+        table << (subsystem < SIZE ? "\n" : "");
+    }
+
+    os << "* Memory per rank, maximum over the ranks [MB]\n" << table.str() << endl;
+}
+
+std::string MemoryAccounting::getName(Subsystem subsystem) {
+    return subsystemNames[subsystem];
+}
+
+std::string MemoryAccounting::getName(Space space) {
+    return spaceNames[space];
+}
+
+size_t MemoryAccounting::getResidentSetSize() {
+#ifdef __linux__
+    std::ifstream in("/proc/self/status");
+
+    // the unit is KiB although it says kB, see MemoryProfiler
+    std::string token;
+    while (in >> token) {
+        if (token == "VmRSS:") {
+            size_t kiB = 0;
+            in >> kiB;
+            return kiB * 1024;
+        }
+    }
+#endif
+    return 0;
+}
@@ -0,0 +1,118 @@
+//
+// Class MemoryAccounting
+//   Keeps track of the memory per subsystem (particle attributes, fields,
+//   field solver, field maps, binning and I/O staging buffers) in host and
+//   device memory on this rank, together with the high-water mark of every
+//   subsystem.
+//
+//   The subsystems register their allocations by name; registering the same
+//   name again replaces the previous size. Buffers that only live during a
+//   call are recorded as transient, they raise the high-water mark but not
+//   the current value. Once per step the accounted memory is compared with
+//   the budget per rank (option MEMORYBUDGET) and a warning is printed when
+//   it is approached or exceeded. The maxima over the ranks are written to
+//   *.mem (option MEMORYDUMP) and printed at the end of the tracking.
+//
+// This file is part of OPAL.
+//
+// OPAL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// You should have received a copy of the GNU General Public License
+// along with OPAL. If not, see <https://www.gnu.org/licenses/>.
+//
+#ifndef OPAL_MEMORY_ACCOUNTING_H
+#define OPAL_MEMORY_ACCOUNTING_H
+
+#include "Ippl.h"
+
+#include <array>
+#include <map>
+#include <string>
+#include <vector>
+
+class MemoryAccounting {
+public:
+    enum Subsystem : unsigned int { PARTICLES, FIELDS, SOLVER, FIELDMAPS, BINNING, IO, SIZE };
+
+    enum Space : unsigned int { HOST, DEVICE, NUMSPACES };
+
+    static MemoryAccounting& getInstance();
+
+    /// sets the size of an allocation, replaces the size registered before under the same name
+    void setBytes(Subsystem subsystem, const std::string& name, size_t bytes, Space space);
+
+    /// sets the size of an allocation from the extent and the memory space of a view
+    template <class View>
+    void setView(Subsystem subsystem, const std::string& name, const View& view);
+
+    void release(Subsystem subsystem, const std::string& name);
+
+    /// accounts a buffer that is freed again before the call returns
+    void recordTransient(Subsystem subsystem, size_t bytes, Space space);
+
+    size_t getCurrentBytes(Subsystem subsystem, Space space) const;
+    size_t getPeakBytes(Subsystem subsystem, Space space) const;
+
+    size_t getTotalCurrentBytes(Space space) const;
+    size_t getTotalPeakBytes(Space space) const;
+
+    /// compares the accounted memory of this rank with the budget
+    void checkBudget(unsigned long long step);
+
+    /**
+     * The maxima over the ranks of the current and peak bytes. The entries are ordered
+     * subsystem by subsystem, with the totals last, as {current, peak} for every space.
+     * Has to be called by all ranks.
+     */
+    std::vector<size_t> getMaxima() const;
+
+    /// prints the maxima over the ranks, has to be called by all ranks
+    void printSummary(Inform& os) const;
+
+    static std::string getName(Subsystem subsystem);
+    static std::string getName(Space space);
+
+    /// whether the default memory space of Kokkos is different from the host memory
+    static constexpr bool hasDeviceSpace() {
+        return !Kokkos::SpaceAccessibility<
+            Kokkos::HostSpace, Kokkos::DefaultExecutionSpace::memory_space>::accessible;
+    }
+
+    /// the resident set size of this process in bytes, 0 if it isn't available
+    static size_t getResidentSetSize();
+
+private:
+    struct Usage {
+        size_t current = 0;
+        size_t peak    = 0;
+    };
+
+    MemoryAccounting();
+
+    MemoryAccounting(const MemoryAccounting&);
+    void operator=(const MemoryAccounting&);
+
+    void update(Subsystem subsystem, Space space);
+
+    std::array<std::map<std::string, std::pair<size_t, Space>>, SIZE> allocations_m;
+
+    std::array<std::array<Usage, NUMSPACES>, SIZE> usage_m;
+    std::array<Usage, NUMSPACES> total_m;
+
+    // the fraction of the budget at which the last warning was printed, per space
+    std::array<double, NUMSPACES> warnedFraction_m;
+};
+
+template <class View>
+void MemoryAccounting::setView(Subsystem subsystem, const std::string& name, const View& view) {
+    constexpr bool isHost = Kokkos::SpaceAccessibility<
+        Kokkos::HostSpace, typename View::memory_space>::accessible;
+
+    setBytes(
+        subsystem, name, view.span() * sizeof(typename View::value_type), isHost ? HOST : DEVICE);
+}
+
+#endif  // OPAL_MEMORY_ACCOUNTING_H
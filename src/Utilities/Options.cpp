@@ -108,4 +108,35 @@ namespace Options {
     double binningAlpha = 1.0;
     double binningBeta = 1.5;
     double desiredWidth = 0.1;
+
+    int cellSortFreq = 0;
+    std::string cellSortCurve = std::string("MORTON");
+
+    std::string deposition = std::string("ATOMIC");
+
+    int checkpointFreq = 0;
+
+    int sddsFlushFreq = 1;
+    std::string statFormat = std::string("ASCII");
+
+    int numSlices = 0;
+    std::string sliceFilter = std::string("");
+
+    std::string lossFormat = std::string("HDF5");
+    double lossBufferSize  = 0.0;
+
+    std::string autoPhaseCache  = std::string("");
+    std::string designPathCache = std::string("");
+
+    int ensembleSize = 1;
+
+    std::string geometryCache = std::string("");
+
+    int perfTraceInterval = 0;
+
+    bool perfTraceKernels = true;
+
+    double memoryBudget = 0.0;
+
+    bool compactParticles = false;
 }  // namespace Options
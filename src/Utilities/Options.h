@@ -145,7 +145,7 @@ namespace Options {
 
     extern bool memoryDump;
 
-    /// The constant parameter C to shift halo, by < w^4 > / < w^2 > ^2 - C (w=x,y,z)
+    /// The constant parameter C to shift halo, by < w^4 > / < w^2 > ^2 - C (w = x - <x>, ...)
     extern double haloShift;
 
     /// The frequency to delete particles (currently: OPAL-cycl only)
@@ -158,6 +158,60 @@ namespace Options {
     extern double binningAlpha;
     extern double binningBeta;
     extern double desiredWidth;
+
+    /// The frequency to reorder the particle container by grid cell, 0 disables the reordering
+    extern int cellSortFreq;
+
+    /// The space filling curve used to order the cells (MORTON or HILBERT)
+    extern std::string cellSortCurve;
+
+    /// The charge deposition scheme: ATOMIC (any platform) or TILED (host execution spaces only)
+    extern std::string deposition;
+
+    /// The frequency (in steps) to write a restart checkpoint, 0 disables checkpointing
+    extern int checkpointFreq;
+
+    /// The number of rows the SDDS writers buffer in memory before writing them to disk
+    extern int sddsFlushFreq;
+
+    /// The data mode of the statistics file (ASCII or BINARY)
+    extern std::string statFormat;
+
+    /// The number of longitudinal slices of the in-situ slice analysis, 0 disables it
+    extern int numSlices;
+
+    /// The FILTER applied to the slice current profile, empty for no smoothing
+    extern std::string sliceFilter;
+
+    /// The format of the files of monitors and other loss data sinks (HDF5 or BINARY)
+    extern std::string lossFormat;
+
+    /// The memory (in MB per rank) loss data sinks may use to buffer data before writing
+    extern double lossBufferSize;
+
+    /// The file in which the phases found by the autophasing are cached, empty to disable caching
+    extern std::string autoPhaseCache;
+
+    /// The file in which the result of the orbit threading is cached, empty to disable caching
+    extern std::string designPathCache;
+
+    /// The number of independent replicas of the distribution that are tracked together
+    extern int ensembleSize;
+
+    /// The directory in which the oriented and voxelized boundary geometries are cached, empty to disable caching
+    extern std::string geometryCache;
+
+    /// Every how many steps the region and kernel times are written to the performance trace, 0 disables tracing
+    extern int perfTraceInterval;
+
+    /// Whether the performance trace records the Kokkos kernels
+    extern bool perfTraceKernels;
+
+    /// The memory (in MB per rank) the accounted allocations may use before a warning is printed, 0 disables the check
+    extern double memoryBudget;
+
+    /// Whether the charge, mass and time step are kept per species and per bunch instead of per particle
+    extern bool compactParticles;
 }  // namespace Options
 
 #endif  // OPAL_Options_HH
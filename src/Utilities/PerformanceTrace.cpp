@@ -0,0 +1,274 @@
+//
+// Class PerformanceTrace
+//   Records the wall times of the regions of a tracking step and of the
+//   Kokkos kernels launched in them, per step and per rank.
+//
+// This file is part of OPAL.
+//
+// OPAL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// You should have received a copy of the GNU General Public License
+// along with OPAL. If not, see <https://www.gnu.org/licenses/>.
+//
+#include "Utilities/PerformanceTrace.h"
+
+#include "Ippl.h"
+
+#include "AbstractObjects/OpalData.h"
+#include "Utilities/Options.h"
+#include "Utilities/Util.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+namespace {
+    // number of events that are buffered before they are appended to the file
+    const size_t maxBufferedEvents = 1 << 16;
+
+    const char* categoryNames[] = {"step", "region", "kernel"};
+}  // namespace
+
+PerformanceTrace::Region::Region(const char* name)
+    : isActive_m(PerformanceTrace::getInstance().isActive()) {
+    if (isActive_m) {
+        PerformanceTrace::getInstance().begin(name);
+    }
+}
+
+PerformanceTrace::Region::~Region() {
+    if (isActive_m) {
+        PerformanceTrace::getInstance().end(REGION);
+    }
+}
+
+PerformanceTrace& PerformanceTrace::getInstance() {
+    static PerformanceTrace instance;
+    return instance;
+}
+
+PerformanceTrace::PerformanceTrace()
+    : isInitialized_m(false),
+      isActive_m(false),
+      step_m(0),
+      previousCallbacks_m(),
+      start_m(std::chrono::steady_clock::now()),
+      isFirstEvent_m(true),
+      nextKernelId_m(0) {
+}
+
+void PerformanceTrace::initialize(const std::string& baseName) {
+    if (isInitialized_m || Options::perfTraceInterval <= 0) {
+        return;
+    }
+
+    const int rank = ippl::Comm->rank();
+    baseName_m     = baseName;
+    const std::string fileName = Util::combineFilePath(
+        {OpalData::getInstance()->getAuxiliaryOutputDirectory(),
+         baseName_m + ".trace." + std::to_string(rank) + ".json"});
+
+    out_m.open(fileName);
+    out_m << std::fixed << std::setprecision(3);
+    out_m << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+    out_m << "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": " << rank
+          << ", \"args\": {\"name\": \"rank " << rank << "\"}}";
+    isFirstEvent_m = false;
+
+    start_m         = std::chrono::steady_clock::now();
+    isInitialized_m = true;
+
+    if (Options::perfTraceKernels) {
+        previousCallbacks_m = Kokkos::Tools::Experimental::get_callbacks();
+        Kokkos::Tools::Experimental::set_begin_parallel_for_callback(beginKernel);
+        Kokkos::Tools::Experimental::set_end_parallel_for_callback(endKernel);
+        Kokkos::Tools::Experimental::set_begin_parallel_reduce_callback(beginKernel);
+        Kokkos::Tools::Experimental::set_end_parallel_reduce_callback(endKernel);
+        Kokkos::Tools::Experimental::set_begin_parallel_scan_callback(beginKernel);
+        Kokkos::Tools::Experimental::set_end_parallel_scan_callback(endKernel);
+    }
+}
+
+void PerformanceTrace::finalize() {
+    if (!isInitialized_m) {
+        return;
+    }
+
+    if (Options::perfTraceKernels) {
+        Kokkos::Tools::Experimental::set_callbacks(previousCallbacks_m);
+    }
+
+    isActive_m = false;
+    openEvents_m.clear();
+    openKernels_m.clear();
+
+    flushEvents();
+    out_m << "\n]}\n";
+    out_m.close();
+
+    writeSummary();
+
+    isInitialized_m = false;
+}
+
+void PerformanceTrace::beginStep(unsigned long long step) {
+    isActive_m = isInitialized_m && step % Options::perfTraceInterval == 0;
+    if (!isActive_m) {
+        return;
+    }
+
+    step_m = step;
+    begin("step");
+}
+
+void PerformanceTrace::endStep() {
+    if (!isActive_m) {
+        return;
+    }
+
+    end(STEP);
+    isActive_m = false;
+
+    if (events_m.size() >= maxBufferedEvents) {
+        flushEvents();
+    }
+}
+
+double PerformanceTrace::now() const {
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start_m)
+        .count();
+}
+
+unsigned int PerformanceTrace::getNameId(const std::string& name) {
+    auto it = nameIds_m.find(name);
+    if (it != nameIds_m.end()) {
+        return it->second;
+    }
+
+    const unsigned int id = names_m.size();
+    names_m.push_back(name);
+    totals_m.push_back(0.0);
+    nameIds_m.emplace(name, id);
+
+    return id;
+}
+
+void PerformanceTrace::begin(const std::string& name) {
+    openEvents_m.push_back({getNameId(name), now()});
+}
+
+void PerformanceTrace::end(Category category) {
+    if (openEvents_m.empty()) {
+        return;
+    }
+
+    const OpenEvent open = openEvents_m.back();
+    openEvents_m.pop_back();
+
+    const double duration = now() - open.begin;
+    events_m.push_back({open.name, category, open.begin, duration, step_m});
+    totals_m[open.name] += duration;
+}
+
+void PerformanceTrace::beginKernel(const char* name, const uint32_t, uint64_t* kernelId) {
+    PerformanceTrace& trace = getInstance();
+
+    *kernelId = trace.nextKernelId_m++;
+    if (trace.isActive_m) {
+        trace.openKernels_m[*kernelId] = {trace.getNameId(name), trace.now()};
+    }
+}
+
+void PerformanceTrace::endKernel(const uint64_t kernelId) {
+    PerformanceTrace& trace = getInstance();
+
+    auto it = trace.openKernels_m.find(kernelId);
+    if (it == trace.openKernels_m.end()) {
+        return;
+    }
+
+    const double duration = trace.now() - it->second.begin;
+    trace.events_m.push_back(
+        {it->second.name, KERNEL, it->second.begin, duration, trace.step_m});
+    trace.totals_m[it->second.name] += duration;
+    trace.openKernels_m.erase(it);
+}
+
+void PerformanceTrace::flushEvents() {
+    const int rank = ippl::Comm->rank();
+
+    for (const Event& event : events_m) {
+        if (!isFirstEvent_m) {
+            out_m << ",\n";
+        }
+        isFirstEvent_m = false;
+
+        out_m << "{\"name\": \"" << names_m[event.name] << "\", \"cat\": \""
+              << categoryNames[event.category] << "\", \"ph\": \"X\", \"ts\": " << event.begin
+              << ", \"dur\": " << event.duration << ", \"pid\": " << rank
+              << ", \"tid\": " << (event.category == KERNEL ? 1 : 0)
+              << ", \"args\": {\"step\": " << event.step << "}}";
+    }
+    out_m << std::flush;
+
+    events_m.clear();
+}
+
+void PerformanceTrace::writeSummary() {
+    // the regions of rank 0 are summarized, names that only occur on other ranks are dropped
+    std::ostringstream joined;
+    for (const std::string& name : names_m) {
+        joined << name << "\n";
+    }
+    std::string names = joined.str();
+
+    MPI_Comm comm = ippl::Comm->getCommunicator();
+    int length    = names.size();
+    MPI_Bcast(&length, 1, MPI_INT, 0, comm);
+    names.resize(length);
+    if (length > 0) {
+        MPI_Bcast(&names[0], length, MPI_CHAR, 0, comm);
+    }
+
+    std::vector<std::string> summaryNames;
+    std::istringstream in(names);
+    for (std::string name; std::getline(in, name);) {
+        summaryNames.push_back(name);
+    }
+
+    const size_t numNames = summaryNames.size();
+    std::vector<double> minTimes(numNames), maxTimes(numNames), sumTimes(numNames);
+    for (size_t i = 0; i < numNames; ++i) {
+        auto it           = nameIds_m.find(summaryNames[i]);
+        const double time = it == nameIds_m.end() ? 0.0 : totals_m[it->second];
+        minTimes[i] = maxTimes[i] = sumTimes[i] = time;
+    }
+
+    ippl::Comm->allreduce(minTimes.data(), numNames, std::less<double>());
+    ippl::Comm->allreduce(maxTimes.data(), numNames, std::greater<double>());
+    ippl::Comm->allreduce(sumTimes.data(), numNames, std::plus<double>());
+
+    if (ippl::Comm->rank() != 0) {
+        return;
+    }
+
+    const double numRanks = ippl::Comm->size();
+    std::ofstream out(Util::combineFilePath(
+        {OpalData::getInstance()->getAuxiliaryOutputDirectory(), baseName_m + ".trace_summary"}));
+    out << "# times of the recorded steps in s over " << ippl::Comm->size() << " ranks, every "
+        << Options::perfTraceInterval << ". step\n";
+    out << "# " << std::left << std::setw(38) << "name" << std::right << std::setw(16) << "min"
+        << std::setw(16) << "mean" << std::setw(16) << "max" << std::setw(12) << "imbalance\n";
+    out << std::scientific << std::setprecision(6);
+    for (size_t i = 0; i < numNames; ++i) {
+        const double mean      = sumTimes[i] / numRanks;
+        const double imbalance = mean > 0.0 ? maxTimes[i] / mean : 1.0;
+        out << "  " << std::left << std::setw(38) << summaryNames[i] << std::right
+            << std::setw(16) << minTimes[i] * 1e-6 << std::setw(16) << mean * 1e-6
+            << std::setw(16) << maxTimes[i] * 1e-6 << std::fixed << std::setprecision(3)
+            << std::setw(11) << imbalance << std::scientific << std::setprecision(6) << "\n";
+    }
+}
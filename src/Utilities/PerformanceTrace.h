@@ -0,0 +1,133 @@
+//
+// Class PerformanceTrace
+//   Records the wall times of the regions of a tracking step and of the
+//   Kokkos kernels launched in them, per step and per rank. Only every n-th
+//   step (option PERFTRACE) is recorded to bound the overhead.
+//
+//   Every rank writes its events to <basename>.trace.<rank>.json in the
+//   auxiliary output directory in the Chrome trace event format, which can be
+//   opened with chrome://tracing or Perfetto. The events are buffered and
+//   appended to the file whenever the buffer is full. At the end rank 0
+//   writes <basename>.trace_summary to the same directory with the minimal,
+//   mean and maximal time per region over the ranks and the load imbalance
+//   max / mean.
+//
+//   The kernels are recorded through the Kokkos Tools callbacks, i.e. a Kokkos
+//   tool loaded via KOKKOS_TOOLS_LIBS is replaced while tracing and its
+//   callbacks are restored at the end. The times of
+//   the kernels are the times of their dispatch, on devices that run
+//   asynchronously they don't include the execution.
+//
+// This file is part of OPAL.
+//
+// OPAL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// You should have received a copy of the GNU General Public License
+// along with OPAL. If not, see <https://www.gnu.org/licenses/>.
+//
+#ifndef OPAL_PERFORMANCE_TRACE_H
+#define OPAL_PERFORMANCE_TRACE_H
+
+#include <Kokkos_Core.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class PerformanceTrace {
+public:
+    /// marks a region of the current step, does nothing if the step isn't recorded
+    class Region {
+    public:
+        explicit Region(const char* name);
+        ~Region();
+
+    private:
+        Region(const Region&);
+        void operator=(const Region&);
+
+        bool isActive_m;
+    };
+
+    static PerformanceTrace& getInstance();
+
+    /// opens the trace file of this rank if PERFTRACE > 0
+    void initialize(const std::string& baseName);
+
+    /// writes the remaining events and the summary next to the traces, has to be called by all
+    /// ranks
+    void finalize();
+
+    void beginStep(unsigned long long step);
+    void endStep();
+
+    bool isActive() const;
+
+private:
+    enum Category : unsigned int { STEP, REGION, KERNEL };
+
+    struct Event {
+        unsigned int name;
+        Category category;
+        double begin;     // [us] since the initialization
+        double duration;  // [us]
+        unsigned long long step;
+    };
+
+    struct OpenEvent {
+        unsigned int name;
+        double begin;
+    };
+
+    PerformanceTrace();
+
+    PerformanceTrace(const PerformanceTrace&);
+    void operator=(const PerformanceTrace&);
+
+    double now() const;
+    unsigned int getNameId(const std::string& name);
+
+    void begin(const std::string& name);
+    void end(Category category);
+
+    void flushEvents();
+    void writeSummary();
+
+    static void beginKernel(const char* name, const uint32_t deviceId, uint64_t* kernelId);
+    static void endKernel(const uint64_t kernelId);
+
+    bool isInitialized_m;
+    bool isActive_m;
+    unsigned long long step_m;
+    std::string baseName_m;
+
+    // the callbacks of other Kokkos tools, restored by finalize
+    Kokkos::Tools::Experimental::EventSet previousCallbacks_m;
+
+    std::chrono::steady_clock::time_point start_m;
+    std::ofstream out_m;
+    bool isFirstEvent_m;
+
+    std::vector<std::string> names_m;
+    std::unordered_map<std::string, unsigned int> nameIds_m;
+
+    std::vector<Event> events_m;
+    std::vector<OpenEvent> openEvents_m;  // step and regions
+    std::unordered_map<uint64_t, OpenEvent> openKernels_m;
+    uint64_t nextKernelId_m;
+
+    // accumulated over all recorded steps, per name
+    std::vector<double> totals_m;
+};
+
+inline bool PerformanceTrace::isActive() const {
+    return isActive_m;
+}
+
+#endif  // OPAL_PERFORMANCE_TRACE_H
@@ -19,12 +19,83 @@
 
 #include <boost/algorithm/string.hpp>
 
+#include <cstdint>
+#include <cstring>
+
+namespace {
+    template <typename T>
+    bool readBinary(const char*& pos, const char* end, T& value) {
+        if (end - pos < static_cast<std::ptrdiff_t>(sizeof(T)))
+            return false;
+        std::memcpy(&value, pos, sizeof(T));
+        pos += sizeof(T);
+        return true;
+    }
+
+    // binary SDDS stores 'short' as 16 bit, 'long' as 32 bit and 'long64' as 64 bit integers,
+    // the byte order of the file has to match the machine
+    bool readBinaryValue(const char*& pos, const char* end,
+                         SDDS::ast::datatype type, SDDS::ast::variant_t& value) {
+        switch(type) {
+        case SDDS::ast::FLOAT: {
+            float f;
+            if (!readBinary(pos, end, f)) return false;
+            value = f;
+            return true;
+        }
+        case SDDS::ast::DOUBLE: {
+            double d;
+            if (!readBinary(pos, end, d)) return false;
+            value = d;
+            return true;
+        }
+        case SDDS::ast::SHORT: {
+            std::int16_t s;
+            if (!readBinary(pos, end, s)) return false;
+            value = static_cast<short>(s);
+            return true;
+        }
+        case SDDS::ast::LONG: {
+            std::int32_t l;
+            if (!readBinary(pos, end, l)) return false;
+            value = static_cast<long>(l);
+            return true;
+        }
+        case SDDS::ast::LONG64: {
+            std::int64_t l;
+            if (!readBinary(pos, end, l)) return false;
+            value = static_cast<long>(l);
+            return true;
+        }
+        case SDDS::ast::CHARACTER: {
+            char c;
+            if (!readBinary(pos, end, c)) return false;
+            value = c;
+            return true;
+        }
+        case SDDS::ast::STRING: {
+            std::int32_t length;
+            if (!readBinary(pos, end, length) || length < 0 || end - pos < length)
+                return false;
+            value = std::string(pos, length);
+            pos += length;
+            return true;
+        }
+        }
+        return false;
+    }
+}
+
 SDDS::SDDSParser::SDDSParser():
-    sddsFileName_m("")
+    sddsFileName_m(""),
+    rowCountOffset_m(-1),
+    firstRowOffset_m(-1)
 { }
 
 SDDS::SDDSParser::SDDSParser(const std::string &input):
-    sddsFileName_m(input)
+    sddsFileName_m(input),
+    rowCountOffset_m(-1),
+    firstRowOffset_m(-1)
 { }
 
 void SDDS::SDDSParser::setInput(const std::string &input) {
@@ -40,6 +111,8 @@ SDDS::file SDDS::SDDSParser::run() {
     sddsData_m.clear();
     paramNameToID_m.clear();
     columnNameToID_m.clear();
+    rowCountOffset_m = -1;
+    firstRowOffset_m = -1;
 
     skipper_t skipper;
     std::string contents = readFile();
@@ -49,7 +122,11 @@ SDDS::file SDDS::SDDSParser::run() {
     file_parser_t parser(error_handler);
 
     bool success = phrase_parse(contentsIter, contentsEnd, parser, skipper, sddsData_m);
-    {
+    if (success && isBinary()) {
+        // the skipper must not run over binary data
+        success = parseBinaryData(contents);
+        contentsIter = contentsEnd;
+    } else {
         SDDS::parameterList::iterator piter = sddsData_m.sddsParameters_m.begin();
         SDDS::parameterList::iterator pend = sddsData_m.sddsParameters_m.end();
         for (; piter != pend && success; ++ piter) {
@@ -91,8 +168,50 @@ SDDS::file SDDS::SDDSParser::run() {
     return sddsData_m;
 }
 
+bool SDDS::SDDSParser::parseBinaryData(const std::string &contents) {
+    // the binary data start after the line containing the '&end' of the '&data' namelist
+    size_t pos = contents.find("&data");
+    if (pos != std::string::npos) pos = contents.find("&end", pos);
+    if (pos != std::string::npos) pos = contents.find('\n', pos);
+    if (pos == std::string::npos) return false;
+    ++ pos;
+
+    const char* begin = contents.data();
+    const char* end = begin + contents.size();
+    const char* iter = begin + pos;
+
+    rowCountOffset_m = pos;
+
+    std::int32_t numRows;
+    if (!readBinary(iter, end, numRows) || numRows < 0)
+        return false;
+
+    for (SDDS::parameter &param: sddsData_m.sddsParameters_m) {
+        if (!readBinaryValue(iter, end, *param.type_m, param.value_m))
+            return false;
+    }
+
+    firstRowOffset_m = iter - begin;
+
+    for (SDDS::column &col: sddsData_m.sddsColumns_m) {
+        col.values_m.reserve(numRows);
+    }
+
+    // data beyond the last counted row are ignored, e.g. of an interrupted flush
+    for (std::int32_t row = 0; row < numRows; ++ row) {
+        for (SDDS::column &col: sddsData_m.sddsColumns_m) {
+            ast::variant_t value;
+            if (!readBinaryValue(iter, end, *col.type_m, value))
+                return false;
+            col.values_m.push_back(value);
+        }
+    }
+
+    return true;
+}
+
 std::string SDDS::SDDSParser::readFile() {
-    std::ifstream in(sddsFileName_m.c_str());
+    std::ifstream in(sddsFileName_m.c_str(), std::ios::binary);
 
     if (in) {
         std::string contents;
@@ -45,6 +45,7 @@ namespace SDDS {
     class SDDSParser {
     private:
         std::string readFile();
+        bool parseBinaryData(const std::string &contents);
         static void fixCaseSensitivity(std::string &for_string);
         static std::string fixCaseSensitivity(const std::string &for_string) {
             std::string retval(for_string);
@@ -60,6 +61,10 @@ namespace SDDS {
 
         SDDS::file sddsData_m;
 
+        /// byte offsets of the row count and of the first row of binary data
+        std::streamoff rowCountOffset_m;
+        std::streamoff firstRowOffset_m;
+
     public:
         SDDSParser();
         SDDSParser(const std::string &input);
@@ -69,6 +74,26 @@ namespace SDDS {
         file getData();
         ast::columnData_t getColumnData(const std::string &columnName);
 
+        bool isBinary() const {
+            return sddsData_m.sddsData_m.mode_m == ast::BINARY;
+        }
+
+        /**
+         *  Byte offset of the row count of the (first) page in a
+         *  binary file, -1 for ASCII files.
+         */
+        std::streamoff getRowCountOffset() const {
+            return rowCountOffset_m;
+        }
+
+        /**
+         *  Byte offset of the first row in a binary file, -1 for ASCII
+         *  files.
+         */
+        std::streamoff getFirstRowOffset() const {
+            return firstRowOffset_m;
+        }
+
         ast::datatype getColumnType(const std::string &col_name) {
             int index = getColumnIndex(col_name);
             return *sddsData_m.sddsColumns_m[index].type_m;
@@ -215,6 +240,7 @@ namespace SDDS {
                     value = boost::get<short>(val);
                     break;
                 case ast::LONG:
+                case ast::LONG64:
                     value = boost::get<long>(val);
                     break;
                 default:
@@ -60,6 +60,7 @@ namespace SDDS { namespace parser
              ("double", ast::DOUBLE)
              ("short", ast::SHORT)
              ("long", ast::LONG)
+             ("long64", ast::LONG64)
              ("character", ast::CHARACTER)
              ("string", ast::STRING)
              ;
@@ -29,6 +29,7 @@ namespace SDDS {
                       , DOUBLE
                       , SHORT
                       , LONG
+                      , LONG64
                       , CHARACTER
                       , STRING };
 
@@ -60,6 +61,8 @@ namespace SDDS {
                 return "short";
             case LONG:
                 return "long";
+            case LONG64:
+                return "long64";
             case CHARACTER:
                 return "char";
             case STRING:
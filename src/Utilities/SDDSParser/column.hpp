@@ -119,6 +119,7 @@ namespace SDDS {
                 break;
             }
             case ast::LONG:
+            case ast::LONG64:
             {
                 long l = 0;
                 boost::spirit::qi::long_type long_;
@@ -43,15 +43,6 @@ namespace SDDS {
         ast::datamode mode_m;
         long numberRows_m;
 
-        bool isASCII() const
-        {
-            if (mode_m == ast::BINARY) {
-                std::cerr << "can't handle binary data yet" << std::endl;
-                return false;
-            }
-            return true;
-        }
-
         template <attributes A>
         struct complainUnsupported
         {
@@ -43,7 +43,6 @@ namespace SDDS { namespace parser
         qi::short_type short_;
         qi::_val_type _val;
         qi::_pass_type _pass;
-        qi::eps_type eps;
 
         datamode.add
             ("ascii", ast::ASCII)
@@ -87,8 +86,7 @@ namespace SDDS { namespace parser
                 > ((data_mode[phx::at_c<0>(_val) = _1] >> ',' >> data_row[phx::at_c<1>(_val) = _1])
                  | (data_row[phx::at_c<1>(_val) = _1] >> ',' >> data_mode[phx::at_c<0>(_val) = _1]))
                 > -data_unsupported_pre
-                > lit("&end")
-                >> eps[_pass = phx::bind(&data::isASCII, _val)];
+                > lit("&end");
 
         BOOST_SPIRIT_DEBUG_NODES(
             (start)
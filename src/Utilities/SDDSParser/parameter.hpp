@@ -104,6 +104,7 @@ namespace SDDS {
                 return phrase_parse(first, last, short_, skipper, this->value_m);
             }
             case ast::LONG:
+            case ast::LONG64:
             {
                 boost::spirit::qi::long_type long_;
                 return phrase_parse(first, last, long_, skipper, this->value_m);
@@ -26,6 +26,7 @@
 #include <fstream>
 #include <iostream>
 #include <iterator>
+#include <map>
 #include <queue>
 
 namespace Util {
@@ -202,6 +203,47 @@ namespace Util {
         return path.string();
     }
 
+    namespace {
+        constexpr std::uint64_t fnvOffsetBasis = 14695981039346656037ull;
+
+        void accumulateHash(std::uint64_t& hash, const char* data, std::streamsize size) {
+            for (std::streamsize i = 0; i < size; ++i) {
+                hash ^= static_cast<unsigned char>(data[i]);
+                hash *= 1099511628211ull;
+            }
+        }
+    }  // namespace
+
+    std::uint64_t hashString(const std::string& str) {
+        std::uint64_t hash = fnvOffsetBasis;
+        accumulateHash(hash, str.data(), str.size());
+        return hash;
+    }
+
+    std::uint64_t hashFile(const std::string& fileName) {
+        // field maps are shared by many elements
+        static std::map<std::string, std::uint64_t> hashes;
+
+        auto it = hashes.find(fileName);
+        if (it != hashes.end()) {
+            return it->second;
+        }
+
+        std::uint64_t hash = fnvOffsetBasis;
+        std::ifstream in(fileName, std::ios::binary);
+        if (in) {
+            char buffer[1 << 16];
+            while (in.read(buffer, sizeof(buffer)) || in.gcount() > 0) {
+                accumulateHash(hash, buffer, in.gcount());
+            }
+        } else {
+            accumulateHash(hash, fileName.data(), fileName.size());
+        }
+
+        hashes[fileName] = hash;
+        return hash;
+    }
+
     KahanAccumulation::KahanAccumulation() : sum(0.0), correction(0.0) {
     }
 
@@ -22,6 +22,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <cstring>
 #include <functional>
 #include <initializer_list>
@@ -200,6 +201,12 @@ namespace Util {
 
     std::string combineFilePath(std::initializer_list<std::string>);
 
+    /// FNV-1a hash of a string
+    std::uint64_t hashString(const std::string& str);
+
+    /// FNV-1a hash of the content of a file (of its name if it can't be read), memoized
+    std::uint64_t hashFile(const std::string& fileName);
+
     template <class IteratorIn, class IteratorOut>
     void toString(IteratorIn first, IteratorIn last, IteratorOut out);
 
@@ -0,0 +1,99 @@
+#include "gtest/gtest.h"
+
+#include "Structure/BoundaryGeometry.h"
+
+#include "opal_test_utilities/SilenceTest.h"
+
+#include <algorithm>
+#include <vector>
+
+// the compressed sparse rows of DeviceVoxelMesh have to give the triangles that
+// voxelMesh_m holds for the ID of mapVoxelIndices2ID
+TEST(BoundaryGeometryTest, DeviceVoxelMeshLookup) {
+    OpalTestUtilities::SilenceTest silencer;
+
+    BoundaryGeometry geometry;
+
+    // a different number of voxels in each direction, such that swapped indices show up
+    geometry.voxelMesh_m.nr_m        = Vector_t<int, 3>(4, 3, 5);
+    geometry.voxelMesh_m.minExtent   = Vector_t<double, 3>(-1.0, -0.5, 0.0);
+    geometry.voxelMesh_m.sizeOfVoxel = Vector_t<double, 3>(0.5, 0.25, 0.2);
+    const Vector_t<int, 3> nr        = geometry.voxelMesh_m.nr_m;
+
+    const unsigned int numTriangles = 7;
+    for (unsigned int t = 0; t < numTriangles; ++t) {
+        geometry.Points_m.push_back(Vector_t<double, 3>(double(t), 0.0, 0.0));
+        geometry.Points_m.push_back(Vector_t<double, 3>(double(t), 1.0, 0.0));
+        geometry.Points_m.push_back(Vector_t<double, 3>(double(t), 0.0, 1.0));
+        geometry.Triangles_m.push_back({0, 3 * t, 3 * t + 1, 3 * t + 2});
+    }
+
+    // some voxels with an arbitrary set of triangles, including the first and the last
+    // voxel and triangles that are shared by several voxels
+    for (int k = 0; k < nr[2]; ++k) {
+        for (int j = 0; j < nr[1]; ++j) {
+            for (int i = 0; i < nr[0]; ++i) {
+                if ((i + 2 * j + 3 * k) % 3 == 1) {
+                    continue;
+                }
+                const int id = geometry.mapVoxelIndices2ID(i, j, k);
+                for (unsigned int t = 0; t < numTriangles; ++t) {
+                    if ((i * 5 + j * 3 + k + t) % 4 == 0) {
+                        geometry.voxelMesh_m.ids[id].insert(t);
+                    }
+                }
+            }
+        }
+    }
+    geometry.voxelMesh_m.ids[geometry.mapVoxelIndices2ID(0, 0, 0)].insert(numTriangles - 1);
+    geometry.voxelMesh_m.ids[geometry.mapVoxelIndices2ID(nr[0] - 1, nr[1] - 1, nr[2] - 1)]
+        .insert(0);
+
+    geometry.buildDeviceVoxelMesh();
+
+    const DeviceVoxelMesh& mesh = geometry.getDeviceVoxelMesh();
+    auto offsets   = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), mesh.offsets);
+    auto triangles = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), mesh.triangles);
+    auto vertices  = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), mesh.vertices);
+
+    const int numVoxels = nr[0] * nr[1] * nr[2];
+    ASSERT_EQ(offsets.extent(0), size_t(numVoxels + 1));
+    EXPECT_EQ(offsets(0), 0);
+    EXPECT_EQ(offsets(numVoxels), int(triangles.extent(0)));
+
+    for (int k = 0; k < nr[2]; ++k) {
+        for (int j = 0; j < nr[1]; ++j) {
+            for (int i = 0; i < nr[0]; ++i) {
+                // the linear index of DeviceVoxelMesh::intersectSegment
+                const int voxel = (k * mesh.nr[1] + j) * mesh.nr[0] + i;
+                const int id    = geometry.mapVoxelIndices2ID(i, j, k);
+                EXPECT_EQ(id, voxel + 1);
+
+                std::vector<int> expected;
+                auto it = geometry.voxelMesh_m.ids.find(id);
+                if (it != geometry.voxelMesh_m.ids.end()) {
+                    expected.assign(it->second.begin(), it->second.end());
+                }
+                std::sort(expected.begin(), expected.end());
+
+                std::vector<int> found;
+                for (int l = offsets(voxel); l < offsets(voxel + 1); ++l) {
+                    found.push_back(triangles(l));
+                }
+                EXPECT_EQ(found, expected) << "voxel (" << i << ", " << j << ", " << k << ")";
+            }
+        }
+    }
+
+    // outside of the mesh
+    EXPECT_EQ(geometry.mapVoxelIndices2ID(nr[0], 0, 0), 0);
+    EXPECT_EQ(geometry.mapVoxelIndices2ID(0, -1, 0), 0);
+
+    for (unsigned int t = 0; t < numTriangles; ++t) {
+        for (int corner = 0; corner < 3; ++corner) {
+            for (int d = 0; d < 3; ++d) {
+                EXPECT_EQ(vertices(t, 3 * corner + d), geometry.Points_m[3 * t + corner][d]);
+            }
+        }
+    }
+}
@@ -0,0 +1,82 @@
+#include "gtest/gtest.h"
+
+#include "Structure/SDDSWriter.h"
+#include "Utilities/OpalException.h"
+#include "Utilities/SDDSParser.h"
+
+#include "opal_test_utilities/SilenceTest.h"
+
+#include <boost/filesystem.hpp>
+
+#include <cstdint>
+#include <string>
+
+namespace {
+    class BinaryTestWriter: public SDDSWriter {
+    public:
+        explicit BinaryTestWriter(const std::string& fname): SDDSWriter(fname, false) {
+            addDescription("SDDSWriter test", "test parameters");
+            columns_m.addColumn("s", "double", "m", "Path length");
+            columns_m.addColumn("numParticles", "long64", "1", "Number of Macro Particles");
+            columns_m.addColumn("slice", "long", "1", "Slice index");
+            addInfo("binary", 1);
+        }
+
+        void addRow(double spos, size_t numParticles, size_t slice) {
+            open();
+            writeHeader();
+
+            columns_m.addColumnValue("s", spos);
+            columns_m.addColumnValue("numParticles", numParticles);
+            columns_m.addColumnValue("slice", slice);
+
+            writeRow();
+        }
+    };
+
+    const std::string fileName = "SDDSWriterTest.sdds";
+}
+
+TEST(SDDSWriterTest, BinaryRoundTrip) {
+    OpalTestUtilities::SilenceTest silencer;
+
+    // more particles than a 32 bit 'long' can hold
+    const size_t manyParticles = (size_t(1) << 33) + 7;
+    {
+        BinaryTestWriter writer(fileName);
+        writer.addRow(0.5, manyParticles, 1);
+        writer.addRow(1.5, 42, 2);
+        writer.flush();
+    }
+
+    SDDS::SDDSParser parser(fileName);
+    parser.run();
+
+    SDDS::ast::columnData_t spos         = parser.getColumnData("s");
+    SDDS::ast::columnData_t numParticles = parser.getColumnData("numParticles");
+    SDDS::ast::columnData_t slice        = parser.getColumnData("slice");
+
+    ASSERT_EQ(spos.size(), 2u);
+    ASSERT_EQ(numParticles.size(), 2u);
+    ASSERT_EQ(slice.size(), 2u);
+
+    EXPECT_EQ(boost::get<double>(spos[0]), 0.5);
+    EXPECT_EQ(boost::get<double>(spos[1]), 1.5);
+    EXPECT_EQ(boost::get<long>(numParticles[0]), static_cast<long>(manyParticles));
+    EXPECT_EQ(boost::get<long>(numParticles[1]), 42);
+    EXPECT_EQ(boost::get<long>(slice[0]), 1);
+    EXPECT_EQ(boost::get<long>(slice[1]), 2);
+
+    boost::filesystem::remove(fileName);
+}
+
+TEST(SDDSWriterTest, BinaryLongOverflow) {
+    OpalTestUtilities::SilenceTest silencer;
+
+    {
+        BinaryTestWriter writer(fileName);
+        EXPECT_THROW(writer.addRow(0.5, 1, size_t(1) << 31), OpalException);
+    }
+
+    boost::filesystem::remove(fileName);
+}
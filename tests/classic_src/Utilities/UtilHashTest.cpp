@@ -0,0 +1,36 @@
+#include "gtest/gtest.h"
+
+#include "Utilities/Util.h"
+
+#include <boost/filesystem.hpp>
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+// FNV-1a test vectors, see http://www.isthe.com/chongo/src/fnv/test_fnv.c
+TEST(UtilHashTest, HashString) {
+    EXPECT_EQ(Util::hashString(""), 0xcbf29ce484222325ull);
+    EXPECT_EQ(Util::hashString("a"), 0xaf63dc4c8601ec8cull);
+    EXPECT_EQ(Util::hashString("foobar"), 0x85944171f73967e8ull);
+}
+
+TEST(UtilHashTest, HashFile) {
+    const std::string fileName = "UtilHashTest.dat";
+
+    // larger than the read buffer of hashFile
+    std::string content;
+    for (unsigned int i = 0; i < 100000; ++i) {
+        content += static_cast<char>(i % 251);
+    }
+    {
+        std::ofstream out(fileName, std::ios::binary);
+        out << content;
+    }
+    EXPECT_EQ(Util::hashFile(fileName), Util::hashString(content));
+    boost::filesystem::remove(fileName);
+
+    // the name of a file that can't be read
+    const std::string missing = "UtilHashTest.missing";
+    EXPECT_EQ(Util::hashFile(missing), Util::hashString(missing));
+}
@@ -0,0 +1,93 @@
+//
+// Tests of the Philox4x32-10 generator and the truncated normal numbers of
+// CounterBasedSampling.
+//
+// This file is part of OPAL.
+//
+// OPAL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// You should have received a copy of the GNU General Public License
+// along with OPAL. If not, see <https://www.gnu.org/licenses/>.
+//
+#include "gtest/gtest.h"
+
+#include "Distribution/CounterBasedSampling.hpp"
+
+#include <cmath>
+#include <cstdint>
+
+using namespace CounterBasedSampling;
+
+namespace {
+    counter_type makeCounter(uint32_t c0, uint32_t c1, uint32_t c2, uint32_t c3) {
+        counter_type ctr;
+        ctr[0] = c0;
+        ctr[1] = c1;
+        ctr[2] = c2;
+        ctr[3] = c3;
+        return ctr;
+    }
+
+    void expectPhilox(
+        const counter_type& ctr, uint32_t key0, uint32_t key1, const counter_type& expected) {
+        const uint64_t seed       = (static_cast<uint64_t>(key1) << 32) | key0;
+        const counter_type result = philox4x32(ctr, seed);
+        for (unsigned int i = 0; i < 4; ++i) {
+            EXPECT_EQ(result[i], expected[i]) << "word " << i;
+        }
+    }
+}  // namespace
+
+// known-answer vectors of Random123 (kat_vectors, philox4x32 with 10 rounds)
+TEST(CounterBasedSamplingTest, PhiloxKnownAnswers) {
+    expectPhilox(
+        makeCounter(0, 0, 0, 0), 0, 0,
+        makeCounter(0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8));
+    expectPhilox(
+        makeCounter(0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff), 0xffffffff, 0xffffffff,
+        makeCounter(0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd));
+    expectPhilox(
+        makeCounter(0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344), 0xa4093822, 0x299f31d0,
+        makeCounter(0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1));
+}
+
+TEST(CounterBasedSamplingTest, InverseNormalCDF) {
+    for (double x = -8.0; x <= 4.0; x += 0.25) {
+        EXPECT_NEAR(inverseNormalCDF(normalCDF(x)), x, 1e-9 * std::max(1.0, std::abs(x)));
+    }
+    EXPECT_NEAR(inverseNormalCDF(0.5), 0.0, 1e-15);
+    EXPECT_NEAR(inverseNormalCDF(0.975), 1.959963984540054, 1e-12);
+}
+
+TEST(CounterBasedSamplingTest, TruncatedNormalFarTail) {
+    // almost no sample of the rejection falls into these intervals
+    const uint64_t seed         = 42;
+    const unsigned int nSamples = 2000;
+    double sumUpper = 0.0, sumLower = 0.0;
+    for (uint64_t id = 0; id < nSamples; ++id) {
+        const double upper = truncatedNormal(seed, id, 0, 10.0, 11.0);
+        const double lower = truncatedNormal(seed, id, 1, -11.0, -10.0);
+        ASSERT_GE(upper, 10.0);
+        ASSERT_LE(upper, 11.0);
+        ASSERT_GE(lower, -11.0);
+        ASSERT_LE(lower, -10.0);
+        sumUpper += upper;
+        sumLower += lower;
+    }
+
+    // mean of the tail beyond 10, phi(10) / (1 - Phi(10)) = 10.0980
+    EXPECT_NEAR(sumUpper / nSamples, 10.098, 0.01);
+    EXPECT_NEAR(sumLower / nSamples, -10.098, 0.01);
+}
+
+TEST(CounterBasedSamplingTest, TruncatedNormalIsReproducible) {
+    for (uint64_t id = 0; id < 100; ++id) {
+        const double z = truncatedNormal(7, id, 3, -3.0, 3.0);
+        EXPECT_GE(z, -3.0);
+        EXPECT_LE(z, 3.0);
+        EXPECT_EQ(z, truncatedNormal(7, id, 3, -3.0, 3.0));
+    }
+}
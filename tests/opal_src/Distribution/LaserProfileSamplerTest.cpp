@@ -0,0 +1,158 @@
+//
+// Tests of the alias table and the bilinear inversion of LaserProfileSampler.
+//
+// This file is part of OPAL.
+//
+// OPAL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// You should have received a copy of the GNU General Public License
+// along with OPAL. If not, see <https://www.gnu.org/licenses/>.
+//
+#include "gtest/gtest.h"
+
+#include "Distribution/LaserProfile.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace {
+    const double xmin = -1.5, ymin = 0.5;
+    const double dx = 0.25, dy = 0.5;
+
+    unsigned int getIndex(double x, double min, double spacing, unsigned int n) {
+        const int idx = static_cast<int>(std::floor((x - min) / spacing));
+        return static_cast<unsigned int>(std::clamp(idx, 0, static_cast<int>(n) - 1));
+    }
+
+    // the samples of a pixel stay inside the pixel
+    double getFraction(double x, double min, double spacing) {
+        return (x - min) / spacing - std::floor((x - min) / spacing);
+    }
+}  // namespace
+
+TEST(LaserProfileSamplerTest, MarginalHistograms) {
+    // not separable, with a pixel without intensity
+    const unsigned int nx = 6, ny = 5;
+    std::vector<double> bins(nx * ny);
+    for (unsigned int i = 0; i < nx; ++i) {
+        for (unsigned int j = 0; j < ny; ++j) {
+            bins[i * ny + j] = (i + 1) * (j + 1) + (i == j ? 10 : 0);
+        }
+    }
+    bins[2 * ny + 3] = 0.0;
+
+    double sum = 0.0;
+    std::vector<double> expectedX(nx, 0.0), expectedY(ny, 0.0);
+    for (unsigned int i = 0; i < nx; ++i) {
+        for (unsigned int j = 0; j < ny; ++j) {
+            expectedX[i] += bins[i * ny + j];
+            expectedY[j] += bins[i * ny + j];
+            sum += bins[i * ny + j];
+        }
+    }
+
+    const auto sampler = makeLaserProfileSampler(bins.data(), nx, ny, xmin, ymin, dx, dy);
+
+    const unsigned int numSamples = 400000;
+    std::mt19937_64 rng(12345);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    std::vector<double> histX(nx, 0.0), histY(ny, 0.0), hist(nx * ny, 0.0);
+    for (unsigned int k = 0; k < numSamples; ++k) {
+        const double u0 = uniform(rng), u1 = uniform(rng), u2 = uniform(rng), u3 = uniform(rng);
+        double x, y;
+        sampler.sample(u0, u1, u2, u3, x, y);
+
+        ASSERT_GE(x, xmin);
+        ASSERT_LE(x, xmin + nx * dx);
+        ASSERT_GE(y, ymin);
+        ASSERT_LE(y, ymin + ny * dy);
+
+        const unsigned int i = getIndex(x, xmin, dx, nx);
+        const unsigned int j = getIndex(y, ymin, dy, ny);
+        ++histX[i];
+        ++histY[j];
+        ++hist[i * ny + j];
+    }
+
+    // five standard deviations of the binomial counts
+    for (unsigned int i = 0; i < nx; ++i) {
+        const double p = expectedX[i] / sum;
+        EXPECT_NEAR(histX[i] / numSamples, p, 5 * std::sqrt(p * (1 - p) / numSamples))
+            << "x bin " << i;
+    }
+    for (unsigned int j = 0; j < ny; ++j) {
+        const double p = expectedY[j] / sum;
+        EXPECT_NEAR(histY[j] / numSamples, p, 5 * std::sqrt(p * (1 - p) / numSamples))
+            << "y bin " << j;
+    }
+    EXPECT_EQ(hist[2 * ny + 3], 0.0);
+}
+
+TEST(LaserProfileSamplerTest, BilinearInsidePixel) {
+    // one row of two pixels, the corner intensities along x are 1, 2 and 3
+    const unsigned int nx = 2, ny = 1;
+    const std::vector<double> bins = {1.0, 3.0};
+    const auto sampler = makeLaserProfileSampler(bins.data(), nx, ny, xmin, ymin, dx, dy);
+
+    const unsigned int numSamples = 400000;
+    const unsigned int numSubBins = 10;
+    const double subBin           = 1.0 / numSubBins;
+    std::mt19937_64 rng(54321);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    std::vector<double> hist(nx * numSubBins, 0.0), histY(numSubBins, 0.0);
+    for (unsigned int k = 0; k < numSamples; ++k) {
+        const double u0 = uniform(rng), u1 = uniform(rng), u2 = uniform(rng), u3 = uniform(rng);
+        double x, y;
+        sampler.sample(u0, u1, u2, u3, x, y);
+
+        const unsigned int i = getIndex(x, xmin, dx, nx);
+        const unsigned int s = getIndex(getFraction(x, xmin, dx), 0.0, subBin, numSubBins);
+        const unsigned int t = getIndex(getFraction(y, ymin, dy), 0.0, subBin, numSubBins);
+        ++hist[i * numSubBins + s];
+        ++histY[t];
+    }
+
+    // inside pixel i the density is linear from corner i to corner i + 1, the mass of
+    // the pixel is given by its intensity
+    const double corners[] = {1.0, 2.0, 3.0};
+    for (unsigned int i = 0; i < nx; ++i) {
+        const double a = corners[i], b = corners[i + 1];
+        auto cdf       = [a, b](double s) {
+            return (a * s + 0.5 * (b - a) * s * s) / (0.5 * (a + b));
+        };
+        for (unsigned int s = 0; s < numSubBins; ++s) {
+            const double p = bins[i] / 4.0
+                             * (cdf((s + 1.0) / numSubBins) - cdf(double(s) / numSubBins));
+            EXPECT_NEAR(
+                hist[i * numSubBins + s] / numSamples, p, 5 * std::sqrt(p * (1 - p) / numSamples))
+                << "pixel " << i << ", sub-bin " << s;
+        }
+    }
+
+    // the intensity doesn't change along y
+    for (unsigned int t = 0; t < numSubBins; ++t) {
+        const double p = 1.0 / numSubBins;
+        EXPECT_NEAR(histY[t] / numSamples, p, 5 * std::sqrt(p * (1 - p) / numSamples));
+    }
+}
+
+TEST(LaserProfileSamplerTest, InvertLinear) {
+    using Sampler = LaserProfileSampler<Kokkos::HostSpace>;
+    for (double a : {0.0, 0.5, 1.0, 4.0}) {
+        for (double b : {0.0, 1.0, 3.0}) {
+            if (a + b == 0.0) {
+                continue;
+            }
+            for (double u = 0.0; u <= 1.0; u += 0.125) {
+                const double s = Sampler::invertLinear(a, b, u);
+                EXPECT_NEAR((a * s + 0.5 * (b - a) * s * s) / (0.5 * (a + b)), u, 1e-12)
+                    << "a = " << a << ", b = " << b;
+            }
+        }
+    }
+}
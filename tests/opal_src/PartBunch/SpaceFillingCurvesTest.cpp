@@ -0,0 +1,99 @@
+//
+// Tests of the space filling curve keys used by AdaptBins::sortContainerByCell.
+//
+// This file is part of OPAL.
+//
+// OPAL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// You should have received a copy of the GNU General Public License
+// along with OPAL. If not, see <https://www.gnu.org/licenses/>.
+//
+#include "gtest/gtest.h"
+
+#include "PartBunch/Binning/SpaceFillingCurves.h"
+
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+using namespace ParticleBinning;
+
+namespace {
+    // the cells of a cube with 2^bits cells per dimension, ordered by their key
+    std::vector<std::array<int, 3>> getCellsByKey(CellOrdering curve, unsigned bits) {
+        const std::uint32_t n = std::uint32_t(1) << bits;
+        std::vector<std::array<int, 3>> cells(n * n * n, {-1, -1, -1});
+
+        for (std::uint32_t x = 0; x < n; ++x) {
+            for (std::uint32_t y = 0; y < n; ++y) {
+                for (std::uint32_t z = 0; z < n; ++z) {
+                    const std::uint64_t key = cellKey3D(curve, x, y, z, bits);
+                    EXPECT_LT(key, cells.size());
+                    if (key >= cells.size()) {
+                        continue;
+                    }
+                    EXPECT_EQ(cells[key][0], -1) << "key " << key << " is not unique";
+                    cells[key] = {int(x), int(y), int(z)};
+                }
+            }
+        }
+        return cells;
+    }
+
+    int getDistance(const std::array<int, 3>& a, const std::array<int, 3>& b) {
+        return std::abs(a[0] - b[0]) + std::abs(a[1] - b[1]) + std::abs(a[2] - b[2]);
+    }
+}  // namespace
+
+TEST(SpaceFillingCurvesTest, MortonInterleavesBits) {
+    EXPECT_EQ(mortonKey3D(0, 0, 1), 1u);
+    EXPECT_EQ(mortonKey3D(0, 1, 0), 2u);
+    EXPECT_EQ(mortonKey3D(1, 0, 0), 4u);
+    EXPECT_EQ(mortonKey3D(2, 0, 0), 32u);
+    EXPECT_EQ(mortonKey3D(3, 3, 3), 63u);
+
+    // the highest of the 21 bits per dimension
+    const std::uint32_t top = std::uint32_t(1) << 20;
+    EXPECT_EQ(mortonKey3D(top, 0, 0), std::uint64_t(1) << 62);
+    EXPECT_EQ(mortonKey3D(0, 0, top), std::uint64_t(1) << 60);
+}
+
+TEST(SpaceFillingCurvesTest, MortonOrdersOctants) {
+    for (unsigned bits = 1; bits <= 4; ++bits) {
+        const auto cells = getCellsByKey(CellOrdering::Morton, bits);
+
+        // every block of 8 consecutive keys is a 2x2x2 block of cells
+        for (size_t k = 0; k < cells.size(); k += 8) {
+            for (size_t j = 1; j < 8; ++j) {
+                for (unsigned d = 0; d < 3; ++d) {
+                    EXPECT_EQ(cells[k + j][d] / 2, cells[k][d] / 2);
+                }
+            }
+        }
+    }
+}
+
+TEST(SpaceFillingCurvesTest, HilbertIsContinuous) {
+    for (unsigned bits = 1; bits <= 5; ++bits) {
+        const auto cells = getCellsByKey(CellOrdering::Hilbert, bits);
+
+        EXPECT_EQ(cells.front(), (std::array<int, 3>{0, 0, 0}));
+
+        // consecutive keys are face neighbours
+        for (size_t k = 1; k < cells.size(); ++k) {
+            EXPECT_EQ(getDistance(cells[k - 1], cells[k]), 1)
+                << "bits = " << bits << ", key = " << k;
+        }
+    }
+}
+
+TEST(SpaceFillingCurvesTest, CellOrderingFromOption) {
+    EXPECT_EQ(getCellOrdering("MORTON"), CellOrdering::Morton);
+    EXPECT_EQ(getCellOrdering("HILBERT"), CellOrdering::Hilbert);
+    EXPECT_EQ(getCellOrdering("NONE"), CellOrdering::None);
+    EXPECT_EQ(getCellOrdering(""), CellOrdering::None);
+}
@@ -0,0 +1,139 @@
+//
+// Tests of the rasterized MSLang masks against the quad tree they are built from.
+//
+// This file is part of OPAL.
+//
+// OPAL is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// You should have received a copy of the GNU General Public License
+// along with OPAL. If not, see <https://www.gnu.org/licenses/>.
+//
+#include "gtest/gtest.h"
+
+#include "Utilities/MSLang.h"
+#include "Utilities/MSLang/QuadTree.h"
+#include "Utilities/MSLang/RasterizedMask.h"
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace mslang;
+
+namespace {
+    // the quad tree of an expression like in RasterizedMask::compile
+    QuadTree getQuadTree(const std::string& expression) {
+        Function* fun = nullptr;
+        EXPECT_TRUE(parse(expression, fun));
+
+        std::vector<std::shared_ptr<Base>> objects;
+        fun->apply(objects);
+        delete fun;
+
+        Vector_t<double, 3> llc(std::numeric_limits<double>::max());
+        Vector_t<double, 3> urc(std::numeric_limits<double>::lowest());
+        for (const std::shared_ptr<Base>& obj: objects) {
+            obj->computeBoundingBox();
+
+            const BoundingBox2D& bb = obj->bb_m;
+            llc[0] = std::min(llc[0], bb.center_m[0] - 0.5 * bb.width_m);
+            llc[1] = std::min(llc[1], bb.center_m[1] - 0.5 * bb.height_m);
+            urc[0] = std::max(urc[0], bb.center_m[0] + 0.5 * bb.width_m);
+            urc[1] = std::max(urc[1], bb.center_m[1] + 0.5 * bb.height_m);
+        }
+        llc[2] = urc[2] = 0.0;
+
+        QuadTree tree;
+        tree.bb_m = BoundingBox2D(llc, urc);
+        tree.objects_m.insert(tree.objects_m.end(), objects.begin(), objects.end());
+        tree.buildUp();
+
+        return tree;
+    }
+
+    // compares the mask with the quad tree on a grid of points around the shape and on the
+    // given points, the cells that aren't boundary cells have to agree with the quad tree
+    void expectSameAsQuadTree(
+        const std::string& expression, unsigned int nx, unsigned int ny,
+        const std::vector<Vector_t<double, 3>>& extraPoints) {
+        const QuadTree tree = getQuadTree(expression);
+        const RasterizedMask mask(tree, nx, ny);
+
+        const DeviceRasterizedMask& deviceMask = mask.getDeviceMask();
+        auto cells = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), deviceMask.cells_m);
+
+        std::vector<Vector_t<double, 3>> points(extraPoints);
+        const unsigned int numPoints = 200;
+        const BoundingBox2D& bb = tree.bb_m;
+        for (unsigned int j = 0; j <= numPoints; ++ j) {
+            const double y = bb.center_m[1] + 1.1 * bb.height_m * (j / double(numPoints) - 0.5);
+            for (unsigned int i = 0; i <= numPoints; ++ i) {
+                const double x = bb.center_m[0] + 1.1 * bb.width_m * (i / double(numPoints) - 0.5);
+                points.emplace_back(x, y, 0.0);
+            }
+        }
+
+        for (const Vector_t<double, 3>& R: points) {
+            const bool isInside = tree.isInside(R);
+            EXPECT_EQ(mask.isInside(R), isInside) << "at (" << R[0] << ", " << R[1] << ")";
+
+            const double u = (R[0] - deviceMask.llc_m[0]) / deviceMask.cellSize_m[0];
+            const double v = (R[1] - deviceMask.llc_m[1]) / deviceMask.cellSize_m[1];
+            if (u < 0.0 || u >= nx || v < 0.0 || v >= ny) {
+                continue;
+            }
+
+            const int cell = cells(int(u), int(v));
+            if (cell < 0) {
+                EXPECT_EQ(cell == DeviceRasterizedMask::INSIDE, isInside)
+                    << "at (" << R[0] << ", " << R[1] << ")";
+            }
+        }
+    }
+}
+
+TEST(RasterizedMaskTest, ThinShape) {
+    // the slit is much narrower than the 8x8 samples of a cell
+    const std::string expression =
+        "union(translate(rectangle(0.4,1.0),-0.3,0.0),translate(rectangle(0.0004,0.8),0.1237,0.0))";
+    const std::vector<Vector_t<double, 3>> slit = {Vector_t<double, 3>(0.1237, 0.0, 0.0),
+                                                   Vector_t<double, 3>(0.1238, 0.3, 0.0),
+                                                   Vector_t<double, 3>(0.1236, -0.3, 0.0)};
+    expectSameAsQuadTree(expression, 8, 8, slit);
+
+    auto mask = RasterizedMask::compile(expression, 8, 8);
+    for (const Vector_t<double, 3>& R: slit) {
+        EXPECT_TRUE(mask->isInside(R));
+    }
+}
+
+TEST(RasterizedMaskTest, HoledShape) {
+    // the hole is much smaller than the 8x8 samples of a cell
+    const std::string expression =
+        "difference(rectangle(1.0,1.0),translate(ellipse(0.002,0.002),0.0123,0.0271))";
+    const std::vector<Vector_t<double, 3>> hole = {Vector_t<double, 3>(0.0123, 0.0271, 0.0),
+                                                   Vector_t<double, 3>(0.0127, 0.0271, 0.0),
+                                                   Vector_t<double, 3>(0.0123, 0.0267, 0.0)};
+    expectSameAsQuadTree(expression, 10, 10, hole);
+
+    auto mask = RasterizedMask::compile(expression, 10, 10);
+    for (const Vector_t<double, 3>& R: hole) {
+        EXPECT_FALSE(mask->isInside(R));
+    }
+    EXPECT_TRUE(mask->isInside(Vector_t<double, 3>(0.3, -0.2, 0.0)));
+}
+
+TEST(RasterizedMaskTest, EllipseBoundary) {
+    const std::string expression = "ellipse(1.0,0.6)";
+    expectSameAsQuadTree(expression, 16, 16, {});
+
+    // the cells at the center are completely inside, the ones at the corners outside
+    auto mask = RasterizedMask::compile(expression, 16, 16);
+    EXPECT_GT(mask->getNumBoundaryCells(), 0u);
+    EXPECT_LT(mask->getNumBoundaryCells(), 16u * 16u);
+}